@@ -38,9 +38,24 @@ uint32_t custom_serial_send_callback(lw_callback_device *device, uint8_t *buffer
 
 int32_t custom_serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
     user_device_context *device_context = (user_device_context *)device->user_data;
+    int available = device_context->port->available();
+
+    // The API requests a whole receive buffer at a time, so only read what is
+    // already available and block for a single byte otherwise.
+    if (available > 0) {
+        if ((uint32_t)available < size) {
+            size = (uint32_t)available;
+        }
+
+        return device_context->port->readBytes(buffer, size);
+    }
+
+    if (timeout_ms == 0) {
+        return 0;
+    }
 
     device_context->port->setTimeout(timeout_ms);
-    return device_context->port->readBytes(buffer, size);
+    return device_context->port->readBytes(buffer, 1);
 }
 
 lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
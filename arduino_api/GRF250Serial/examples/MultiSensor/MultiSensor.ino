@@ -0,0 +1,92 @@
+#include <GRF250SerialGroup.h>
+
+// Serial port used for the serial monitor output.
+#define SERIAL_MONITOR Serial
+
+// The control loop period, 400 Hz.
+#define LOOP_PERIOD_US 2500
+
+// A helper function that checks if a function returns LW_RESULT_SUCCESS, otherwise
+// prints an error message to the SERIAL_MONITOR interface and pauses the program.
+void check_success(lw_result result, const char *error_message) {
+  if (result != LW_RESULT_SUCCESS) {
+    SERIAL_MONITOR.print(error_message);
+    // Sit in a loop to prevent the program from going further.
+    while (true) {}
+  }
+}
+
+GRF250SerialGroup grf250s;
+
+// The latest distance from each sensor, kept between samples.
+int32_t distance_mm[GRF250_GROUP_MAX_SENSORS];
+
+uint32_t last_loop_us = 0;
+uint32_t last_print_ms = 0;
+
+void setup() {
+  // Serial monitor serial port.
+  SERIAL_MONITOR.begin(115200);
+
+  // GRF250 serial ports.
+  Serial1.begin(115200);
+  Serial2.begin(115200);
+  Serial3.begin(115200);
+
+  grf250s.add(&Serial1);
+  grf250s.add(&Serial2);
+  grf250s.add(&Serial3);
+
+  // ----------------------------------------------------------------------------
+  // Set up the devices, blocking is fine here. start_streaming() initiates
+  // serial mode and applies the settings on every sensor.
+  // ----------------------------------------------------------------------------
+  for (uint32_t i = 0; i < grf250s.sensor_count; ++i) {
+    grf250s.sensors[i].distance_config = LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_FILTERED;
+    grf250s.sensors[i].update_rate = 50;
+    grf250s.sensors[i].enable_timestamps(115200);
+  }
+
+  check_success(grf250s.start_streaming(), "Failed to start streaming\n");
+
+  // Start pacing from now, not from before the blocking setup.
+  last_loop_us = micros();
+}
+
+void loop() {
+  // ----------------------------------------------------------------------------
+  // Take whatever the UARTs have received, this never waits.
+  // ----------------------------------------------------------------------------
+  grf250s.poll();
+
+  for (uint32_t i = 0; i < grf250s.sensor_count; ++i) {
+    lw_grf250_distance_data distance_data;
+
+    if (grf250s.read_latest_sample(i, &distance_data)) {
+      distance_mm[i] = distance_data.first_return_filtered_mm;
+    }
+  }
+
+  // ----------------------------------------------------------------------------
+  // Control loop work goes here.
+  // ----------------------------------------------------------------------------
+  if (millis() - last_print_ms >= 500) {
+    last_print_ms = millis();
+
+    for (uint32_t i = 0; i < grf250s.sensor_count; ++i) {
+      SERIAL_MONITOR.print(distance_mm[i]);
+      SERIAL_MONITOR.print(" mm ");
+    }
+
+    SERIAL_MONITOR.println();
+  }
+
+  while (micros() - last_loop_us < LOOP_PERIOD_US) {}
+  last_loop_us += LOOP_PERIOD_US;
+
+  // A pass that overran by more than a period skips the missed periods
+  // instead of running them back to back.
+  if (micros() - last_loop_us >= LOOP_PERIOD_US) {
+    last_loop_us = micros();
+  }
+}
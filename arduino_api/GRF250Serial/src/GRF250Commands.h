@@ -0,0 +1,306 @@
+#ifndef GRF250COMMANDS_H
+#define GRF250COMMANDS_H
+
+// NOTE: Written for C++11, the default of the AVR cores.
+#if __cplusplus < 201103L
+#error "GRF250Commands.h needs C++11, eg: add -std=gnu++11 to the compiler flags"
+#endif
+
+#include "lw_serial_api_grf250.h"
+#include <string.h>
+
+/*
+ * Typed GRF-250 register commands, generated at compile time from a single
+ * command table.
+ *
+ * Every register command is described once in command_table with its wire
+ * type, access mode, scaling and valid range. get<Cmd>() and set<Cmd>() then
+ * build and parse packets inline with payload sizes known at compile time,
+ * instead of going through one create_request, parse_response and get or set
+ * function per command.
+ *
+ * Only the commands that are used are compiled in, which saves flash on AVR.
+ * Commands with string or structured payloads, such as the product name and
+ * distance data, stay with the lw_grf250_... functions.
+ *
+ * Example:
+ *     uint32_t rate;
+ *     lw_grf250::set<lw_grf250::update_rate>(&sensor.device, 20);
+ *     lw_grf250::get<lw_grf250::update_rate>(&sensor.device, &rate);
+ *
+ */
+namespace lw_grf250 {
+
+    enum class access : uint8_t {
+        read,
+        write,
+        read_write,
+    };
+
+    enum class wire : uint8_t {
+        uint8,
+        uint16,
+        uint32,
+        int32,
+    };
+
+    enum class check : uint8_t {
+        none,
+        range,
+        stream,
+    };
+
+    struct command_info {
+        uint8_t id;
+        wire type;
+        access mode;
+
+        // The API value is the wire value times the scale, eg: alarm distances are
+        // given in cm and sent in 10 cm steps.
+        int32_t scale;
+
+        // Values outside the range are rejected by set() with LW_RESULT_INVALID_PARAMETER.
+        check validation;
+        int32_t min;
+        int32_t max;
+
+        // The response size of the command, checked against the wire type.
+        uint32_t response_size;
+    };
+
+    // clang-format off
+    // NOTE: Namespace scope constexpr has internal linkage, each translation unit
+    // gets its own table but only reads it at compile time.
+    constexpr command_info command_table[] = {
+        {LW_GRF250_COMMAND_HARDWARE_VERSION,         wire::uint32, access::read,       1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_HARDWARE_VERSION},
+        {LW_GRF250_COMMAND_FIRMWARE_VERSION,         wire::uint32, access::read,       1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_FIRMWARE_VERSION},
+        {LW_GRF250_COMMAND_TOKEN,                    wire::uint16, access::read,       1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_TOKEN},
+        {LW_GRF250_COMMAND_SAVE_PARAMETERS,          wire::uint16, access::write,      1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_SAVE_PARAMETERS},
+        {LW_GRF250_COMMAND_RESET,                    wire::uint16, access::write,      1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_RESET},
+        {LW_GRF250_COMMAND_DISTANCE_CONFIG,          wire::uint32, access::read_write, 1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_DISTANCE_CONFIG},
+        {LW_GRF250_COMMAND_STREAM,                   wire::uint32, access::read_write, 1,  check::stream, 0,     0,     LW_GRF250_RESPONSE_SIZE_STREAM},
+        {LW_GRF250_COMMAND_LASER_FIRING,             wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_LASER_FIRING},
+        {LW_GRF250_COMMAND_TEMPERATURE,              wire::int32,  access::read,       1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_TEMPERATURE},
+        {LW_GRF250_COMMAND_AUTO_EXPOSURE,            wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_AUTO_EXPOSURE},
+        {LW_GRF250_COMMAND_UPDATE_RATE,              wire::uint32, access::read_write, 1,  check::range,  1,     50,    LW_GRF250_RESPONSE_SIZE_UPDATE_RATE},
+        {LW_GRF250_COMMAND_ALARM_RETURN_MODE,        wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_ALARM_RETURN_MODE},
+        {LW_GRF250_COMMAND_LOST_SIGNAL_COUNTER,      wire::uint32, access::read_write, 1,  check::range,  1,     250,   LW_GRF250_RESPONSE_SIZE_LOST_SIGNAL_COUNTER},
+        {LW_GRF250_COMMAND_ALARM_A_DISTANCE,         wire::uint32, access::read_write, 10, check::range,  0,     30000, LW_GRF250_RESPONSE_SIZE_ALARM_A_DISTANCE},
+        {LW_GRF250_COMMAND_ALARM_B_DISTANCE,         wire::uint32, access::read_write, 10, check::range,  0,     30000, LW_GRF250_RESPONSE_SIZE_ALARM_B_DISTANCE},
+        {LW_GRF250_COMMAND_ALARM_HYSTERESIS,         wire::uint32, access::read_write, 10, check::range,  0,     3000,  LW_GRF250_RESPONSE_SIZE_ALARM_HYSTERESIS},
+        {LW_GRF250_COMMAND_GPIO_MODE,                wire::uint8,  access::read_write, 1,  check::range,  0,     2,     LW_GRF250_RESPONSE_SIZE_GPIO_MODE},
+        {LW_GRF250_COMMAND_GPIO_ALARM_CONFIRM_COUNT, wire::uint32, access::read_write, 1,  check::range,  0,     1000,  LW_GRF250_RESPONSE_SIZE_GPIO_ALARM_CONFIRM_COUNT},
+        {LW_GRF250_COMMAND_MEDIAN_FILTER_ENABLE,     wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_MEDIAN_FILTER_ENABLE},
+        {LW_GRF250_COMMAND_MEDIAN_FILTER_SIZE,       wire::uint32, access::read_write, 1,  check::range,  3,     32,    LW_GRF250_RESPONSE_SIZE_MEDIAN_FILTER_SIZE},
+        {LW_GRF250_COMMAND_SMOOTH_FILTER_ENABLE,     wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_SMOOTH_FILTER_ENABLE},
+        {LW_GRF250_COMMAND_SMOOTH_FILTER_FACTOR,     wire::uint32, access::read_write, 1,  check::range,  1,     99,    LW_GRF250_RESPONSE_SIZE_SMOOTH_FILTER_FACTOR},
+        {LW_GRF250_COMMAND_BAUD_RATE,                wire::uint8,  access::read_write, 1,  check::range,  0,     7,     LW_GRF250_RESPONSE_SIZE_BAUD_RATE},
+        {LW_GRF250_COMMAND_I2C_ADDRESS,              wire::uint8,  access::read_write, 1,  check::none,   0,     0,     LW_GRF250_RESPONSE_SIZE_I2C_ADDRESS},
+        {LW_GRF250_COMMAND_ROLLING_AVERAGE_ENABLE,   wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_ROLLING_AVERAGE_ENABLE},
+        {LW_GRF250_COMMAND_ROLLING_AVERAGE_SIZE,     wire::uint32, access::read_write, 1,  check::range,  2,     32,    LW_GRF250_RESPONSE_SIZE_ROLLING_AVERAGE_SIZE},
+        {LW_GRF250_COMMAND_LED_STATE,                wire::uint8,  access::read_write, 1,  check::range,  0,     1,     LW_GRF250_RESPONSE_SIZE_LED_STATE},
+        {LW_GRF250_COMMAND_ZERO_OFFSET,              wire::int32,  access::read_write, 10, check::range,  -1000, 1000,  LW_GRF250_RESPONSE_SIZE_ZERO_OFFSET},
+    };
+    // clang-format on
+
+    constexpr uint32_t command_count = sizeof(command_table) / sizeof(command_table[0]);
+
+    /*
+     * Find a command in the table.
+     *
+     * @param id The command ID.
+     * @param index The index to start searching from.
+     * @return The index of the command, or command_count if it is not in the table.
+     */
+    constexpr uint32_t find_command(uint8_t id, uint32_t index = 0) {
+        // NOTE: C++11 constexpr functions are a single return statement.
+        return (index == command_count) ? command_count : (command_table[index].id == id) ? index : find_command(id, index + 1);
+    }
+
+    template <wire Type> struct wire_value;
+    template <> struct wire_value<wire::uint8> { using type = uint8_t; };
+    template <> struct wire_value<wire::uint16> { using type = uint16_t; };
+    template <> struct wire_value<wire::uint32> { using type = uint32_t; };
+    template <> struct wire_value<wire::int32> { using type = int32_t; };
+
+    /*
+     * A register command, its table entry is looked up at compile time.
+     *
+     * @tparam Id The command ID.
+     * @tparam Value The type get() and set() use for the value.
+     */
+    template <uint8_t Id, typename Value>
+    struct command {
+        static_assert(find_command(Id) < command_count, "Command is not in command_table");
+
+        static constexpr command_info info = command_table[find_command(Id)];
+
+        using value_type = Value;
+        using wire_type = typename wire_value<info.type>::type;
+
+        static_assert(sizeof(wire_type) == info.response_size, "Wire type does not match the response size");
+    };
+
+    // NOTE: Needed before C++17 when info is used outside constant expressions.
+    template <uint8_t Id, typename Value>
+    constexpr command_info command<Id, Value>::info;
+
+    using hardware_version = command<LW_GRF250_COMMAND_HARDWARE_VERSION, uint32_t>;
+    using firmware_version = command<LW_GRF250_COMMAND_FIRMWARE_VERSION, uint32_t>;
+    using token = command<LW_GRF250_COMMAND_TOKEN, uint16_t>;
+    using save_parameters = command<LW_GRF250_COMMAND_SAVE_PARAMETERS, uint16_t>;
+    using reset = command<LW_GRF250_COMMAND_RESET, uint16_t>;
+    using distance_config = command<LW_GRF250_COMMAND_DISTANCE_CONFIG, lw_grf_distance_config>;
+    using stream = command<LW_GRF250_COMMAND_STREAM, lw_grf250_stream>;
+    using laser_firing = command<LW_GRF250_COMMAND_LASER_FIRING, lw_grf250_enable>;
+    using temperature = command<LW_GRF250_COMMAND_TEMPERATURE, int32_t>;
+    using auto_exposure = command<LW_GRF250_COMMAND_AUTO_EXPOSURE, lw_grf250_enable>;
+    using update_rate = command<LW_GRF250_COMMAND_UPDATE_RATE, uint32_t>;
+    using alarm_return_mode = command<LW_GRF250_COMMAND_ALARM_RETURN_MODE, lw_grf250_return_mode>;
+    using lost_signal_counter = command<LW_GRF250_COMMAND_LOST_SIGNAL_COUNTER, uint32_t>;
+    using alarm_a_distance = command<LW_GRF250_COMMAND_ALARM_A_DISTANCE, uint32_t>;
+    using alarm_b_distance = command<LW_GRF250_COMMAND_ALARM_B_DISTANCE, uint32_t>;
+    using alarm_hysteresis = command<LW_GRF250_COMMAND_ALARM_HYSTERESIS, uint32_t>;
+    using gpio_mode = command<LW_GRF250_COMMAND_GPIO_MODE, lw_grf250_gpio_mode>;
+    using gpio_alarm_confirm_count = command<LW_GRF250_COMMAND_GPIO_ALARM_CONFIRM_COUNT, uint32_t>;
+    using median_filter_enable = command<LW_GRF250_COMMAND_MEDIAN_FILTER_ENABLE, lw_grf250_enable>;
+    using median_filter_size = command<LW_GRF250_COMMAND_MEDIAN_FILTER_SIZE, uint32_t>;
+    using smooth_filter_enable = command<LW_GRF250_COMMAND_SMOOTH_FILTER_ENABLE, lw_grf250_enable>;
+    using smooth_filter_factor = command<LW_GRF250_COMMAND_SMOOTH_FILTER_FACTOR, uint32_t>;
+    using baud_rate = command<LW_GRF250_COMMAND_BAUD_RATE, lw_grf250_baud_rate>;
+    using i2c_address = command<LW_GRF250_COMMAND_I2C_ADDRESS, uint8_t>;
+    using rolling_average_enable = command<LW_GRF250_COMMAND_ROLLING_AVERAGE_ENABLE, lw_grf250_enable>;
+    using rolling_average_size = command<LW_GRF250_COMMAND_ROLLING_AVERAGE_SIZE, uint32_t>;
+    using led_state = command<LW_GRF250_COMMAND_LED_STATE, lw_grf250_enable>;
+    using zero_offset = command<LW_GRF250_COMMAND_ZERO_OFFSET, int32_t>;
+
+    // ----------------------------------------------------------------------------
+    // Packets.
+    // ----------------------------------------------------------------------------
+    // Write the header and CRC around a payload already in place, same layout as
+    // lw_create_packet.
+    template <uint8_t Id, uint32_t DataSize, uint8_t Write>
+    inline void create_packet(lw_request *request) {
+        constexpr uint16_t flags = (uint16_t)(((1 + DataSize) << 6) | Write);
+
+        request->data[0] = LW_PACKET_START_BYTE;
+        request->data[1] = (uint8_t)(flags & 0xFF);
+        request->data[2] = (uint8_t)(flags >> 8);
+        request->data[3] = Id;
+
+        uint16_t crc = lw_create_crc(request->data, (uint16_t)(4 + DataSize));
+        request->data[4 + DataSize] = (uint8_t)(crc & 0xFF);
+        request->data[5 + DataSize] = (uint8_t)(crc >> 8);
+
+        request->data_size = 6 + DataSize;
+        request->command_id = Id;
+    }
+
+    /*
+     * Create a read request.
+     *
+     * @param request The request to create.
+     */
+    template <typename Cmd>
+    inline void create_request_read(lw_request *request) {
+        static_assert(Cmd::info.mode != access::write, "Command is write only");
+        create_packet<Cmd::info.id, 0, 0>(request);
+    }
+
+    /*
+     * Create a write request.
+     *
+     * @param request The request to create.
+     * @param value The value to write.
+     * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the value is out of range.
+     */
+    template <typename Cmd>
+    inline lw_result create_request_write(lw_request *request, typename Cmd::value_type value) {
+        static_assert(Cmd::info.mode != access::read, "Command is read only");
+        using wire_type = typename Cmd::wire_type;
+
+        // NOTE: The checks are on constants, so the compiler drops the ones a
+        // command does not use. Unsigned values past INT32_MAX wrap negative
+        // and fail the range check.
+        if (Cmd::info.validation == check::range) {
+            int32_t number = (int32_t)value;
+
+            if (number < Cmd::info.min || number > Cmd::info.max) {
+                return LW_RESULT_INVALID_PARAMETER;
+            }
+        } else if (Cmd::info.validation == check::stream) {
+            uint32_t stream_id = (uint32_t)value;
+
+            if (stream_id != LW_GRF250_STREAM_NONE && stream_id != LW_GRF250_STREAM_DISTANCE && stream_id != LW_GRF250_STREAM_MULTI) {
+                return LW_RESULT_INVALID_PARAMETER;
+            }
+        }
+
+        wire_type raw = (wire_type)value;
+
+        if (Cmd::info.scale != 1) {
+            raw = (wire_type)(raw / Cmd::info.scale);
+        }
+
+        memcpy(request->data + 4, &raw, sizeof(raw));
+        create_packet<Cmd::info.id, sizeof(wire_type), 1>(request);
+        return LW_RESULT_SUCCESS;
+    }
+
+    /*
+     * Parse a response.
+     *
+     * @param response The completed response.
+     * @param value The value is written here.
+     * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INCORRECT_COMMAND_ID if the response is for another command.
+     */
+    template <typename Cmd>
+    inline lw_result parse_response(const lw_response *response, typename Cmd::value_type *value) {
+        if (response->command_id != Cmd::info.id) {
+            return LW_RESULT_INCORRECT_COMMAND_ID;
+        }
+
+        typename Cmd::wire_type raw;
+        memcpy(&raw, response->data + 4, sizeof(raw));
+
+        if (Cmd::info.scale != 1) {
+            raw = (typename Cmd::wire_type)(raw * Cmd::info.scale);
+        }
+
+        *value = (typename Cmd::value_type)raw;
+        return LW_RESULT_SUCCESS;
+    }
+
+    // ----------------------------------------------------------------------------
+    // Managed commands.
+    // ----------------------------------------------------------------------------
+    /*
+     * Read a register.
+     *
+     * @param device Connected device.
+     * @param value The value is written here.
+     * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+     */
+    template <typename Cmd>
+    inline lw_result get(lw_callback_device *device, typename Cmd::value_type *value) {
+        create_request_read<Cmd>(&device->request);
+        LW_CHECK_SUCCESS(lw_send_request_get_response(device))
+        return parse_response<Cmd>(&device->response, value);
+    }
+
+    /*
+     * Write a register.
+     *
+     * @param device Connected device.
+     * @param value The value to write.
+     * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+     */
+    template <typename Cmd>
+    inline lw_result set(lw_callback_device *device, typename Cmd::value_type value) {
+        LW_CHECK_SUCCESS(create_request_write<Cmd>(&device->request, value))
+        return lw_send_request_get_response(device);
+    }
+
+} // namespace lw_grf250
+
+#endif // GRF250COMMANDS_H
@@ -1,11 +1,25 @@
 #include "GRF250Serial.h"
 
+GRF250Serial::GRF250Serial() : port(NULL) {
+    init_device();
+}
+
 GRF250Serial::GRF250Serial(Stream *stream) : port(stream) {
-    port = stream;
+    init_device();
+}
+
+void GRF250Serial::init_device() {
     device = lw_create_callback_device(this, &GRF250Serial::sleep_callback,
                                        &GRF250Serial::get_time_ms_callback,
                                        &GRF250Serial::serial_send_callback,
                                        &GRF250Serial::serial_receive_callback);
+    lw_response_set_header_check(&device.response, &lw_grf250_check_response_header);
+    lw_device_set_command_timeout(&device, &lw_grf250_get_command_timeout);
+    decoder = lw_grf250_create_distance_decoder(distance_config);
+}
+
+void GRF250Serial::set_stream(Stream *stream) {
+    port = stream;
 }
 
 void GRF250Serial::set_callbacks(lw_device_callback_get_time_ms get_time_ms_callback,
@@ -18,10 +32,134 @@ void GRF250Serial::set_callbacks(lw_device_callback_get_time_ms get_time_ms_call
     device.serial_receive = serial_receive_callback;
 }
 
+void GRF250Serial::enable_timestamps(uint32_t baud_rate) {
+    lw_device_enable_timestamps(&device, &GRF250Serial::get_time_ns_callback, baud_rate);
+}
+
+lw_result GRF250Serial::start_streaming() {
+    LW_CHECK_SUCCESS(lw_grf250_set_distance_config(&device, distance_config))
+
+    if (update_rate != 0) {
+        LW_CHECK_SUCCESS(lw_grf250_set_update_rate(&device, update_rate))
+    }
+
+    decoder = lw_grf250_create_distance_decoder(distance_config);
+    sample_head = sample_tail;
+    return lw_grf250_set_stream(&device, LW_GRF250_STREAM_DISTANCE);
+}
+
+lw_result GRF250Serial::stop_streaming() {
+    return lw_grf250_set_stream(&device, LW_GRF250_STREAM_NONE);
+}
+
+uint32_t GRF250Serial::poll() {
+    uint32_t budget = GRF250_POLL_BYTE_BUDGET;
+    uint8_t buffer[16];
+
+    // NOTE: The managed receive path can leave bytes in the device buffer
+    // after the response it waited for.
+    uint32_t queued = parse_received();
+
+    while (1) {
+        uint32_t size = 0;
+
+        // NOTE: read() only takes bytes the UART interrupt already buffered.
+        while (size < sizeof(buffer) && budget > 0 && port->available() > 0) {
+            buffer[size++] = (uint8_t)port->read();
+            budget -= 1;
+        }
+
+        if (size == 0) {
+            break;
+        }
+
+        // The bytes go through the device receive path, so the stats, taps and
+        // packet timestamps see them like received bytes.
+        lw_device_receive_bytes(&device, buffer, size);
+        queued += parse_received();
+
+        if (size < sizeof(buffer)) {
+            break;
+        }
+    }
+
+    return queued;
+}
+
+uint32_t GRF250Serial::parse_received() {
+    uint32_t queued = 0;
+
+    // Other packets are routed by the device, such as to the packet callback.
+    while (lw_device_parse_receive_buffer(&device, LW_GRF250_COMMAND_DISTANCE_DATA) == LW_RESULT_SUCCESS) {
+        if (queue_sample()) {
+            queued += 1;
+        }
+    }
+
+    return queued;
+}
+
+bool GRF250Serial::queue_sample() {
+    // When the queue is full, new samples are dropped and counted as overruns.
+    if (sample_head - sample_tail == GRF250_SAMPLE_QUEUE_SIZE) {
+        sample_overruns += 1;
+        return false;
+    }
+
+    lw_grf250_distance_data *distance_data = &samples[sample_head & (GRF250_SAMPLE_QUEUE_SIZE - 1)];
+
+    // NOTE: The sample takes the start time of its packet when timestamps are enabled.
+    if (lw_grf250_decode_distance_data(&decoder, &device.response, distance_data) != LW_RESULT_SUCCESS) {
+        return false;
+    }
+
+    sample_head += 1;
+    return true;
+}
+
+bool GRF250Serial::read_sample(lw_grf250_distance_data *distance_data) {
+    if (sample_head == sample_tail) {
+        return false;
+    }
+
+    *distance_data = samples[sample_tail & (GRF250_SAMPLE_QUEUE_SIZE - 1)];
+    sample_tail += 1;
+    return true;
+}
+
+bool GRF250Serial::read_latest_sample(lw_grf250_distance_data *distance_data) {
+    if (sample_head == sample_tail) {
+        return false;
+    }
+
+    *distance_data = samples[(sample_head - 1) & (GRF250_SAMPLE_QUEUE_SIZE - 1)];
+    sample_tail = sample_head;
+    return true;
+}
+
+uint32_t GRF250Serial::available_samples() {
+    return sample_head - sample_tail;
+}
+
 uint32_t GRF250Serial::get_time_ms_callback(lw_callback_device *device) {
     return (uint32_t)millis();
 }
 
+uint64_t GRF250Serial::get_time_ns_callback(lw_callback_device *device) {
+    GRF250Serial *device_context = (GRF250Serial *)device->user_data;
+    uint32_t time_us = micros();
+
+    // NOTE: micros() wraps about every 71 minutes, which is counted as long as
+    // the device receives at least that often.
+    if (time_us < device_context->last_time_us) {
+        device_context->time_us_wraps += 1;
+    }
+
+    device_context->last_time_us = time_us;
+
+    return (((uint64_t)device_context->time_us_wraps << 32) | time_us) * 1000;
+}
+
 void GRF250Serial::sleep_callback(lw_callback_device *device, uint32_t time_ms) {
     delay(time_ms);
 }
@@ -33,10 +171,22 @@ uint32_t GRF250Serial::serial_send_callback(lw_callback_device *device, uint8_t
 
 int32_t GRF250Serial::serial_receive_callback(lw_callback_device *device,
                                               uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
-    (void)timeout_ms;
-
     GRF250Serial *device_context = (GRF250Serial *)device->user_data;
+    int available = device_context->port->available();
+
+    // Only block when nothing is buffered, readBytes waits for the full size.
+    if (available > 0) {
+        if ((uint32_t)available < size) {
+            size = (uint32_t)available;
+        }
+
+        return device_context->port->readBytes(buffer, size);
+    }
+
+    if (timeout_ms == 0) {
+        return 0;
+    }
 
     device_context->port->setTimeout(timeout_ms);
-    return device_context->port->readBytes(buffer, size);
+    return device_context->port->readBytes(buffer, 1);
 }
\ No newline at end of file
@@ -4,6 +4,25 @@
 #include "lw_serial_api_grf250.h"
 #include <Arduino.h>
 
+// The number of streamed samples queued by poll() for each sensor.
+#ifndef GRF250_SAMPLE_QUEUE_SIZE
+#ifdef __AVR__
+#define GRF250_SAMPLE_QUEUE_SIZE 4
+#else
+#define GRF250_SAMPLE_QUEUE_SIZE 16
+#endif
+#endif
+
+#if (GRF250_SAMPLE_QUEUE_SIZE & (GRF250_SAMPLE_QUEUE_SIZE - 1)) != 0
+#error "GRF250_SAMPLE_QUEUE_SIZE must be a power of 2"
+#endif
+
+// The most bytes a single poll() takes from the port, which bounds how long
+// it runs when the port has fallen behind.
+#ifndef GRF250_POLL_BYTE_BUDGET
+#define GRF250_POLL_BYTE_BUDGET 64
+#endif
+
 /*
  * Wrapper around the GRF-250 API to use with Arduino Stream objects.
  * You will still need to call the lw_grf250_... functions directly to communicate with the device.
@@ -18,15 +37,103 @@ public:
 
     lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
 
+    // The update rate set by start_streaming(), or 0 to keep the device setting.
+    uint32_t update_rate = 0;
+
+    // Samples dropped by poll() because the queue was full.
+    uint32_t sample_overruns = 0;
+
+    GRF250Serial();
     GRF250Serial(Stream *stream);
 
+    void set_stream(Stream *stream);
+
     void set_callbacks(lw_device_callback_get_time_ms get_time_ms_callback,
                        lw_device_callback_sleep sleep_callback,
                        lw_device_callback_serial_send serial_send_callback,
                        lw_device_callback_serial_receive serial_receive_callback);
 
+    /*
+     * Timestamp received samples with micros(). Timestamps are off by default
+     * as they add 64 bit math to every receive.
+     *
+     * @param baud_rate The baud rate of the stream, or 0 to skip the correction
+     *        for the transmission time of buffered bytes.
+     */
+    void enable_timestamps(uint32_t baud_rate = 0);
+
+    /*
+     * Set the distance config and update rate, and start streaming distance
+     * data. This blocks while the requests are sent, so call it from setup().
+     *
+     * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+     */
+    lw_result start_streaming();
+
+    /*
+     * Stop streaming distance data. This blocks while the request is sent.
+     *
+     * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+     */
+    lw_result stop_streaming();
+
+    /*
+     * Parse the bytes the port has already received, without waiting for
+     * more, and queue completed distance samples. The UART interrupt keeps
+     * filling the port buffer between calls, so call this often from loop()
+     * or serialEvent(), and read the samples with read_sample().
+     *
+     * The bytes go through the device receive path like received bytes, so
+     * device stats, taps and timestamps see them, and packets other than
+     * distance data go to the packet callback. Bytes the managed functions
+     * received but did not parse, such as the start of a sample that arrived
+     * with the last response, are parsed first.
+     *
+     * NOTE: Don't use the managed lw_grf250_... functions while streaming, as
+     * they would take the streamed bytes from under poll().
+     *
+     * @return The number of samples queued.
+     */
+    uint32_t poll();
+
+    /*
+     * Take the oldest queued sample.
+     *
+     * @param distance_data The sample is written here.
+     * @return True if a sample was queued.
+     */
+    bool read_sample(lw_grf250_distance_data *distance_data);
+
+    /*
+     * Take the newest queued sample and discard the older ones.
+     *
+     * @param distance_data The sample is written here.
+     * @return True if a sample was queued.
+     */
+    bool read_latest_sample(lw_grf250_distance_data *distance_data);
+
+    /*
+     * Get the number of queued samples.
+     */
+    uint32_t available_samples();
+
 private:
+    uint32_t last_time_us = 0;
+    uint32_t time_us_wraps = 0;
+
+    lw_grf250_distance_decoder decoder;
+
+    // NOTE: Free running indices, the queue holds (sample_head - sample_tail) samples.
+    uint32_t sample_head = 0;
+    uint32_t sample_tail = 0;
+    lw_grf250_distance_data samples[GRF250_SAMPLE_QUEUE_SIZE];
+
+    void init_device();
+    uint32_t parse_received();
+    bool queue_sample();
+
     static uint32_t get_time_ms_callback(lw_callback_device *device);
+    static uint64_t get_time_ns_callback(lw_callback_device *device);
     static void sleep_callback(lw_callback_device *device, uint32_t time_ms);
     static uint32_t serial_send_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size);
     static int32_t serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms);
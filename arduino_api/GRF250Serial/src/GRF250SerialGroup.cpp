@@ -0,0 +1,45 @@
+#include "GRF250SerialGroup.h"
+
+int GRF250SerialGroup::add(Stream *stream) {
+    if (sensor_count == GRF250_GROUP_MAX_SENSORS) {
+        return -1;
+    }
+
+    sensors[sensor_count].set_stream(stream);
+    return (int)sensor_count++;
+}
+
+lw_result GRF250SerialGroup::start_streaming() {
+    for (uint32_t i = 0; i < sensor_count; ++i) {
+        LW_CHECK_SUCCESS(lw_grf250_initiate_serial(&sensors[i].device))
+        LW_CHECK_SUCCESS(sensors[i].start_streaming())
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+uint32_t GRF250SerialGroup::poll() {
+    uint32_t queued = 0;
+
+    for (uint32_t i = 0; i < sensor_count; ++i) {
+        queued += sensors[i].poll();
+    }
+
+    return queued;
+}
+
+bool GRF250SerialGroup::read_sample(uint32_t index, lw_grf250_distance_data *distance_data) {
+    if (index >= sensor_count) {
+        return false;
+    }
+
+    return sensors[index].read_sample(distance_data);
+}
+
+bool GRF250SerialGroup::read_latest_sample(uint32_t index, lw_grf250_distance_data *distance_data) {
+    if (index >= sensor_count) {
+        return false;
+    }
+
+    return sensors[index].read_latest_sample(distance_data);
+}
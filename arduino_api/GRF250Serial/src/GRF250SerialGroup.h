@@ -0,0 +1,69 @@
+#ifndef GRF250SERIALGROUP_H
+#define GRF250SERIALGROUP_H
+
+#include "GRF250Serial.h"
+
+#ifndef GRF250_GROUP_MAX_SENSORS
+#define GRF250_GROUP_MAX_SENSORS 3
+#endif
+
+/*
+ * Several GRF-250s, each on its own Stream, serviced without blocking.
+ *
+ * Set up every sensor in setup(), where blocking is fine, then call poll()
+ * once per pass of loop(). Each poll() only parses the bytes the UARTs have
+ * already buffered, and queues the completed samples for each sensor.
+ *
+ * NOTE: Each port gets its own byte budget in a poll(), so a port that has
+ * fallen behind can't starve the others.
+ *
+ */
+class GRF250SerialGroup {
+public:
+    GRF250Serial sensors[GRF250_GROUP_MAX_SENSORS];
+    uint32_t sensor_count = 0;
+
+    /*
+     * Add a sensor. The port must already be started at the sensor baud rate.
+     *
+     * @param stream The port the sensor is connected to.
+     * @return The index of the sensor, or -1 if the group is full.
+     */
+    int add(Stream *stream);
+
+    /*
+     * Initiate serial mode, set the distance config and update rate, and start
+     * streaming on every sensor. This blocks while the requests are sent, so call it from
+     * setup().
+     *
+     * @return LW_RESULT_SUCCESS on success, or the error of the first sensor that failed.
+     */
+    lw_result start_streaming();
+
+    /*
+     * Parse the bytes every port has already received and queue completed samples.
+     *
+     * @return The number of samples queued across all sensors.
+     */
+    uint32_t poll();
+
+    /*
+     * Take the oldest queued sample of a sensor.
+     *
+     * @param index The index of the sensor.
+     * @param distance_data The sample is written here.
+     * @return True if a sample was queued.
+     */
+    bool read_sample(uint32_t index, lw_grf250_distance_data *distance_data);
+
+    /*
+     * Take the newest queued sample of a sensor and discard the older ones.
+     *
+     * @param index The index of the sensor.
+     * @param distance_data The sample is written here.
+     * @return True if a sample was queued.
+     */
+    bool read_latest_sample(uint32_t index, lw_grf250_distance_data *distance_data);
+};
+
+#endif // GRF250SERIALGROUP_H
@@ -31,43 +31,437 @@ lw_firmware_version lw_expand_firmware_version(uint32_t version) {
 // ----------------------------------------------------------------------------
 // Packet handling.
 // ----------------------------------------------------------------------------
-uint16_t lw_create_crc(uint8_t *data, uint16_t size) {
-    uint16_t crc = 0;
+#if LW_CRC_MODE == LW_CRC_MODE_BITWISE
 
-    for (uint32_t i = 0; i < size; ++i) {
-        uint16_t code = crc >> 8;
-        code ^= data[i];
-        code ^= code >> 4;
-        crc = crc << 8;
-        crc ^= code;
-        code = code << 5;
-        crc ^= code;
-        code = code << 7;
-        crc ^= code;
+static uint16_t lw_update_crc_byte(uint16_t crc, uint8_t data) {
+    uint16_t code = crc >> 8;
+    code ^= data;
+    code ^= code >> 4;
+    crc = crc << 8;
+    crc ^= code;
+    code = code << 5;
+    crc ^= code;
+    code = code << 7;
+    crc ^= code;
+
+    return crc;
+}
+
+#else
+
+#if LW_CRC_MODE == LW_CRC_MODE_SLICE_BY_8
+#define LW_CRC_TABLE_COUNT 8
+#elif LW_CRC_MODE == LW_CRC_MODE_SLICE_BY_4
+#define LW_CRC_TABLE_COUNT 4
+#else
+#define LW_CRC_TABLE_COUNT 1
+#endif
+
+// Table 0 holds the CRC of each single byte value. Table N holds the CRC of
+// each byte value followed by N zero bytes, which lets several input bytes be
+// combined per step.
+static const uint16_t lw_crc_table[LW_CRC_TABLE_COUNT][256] = {
+    {
+        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+        0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF,
+        0x1231, 0x0210, 0x3273, 0x2252, 0x52B5, 0x4294, 0x72F7, 0x62D6,
+        0x9339, 0x8318, 0xB37B, 0xA35A, 0xD3BD, 0xC39C, 0xF3FF, 0xE3DE,
+        0x2462, 0x3443, 0x0420, 0x1401, 0x64E6, 0x74C7, 0x44A4, 0x5485,
+        0xA56A, 0xB54B, 0x8528, 0x9509, 0xE5EE, 0xF5CF, 0xC5AC, 0xD58D,
+        0x3653, 0x2672, 0x1611, 0x0630, 0x76D7, 0x66F6, 0x5695, 0x46B4,
+        0xB75B, 0xA77A, 0x9719, 0x8738, 0xF7DF, 0xE7FE, 0xD79D, 0xC7BC,
+        0x48C4, 0x58E5, 0x6886, 0x78A7, 0x0840, 0x1861, 0x2802, 0x3823,
+        0xC9CC, 0xD9ED, 0xE98E, 0xF9AF, 0x8948, 0x9969, 0xA90A, 0xB92B,
+        0x5AF5, 0x4AD4, 0x7AB7, 0x6A96, 0x1A71, 0x0A50, 0x3A33, 0x2A12,
+        0xDBFD, 0xCBDC, 0xFBBF, 0xEB9E, 0x9B79, 0x8B58, 0xBB3B, 0xAB1A,
+        0x6CA6, 0x7C87, 0x4CE4, 0x5CC5, 0x2C22, 0x3C03, 0x0C60, 0x1C41,
+        0xEDAE, 0xFD8F, 0xCDEC, 0xDDCD, 0xAD2A, 0xBD0B, 0x8D68, 0x9D49,
+        0x7E97, 0x6EB6, 0x5ED5, 0x4EF4, 0x3E13, 0x2E32, 0x1E51, 0x0E70,
+        0xFF9F, 0xEFBE, 0xDFDD, 0xCFFC, 0xBF1B, 0xAF3A, 0x9F59, 0x8F78,
+        0x9188, 0x81A9, 0xB1CA, 0xA1EB, 0xD10C, 0xC12D, 0xF14E, 0xE16F,
+        0x1080, 0x00A1, 0x30C2, 0x20E3, 0x5004, 0x4025, 0x7046, 0x6067,
+        0x83B9, 0x9398, 0xA3FB, 0xB3DA, 0xC33D, 0xD31C, 0xE37F, 0xF35E,
+        0x02B1, 0x1290, 0x22F3, 0x32D2, 0x4235, 0x5214, 0x6277, 0x7256,
+        0xB5EA, 0xA5CB, 0x95A8, 0x8589, 0xF56E, 0xE54F, 0xD52C, 0xC50D,
+        0x34E2, 0x24C3, 0x14A0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
+        0xA7DB, 0xB7FA, 0x8799, 0x97B8, 0xE75F, 0xF77E, 0xC71D, 0xD73C,
+        0x26D3, 0x36F2, 0x0691, 0x16B0, 0x6657, 0x7676, 0x4615, 0x5634,
+        0xD94C, 0xC96D, 0xF90E, 0xE92F, 0x99C8, 0x89E9, 0xB98A, 0xA9AB,
+        0x5844, 0x4865, 0x7806, 0x6827, 0x18C0, 0x08E1, 0x3882, 0x28A3,
+        0xCB7D, 0xDB5C, 0xEB3F, 0xFB1E, 0x8BF9, 0x9BD8, 0xABBB, 0xBB9A,
+        0x4A75, 0x5A54, 0x6A37, 0x7A16, 0x0AF1, 0x1AD0, 0x2AB3, 0x3A92,
+        0xFD2E, 0xED0F, 0xDD6C, 0xCD4D, 0xBDAA, 0xAD8B, 0x9DE8, 0x8DC9,
+        0x7C26, 0x6C07, 0x5C64, 0x4C45, 0x3CA2, 0x2C83, 0x1CE0, 0x0CC1,
+        0xEF1F, 0xFF3E, 0xCF5D, 0xDF7C, 0xAF9B, 0xBFBA, 0x8FD9, 0x9FF8,
+        0x6E17, 0x7E36, 0x4E55, 0x5E74, 0x2E93, 0x3EB2, 0x0ED1, 0x1EF0,
+    },
+#if LW_CRC_TABLE_COUNT > 1
+    {
+        0x0000, 0x3331, 0x6662, 0x5553, 0xCCC4, 0xFFF5, 0xAAA6, 0x9997,
+        0x89A9, 0xBA98, 0xEFCB, 0xDCFA, 0x456D, 0x765C, 0x230F, 0x103E,
+        0x0373, 0x3042, 0x6511, 0x5620, 0xCFB7, 0xFC86, 0xA9D5, 0x9AE4,
+        0x8ADA, 0xB9EB, 0xECB8, 0xDF89, 0x461E, 0x752F, 0x207C, 0x134D,
+        0x06E6, 0x35D7, 0x6084, 0x53B5, 0xCA22, 0xF913, 0xAC40, 0x9F71,
+        0x8F4F, 0xBC7E, 0xE92D, 0xDA1C, 0x438B, 0x70BA, 0x25E9, 0x16D8,
+        0x0595, 0x36A4, 0x63F7, 0x50C6, 0xC951, 0xFA60, 0xAF33, 0x9C02,
+        0x8C3C, 0xBF0D, 0xEA5E, 0xD96F, 0x40F8, 0x73C9, 0x269A, 0x15AB,
+        0x0DCC, 0x3EFD, 0x6BAE, 0x589F, 0xC108, 0xF239, 0xA76A, 0x945B,
+        0x8465, 0xB754, 0xE207, 0xD136, 0x48A1, 0x7B90, 0x2EC3, 0x1DF2,
+        0x0EBF, 0x3D8E, 0x68DD, 0x5BEC, 0xC27B, 0xF14A, 0xA419, 0x9728,
+        0x8716, 0xB427, 0xE174, 0xD245, 0x4BD2, 0x78E3, 0x2DB0, 0x1E81,
+        0x0B2A, 0x381B, 0x6D48, 0x5E79, 0xC7EE, 0xF4DF, 0xA18C, 0x92BD,
+        0x8283, 0xB1B2, 0xE4E1, 0xD7D0, 0x4E47, 0x7D76, 0x2825, 0x1B14,
+        0x0859, 0x3B68, 0x6E3B, 0x5D0A, 0xC49D, 0xF7AC, 0xA2FF, 0x91CE,
+        0x81F0, 0xB2C1, 0xE792, 0xD4A3, 0x4D34, 0x7E05, 0x2B56, 0x1867,
+        0x1B98, 0x28A9, 0x7DFA, 0x4ECB, 0xD75C, 0xE46D, 0xB13E, 0x820F,
+        0x9231, 0xA100, 0xF453, 0xC762, 0x5EF5, 0x6DC4, 0x3897, 0x0BA6,
+        0x18EB, 0x2BDA, 0x7E89, 0x4DB8, 0xD42F, 0xE71E, 0xB24D, 0x817C,
+        0x9142, 0xA273, 0xF720, 0xC411, 0x5D86, 0x6EB7, 0x3BE4, 0x08D5,
+        0x1D7E, 0x2E4F, 0x7B1C, 0x482D, 0xD1BA, 0xE28B, 0xB7D8, 0x84E9,
+        0x94D7, 0xA7E6, 0xF2B5, 0xC184, 0x5813, 0x6B22, 0x3E71, 0x0D40,
+        0x1E0D, 0x2D3C, 0x786F, 0x4B5E, 0xD2C9, 0xE1F8, 0xB4AB, 0x879A,
+        0x97A4, 0xA495, 0xF1C6, 0xC2F7, 0x5B60, 0x6851, 0x3D02, 0x0E33,
+        0x1654, 0x2565, 0x7036, 0x4307, 0xDA90, 0xE9A1, 0xBCF2, 0x8FC3,
+        0x9FFD, 0xACCC, 0xF99F, 0xCAAE, 0x5339, 0x6008, 0x355B, 0x066A,
+        0x1527, 0x2616, 0x7345, 0x4074, 0xD9E3, 0xEAD2, 0xBF81, 0x8CB0,
+        0x9C8E, 0xAFBF, 0xFAEC, 0xC9DD, 0x504A, 0x637B, 0x3628, 0x0519,
+        0x10B2, 0x2383, 0x76D0, 0x45E1, 0xDC76, 0xEF47, 0xBA14, 0x8925,
+        0x991B, 0xAA2A, 0xFF79, 0xCC48, 0x55DF, 0x66EE, 0x33BD, 0x008C,
+        0x13C1, 0x20F0, 0x75A3, 0x4692, 0xDF05, 0xEC34, 0xB967, 0x8A56,
+        0x9A68, 0xA959, 0xFC0A, 0xCF3B, 0x56AC, 0x659D, 0x30CE, 0x03FF,
+    },
+    {
+        0x0000, 0x3730, 0x6E60, 0x5950, 0xDCC0, 0xEBF0, 0xB2A0, 0x8590,
+        0xA9A1, 0x9E91, 0xC7C1, 0xF0F1, 0x7561, 0x4251, 0x1B01, 0x2C31,
+        0x4363, 0x7453, 0x2D03, 0x1A33, 0x9FA3, 0xA893, 0xF1C3, 0xC6F3,
+        0xEAC2, 0xDDF2, 0x84A2, 0xB392, 0x3602, 0x0132, 0x5862, 0x6F52,
+        0x86C6, 0xB1F6, 0xE8A6, 0xDF96, 0x5A06, 0x6D36, 0x3466, 0x0356,
+        0x2F67, 0x1857, 0x4107, 0x7637, 0xF3A7, 0xC497, 0x9DC7, 0xAAF7,
+        0xC5A5, 0xF295, 0xABC5, 0x9CF5, 0x1965, 0x2E55, 0x7705, 0x4035,
+        0x6C04, 0x5B34, 0x0264, 0x3554, 0xB0C4, 0x87F4, 0xDEA4, 0xE994,
+        0x1DAD, 0x2A9D, 0x73CD, 0x44FD, 0xC16D, 0xF65D, 0xAF0D, 0x983D,
+        0xB40C, 0x833C, 0xDA6C, 0xED5C, 0x68CC, 0x5FFC, 0x06AC, 0x319C,
+        0x5ECE, 0x69FE, 0x30AE, 0x079E, 0x820E, 0xB53E, 0xEC6E, 0xDB5E,
+        0xF76F, 0xC05F, 0x990F, 0xAE3F, 0x2BAF, 0x1C9F, 0x45CF, 0x72FF,
+        0x9B6B, 0xAC5B, 0xF50B, 0xC23B, 0x47AB, 0x709B, 0x29CB, 0x1EFB,
+        0x32CA, 0x05FA, 0x5CAA, 0x6B9A, 0xEE0A, 0xD93A, 0x806A, 0xB75A,
+        0xD808, 0xEF38, 0xB668, 0x8158, 0x04C8, 0x33F8, 0x6AA8, 0x5D98,
+        0x71A9, 0x4699, 0x1FC9, 0x28F9, 0xAD69, 0x9A59, 0xC309, 0xF439,
+        0x3B5A, 0x0C6A, 0x553A, 0x620A, 0xE79A, 0xD0AA, 0x89FA, 0xBECA,
+        0x92FB, 0xA5CB, 0xFC9B, 0xCBAB, 0x4E3B, 0x790B, 0x205B, 0x176B,
+        0x7839, 0x4F09, 0x1659, 0x2169, 0xA4F9, 0x93C9, 0xCA99, 0xFDA9,
+        0xD198, 0xE6A8, 0xBFF8, 0x88C8, 0x0D58, 0x3A68, 0x6338, 0x5408,
+        0xBD9C, 0x8AAC, 0xD3FC, 0xE4CC, 0x615C, 0x566C, 0x0F3C, 0x380C,
+        0x143D, 0x230D, 0x7A5D, 0x4D6D, 0xC8FD, 0xFFCD, 0xA69D, 0x91AD,
+        0xFEFF, 0xC9CF, 0x909F, 0xA7AF, 0x223F, 0x150F, 0x4C5F, 0x7B6F,
+        0x575E, 0x606E, 0x393E, 0x0E0E, 0x8B9E, 0xBCAE, 0xE5FE, 0xD2CE,
+        0x26F7, 0x11C7, 0x4897, 0x7FA7, 0xFA37, 0xCD07, 0x9457, 0xA367,
+        0x8F56, 0xB866, 0xE136, 0xD606, 0x5396, 0x64A6, 0x3DF6, 0x0AC6,
+        0x6594, 0x52A4, 0x0BF4, 0x3CC4, 0xB954, 0x8E64, 0xD734, 0xE004,
+        0xCC35, 0xFB05, 0xA255, 0x9565, 0x10F5, 0x27C5, 0x7E95, 0x49A5,
+        0xA031, 0x9701, 0xCE51, 0xF961, 0x7CF1, 0x4BC1, 0x1291, 0x25A1,
+        0x0990, 0x3EA0, 0x67F0, 0x50C0, 0xD550, 0xE260, 0xBB30, 0x8C00,
+        0xE352, 0xD462, 0x8D32, 0xBA02, 0x3F92, 0x08A2, 0x51F2, 0x66C2,
+        0x4AF3, 0x7DC3, 0x2493, 0x13A3, 0x9633, 0xA103, 0xF853, 0xCF63,
+    },
+    {
+        0x0000, 0x76B4, 0xED68, 0x9BDC, 0xCAF1, 0xBC45, 0x2799, 0x512D,
+        0x85C3, 0xF377, 0x68AB, 0x1E1F, 0x4F32, 0x3986, 0xA25A, 0xD4EE,
+        0x1BA7, 0x6D13, 0xF6CF, 0x807B, 0xD156, 0xA7E2, 0x3C3E, 0x4A8A,
+        0x9E64, 0xE8D0, 0x730C, 0x05B8, 0x5495, 0x2221, 0xB9FD, 0xCF49,
+        0x374E, 0x41FA, 0xDA26, 0xAC92, 0xFDBF, 0x8B0B, 0x10D7, 0x6663,
+        0xB28D, 0xC439, 0x5FE5, 0x2951, 0x787C, 0x0EC8, 0x9514, 0xE3A0,
+        0x2CE9, 0x5A5D, 0xC181, 0xB735, 0xE618, 0x90AC, 0x0B70, 0x7DC4,
+        0xA92A, 0xDF9E, 0x4442, 0x32F6, 0x63DB, 0x156F, 0x8EB3, 0xF807,
+        0x6E9C, 0x1828, 0x83F4, 0xF540, 0xA46D, 0xD2D9, 0x4905, 0x3FB1,
+        0xEB5F, 0x9DEB, 0x0637, 0x7083, 0x21AE, 0x571A, 0xCCC6, 0xBA72,
+        0x753B, 0x038F, 0x9853, 0xEEE7, 0xBFCA, 0xC97E, 0x52A2, 0x2416,
+        0xF0F8, 0x864C, 0x1D90, 0x6B24, 0x3A09, 0x4CBD, 0xD761, 0xA1D5,
+        0x59D2, 0x2F66, 0xB4BA, 0xC20E, 0x9323, 0xE597, 0x7E4B, 0x08FF,
+        0xDC11, 0xAAA5, 0x3179, 0x47CD, 0x16E0, 0x6054, 0xFB88, 0x8D3C,
+        0x4275, 0x34C1, 0xAF1D, 0xD9A9, 0x8884, 0xFE30, 0x65EC, 0x1358,
+        0xC7B6, 0xB102, 0x2ADE, 0x5C6A, 0x0D47, 0x7BF3, 0xE02F, 0x969B,
+        0xDD38, 0xAB8C, 0x3050, 0x46E4, 0x17C9, 0x617D, 0xFAA1, 0x8C15,
+        0x58FB, 0x2E4F, 0xB593, 0xC327, 0x920A, 0xE4BE, 0x7F62, 0x09D6,
+        0xC69F, 0xB02B, 0x2BF7, 0x5D43, 0x0C6E, 0x7ADA, 0xE106, 0x97B2,
+        0x435C, 0x35E8, 0xAE34, 0xD880, 0x89AD, 0xFF19, 0x64C5, 0x1271,
+        0xEA76, 0x9CC2, 0x071E, 0x71AA, 0x2087, 0x5633, 0xCDEF, 0xBB5B,
+        0x6FB5, 0x1901, 0x82DD, 0xF469, 0xA544, 0xD3F0, 0x482C, 0x3E98,
+        0xF1D1, 0x8765, 0x1CB9, 0x6A0D, 0x3B20, 0x4D94, 0xD648, 0xA0FC,
+        0x7412, 0x02A6, 0x997A, 0xEFCE, 0xBEE3, 0xC857, 0x538B, 0x253F,
+        0xB3A4, 0xC510, 0x5ECC, 0x2878, 0x7955, 0x0FE1, 0x943D, 0xE289,
+        0x3667, 0x40D3, 0xDB0F, 0xADBB, 0xFC96, 0x8A22, 0x11FE, 0x674A,
+        0xA803, 0xDEB7, 0x456B, 0x33DF, 0x62F2, 0x1446, 0x8F9A, 0xF92E,
+        0x2DC0, 0x5B74, 0xC0A8, 0xB61C, 0xE731, 0x9185, 0x0A59, 0x7CED,
+        0x84EA, 0xF25E, 0x6982, 0x1F36, 0x4E1B, 0x38AF, 0xA373, 0xD5C7,
+        0x0129, 0x779D, 0xEC41, 0x9AF5, 0xCBD8, 0xBD6C, 0x26B0, 0x5004,
+        0x9F4D, 0xE9F9, 0x7225, 0x0491, 0x55BC, 0x2308, 0xB8D4, 0xCE60,
+        0x1A8E, 0x6C3A, 0xF7E6, 0x8152, 0xD07F, 0xA6CB, 0x3D17, 0x4BA3,
+    },
+#endif
+#if LW_CRC_TABLE_COUNT > 4
+    {
+        0x0000, 0xAA51, 0x4483, 0xEED2, 0x8906, 0x2357, 0xCD85, 0x67D4,
+        0x022D, 0xA87C, 0x46AE, 0xECFF, 0x8B2B, 0x217A, 0xCFA8, 0x65F9,
+        0x045A, 0xAE0B, 0x40D9, 0xEA88, 0x8D5C, 0x270D, 0xC9DF, 0x638E,
+        0x0677, 0xAC26, 0x42F4, 0xE8A5, 0x8F71, 0x2520, 0xCBF2, 0x61A3,
+        0x08B4, 0xA2E5, 0x4C37, 0xE666, 0x81B2, 0x2BE3, 0xC531, 0x6F60,
+        0x0A99, 0xA0C8, 0x4E1A, 0xE44B, 0x839F, 0x29CE, 0xC71C, 0x6D4D,
+        0x0CEE, 0xA6BF, 0x486D, 0xE23C, 0x85E8, 0x2FB9, 0xC16B, 0x6B3A,
+        0x0EC3, 0xA492, 0x4A40, 0xE011, 0x87C5, 0x2D94, 0xC346, 0x6917,
+        0x1168, 0xBB39, 0x55EB, 0xFFBA, 0x986E, 0x323F, 0xDCED, 0x76BC,
+        0x1345, 0xB914, 0x57C6, 0xFD97, 0x9A43, 0x3012, 0xDEC0, 0x7491,
+        0x1532, 0xBF63, 0x51B1, 0xFBE0, 0x9C34, 0x3665, 0xD8B7, 0x72E6,
+        0x171F, 0xBD4E, 0x539C, 0xF9CD, 0x9E19, 0x3448, 0xDA9A, 0x70CB,
+        0x19DC, 0xB38D, 0x5D5F, 0xF70E, 0x90DA, 0x3A8B, 0xD459, 0x7E08,
+        0x1BF1, 0xB1A0, 0x5F72, 0xF523, 0x92F7, 0x38A6, 0xD674, 0x7C25,
+        0x1D86, 0xB7D7, 0x5905, 0xF354, 0x9480, 0x3ED1, 0xD003, 0x7A52,
+        0x1FAB, 0xB5FA, 0x5B28, 0xF179, 0x96AD, 0x3CFC, 0xD22E, 0x787F,
+        0x22D0, 0x8881, 0x6653, 0xCC02, 0xABD6, 0x0187, 0xEF55, 0x4504,
+        0x20FD, 0x8AAC, 0x647E, 0xCE2F, 0xA9FB, 0x03AA, 0xED78, 0x4729,
+        0x268A, 0x8CDB, 0x6209, 0xC858, 0xAF8C, 0x05DD, 0xEB0F, 0x415E,
+        0x24A7, 0x8EF6, 0x6024, 0xCA75, 0xADA1, 0x07F0, 0xE922, 0x4373,
+        0x2A64, 0x8035, 0x6EE7, 0xC4B6, 0xA362, 0x0933, 0xE7E1, 0x4DB0,
+        0x2849, 0x8218, 0x6CCA, 0xC69B, 0xA14F, 0x0B1E, 0xE5CC, 0x4F9D,
+        0x2E3E, 0x846F, 0x6ABD, 0xC0EC, 0xA738, 0x0D69, 0xE3BB, 0x49EA,
+        0x2C13, 0x8642, 0x6890, 0xC2C1, 0xA515, 0x0F44, 0xE196, 0x4BC7,
+        0x33B8, 0x99E9, 0x773B, 0xDD6A, 0xBABE, 0x10EF, 0xFE3D, 0x546C,
+        0x3195, 0x9BC4, 0x7516, 0xDF47, 0xB893, 0x12C2, 0xFC10, 0x5641,
+        0x37E2, 0x9DB3, 0x7361, 0xD930, 0xBEE4, 0x14B5, 0xFA67, 0x5036,
+        0x35CF, 0x9F9E, 0x714C, 0xDB1D, 0xBCC9, 0x1698, 0xF84A, 0x521B,
+        0x3B0C, 0x915D, 0x7F8F, 0xD5DE, 0xB20A, 0x185B, 0xF689, 0x5CD8,
+        0x3921, 0x9370, 0x7DA2, 0xD7F3, 0xB027, 0x1A76, 0xF4A4, 0x5EF5,
+        0x3F56, 0x9507, 0x7BD5, 0xD184, 0xB650, 0x1C01, 0xF2D3, 0x5882,
+        0x3D7B, 0x972A, 0x79F8, 0xD3A9, 0xB47D, 0x1E2C, 0xF0FE, 0x5AAF,
+    },
+    {
+        0x0000, 0x45A0, 0x8B40, 0xCEE0, 0x06A1, 0x4301, 0x8DE1, 0xC841,
+        0x0D42, 0x48E2, 0x8602, 0xC3A2, 0x0BE3, 0x4E43, 0x80A3, 0xC503,
+        0x1A84, 0x5F24, 0x91C4, 0xD464, 0x1C25, 0x5985, 0x9765, 0xD2C5,
+        0x17C6, 0x5266, 0x9C86, 0xD926, 0x1167, 0x54C7, 0x9A27, 0xDF87,
+        0x3508, 0x70A8, 0xBE48, 0xFBE8, 0x33A9, 0x7609, 0xB8E9, 0xFD49,
+        0x384A, 0x7DEA, 0xB30A, 0xF6AA, 0x3EEB, 0x7B4B, 0xB5AB, 0xF00B,
+        0x2F8C, 0x6A2C, 0xA4CC, 0xE16C, 0x292D, 0x6C8D, 0xA26D, 0xE7CD,
+        0x22CE, 0x676E, 0xA98E, 0xEC2E, 0x246F, 0x61CF, 0xAF2F, 0xEA8F,
+        0x6A10, 0x2FB0, 0xE150, 0xA4F0, 0x6CB1, 0x2911, 0xE7F1, 0xA251,
+        0x6752, 0x22F2, 0xEC12, 0xA9B2, 0x61F3, 0x2453, 0xEAB3, 0xAF13,
+        0x7094, 0x3534, 0xFBD4, 0xBE74, 0x7635, 0x3395, 0xFD75, 0xB8D5,
+        0x7DD6, 0x3876, 0xF696, 0xB336, 0x7B77, 0x3ED7, 0xF037, 0xB597,
+        0x5F18, 0x1AB8, 0xD458, 0x91F8, 0x59B9, 0x1C19, 0xD2F9, 0x9759,
+        0x525A, 0x17FA, 0xD91A, 0x9CBA, 0x54FB, 0x115B, 0xDFBB, 0x9A1B,
+        0x459C, 0x003C, 0xCEDC, 0x8B7C, 0x433D, 0x069D, 0xC87D, 0x8DDD,
+        0x48DE, 0x0D7E, 0xC39E, 0x863E, 0x4E7F, 0x0BDF, 0xC53F, 0x809F,
+        0xD420, 0x9180, 0x5F60, 0x1AC0, 0xD281, 0x9721, 0x59C1, 0x1C61,
+        0xD962, 0x9CC2, 0x5222, 0x1782, 0xDFC3, 0x9A63, 0x5483, 0x1123,
+        0xCEA4, 0x8B04, 0x45E4, 0x0044, 0xC805, 0x8DA5, 0x4345, 0x06E5,
+        0xC3E6, 0x8646, 0x48A6, 0x0D06, 0xC547, 0x80E7, 0x4E07, 0x0BA7,
+        0xE128, 0xA488, 0x6A68, 0x2FC8, 0xE789, 0xA229, 0x6CC9, 0x2969,
+        0xEC6A, 0xA9CA, 0x672A, 0x228A, 0xEACB, 0xAF6B, 0x618B, 0x242B,
+        0xFBAC, 0xBE0C, 0x70EC, 0x354C, 0xFD0D, 0xB8AD, 0x764D, 0x33ED,
+        0xF6EE, 0xB34E, 0x7DAE, 0x380E, 0xF04F, 0xB5EF, 0x7B0F, 0x3EAF,
+        0xBE30, 0xFB90, 0x3570, 0x70D0, 0xB891, 0xFD31, 0x33D1, 0x7671,
+        0xB372, 0xF6D2, 0x3832, 0x7D92, 0xB5D3, 0xF073, 0x3E93, 0x7B33,
+        0xA4B4, 0xE114, 0x2FF4, 0x6A54, 0xA215, 0xE7B5, 0x2955, 0x6CF5,
+        0xA9F6, 0xEC56, 0x22B6, 0x6716, 0xAF57, 0xEAF7, 0x2417, 0x61B7,
+        0x8B38, 0xCE98, 0x0078, 0x45D8, 0x8D99, 0xC839, 0x06D9, 0x4379,
+        0x867A, 0xC3DA, 0x0D3A, 0x489A, 0x80DB, 0xC57B, 0x0B9B, 0x4E3B,
+        0x91BC, 0xD41C, 0x1AFC, 0x5F5C, 0x971D, 0xD2BD, 0x1C5D, 0x59FD,
+        0x9CFE, 0xD95E, 0x17BE, 0x521E, 0x9A5F, 0xDFFF, 0x111F, 0x54BF,
+    },
+    {
+        0x0000, 0xB861, 0x60E3, 0xD882, 0xC1C6, 0x79A7, 0xA125, 0x1944,
+        0x93AD, 0x2BCC, 0xF34E, 0x4B2F, 0x526B, 0xEA0A, 0x3288, 0x8AE9,
+        0x377B, 0x8F1A, 0x5798, 0xEFF9, 0xF6BD, 0x4EDC, 0x965E, 0x2E3F,
+        0xA4D6, 0x1CB7, 0xC435, 0x7C54, 0x6510, 0xDD71, 0x05F3, 0xBD92,
+        0x6EF6, 0xD697, 0x0E15, 0xB674, 0xAF30, 0x1751, 0xCFD3, 0x77B2,
+        0xFD5B, 0x453A, 0x9DB8, 0x25D9, 0x3C9D, 0x84FC, 0x5C7E, 0xE41F,
+        0x598D, 0xE1EC, 0x396E, 0x810F, 0x984B, 0x202A, 0xF8A8, 0x40C9,
+        0xCA20, 0x7241, 0xAAC3, 0x12A2, 0x0BE6, 0xB387, 0x6B05, 0xD364,
+        0xDDEC, 0x658D, 0xBD0F, 0x056E, 0x1C2A, 0xA44B, 0x7CC9, 0xC4A8,
+        0x4E41, 0xF620, 0x2EA2, 0x96C3, 0x8F87, 0x37E6, 0xEF64, 0x5705,
+        0xEA97, 0x52F6, 0x8A74, 0x3215, 0x2B51, 0x9330, 0x4BB2, 0xF3D3,
+        0x793A, 0xC15B, 0x19D9, 0xA1B8, 0xB8FC, 0x009D, 0xD81F, 0x607E,
+        0xB31A, 0x0B7B, 0xD3F9, 0x6B98, 0x72DC, 0xCABD, 0x123F, 0xAA5E,
+        0x20B7, 0x98D6, 0x4054, 0xF835, 0xE171, 0x5910, 0x8192, 0x39F3,
+        0x8461, 0x3C00, 0xE482, 0x5CE3, 0x45A7, 0xFDC6, 0x2544, 0x9D25,
+        0x17CC, 0xAFAD, 0x772F, 0xCF4E, 0xD60A, 0x6E6B, 0xB6E9, 0x0E88,
+        0xABF9, 0x1398, 0xCB1A, 0x737B, 0x6A3F, 0xD25E, 0x0ADC, 0xB2BD,
+        0x3854, 0x8035, 0x58B7, 0xE0D6, 0xF992, 0x41F3, 0x9971, 0x2110,
+        0x9C82, 0x24E3, 0xFC61, 0x4400, 0x5D44, 0xE525, 0x3DA7, 0x85C6,
+        0x0F2F, 0xB74E, 0x6FCC, 0xD7AD, 0xCEE9, 0x7688, 0xAE0A, 0x166B,
+        0xC50F, 0x7D6E, 0xA5EC, 0x1D8D, 0x04C9, 0xBCA8, 0x642A, 0xDC4B,
+        0x56A2, 0xEEC3, 0x3641, 0x8E20, 0x9764, 0x2F05, 0xF787, 0x4FE6,
+        0xF274, 0x4A15, 0x9297, 0x2AF6, 0x33B2, 0x8BD3, 0x5351, 0xEB30,
+        0x61D9, 0xD9B8, 0x013A, 0xB95B, 0xA01F, 0x187E, 0xC0FC, 0x789D,
+        0x7615, 0xCE74, 0x16F6, 0xAE97, 0xB7D3, 0x0FB2, 0xD730, 0x6F51,
+        0xE5B8, 0x5DD9, 0x855B, 0x3D3A, 0x247E, 0x9C1F, 0x449D, 0xFCFC,
+        0x416E, 0xF90F, 0x218D, 0x99EC, 0x80A8, 0x38C9, 0xE04B, 0x582A,
+        0xD2C3, 0x6AA2, 0xB220, 0x0A41, 0x1305, 0xAB64, 0x73E6, 0xCB87,
+        0x18E3, 0xA082, 0x7800, 0xC061, 0xD925, 0x6144, 0xB9C6, 0x01A7,
+        0x8B4E, 0x332F, 0xEBAD, 0x53CC, 0x4A88, 0xF2E9, 0x2A6B, 0x920A,
+        0x2F98, 0x97F9, 0x4F7B, 0xF71A, 0xEE5E, 0x563F, 0x8EBD, 0x36DC,
+        0xBC35, 0x0454, 0xDCD6, 0x64B7, 0x7DF3, 0xC592, 0x1D10, 0xA571,
+    },
+    {
+        0x0000, 0x47D3, 0x8FA6, 0xC875, 0x0F6D, 0x48BE, 0x80CB, 0xC718,
+        0x1EDA, 0x5909, 0x917C, 0xD6AF, 0x11B7, 0x5664, 0x9E11, 0xD9C2,
+        0x3DB4, 0x7A67, 0xB212, 0xF5C1, 0x32D9, 0x750A, 0xBD7F, 0xFAAC,
+        0x236E, 0x64BD, 0xACC8, 0xEB1B, 0x2C03, 0x6BD0, 0xA3A5, 0xE476,
+        0x7B68, 0x3CBB, 0xF4CE, 0xB31D, 0x7405, 0x33D6, 0xFBA3, 0xBC70,
+        0x65B2, 0x2261, 0xEA14, 0xADC7, 0x6ADF, 0x2D0C, 0xE579, 0xA2AA,
+        0x46DC, 0x010F, 0xC97A, 0x8EA9, 0x49B1, 0x0E62, 0xC617, 0x81C4,
+        0x5806, 0x1FD5, 0xD7A0, 0x9073, 0x576B, 0x10B8, 0xD8CD, 0x9F1E,
+        0xF6D0, 0xB103, 0x7976, 0x3EA5, 0xF9BD, 0xBE6E, 0x761B, 0x31C8,
+        0xE80A, 0xAFD9, 0x67AC, 0x207F, 0xE767, 0xA0B4, 0x68C1, 0x2F12,
+        0xCB64, 0x8CB7, 0x44C2, 0x0311, 0xC409, 0x83DA, 0x4BAF, 0x0C7C,
+        0xD5BE, 0x926D, 0x5A18, 0x1DCB, 0xDAD3, 0x9D00, 0x5575, 0x12A6,
+        0x8DB8, 0xCA6B, 0x021E, 0x45CD, 0x82D5, 0xC506, 0x0D73, 0x4AA0,
+        0x9362, 0xD4B1, 0x1CC4, 0x5B17, 0x9C0F, 0xDBDC, 0x13A9, 0x547A,
+        0xB00C, 0xF7DF, 0x3FAA, 0x7879, 0xBF61, 0xF8B2, 0x30C7, 0x7714,
+        0xAED6, 0xE905, 0x2170, 0x66A3, 0xA1BB, 0xE668, 0x2E1D, 0x69CE,
+        0xFD81, 0xBA52, 0x7227, 0x35F4, 0xF2EC, 0xB53F, 0x7D4A, 0x3A99,
+        0xE35B, 0xA488, 0x6CFD, 0x2B2E, 0xEC36, 0xABE5, 0x6390, 0x2443,
+        0xC035, 0x87E6, 0x4F93, 0x0840, 0xCF58, 0x888B, 0x40FE, 0x072D,
+        0xDEEF, 0x993C, 0x5149, 0x169A, 0xD182, 0x9651, 0x5E24, 0x19F7,
+        0x86E9, 0xC13A, 0x094F, 0x4E9C, 0x8984, 0xCE57, 0x0622, 0x41F1,
+        0x9833, 0xDFE0, 0x1795, 0x5046, 0x975E, 0xD08D, 0x18F8, 0x5F2B,
+        0xBB5D, 0xFC8E, 0x34FB, 0x7328, 0xB430, 0xF3E3, 0x3B96, 0x7C45,
+        0xA587, 0xE254, 0x2A21, 0x6DF2, 0xAAEA, 0xED39, 0x254C, 0x629F,
+        0x0B51, 0x4C82, 0x84F7, 0xC324, 0x043C, 0x43EF, 0x8B9A, 0xCC49,
+        0x158B, 0x5258, 0x9A2D, 0xDDFE, 0x1AE6, 0x5D35, 0x9540, 0xD293,
+        0x36E5, 0x7136, 0xB943, 0xFE90, 0x3988, 0x7E5B, 0xB62E, 0xF1FD,
+        0x283F, 0x6FEC, 0xA799, 0xE04A, 0x2752, 0x6081, 0xA8F4, 0xEF27,
+        0x7039, 0x37EA, 0xFF9F, 0xB84C, 0x7F54, 0x3887, 0xF0F2, 0xB721,
+        0x6EE3, 0x2930, 0xE145, 0xA696, 0x618E, 0x265D, 0xEE28, 0xA9FB,
+        0x4D8D, 0x0A5E, 0xC22B, 0x85F8, 0x42E0, 0x0533, 0xCD46, 0x8A95,
+        0x5357, 0x1484, 0xDCF1, 0x9B22, 0x5C3A, 0x1BE9, 0xD39C, 0x944F,
+    },
+#endif
+};
+
+static uint16_t lw_update_crc_byte(uint16_t crc, uint8_t data) {
+    return (uint16_t)((crc << 8) ^ lw_crc_table[0][(crc >> 8) ^ data]);
+}
+
+#endif
+
+uint16_t lw_update_crc(uint16_t crc, const uint8_t *data, uint32_t size) {
+    uint32_t i = 0;
+
+#if LW_CRC_MODE == LW_CRC_MODE_SLICE_BY_8
+    for (; i + 8 <= size; i += 8) {
+        crc = lw_crc_table[7][data[i + 0] ^ (crc >> 8)] ^
+              lw_crc_table[6][data[i + 1] ^ (crc & 0xFF)] ^
+              lw_crc_table[5][data[i + 2]] ^
+              lw_crc_table[4][data[i + 3]] ^
+              lw_crc_table[3][data[i + 4]] ^
+              lw_crc_table[2][data[i + 5]] ^
+              lw_crc_table[1][data[i + 6]] ^
+              lw_crc_table[0][data[i + 7]];
+    }
+#elif LW_CRC_MODE == LW_CRC_MODE_SLICE_BY_4
+    for (; i + 4 <= size; i += 4) {
+        crc = lw_crc_table[3][data[i + 0] ^ (crc >> 8)] ^
+              lw_crc_table[2][data[i + 1] ^ (crc & 0xFF)] ^
+              lw_crc_table[1][data[i + 2]] ^
+              lw_crc_table[0][data[i + 3]];
+    }
+#endif
+
+    for (; i < size; ++i) {
+        crc = lw_update_crc_byte(crc, data[i]);
     }
 
     return crc;
 }
 
-void lw_init_response(lw_response *response) {
+uint16_t lw_create_crc(uint8_t *data, uint16_t size) {
+    return lw_update_crc(0, data, size);
+}
+
+static void lw_clear_response(lw_response *response) {
     response->data_size = 0;
     response->payload_size = 0;
     response->parse_state = LW_PARSESTATE_START;
+    response->parse_error = LW_PARSE_ERROR_NONE;
+    response->crc = 0;
     response->command_id = UINT8_MAX;
+    response->start_time_ns = 0;
 }
 
-lw_result lw_feed_response(lw_response *response, uint8_t data) {
-    LW_DEBUG_LVL_3("Feed packet: 0x%02X\n", data);
-    
-    if (response->parse_state == LW_PARSESTATE_DONE) {
-        lw_init_response(response);
+void lw_init_response(lw_response *response) {
+    lw_clear_response(response);
+    response->header_check = NULL;
+    response->resync_size = 0;
+}
+
+void lw_reset_response(lw_response *response) {
+    lw_clear_response(response);
+    response->resync_size = 0;
+}
+
+void lw_response_set_header_check(lw_response *response, lw_response_header_check header_check) {
+    response->header_check = header_check;
+}
+
+/*
+ * Start the next packet after a completed one.
+ *
+ * @param response The completed response.
+ * @return The number of bytes left over from a resync, moved to the start of response->data.
+ */
+static uint32_t lw_restart_response(lw_response *response) {
+    uint32_t resync_offset = response->data_size;
+    uint32_t resync_size = response->resync_size;
+    uint64_t start_time_ns = response->start_time_ns;
+
+    lw_clear_response(response);
+    response->resync_size = 0;
+
+    if (resync_size != 0) {
+        memmove(response->data, response->data + resync_offset, resync_size);
+        response->start_time_ns = start_time_ns;
+    }
+
+    return resync_size;
+}
+
+// NOTE: Every parse error after LW_PARSE_ERROR_SKIPPED_BYTES fails a packet.
+static uint8_t lw_response_failed(lw_response *response) {
+    return response->parse_error > LW_PARSE_ERROR_SKIPPED_BYTES;
+}
+
+static lw_result lw_complete_response(lw_response *response) {
+    // The CRC of the header and payload is built up as the bytes arrive.
+    uint16_t crc = response->data[response->data_size - 2] | (response->data[response->data_size - 1] << 8);
+
+    if (crc != response->crc) {
+        response->parse_state = LW_PARSESTATE_START;
+        response->parse_error = LW_PARSE_ERROR_CRC;
+        LW_DEBUG_LVL_2("Invalid CRC\n");
+        return LW_RESULT_AGAIN;
     }
 
+    response->parse_state = LW_PARSESTATE_DONE;
+    response->command_id = response->data[3];
+    print_hex_debug("Recv packet: ", response->data, response->data_size);
+    LW_DEBUG_LVL_2("Got packet %d\n", response->command_id);
+    return LW_RESULT_SUCCESS;
+}
+
+/*
+ * Advance the parser by one byte. A failed packet leaves its bytes in
+ * response->data, with response->data_size set to how many were buffered.
+ */
+static lw_result lw_parse_response_byte(lw_response *response, uint8_t data) {
     switch (response->parse_state) {
         case LW_PARSESTATE_START: {
             if (data == LW_PACKET_START_BYTE) {
                 response->parse_state = LW_PARSESTATE_FLAGS1;
                 response->data[0] = LW_PACKET_START_BYTE;
+                response->crc = lw_update_crc_byte(0, data);
+            } else {
+                response->parse_error = LW_PARSE_ERROR_SKIPPED_BYTES;
             }
 
             break;
@@ -76,6 +470,7 @@ lw_result lw_feed_response(lw_response *response, uint8_t data) {
         case LW_PARSESTATE_FLAGS1: {
             response->parse_state = LW_PARSESTATE_FLAGS2;
             response->data[1] = data;
+            response->crc = lw_update_crc_byte(response->crc, data);
             break;
         }
 
@@ -83,10 +478,12 @@ lw_result lw_feed_response(lw_response *response, uint8_t data) {
             response->parse_state = LW_PARSESTATE_PAYLOAD;
             response->data[2] = data;
             response->data_size = 3;
+            response->crc = lw_update_crc_byte(response->crc, data);
             response->payload_size = (uint32_t)(response->data[1] | (response->data[2] << 8)) >> 6;
 
             if (response->payload_size > (LW_PACKET_RECV_SIZE - 5) || response->payload_size < 1) {
                 response->parse_state = LW_PARSESTATE_START;
+                response->parse_error = LW_PARSE_ERROR_PAYLOAD_SIZE;
                 LW_DEBUG_LVL_2("Invalid payload size %d\n", response->payload_size);
             }
 
@@ -94,24 +491,27 @@ lw_result lw_feed_response(lw_response *response, uint8_t data) {
         }
 
         case LW_PARSESTATE_PAYLOAD: {
+            // The last two bytes are the CRC itself.
+            if (response->data_size < response->payload_size + 3) {
+                response->crc = lw_update_crc_byte(response->crc, data);
+            }
+
             response->data[response->data_size++] = data;
 
-            if (response->data_size == response->payload_size + 5) {
-                uint16_t crc = response->data[response->data_size - 2] | (response->data[response->data_size - 1] << 8);
-                uint16_t verify_crc = lw_create_crc(response->data, (uint16_t)(response->data_size - 2));
-
-                if (crc == verify_crc) {
-                    response->parse_state = LW_PARSESTATE_DONE;
-                    response->command_id = response->data[3];
-                    print_hex_debug("Recv packet: ", response->data, response->data_size);
-                    LW_DEBUG_LVL_2("Got packet %d\n", response->command_id);
-                    return LW_RESULT_SUCCESS;
-                } else {
+            // The first payload byte is the command ID.
+            if (response->data_size == 4 && response->header_check != NULL) {
+                if (response->header_check(data, response->payload_size) != LW_RESULT_SUCCESS) {
                     response->parse_state = LW_PARSESTATE_START;
-                    LW_DEBUG_LVL_2("Invalid CRC\n");
+                    response->parse_error = LW_PARSE_ERROR_HEADER;
+                    LW_DEBUG_LVL_2("Invalid header for command %d\n", data);
+                    break;
                 }
             }
 
+            if (response->data_size == response->payload_size + 5) {
+                return lw_complete_response(response);
+            }
+
             break;
         }
 
@@ -123,6 +523,192 @@ lw_result lw_feed_response(lw_response *response, uint8_t data) {
     return LW_RESULT_AGAIN;
 }
 
+/*
+ * Parse bytes already held in response->data again, from the first start
+ * byte at or after index. Whenever a candidate packet fails, the scan
+ * continues from its second byte, so every start byte gets a chance.
+ *
+ * @param response The response.
+ * @param index Where to start the scan.
+ * @param size The number of bytes held in response->data.
+ * @return LW_RESULT_SUCCESS if a packet was recovered, or LW_RESULT_AGAIN if more data is needed.
+ */
+static lw_result lw_resync_response(lw_response *response, uint32_t index, uint32_t size) {
+    // Report the error that caused the resync, not the ones found while scanning.
+    lw_packet_parse_error parse_error = response->parse_error;
+
+    while (1) {
+        const uint8_t *start = (const uint8_t *)memchr(response->data + index, LW_PACKET_START_BYTE, size - index);
+
+        response->parse_state = LW_PARSESTATE_START;
+        response->parse_error = LW_PARSE_ERROR_NONE;
+
+        if (start == NULL) {
+            response->data_size = 0;
+
+            if (index != size && parse_error == LW_PARSE_ERROR_NONE) {
+                parse_error = LW_PARSE_ERROR_SKIPPED_BYTES;
+            }
+
+            break;
+        }
+
+        uint32_t read_index = (uint32_t)(start - response->data);
+
+        if (read_index != index && parse_error == LW_PARSE_ERROR_NONE) {
+            parse_error = LW_PARSE_ERROR_SKIPPED_BYTES;
+        }
+
+        // NOTE: The packet is rebuilt at the front of the buffer, which never
+        // overtakes the bytes still to be read.
+        while (read_index < size) {
+            if (lw_parse_response_byte(response, response->data[read_index++]) == LW_RESULT_SUCCESS) {
+                response->resync_size = size - read_index;
+                memmove(response->data + response->data_size, response->data + read_index, response->resync_size);
+                response->parse_error = parse_error;
+                LW_DEBUG_LVL_2("Resync recovered packet %d\n", response->command_id);
+                return LW_RESULT_SUCCESS;
+            }
+
+            if (response->parse_error != LW_PARSE_ERROR_NONE) {
+                break;
+            }
+        }
+
+        if (response->parse_error == LW_PARSE_ERROR_NONE) {
+            // The candidate is still in progress and waits for more bytes.
+            break;
+        }
+
+        // Keep the bytes of the failed candidate and the unread bytes together.
+        memmove(response->data + response->data_size, response->data + read_index, size - read_index);
+        size = response->data_size + (size - read_index);
+        index = 1;
+    }
+
+    response->parse_error = parse_error;
+    return LW_RESULT_AGAIN;
+}
+
+/*
+ * Recover from a failed packet by rescanning its bytes, or discard them.
+ */
+static lw_result lw_recover_response(lw_response *response) {
+#if LW_PARSE_RESYNC
+    return lw_resync_response(response, 1, response->data_size);
+#else
+    (void)response;
+    return LW_RESULT_AGAIN;
+#endif
+}
+
+lw_result lw_feed_response(lw_response *response, uint8_t data) {
+    LW_DEBUG_LVL_3("Feed packet: 0x%02X\n", data);
+    
+    if (response->parse_state == LW_PARSESTATE_DONE) {
+        uint32_t resync_size = lw_restart_response(response);
+
+        if (resync_size != 0) {
+            response->data[resync_size] = data;
+            return lw_resync_response(response, 0, resync_size + 1);
+        }
+    }
+
+    response->parse_error = LW_PARSE_ERROR_NONE;
+
+    lw_result result = lw_parse_response_byte(response, data);
+
+    if (lw_response_failed(response)) {
+        return lw_recover_response(response);
+    }
+
+    return result;
+}
+
+lw_result lw_feed_response_buffer(lw_response *response, const uint8_t *data, uint32_t size, uint32_t *consumed) {
+    LW_DEBUG_LVL_3("Feed buffer: %d bytes\n", size);
+
+    if (response->parse_state == LW_PARSESTATE_DONE) {
+        uint32_t resync_size = lw_restart_response(response);
+
+        if (resync_size != 0) {
+            *consumed = 0;
+            return lw_resync_response(response, 0, resync_size);
+        }
+    }
+
+    response->parse_error = LW_PARSE_ERROR_NONE;
+
+    uint32_t index = 0;
+
+    while (index < size) {
+        if (response->parse_state == LW_PARSESTATE_START) {
+            // Skip straight to the next candidate start byte.
+            const uint8_t *start = (const uint8_t *)memchr(data + index, LW_PACKET_START_BYTE, size - index);
+            uint32_t start_index = (start == NULL) ? size : (uint32_t)(start - data);
+
+            if (start_index != index) {
+                response->parse_error = LW_PARSE_ERROR_SKIPPED_BYTES;
+                *consumed = start_index;
+                return LW_RESULT_AGAIN;
+            }
+
+            lw_parse_response_byte(response, data[index++]);
+        } else if (response->parse_state == LW_PARSESTATE_PAYLOAD && response->data_size > 3) {
+            // Copy as much of the remaining packet as the buffer holds in one go.
+            uint32_t count = response->payload_size + 5 - response->data_size;
+
+            if (count > size - index) {
+                count = size - index;
+            }
+
+            // The last two bytes are the CRC itself.
+            uint32_t crc_end = response->payload_size + 3;
+
+            if (response->data_size < crc_end) {
+                uint32_t crc_count = crc_end - response->data_size;
+
+                if (crc_count > count) {
+                    crc_count = count;
+                }
+
+                response->crc = lw_update_crc(response->crc, data + index, crc_count);
+            }
+
+            memcpy(response->data + response->data_size, data + index, count);
+            response->data_size += count;
+            index += count;
+
+            if (response->data_size == response->payload_size + 5) {
+                lw_result result = lw_complete_response(response);
+                *consumed = index;
+
+                if (lw_response_failed(response)) {
+                    return lw_recover_response(response);
+                }
+
+                return result;
+            }
+        } else {
+            // The flags and command ID go through the byte parser for the header checks.
+            lw_result result = lw_parse_response_byte(response, data[index++]);
+
+            if (lw_response_failed(response)) {
+                *consumed = index;
+                return lw_recover_response(response);
+            }
+
+            if (result == LW_RESULT_SUCCESS) {
+                *consumed = index;
+                return result;
+            }
+        }
+    }
+
+    *consumed = index;
+    return LW_RESULT_AGAIN;
+}
+
 uint32_t lw_create_packet(uint8_t *packet_buffer, uint8_t command_id, uint8_t write, uint8_t *data, uint32_t data_size) {
     uint32_t payload_length = 1 + data_size;
     uint16_t flags = (uint16_t)((payload_length << 6) | (write & 0x1));
@@ -222,6 +808,164 @@ void lw_parse_response_data(lw_response *response, uint8_t *data, uint32_t size,
     lw_parse_packet_data(response->data, data, size, offset);
 }
 
+// ----------------------------------------------------------------------------
+// Device statistics.
+// ----------------------------------------------------------------------------
+void lw_stats_histogram_add(lw_stats_histogram *histogram, uint32_t value_ms) {
+    uint32_t bucket = 0;
+
+    while (bucket < LW_STATS_HISTOGRAM_BUCKETS - 1 && value_ms >= (1u << bucket)) {
+        ++bucket;
+    }
+
+    histogram->buckets[bucket] += 1;
+
+    if (histogram->count == 0 || value_ms < histogram->min_ms) {
+        histogram->min_ms = value_ms;
+    }
+
+    if (value_ms > histogram->max_ms) {
+        histogram->max_ms = value_ms;
+    }
+
+    histogram->count += 1;
+    histogram->total_ms += value_ms;
+}
+
+lw_command_stats *lw_stats_get_command(lw_device_stats *stats, uint8_t command_id) {
+    for (uint32_t i = 0; i < stats->command_count; ++i) {
+        if (stats->commands[i].command_id == command_id) {
+            return &stats->commands[i];
+        }
+    }
+
+    return NULL;
+}
+
+static lw_command_stats *lw_stats_add_command(lw_device_stats *stats, uint8_t command_id) {
+    lw_command_stats *command_stats = lw_stats_get_command(stats, command_id);
+
+    if (command_stats == NULL && stats->command_count < LW_STATS_COMMAND_SLOTS) {
+        command_stats = &stats->commands[stats->command_count++];
+        command_stats->command_id = command_id;
+    }
+
+    return command_stats;
+}
+
+static void lw_stats_record_parse(lw_callback_device *device, lw_result result) {
+    lw_device_stats *stats = device->stats;
+
+    if (stats == NULL) {
+        return;
+    }
+
+    switch (device->response.parse_error) {
+        case LW_PARSE_ERROR_NONE: {
+            break;
+        }
+
+        case LW_PARSE_ERROR_SKIPPED_BYTES: {
+            stats->skipped_bytes += 1;
+            break;
+        }
+
+        case LW_PARSE_ERROR_PAYLOAD_SIZE: {
+            stats->payload_size_errors += 1;
+            break;
+        }
+
+        case LW_PARSE_ERROR_CRC: {
+            stats->crc_errors += 1;
+            break;
+        }
+
+        case LW_PARSE_ERROR_HEADER: {
+            stats->header_errors += 1;
+            break;
+        }
+    }
+
+#if LW_PARSE_RESYNC
+    if (lw_response_failed(&device->response)) {
+        stats->resyncs += 1;
+    }
+#endif
+
+    if (result != LW_RESULT_SUCCESS) {
+        return;
+    }
+
+    stats->packets += 1;
+
+    lw_command_stats *command_stats = lw_stats_add_command(stats, device->response.command_id);
+
+    if (command_stats != NULL) {
+        uint32_t current_time = device->get_time_ms(device);
+
+        if (command_stats->packets != 0) {
+            lw_stats_histogram_add(&command_stats->inter_arrival, current_time - command_stats->last_arrival_ms);
+        }
+
+        command_stats->packets += 1;
+        command_stats->last_arrival_ms = current_time;
+    }
+}
+
+static void lw_stats_record_latency(lw_callback_device *device, uint8_t command_id, uint32_t send_time_ms) {
+    if (device->stats == NULL) {
+        return;
+    }
+
+    lw_command_stats *command_stats = lw_stats_add_command(device->stats, command_id);
+
+    if (command_stats != NULL) {
+        lw_stats_histogram_add(&command_stats->latency, device->get_time_ms(device) - send_time_ms);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Round trip time estimation.
+// ----------------------------------------------------------------------------
+static uint8_t lw_rtt_is_adaptive(lw_callback_device *device, uint8_t command_id) {
+    return device->command_timeout == NULL || device->command_timeout(command_id) == 0;
+}
+
+static void lw_rtt_add_sample(lw_callback_device *device, uint32_t send_time_ms) {
+    lw_rtt_estimator *rtt = &device->rtt;
+    uint32_t sample_ms = device->get_time_ms(device) - send_time_ms;
+
+    if (rtt->samples == 0) {
+        rtt->srtt_x8 = sample_ms << 3;
+        rtt->rttvar_x4 = sample_ms << 1;
+    } else {
+        // NOTE: srtt += (sample - srtt) / 8, rttvar += (|sample - srtt| - rttvar) / 4.
+        int32_t delta = (int32_t)sample_ms - (int32_t)(rtt->srtt_x8 >> 3);
+        uint32_t deviation = (uint32_t)(delta < 0 ? -delta : delta);
+
+        rtt->srtt_x8 = (uint32_t)((int32_t)rtt->srtt_x8 + delta);
+        rtt->rttvar_x4 = rtt->rttvar_x4 - (rtt->rttvar_x4 >> 2) + deviation;
+    }
+
+    rtt->samples += 1;
+
+    // The deviation term is at least the 1 ms resolution of the clock.
+    uint32_t timeout_ms = (rtt->srtt_x8 >> 3) + (rtt->rttvar_x4 > 1 ? rtt->rttvar_x4 : 1);
+
+    if (timeout_ms < LW_RTO_MIN_MS) {
+        timeout_ms = LW_RTO_MIN_MS;
+    } else if (timeout_ms > LW_RTO_MAX_MS) {
+        timeout_ms = LW_RTO_MAX_MS;
+    }
+
+    rtt->timeout_ms = timeout_ms;
+}
+
+static void lw_rtt_backoff(lw_callback_device *device) {
+    uint32_t timeout_ms = device->rtt.timeout_ms * 2;
+    device->rtt.timeout_ms = (timeout_ms < LW_RTO_MAX_MS) ? timeout_ms : LW_RTO_MAX_MS;
+}
+
 // ----------------------------------------------------------------------------
 // Managed request/response commands.
 // ----------------------------------------------------------------------------
@@ -241,9 +985,221 @@ lw_callback_device lw_create_callback_device(void *user_data,
     lw_init_request(&device.request, 0, 0);
     lw_init_response(&device.response);
 
+    device.receive_buffer_size = 0;
+    device.receive_buffer_offset = 0;
+
+    device.packet_callback = NULL;
+    device.async_requests = NULL;
+    device.stream_queue = NULL;
+    device.stats = NULL;
+    lw_device_reset_rtt(&device);
+    device.command_timeout = NULL;
+    device.receive_tap = NULL;
+    device.receive_tap_user_data = NULL;
+    device.response_taps = NULL;
+    device.get_time_ns = NULL;
+    device.byte_time_ns = 0;
+    device.receive_time_ns = 0;
+
     return device;
 }
 
+void lw_device_enable_stats(lw_callback_device *device, lw_device_stats *stats) {
+    if (stats != NULL) {
+        memset(stats, 0, sizeof(*stats));
+    }
+
+    device->stats = stats;
+}
+
+void lw_device_set_command_timeout(lw_callback_device *device, lw_command_timeout command_timeout) {
+    device->command_timeout = command_timeout;
+}
+
+void lw_device_reset_rtt(lw_callback_device *device) {
+    device->rtt.srtt_x8 = 0;
+    device->rtt.rttvar_x4 = 0;
+    device->rtt.timeout_ms = LW_RESPONSE_TIMEOUT_MS;
+    device->rtt.samples = 0;
+}
+
+uint32_t lw_device_get_response_timeout(lw_callback_device *device, uint8_t command_id) {
+    if (device->command_timeout != NULL) {
+        uint32_t timeout_ms = device->command_timeout(command_id);
+
+        if (timeout_ms != 0) {
+            return timeout_ms;
+        }
+    }
+
+    return device->rtt.timeout_ms;
+}
+
+void lw_device_enable_timestamps(lw_callback_device *device, lw_device_callback_get_time_ns get_time_ns, uint32_t baud_rate) {
+    device->get_time_ns = get_time_ns;
+    device->receive_time_ns = 0;
+
+    // NOTE: 10 bits per byte with 8N1 framing.
+    device->byte_time_ns = (baud_rate != 0) ? (uint32_t)(10000000000ull / baud_rate) : 0;
+}
+
+void lw_device_enable_stream_queue(lw_callback_device *device, lw_stream_queue *queue) {
+    if (queue != NULL) {
+        queue->overruns = 0;
+        queue->head = 0;
+        queue->tail = 0;
+    }
+
+    device->stream_queue = queue;
+}
+
+void lw_device_set_receive_tap(lw_callback_device *device, lw_device_callback_receive_tap receive_tap, void *user_data) {
+    device->receive_tap = receive_tap;
+    device->receive_tap_user_data = user_data;
+}
+
+void lw_device_add_response_tap(lw_callback_device *device, lw_response_tap *tap, lw_response_tap_callback callback, void *user_data) {
+    lw_device_remove_response_tap(device, tap);
+
+    tap->callback = callback;
+    tap->user_data = user_data;
+    tap->next = NULL;
+
+    lw_response_tap **link = &device->response_taps;
+
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+
+    *link = tap;
+}
+
+void lw_device_remove_response_tap(lw_callback_device *device, lw_response_tap *tap) {
+    lw_response_tap **link = &device->response_taps;
+
+    while (*link != NULL) {
+        if (*link == tap) {
+            *link = tap->next;
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    tap->next = NULL;
+}
+
+// Hand over a completed packet nothing is waiting for.
+static void lw_device_route_packet(lw_callback_device *device, lw_response *response) {
+    if (device->packet_callback != NULL) {
+        device->packet_callback(device, response);
+        return;
+    }
+
+    lw_stream_queue *queue = device->stream_queue;
+
+    if (queue == NULL) {
+        return;
+    }
+
+    if (queue->head - queue->tail >= LW_STREAM_QUEUE_SIZE) {
+        queue->overruns += 1;
+        return;
+    }
+
+    // NOTE: Only the packet is copied, resync bytes stay with the parser.
+    lw_response *packet = &queue->packets[queue->head & (LW_STREAM_QUEUE_SIZE - 1)];
+    memcpy(packet->data, response->data, response->data_size);
+    packet->data_size = response->data_size;
+    packet->payload_size = response->payload_size;
+    packet->parse_state = LW_PARSESTATE_DONE;
+    packet->parse_error = LW_PARSE_ERROR_NONE;
+    packet->crc = response->crc;
+    packet->command_id = response->command_id;
+    packet->start_time_ns = response->start_time_ns;
+    packet->header_check = NULL;
+    packet->resync_size = 0;
+    queue->head += 1;
+}
+
+lw_result lw_device_parse_receive_buffer(lw_callback_device *device, uint8_t command_id) {
+    // NOTE: Bytes kept by a resync can complete packets without new bytes.
+    while (device->receive_buffer_offset < device->receive_buffer_size || device->response.resync_size != 0) {
+        if (device->response.parse_state == LW_PARSESTATE_DONE && device->response.resync_size == 0) {
+            lw_restart_response(&device->response);
+        }
+
+        // A packet starting in this receive has its start byte at the offset,
+        // as skipped bytes end the feed early. Packets recovered by a resync
+        // keep the start time of the packet they were found in.
+        if (device->get_time_ns != NULL && device->response.parse_state == LW_PARSESTATE_START) {
+            uint32_t bytes_after = device->receive_buffer_size - device->receive_buffer_offset - 1;
+            device->response.start_time_ns = device->receive_time_ns - (uint64_t)bytes_after * device->byte_time_ns;
+        }
+
+        uint32_t consumed = 0;
+        lw_result result = lw_feed_response_buffer(&device->response,
+                                                   device->receive_buffer + device->receive_buffer_offset,
+                                                   device->receive_buffer_size - device->receive_buffer_offset,
+                                                   &consumed);
+        device->receive_buffer_offset += consumed;
+        lw_stats_record_parse(device, result);
+
+        if (result == LW_RESULT_SUCCESS) {
+            lw_response_tap *tap = device->response_taps;
+
+            // NOTE: The next tap is taken first so a tap can remove itself.
+            while (tap != NULL) {
+                lw_response_tap *next = tap->next;
+                tap->callback(device, tap, &device->response);
+                tap = next;
+            }
+
+            if (command_id == LW_ANY_COMMAND || device->response.command_id == command_id) {
+                return LW_RESULT_SUCCESS;
+            }
+
+            lw_device_route_packet(device, &device->response);
+        }
+    }
+
+    return LW_RESULT_AGAIN;
+}
+
+// Account for bytes that were just placed in the receive buffer.
+static void lw_device_take_receive_buffer(lw_callback_device *device, uint32_t size) {
+    device->receive_buffer_size = size;
+    device->receive_buffer_offset = 0;
+
+    if (device->get_time_ns != NULL) {
+        device->receive_time_ns = device->get_time_ns(device);
+    }
+
+    if (device->stats != NULL) {
+        device->stats->bytes_received += size;
+    }
+
+    if (device->receive_tap != NULL) {
+        uint64_t time_ns = device->get_time_ns != NULL ? device->receive_time_ns : (uint64_t)device->get_time_ms(device) * 1000000;
+        device->receive_tap(device, device->receive_buffer, device->receive_buffer_size, time_ns);
+    }
+}
+
+lw_result lw_device_receive_bytes(lw_callback_device *device, const uint8_t *buffer, uint32_t size) {
+    if (size > LW_RECEIVE_BUFFER_SIZE) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    // NOTE: The new bytes replace the receive buffer, so the old ones must be parsed first.
+    if (device->receive_buffer_offset < device->receive_buffer_size || device->response.resync_size != 0) {
+        return LW_RESULT_AGAIN;
+    }
+
+    memcpy(device->receive_buffer, buffer, size);
+    lw_device_take_receive_buffer(device, size);
+    return LW_RESULT_SUCCESS;
+}
+
 lw_result lw_wait_for_next_response(lw_callback_device *device, uint8_t command_id, uint32_t timeout_ms) {
     uint32_t timeout_time = 0;
 
@@ -252,6 +1208,11 @@ lw_result lw_wait_for_next_response(lw_callback_device *device, uint8_t command_
     }
 
     while (1) {
+        // Parse bytes left over from previous receives before asking for more.
+        if (lw_device_parse_receive_buffer(device, command_id) == LW_RESULT_SUCCESS) {
+            return LW_RESULT_SUCCESS;
+        }
+
         uint32_t current_time = 0;
         uint32_t time_left_ms = 0;
 
@@ -263,17 +1224,12 @@ lw_result lw_wait_for_next_response(lw_callback_device *device, uint8_t command_
             }
         }
 
-        uint8_t byte = 0;
-        int32_t bytes_read = device->serial_receive(device, &byte, 1, time_left_ms);
+        int32_t bytes_read = device->serial_receive(device, device->receive_buffer, LW_RECEIVE_BUFFER_SIZE, time_left_ms);
 
         if (bytes_read == -1) {
             return LW_RESULT_ERROR;
         } else if (bytes_read > 0) {
-            if (lw_feed_response(&device->response, byte) == LW_RESULT_SUCCESS) {
-                if (command_id == LW_ANY_COMMAND || device->response.command_id == command_id) {
-                    return LW_RESULT_SUCCESS;
-                }
-            }
+            lw_device_take_receive_buffer(device, (uint32_t)bytes_read);
         } else if (timeout_ms == 0) {
             return LW_RESULT_AGAIN;
         } else if (time_left_ms == 0) {
@@ -282,20 +1238,50 @@ lw_result lw_wait_for_next_response(lw_callback_device *device, uint8_t command_
     }
 }
 
+lw_result lw_wait_for_stream_packet(lw_callback_device *device, uint8_t command_id, uint32_t timeout_ms, lw_response **response) {
+    lw_stream_queue *queue = device->stream_queue;
+
+    if (queue != NULL) {
+        while (queue->head != queue->tail) {
+            lw_response *packet = &queue->packets[queue->tail & (LW_STREAM_QUEUE_SIZE - 1)];
+            queue->tail += 1;
+
+            if (command_id == LW_ANY_COMMAND || packet->command_id == command_id) {
+                *response = packet;
+                return LW_RESULT_SUCCESS;
+            }
+        }
+    }
+
+    LW_CHECK_SUCCESS(lw_wait_for_next_response(device, command_id, timeout_ms))
+    *response = &device->response;
+    return LW_RESULT_SUCCESS;
+}
+
 lw_result lw_send_request_get_response(lw_callback_device *device) {
     LW_DEBUG_LVL_3("Running request\n");
 
+    uint8_t command_id = device->request.command_id;
+    uint8_t adaptive = lw_rtt_is_adaptive(device, command_id);
     int32_t attempts = LW_REQUEST_RETRIES;
 
     while (attempts--) {
         print_hex_debug("Send packet: ", device->request.data, device->request.data_size);
+        uint32_t send_time = device->get_time_ms(device);
+
         if (device->serial_send(device, device->request.data, device->request.data_size) == 0) {
             return LW_RESULT_ERROR;
         }
 
-        lw_result result = lw_wait_for_next_response(device, device->request.command_id, LW_RESPONSE_TIMEOUT_MS);
+        lw_result result = lw_wait_for_next_response(device, command_id, lw_device_get_response_timeout(device, command_id));
 
         if (result == LW_RESULT_SUCCESS) {
+            lw_stats_record_latency(device, command_id, send_time);
+
+            if (adaptive && attempts == LW_REQUEST_RETRIES - 1) {
+                lw_rtt_add_sample(device, send_time);
+            }
+
             return LW_RESULT_SUCCESS;
         }
 
@@ -303,8 +1289,422 @@ lw_result lw_send_request_get_response(lw_callback_device *device) {
             return LW_RESULT_ERROR;
         }
 
+        if (adaptive) {
+            lw_rtt_backoff(device);
+        }
+
+        if (device->stats != NULL) {
+            device->stats->timeouts += 1;
+            device->stats->retries += (attempts > 0) ? 1 : 0;
+        }
+
         LW_DEBUG_LVL_2("Timeout waiting for packet: %d attemps remaining\n", attempts);
     }
 
     return LW_RESULT_EXCEEDED_RETRIES;
 }
+
+// ----------------------------------------------------------------------------
+// Batched requests.
+// ----------------------------------------------------------------------------
+void lw_init_request_batch(lw_request_batch *batch) {
+    batch->data_size = 0;
+    batch->count = 0;
+    batch->completed_mask = 0;
+}
+
+lw_result lw_request_batch_add(lw_request_batch *batch, const lw_request *request) {
+    for (uint32_t i = 0; i < batch->count; ++i) {
+        if (batch->command_ids[i] == request->command_id) {
+            return LW_RESULT_INVALID_PARAMETER;
+        }
+    }
+
+    if (batch->count >= LW_BATCH_MAX_REQUESTS || batch->data_size + request->data_size > LW_BATCH_SEND_SIZE) {
+        return LW_RESULT_AGAIN;
+    }
+
+    memcpy(batch->data + batch->data_size, request->data, request->data_size);
+    batch->offsets[batch->count] = (uint16_t)batch->data_size;
+    batch->command_ids[batch->count] = request->command_id;
+    batch->data_size += request->data_size;
+    batch->count += 1;
+
+    return LW_RESULT_SUCCESS;
+}
+
+static lw_result lw_send_batch_requests(lw_callback_device *device, lw_request_batch *batch) {
+    // The first attempt sends the whole batch at once, retries only send the
+    // requests that are still unanswered.
+    if (batch->completed_mask == 0) {
+        print_hex_debug("Send batch: ", batch->data, batch->data_size);
+        return device->serial_send(device, batch->data, batch->data_size) == 0 ? LW_RESULT_ERROR : LW_RESULT_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < batch->count; ++i) {
+        if (batch->completed_mask & (1u << i)) {
+            continue;
+        }
+
+        uint32_t end = (i + 1 < batch->count) ? batch->offsets[i + 1] : batch->data_size;
+        uint32_t size = end - batch->offsets[i];
+
+        print_hex_debug("Send packet: ", batch->data + batch->offsets[i], size);
+        if (device->serial_send(device, batch->data + batch->offsets[i], size) == 0) {
+            return LW_RESULT_ERROR;
+        }
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+// Hand the device response to the batch callback if it answers an unanswered
+// request, otherwise route it.
+// Returns 1 if the response completed a batch entry, 0 if it was routed.
+static uint8_t lw_batch_take_response(lw_callback_device *device, lw_request_batch *batch, uint32_t send_time, lw_batch_response_callback callback, void *user_data) {
+    uint32_t i = 0;
+
+    while (i < batch->count && batch->command_ids[i] != device->response.command_id) {
+        ++i;
+    }
+
+    if (i < batch->count && (batch->completed_mask & (1u << i)) == 0) {
+        batch->completed_mask |= (1u << i);
+        lw_stats_record_latency(device, device->response.command_id, send_time);
+        callback(device, &device->response, user_data);
+        return 1;
+    }
+
+    lw_device_route_packet(device, &device->response);
+    return 0;
+}
+
+lw_result lw_send_batch_get_responses(lw_callback_device *device, lw_request_batch *batch, lw_batch_response_callback callback, void *user_data) {
+    LW_DEBUG_LVL_3("Running batch\n");
+
+    if (batch->count == 0) {
+        return LW_RESULT_SUCCESS;
+    }
+
+    uint32_t all_mask = (batch->count == 32) ? 0xFFFFFFFF : ((1u << batch->count) - 1);
+    int32_t attempts = LW_REQUEST_RETRIES;
+
+    batch->completed_mask = 0;
+
+    while (attempts--) {
+        uint32_t send_time = device->get_time_ms(device);
+        LW_CHECK_SUCCESS(lw_send_batch_requests(device, batch))
+
+        // The batch waits as long as its slowest command.
+        uint32_t timeout_ms = 0;
+        uint8_t adaptive = 0;
+
+        for (uint32_t i = 0; i < batch->count; ++i) {
+            uint32_t command_timeout_ms = lw_device_get_response_timeout(device, batch->command_ids[i]);
+            timeout_ms = (command_timeout_ms > timeout_ms) ? command_timeout_ms : timeout_ms;
+            adaptive |= lw_rtt_is_adaptive(device, batch->command_ids[i]);
+        }
+
+        uint32_t wait_start = device->get_time_ms(device);
+
+        while (batch->completed_mask != all_mask) {
+            // NOTE: The timeout restarts with every response to the batch so
+            // long batches are not cut short while the responses are still
+            // arriving. Other packets, such as a stream, do not extend it.
+            int32_t remaining_ms = (int32_t)(wait_start + timeout_ms - device->get_time_ms(device));
+
+            if (remaining_ms <= 0) {
+                break;
+            }
+
+            lw_result result = lw_wait_for_next_response(device, LW_ANY_COMMAND, (uint32_t)remaining_ms);
+
+            if (result == LW_RESULT_ERROR) {
+                return LW_RESULT_ERROR;
+            }
+
+            if (result != LW_RESULT_SUCCESS) {
+                break;
+            }
+
+            if (lw_batch_take_response(device, batch, send_time, callback, user_data)) {
+                wait_start = device->get_time_ms(device);
+            }
+        }
+
+        if (batch->completed_mask == all_mask) {
+            return LW_RESULT_SUCCESS;
+        }
+
+        // NOTE: Batch responses queue behind each other, so they back off
+        // the timeout but are never timed.
+        if (adaptive) {
+            lw_rtt_backoff(device);
+        }
+
+        if (device->stats != NULL) {
+            device->stats->timeouts += 1;
+            device->stats->retries += (attempts > 0) ? 1 : 0;
+        }
+
+        LW_DEBUG_LVL_2("Timeout waiting for batch: %d attemps remaining\n", attempts);
+    }
+
+    return LW_RESULT_EXCEEDED_RETRIES;
+}
+
+lw_result lw_send_batch_once(lw_callback_device *device, lw_request_batch *batch, lw_batch_response_callback callback, void *user_data, uint32_t timeout_ms, uint32_t *packets) {
+    uint32_t all_mask = (batch->count == 32) ? 0xFFFFFFFF : ((1u << batch->count) - 1);
+    uint32_t send_time = device->get_time_ms(device);
+    uint32_t end_time = send_time + timeout_ms;
+
+    *packets = 0;
+    batch->completed_mask = 0;
+    LW_CHECK_SUCCESS(lw_send_batch_requests(device, batch))
+
+    while (batch->completed_mask != all_mask) {
+        // NOTE: Unlike a managed batch the timeout covers the whole batch, so
+        // a busy stream cannot keep extending it.
+        int32_t remaining_ms = (int32_t)(end_time - device->get_time_ms(device));
+
+        if (remaining_ms <= 0) {
+            return LW_RESULT_TIMEOUT;
+        }
+
+        lw_result result = lw_wait_for_next_response(device, LW_ANY_COMMAND, (uint32_t)remaining_ms);
+
+        if (result != LW_RESULT_SUCCESS) {
+            return result;
+        }
+
+        *packets += 1;
+        lw_batch_take_response(device, batch, send_time, callback, user_data);
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Asynchronous request pipeline.
+// ----------------------------------------------------------------------------
+static void lw_async_remove_request(lw_callback_device *device, lw_async_request *async_request) {
+    lw_async_request **link = &device->async_requests;
+
+    while (*link != NULL) {
+        if (*link == async_request) {
+            *link = async_request->next;
+            break;
+        }
+
+        link = &(*link)->next;
+    }
+
+    async_request->next = NULL;
+    async_request->state = LW_ASYNC_REQUEST_IDLE;
+}
+
+static void lw_async_complete_request(lw_callback_device *device, lw_async_request *async_request, lw_result result, lw_response *response) {
+    lw_async_remove_request(device, async_request);
+
+    if (async_request->callback != NULL) {
+        async_request->callback(device, async_request, result, response);
+    }
+}
+
+static void lw_async_fail_requests(lw_callback_device *device) {
+    // NOTE: The queue is detached first so requests resubmitted from the
+    // callbacks are not failed again.
+    lw_async_request *async_request = device->async_requests;
+    device->async_requests = NULL;
+
+    while (async_request != NULL) {
+        lw_async_request *next = async_request->next;
+        async_request->next = NULL;
+        async_request->state = LW_ASYNC_REQUEST_IDLE;
+
+        if (async_request->callback != NULL) {
+            async_request->callback(device, async_request, LW_RESULT_ERROR, NULL);
+        }
+
+        async_request = next;
+    }
+}
+
+static uint8_t lw_async_command_sent(lw_callback_device *device, uint8_t command_id) {
+    for (lw_async_request *async_request = device->async_requests; async_request != NULL; async_request = async_request->next) {
+        if (async_request->state == LW_ASYNC_REQUEST_SENT && async_request->request.command_id == command_id) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static lw_result lw_async_send_request(lw_callback_device *device, lw_async_request *async_request, uint32_t current_time) {
+    print_hex_debug("Send packet: ", async_request->request.data, async_request->request.data_size);
+
+    if (device->serial_send(device, async_request->request.data, async_request->request.data_size) == 0) {
+        return LW_RESULT_ERROR;
+    }
+
+    async_request->state = LW_ASYNC_REQUEST_SENT;
+    async_request->send_time_ms = current_time;
+    async_request->timeout_ms = lw_device_get_response_timeout(device, async_request->request.command_id);
+    async_request->attempts += 1;
+
+    return LW_RESULT_SUCCESS;
+}
+
+static lw_result lw_async_service_requests(lw_callback_device *device) {
+    uint32_t current_time = device->get_time_ms(device);
+    lw_async_request *async_request = device->async_requests;
+
+    while (async_request != NULL) {
+        lw_async_request *next = async_request->next;
+
+        if (async_request->state == LW_ASYNC_REQUEST_SENT) {
+            if ((int32_t)(current_time - async_request->send_time_ms) >= (int32_t)async_request->timeout_ms) {
+                if (lw_rtt_is_adaptive(device, async_request->request.command_id)) {
+                    lw_rtt_backoff(device);
+                }
+
+                if (device->stats != NULL) {
+                    device->stats->timeouts += 1;
+                    device->stats->retries += (async_request->attempts < LW_REQUEST_RETRIES) ? 1 : 0;
+                }
+
+                if (async_request->attempts >= LW_REQUEST_RETRIES) {
+                    lw_async_complete_request(device, async_request, LW_RESULT_EXCEEDED_RETRIES, NULL);
+
+                    // NOTE: The callback may have changed the queue, so start over.
+                    async_request = device->async_requests;
+                    continue;
+                }
+
+                LW_DEBUG_LVL_2("Timeout waiting for packet: %d attemps remaining\n", LW_REQUEST_RETRIES - async_request->attempts);
+                LW_CHECK_SUCCESS(lw_async_send_request(device, async_request, current_time))
+            }
+        } else if (!lw_async_command_sent(device, async_request->request.command_id)) {
+            LW_CHECK_SUCCESS(lw_async_send_request(device, async_request, current_time))
+        }
+
+        async_request = next;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+static uint32_t lw_async_limit_wait(lw_callback_device *device, uint32_t timeout_ms) {
+    if (timeout_ms == 0) {
+        return 0;
+    }
+
+    uint32_t current_time = device->get_time_ms(device);
+
+    for (lw_async_request *async_request = device->async_requests; async_request != NULL; async_request = async_request->next) {
+        if (async_request->state != LW_ASYNC_REQUEST_SENT) {
+            continue;
+        }
+
+        int32_t time_left_ms = (int32_t)(async_request->send_time_ms + async_request->timeout_ms - current_time);
+
+        if (time_left_ms <= 0) {
+            // NOTE: A wait of 0 is non-blocking, so wait the shortest time instead.
+            return 1;
+        }
+
+        if ((uint32_t)time_left_ms < timeout_ms) {
+            timeout_ms = (uint32_t)time_left_ms;
+        }
+    }
+
+    return timeout_ms;
+}
+
+static void lw_async_dispatch(lw_callback_device *device, lw_response *response) {
+    for (lw_async_request *async_request = device->async_requests; async_request != NULL; async_request = async_request->next) {
+        if (async_request->state == LW_ASYNC_REQUEST_SENT && async_request->request.command_id == response->command_id) {
+            lw_stats_record_latency(device, response->command_id, async_request->send_time_ms);
+
+            if (async_request->attempts == 1 && lw_rtt_is_adaptive(device, response->command_id)) {
+                lw_rtt_add_sample(device, async_request->send_time_ms);
+            }
+
+            lw_async_complete_request(device, async_request, LW_RESULT_SUCCESS, response);
+            return;
+        }
+    }
+
+    lw_device_route_packet(device, response);
+}
+
+void lw_init_async_request(lw_async_request *async_request, lw_async_request_callback callback, void *user_data) {
+    lw_init_request(&async_request->request, 0, 0);
+    async_request->callback = callback;
+    async_request->user_data = user_data;
+    async_request->state = LW_ASYNC_REQUEST_IDLE;
+    async_request->send_time_ms = 0;
+    async_request->timeout_ms = 0;
+    async_request->attempts = 0;
+    async_request->next = NULL;
+}
+
+lw_result lw_device_submit_request(lw_callback_device *device, lw_async_request *async_request) {
+    if (async_request->state != LW_ASYNC_REQUEST_IDLE) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    async_request->state = LW_ASYNC_REQUEST_QUEUED;
+    async_request->attempts = 0;
+    async_request->next = NULL;
+
+    lw_async_request **link = &device->async_requests;
+
+    while (*link != NULL) {
+        link = &(*link)->next;
+    }
+
+    *link = async_request;
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_device_cancel_request(lw_callback_device *device, lw_async_request *async_request) {
+    lw_async_remove_request(device, async_request);
+}
+
+lw_result lw_device_poll(lw_callback_device *device, uint32_t timeout_ms) {
+    if (lw_async_service_requests(device) != LW_RESULT_SUCCESS) {
+        lw_async_fail_requests(device);
+        return LW_RESULT_ERROR;
+    }
+
+    uint32_t wait_time_ms = lw_async_limit_wait(device, timeout_ms);
+
+    while (1) {
+        lw_result result = lw_wait_for_next_response(device, LW_ANY_COMMAND, wait_time_ms);
+
+        if (result == LW_RESULT_ERROR) {
+            lw_async_fail_requests(device);
+            return LW_RESULT_ERROR;
+        }
+
+        if (result != LW_RESULT_SUCCESS) {
+            break;
+        }
+
+        lw_async_dispatch(device, &device->response);
+
+        // Only drain what is already buffered after the first packet.
+        wait_time_ms = 0;
+    }
+
+    // Send requests that were queued behind completed ones, and retry the
+    // requests that timed out during the wait.
+    if (lw_async_service_requests(device) != LW_RESULT_SUCCESS) {
+        lw_async_fail_requests(device);
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
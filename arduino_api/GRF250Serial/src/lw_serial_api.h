@@ -132,11 +132,55 @@ lw_firmware_version lw_expand_firmware_version(uint32_t version);
 #define LW_PACKET_START_BYTE 0xAA
 #define LW_PACKET_SEND_SIZE 160
 
-#ifdef LW_LARGE_PACKETS
+// The largest packet a response can hold, which bounds the payload size the
+// parser accepts. Arduino builds default to the largest GRF250 response
+// (multi data), checked against LW_GRF250_RESPONSE_PACKET_SIZE, to save RAM
+// for each device.
+#ifndef LW_PACKET_RECV_SIZE
+#if defined(LW_LARGE_PACKETS)
 #define LW_PACKET_RECV_SIZE 1024
+#elif defined(ARDUINO)
+#define LW_PACKET_RECV_SIZE 50
 #else
 #define LW_PACKET_RECV_SIZE 64
 #endif
+#endif
+
+// When a packet fails its CRC or header checks the parser rescans the bytes
+// it has already buffered for the next start byte, so a packet that began
+// inside the failed one is still recovered. Define LW_PARSE_RESYNC as 0 to
+// discard the failed bytes instead.
+#ifndef LW_PARSE_RESYNC
+#define LW_PARSE_RESYNC 1
+#endif
+
+// ----------------------------------------------------------------------------
+// CRC implementation.
+//
+// The packet CRC is CRC-16/XMODEM. LW_CRC_MODE selects how it is computed:
+//
+// LW_CRC_MODE_BITWISE: Shift and xor per byte, no lookup tables.
+// LW_CRC_MODE_TABLE: One byte per step using a 512 byte lookup table.
+// LW_CRC_MODE_SLICE_BY_4: Four bytes per step using 2 KB of lookup tables.
+// LW_CRC_MODE_SLICE_BY_8: Eight bytes per step using 4 KB of lookup tables.
+//
+// All modes produce identical output. You can define LW_CRC_MODE as a
+// compiler flag, eg: -DLW_CRC_MODE=0, or just set it here.
+// ----------------------------------------------------------------------------
+#define LW_CRC_MODE_BITWISE 0
+#define LW_CRC_MODE_TABLE 1
+#define LW_CRC_MODE_SLICE_BY_4 2
+#define LW_CRC_MODE_SLICE_BY_8 3
+
+#ifndef LW_CRC_MODE
+#if defined(__AVR__)
+#define LW_CRC_MODE LW_CRC_MODE_BITWISE
+#elif defined(ARDUINO)
+#define LW_CRC_MODE LW_CRC_MODE_TABLE
+#else
+#define LW_CRC_MODE LW_CRC_MODE_SLICE_BY_8
+#endif
+#endif
 
 typedef enum {
     LW_PARSESTATE_START,
@@ -146,6 +190,26 @@ typedef enum {
     LW_PARSESTATE_DONE,
 } lw_packet_parse_state;
 
+// The reason bytes were last discarded by the response parser. Errors after
+// LW_PARSE_ERROR_SKIPPED_BYTES mean a started packet failed.
+typedef enum {
+    LW_PARSE_ERROR_NONE,
+    LW_PARSE_ERROR_SKIPPED_BYTES,
+    LW_PARSE_ERROR_PAYLOAD_SIZE,
+    LW_PARSE_ERROR_CRC,
+    LW_PARSE_ERROR_HEADER,
+} lw_packet_parse_error;
+
+/*
+ * Called when the command ID of a response arrives, to reject implausible
+ * headers before the rest of the packet is buffered.
+ *
+ * @param command_id The command ID of the response.
+ * @param payload_size The payload size from the header, including the command ID.
+ * @return LW_RESULT_SUCCESS if the header is plausible, otherwise LW_RESULT_ERROR.
+ */
+typedef lw_result (*lw_response_header_check)(uint8_t command_id, uint32_t payload_size);
+
 typedef struct {
     uint8_t data[LW_PACKET_SEND_SIZE];
     uint32_t data_size;
@@ -158,16 +222,45 @@ typedef struct {
     uint32_t data_size;
     uint32_t payload_size;
     lw_packet_parse_state parse_state;
+    lw_packet_parse_error parse_error;
+    uint16_t crc;
     uint8_t command_id;
+
+    // The monotonic time in nanoseconds the start byte arrived, set by the
+    // managed layer when the device has timestamps enabled, otherwise 0.
+    uint64_t start_time_ns;
+
+    // Optional, kept when the parser moves on to the next packet.
+    lw_response_header_check header_check;
+
+    // NOTE: Used internally. Bytes recovered by a resync that follow the
+    // completed packet in data, parsed before any newly fed bytes.
+    uint32_t resync_size;
 } lw_response;
 
 /*
- * Initialize a response.
+ * Initialize a response, without a header check.
  *
  * @param response The response to initialize.
  */
 void lw_init_response(lw_response *response);
 
+/*
+ * Discard a partially parsed packet and any bytes buffered for a resync,
+ * keeping the header check.
+ *
+ * @param response The response to reset.
+ */
+void lw_reset_response(lw_response *response);
+
+/*
+ * Set the header check used while parsing a response.
+ *
+ * @param response The response.
+ * @param header_check The header check, or NULL to accept any header with a valid payload size.
+ */
+void lw_response_set_header_check(lw_response *response, lw_response_header_check header_check);
+
 /*
  * Create a CRC for a data buffer.
  *
@@ -177,6 +270,17 @@ void lw_init_response(lw_response *response);
  */
 uint16_t lw_create_crc(uint8_t *data, uint16_t size);
 
+/*
+ * Continue a CRC over more data. Feeding a buffer in several parts gives the
+ * same result as a single call to lw_create_crc over the whole buffer.
+ *
+ * @param crc The CRC of the data so far, 0 for the first part.
+ * @param data The data buffer.
+ * @param size The size of the data buffer.
+ * @return The updated CRC.
+ */
+uint16_t lw_update_crc(uint16_t crc, const uint8_t *data, uint32_t size);
+
 /*
  * Create a binary protocol packet.
  *
@@ -192,12 +296,33 @@ uint32_t lw_create_packet(uint8_t *packet_buffer, uint8_t command_id, uint8_t wr
 /*
  * Feed a response byte by byte until a full response packet is completed.
  *
+ * After a resync the byte may complete a packet that was already buffered,
+ * in which case the byte itself is kept for the next packet.
+ *
  * @param response The response to feed.
  * @param data The data byte.
  * @return LW_RESULT_SUCCESS if the response is complete, or LW_RESULT_AGAIN if more data is needed.
  */
 lw_result lw_feed_response(lw_response *response, uint8_t data);
 
+/*
+ * Feed a response from a buffer of received bytes until a full response packet
+ * is completed or the buffer is exhausted. Bytes following a completed packet
+ * are not consumed, so they can be fed into the next response.
+ *
+ * Feeding also stops early when bytes are discarded, with the reason set in
+ * response->parse_error, so keep feeding until all bytes are consumed. After
+ * a resync a packet can complete without consuming any bytes, and while
+ * response->resync_size is not 0 feeding an empty buffer can complete more.
+ *
+ * @param response The response to feed.
+ * @param data The buffer of received bytes.
+ * @param size The number of bytes in the buffer.
+ * @param consumed The number of bytes consumed from the buffer is written here.
+ * @return LW_RESULT_SUCCESS if the response is complete, or LW_RESULT_AGAIN if more data is needed.
+ */
+lw_result lw_feed_response_buffer(lw_response *response, const uint8_t *data, uint32_t size, uint32_t *consumed);
+
 /*
  * Extracts data from the packet buffer after the header.
  *
@@ -374,6 +499,85 @@ void lw_parse_response_string(lw_response *response, char *data, uint32_t offset
  */
 void lw_parse_response_data(lw_response *response, uint8_t *data, uint32_t size, uint32_t offset);
 
+// ----------------------------------------------------------------------------
+// Device statistics.
+//
+// An optional block of link statistics kept by the managed layer. Stats are
+// disabled unless a block is attached with lw_device_enable_stats, and cost a
+// NULL check per packet when disabled. No debug output is involved, so
+// enabling them does not change timing.
+//
+// Latency and packet inter-arrival times are tracked per command ID in
+// LW_STATS_COMMAND_SLOTS slots, which are taken in the order command IDs are
+// first seen. Inter-arrival times are most useful for streamed commands.
+// ----------------------------------------------------------------------------
+#ifndef LW_STATS_COMMAND_SLOTS
+#ifdef ARDUINO
+#define LW_STATS_COMMAND_SLOTS 4
+#else
+#define LW_STATS_COMMAND_SLOTS 16
+#endif
+#endif
+
+// Bucket i counts values below 2^i milliseconds, the last bucket counts all
+// larger values.
+#define LW_STATS_HISTOGRAM_BUCKETS 12
+
+typedef struct {
+    uint32_t buckets[LW_STATS_HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint32_t min_ms;
+    uint32_t max_ms;
+    uint32_t total_ms;
+} lw_stats_histogram;
+
+typedef struct {
+    uint8_t command_id;
+    uint32_t packets;
+    uint32_t last_arrival_ms;
+    lw_stats_histogram latency;
+    lw_stats_histogram inter_arrival;
+} lw_command_stats;
+
+typedef struct {
+    uint32_t bytes_received;
+    uint32_t packets;
+    uint32_t crc_errors;
+    uint32_t payload_size_errors;
+    uint32_t header_errors;
+
+    // Times bytes outside of any packet were skipped, such as line noise.
+    uint32_t skipped_bytes;
+
+    // Times the bytes of a failed packet were rescanned for the next start
+    // byte, see LW_PARSE_RESYNC. The failure is also counted by its error.
+    uint32_t resyncs;
+
+    uint32_t retries;
+    uint32_t timeouts;
+
+    uint32_t command_count;
+    lw_command_stats commands[LW_STATS_COMMAND_SLOTS];
+} lw_device_stats;
+
+/*
+ * Add a value to a histogram.
+ *
+ * @param histogram The histogram.
+ * @param value_ms The value in milliseconds.
+ */
+void lw_stats_histogram_add(lw_stats_histogram *histogram, uint32_t value_ms);
+
+/*
+ * Get the stats for a command ID.
+ *
+ * @param stats The stats block.
+ * @param command_id The command ID.
+ * @return The command stats, or NULL if the command ID has not been seen or
+ *         all slots were taken.
+ */
+lw_command_stats *lw_stats_get_command(lw_device_stats *stats, uint8_t command_id);
+
 // ----------------------------------------------------------------------------
 // Managed request/response commands.
 //
@@ -388,7 +592,88 @@ void lw_parse_response_data(lw_response *response, uint8_t *data, uint32_t size,
 
 #define LW_ANY_COMMAND 255
 
+// Response timeouts adapt to the measured round trip time in the same way as
+// TCP (RFC 6298). The timeout is the smoothed round trip time plus four times
+// its mean deviation, limited to LW_RTO_MIN_MS and LW_RTO_MAX_MS. Until the
+// first response has been timed, LW_RESPONSE_TIMEOUT_MS is used.
+//
+// Every timeout doubles the timeout, and it stays doubled until a response
+// is timed again. Only requests that were answered on their first attempt
+// are timed, because a response to a resent request could answer either
+// attempt. By default the limit is LW_RESPONSE_TIMEOUT_MS, so a request never
+// waits longer than it did with a fixed timeout.
+#ifndef LW_RTO_MIN_MS
+#define LW_RTO_MIN_MS 10
+#endif
+
+#ifndef LW_RTO_MAX_MS
+#define LW_RTO_MAX_MS LW_RESPONSE_TIMEOUT_MS
+#endif
+
+#if LW_RTO_MIN_MS > LW_RTO_MAX_MS
+#error "LW_RTO_MIN_MS can be at most LW_RTO_MAX_MS"
+#endif
+
+typedef struct {
+    // NOTE: Scaled by 8 and 4 to keep the fractions of the averages.
+    uint32_t srtt_x8;
+    uint32_t rttvar_x4;
+
+    uint32_t timeout_ms;
+    uint32_t samples;
+} lw_rtt_estimator;
+
+/*
+ * Command timeout callback. Gives slow commands, eg: a save to flash, a fixed
+ * timeout in place of the adaptive one. Fixed timeouts are not backed off and
+ * their responses are not timed.
+ *
+ * @param command_id The command ID of the request.
+ * @return The timeout in milliseconds, or 0 to use the adaptive timeout.
+ */
+typedef uint32_t (*lw_command_timeout)(uint8_t command_id);
+
+// The number of bytes the managed layer requests from the platform per
+// receive callback. Bytes that are not part of the current response are kept
+// for the next one.
+#ifndef LW_RECEIVE_BUFFER_SIZE
+#ifdef ARDUINO
+#define LW_RECEIVE_BUFFER_SIZE 32
+#else
+#define LW_RECEIVE_BUFFER_SIZE 256
+#endif
+#endif
+
+// The number of streamed packets a stream queue holds, must be a power of 2.
+#ifndef LW_STREAM_QUEUE_SIZE
+#ifdef ARDUINO
+#define LW_STREAM_QUEUE_SIZE 2
+#else
+#define LW_STREAM_QUEUE_SIZE 64
+#endif
+#endif
+
+#if (LW_STREAM_QUEUE_SIZE & (LW_STREAM_QUEUE_SIZE - 1)) != 0
+#error "LW_STREAM_QUEUE_SIZE must be a power of 2"
+#endif
+
 typedef struct lw_callback_device_s lw_callback_device;
+typedef struct lw_async_request_s lw_async_request;
+typedef struct lw_response_tap_s lw_response_tap;
+
+/*
+ * Holds packets that complete while the managed layer waits for a different
+ * command, such as distance data streamed while a request waits for its
+ * response. When full, new packets are dropped and counted as overruns.
+ */
+typedef struct {
+    uint32_t overruns;
+
+    // NOTE: Free running indices, the queue holds (head - tail) packets.
+    uint32_t head;
+    uint32_t tail;
+    lw_response packets[LW_STREAM_QUEUE_SIZE];
+} lw_stream_queue;
 
 /*
  * Sleep callback. This callback is called when the API wants to sleep for a
@@ -413,6 +698,16 @@ typedef void (*lw_device_callback_sleep)(lw_callback_device *device, uint32_t ti
  */
 typedef uint32_t (*lw_device_callback_get_time_ms)(lw_callback_device *device);
 
+/*
+ * Get precise time callback. This optional callback returns a monotonic time
+ * in nanoseconds, and is used to timestamp received packets. Unlike
+ * get_time_ms it must not wrap.
+ *
+ * @param device The callback device.
+ * @return The current time in nanoseconds.
+ */
+typedef uint64_t (*lw_device_callback_get_time_ns)(lw_callback_device *device);
+
 /*
  * Serial send callback. This callback is called when the API wants to send
  * data to the device. The callback should block until ALL the data has
@@ -445,6 +740,50 @@ typedef uint32_t (*lw_device_callback_serial_send)(lw_callback_device *device, u
  */
 typedef int32_t (*lw_device_callback_serial_receive)(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms);
 
+/*
+ * Packet callback. This optional callback is called for every completed
+ * packet that the managed layer is not waiting for, such as streamed distance
+ * data. This includes packets that arrive while lw_send_request_get_response
+ * waits, so the callback must not send requests on the same device. It takes
+ * precedence over a stream queue.
+ *
+ * @param device The callback device.
+ * @param response The completed response, only valid during the callback.
+ */
+typedef void (*lw_device_callback_packet)(lw_callback_device *device, lw_response *response);
+
+/*
+ * Receive tap callback. This optional callback sees every block of bytes
+ * returned by the serial receive callback before it is parsed, such as for
+ * recording the raw stream.
+ *
+ * @param device The callback device.
+ * @param buffer The received bytes, only valid during the callback.
+ * @param size The number of received bytes.
+ * @param time_ns The receive time in nanoseconds, from get_time_ns when
+ *        timestamps are enabled or get_time_ms otherwise.
+ */
+typedef void (*lw_device_callback_receive_tap)(lw_callback_device *device, const uint8_t *buffer, uint32_t size, uint64_t time_ns);
+
+/*
+ * Response tap callback. A response tap sees every completed packet,
+ * including responses to requests, before it is handed to whatever waits for
+ * it. Like the packet callback it must not send requests on the same device.
+ *
+ * @param device The callback device.
+ * @param tap The tap, it can be removed from the callback.
+ * @param response The completed packet, only valid during the callback.
+ */
+typedef void (*lw_response_tap_callback)(lw_callback_device *device, lw_response_tap *tap, lw_response *response);
+
+// Response taps are owned by the caller and linked into a list on the device,
+// so any number of them can watch the same device.
+struct lw_response_tap_s {
+    lw_response_tap_callback callback;
+    void *user_data;
+    lw_response_tap *next;
+};
+
 struct lw_callback_device_s {
     void *user_data;
 
@@ -455,6 +794,29 @@ struct lw_callback_device_s {
 
     lw_request request;
     lw_response response;
+
+    uint8_t receive_buffer[LW_RECEIVE_BUFFER_SIZE];
+    uint32_t receive_buffer_size;
+    uint32_t receive_buffer_offset;
+
+    lw_device_callback_packet packet_callback;
+    lw_async_request *async_requests;
+    lw_stream_queue *stream_queue;
+
+    lw_device_stats *stats;
+
+    lw_rtt_estimator rtt;
+    lw_command_timeout command_timeout;
+
+    lw_device_callback_receive_tap receive_tap;
+    void *receive_tap_user_data;
+
+    lw_response_tap *response_taps;
+
+    // NOTE: Used internally to timestamp received packets.
+    lw_device_callback_get_time_ns get_time_ns;
+    uint32_t byte_time_ns;
+    uint64_t receive_time_ns;
 };
 
 /*
@@ -473,6 +835,120 @@ lw_callback_device lw_create_callback_device(void *user_data,
                                              lw_device_callback_serial_send serial_send,
                                              lw_device_callback_serial_receive serial_receive);
 
+/*
+ * Attach a stats block to a device. The block is cleared.
+ *
+ * @param device The callback device.
+ * @param stats The stats block, or NULL to disable stats.
+ */
+void lw_device_enable_stats(lw_callback_device *device, lw_device_stats *stats);
+
+/*
+ * Set the command timeout callback of a device, eg: lw_grf250_get_command_timeout.
+ *
+ * @param device The callback device.
+ * @param command_timeout The command timeout callback, or NULL to use the
+ *        adaptive timeout for every command.
+ */
+void lw_device_set_command_timeout(lw_callback_device *device, lw_command_timeout command_timeout);
+
+/*
+ * Forget the measured round trip time and go back to LW_RESPONSE_TIMEOUT_MS
+ * until the next response is timed, eg: after the baud rate changes.
+ *
+ * @param device The callback device.
+ */
+void lw_device_reset_rtt(lw_callback_device *device);
+
+/*
+ * Get the time the managed layer waits for the response to a request.
+ *
+ * @param device The callback device.
+ * @param command_id The command ID of the request.
+ * @return The timeout in milliseconds.
+ */
+uint32_t lw_device_get_response_timeout(lw_callback_device *device, uint8_t command_id);
+
+/*
+ * Enable packet timestamps on a device. The time is taken when the receive
+ * callback returns, and moved back by the transmission time of the bytes that
+ * followed the start byte in the same receive. Every completed response then
+ * has start_time_ns set.
+ *
+ * @param device The callback device.
+ * @param get_time_ns The precise time callback, or NULL to disable timestamps.
+ * @param baud_rate The baud rate of the link, or 0 to skip the correction.
+ */
+void lw_device_enable_timestamps(lw_callback_device *device, lw_device_callback_get_time_ns get_time_ns, uint32_t baud_rate);
+
+/*
+ * Attach a stream queue to a device. The queue is cleared.
+ *
+ * Packets that complete while the device waits for another command ID, and
+ * are not taken by the packet callback, are queued instead of dropped, so
+ * requests can be sent while streaming without losing samples. Queued
+ * packets are read with lw_wait_for_stream_packet.
+ *
+ * @param device The callback device.
+ * @param queue The stream queue, or NULL to drop those packets.
+ */
+void lw_device_enable_stream_queue(lw_callback_device *device, lw_stream_queue *queue);
+
+/*
+ * Set the receive tap of a device.
+ *
+ * @param device The callback device.
+ * @param receive_tap The receive tap callback, or NULL to remove it.
+ * @param user_data User data for the tap, stored in receive_tap_user_data.
+ */
+void lw_device_set_receive_tap(lw_callback_device *device, lw_device_callback_receive_tap receive_tap, void *user_data);
+
+/*
+ * Add a response tap to a device. Taps are called in the order they were
+ * added, and a tap that is already added is moved to the end.
+ *
+ * @param device The callback device.
+ * @param tap The tap, must stay valid until it is removed.
+ * @param callback The response tap callback.
+ * @param user_data User data stored on the tap.
+ */
+void lw_device_add_response_tap(lw_callback_device *device, lw_response_tap *tap, lw_response_tap_callback callback, void *user_data);
+
+/*
+ * Remove a response tap from a device. Does nothing if it was not added.
+ *
+ * @param device The callback device.
+ * @param tap The tap to remove.
+ */
+void lw_device_remove_response_tap(lw_callback_device *device, lw_response_tap *tap);
+
+/*
+ * Parse the bytes left in the device receive buffer, without receiving more,
+ * until a packet with a specific command ID is completed. This is only needed
+ * when filling the receive buffer directly, such as from an event loop.
+ *
+ * @param device The callback device.
+ * @param command_id The command ID to wait for, or LW_ANY_COMMAND.
+ * @return LW_RESULT_SUCCESS if a packet was completed, or LW_RESULT_AGAIN if
+ *         the receive buffer is exhausted.
+ */
+lw_result lw_device_parse_receive_buffer(lw_callback_device *device, uint8_t command_id);
+
+/*
+ * Pass bytes that were received outside the serial receive callback to the
+ * device, such as from a UART buffer that is polled. The bytes are counted,
+ * timestamped and passed to the receive tap like received bytes, then parsed
+ * with lw_device_parse_receive_buffer.
+ *
+ * @param device The callback device.
+ * @param buffer The received bytes.
+ * @param size The number of bytes, at most LW_RECEIVE_BUFFER_SIZE.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_AGAIN if the receive buffer
+ *         still holds bytes to parse, or LW_RESULT_INVALID_PARAMETER if the
+ *         bytes do not fit.
+ */
+lw_result lw_device_receive_bytes(lw_callback_device *device, const uint8_t *buffer, uint32_t size);
+
 /*
  * Wait for the next response packet with a specific command ID. This can be a
  * blocking or non-blocking call depending on the timeout_ms argument.
@@ -485,6 +961,21 @@ lw_callback_device lw_create_callback_device(void *user_data,
  */
 lw_result lw_wait_for_next_response(lw_callback_device *device, uint8_t command_id, uint32_t timeout_ms);
 
+/*
+ * Wait for the next streamed packet with a specific command ID, taking queued
+ * packets first. Queued packets for other command IDs are dropped, in the
+ * same way lw_wait_for_next_response skips them.
+ *
+ * @param device The callback device.
+ * @param command_id The command ID to wait for, or LW_ANY_COMMAND.
+ * @param timeout_ms The timeout in milliseconds, or 0 for non-blocking.
+ * @param response A pointer to the packet is written here, either a queue slot
+ *        or the device response. It is valid until the device next receives.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure, or
+ *         LW_RESULT_AGAIN if non-blocking and no packet has been completed.
+ */
+lw_result lw_wait_for_stream_packet(lw_callback_device *device, uint8_t command_id, uint32_t timeout_ms, lw_response **response);
+
 /*
  * Fully managed request sending and waiting for the response.
  *
@@ -493,6 +984,204 @@ lw_result lw_wait_for_next_response(lw_callback_device *device, uint8_t command_
  */
 lw_result lw_send_request_get_response(lw_callback_device *device);
 
+// ----------------------------------------------------------------------------
+// Batched requests.
+//
+// A batch packs several request packets back to back so they are sent with a
+// single serial send, and then collects the responses in any order. This
+// removes the round trip latency between requests, which dominates when
+// reading many values.
+//
+// Responses are matched by command ID, so a batch can only hold one request
+// per command ID. Requests that are not answered within the timeout are sent
+// again, up to LW_REQUEST_RETRIES attempts in total.
+//
+// The batch limits can be defined as compiler flags, eg: -DLW_BATCH_MAX_REQUESTS=16.
+// LW_BATCH_MAX_REQUESTS can be at most 32. Functions that split their requests
+// over several batches fail with LW_RESULT_INVALID_PARAMETER if a single
+// request does not fit in LW_BATCH_SEND_SIZE.
+// ----------------------------------------------------------------------------
+#ifndef LW_BATCH_MAX_REQUESTS
+#ifdef ARDUINO
+#define LW_BATCH_MAX_REQUESTS 8
+#else
+#define LW_BATCH_MAX_REQUESTS 32
+#endif
+#endif
+
+#ifndef LW_BATCH_SEND_SIZE
+#ifdef ARDUINO
+#define LW_BATCH_SEND_SIZE 64
+#else
+#define LW_BATCH_SEND_SIZE 256
+#endif
+#endif
+
+#if LW_BATCH_MAX_REQUESTS > 32
+#error "LW_BATCH_MAX_REQUESTS can be at most 32"
+#endif
+
+typedef struct {
+    uint8_t data[LW_BATCH_SEND_SIZE];
+    uint32_t data_size;
+
+    uint16_t offsets[LW_BATCH_MAX_REQUESTS];
+    uint8_t command_ids[LW_BATCH_MAX_REQUESTS];
+    uint32_t count;
+    uint32_t completed_mask;
+} lw_request_batch;
+
+/*
+ * Batch response callback. Called once for every request in the batch as its
+ * response arrives.
+ *
+ * @param device The callback device.
+ * @param response The completed response, only valid during the callback.
+ * @param user_data The user data passed to lw_send_batch_get_responses.
+ */
+typedef void (*lw_batch_response_callback)(lw_callback_device *device, lw_response *response, void *user_data);
+
+/*
+ * Initialize an empty batch.
+ *
+ * @param batch The batch to initialize.
+ */
+void lw_init_request_batch(lw_request_batch *batch);
+
+/*
+ * Append a request packet to a batch.
+ *
+ * @param batch The batch.
+ * @param request The request to append, usually created with a request generator.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_AGAIN if the batch is full,
+ *         or LW_RESULT_INVALID_PARAMETER if the batch already holds a request
+ *         with the same command ID.
+ */
+lw_result lw_request_batch_add(lw_request_batch *batch, const lw_request *request);
+
+/*
+ * Fully managed batch sending and waiting for all the responses.
+ *
+ * Packets that do not answer a request in the batch are passed to the device
+ * packet callback, if set.
+ *
+ * @param device The callback device.
+ * @param batch The batch to send. The completed_mask holds a bit for each
+ *        request that was answered.
+ * @param callback Called for every response.
+ * @param user_data User data passed to the callback.
+ * @return LW_RESULT_SUCCESS if all requests were answered, or an error code on failure.
+ */
+lw_result lw_send_batch_get_responses(lw_callback_device *device, lw_request_batch *batch, lw_batch_response_callback callback, void *user_data);
+
+/*
+ * Send a batch once and wait up to timeout_ms for all the responses, without
+ * retries. Used to check whether a device answers at all before falling back
+ * to lw_send_batch_get_responses.
+ *
+ * @param device The callback device.
+ * @param batch The batch to send. The completed_mask holds a bit for each
+ *        request that was answered.
+ * @param callback Called for every response.
+ * @param user_data User data passed to the callback.
+ * @param timeout_ms The timeout for the whole batch in milliseconds.
+ * @param packets The number of packets completed while waiting is written
+ *        here, including packets that did not answer the batch.
+ * @return LW_RESULT_SUCCESS if all requests were answered, LW_RESULT_TIMEOUT
+ *         if they were not, or an error code on failure.
+ */
+lw_result lw_send_batch_once(lw_callback_device *device, lw_request_batch *batch, lw_batch_response_callback callback, void *user_data, uint32_t timeout_ms, uint32_t *packets);
+
+// ----------------------------------------------------------------------------
+// Asynchronous request pipeline.
+//
+// Requests are submitted to a device without blocking and completed from
+// lw_device_poll, which also handles the timeouts and retries. This allows
+// configuration writes to be sent while a stream is being consumed.
+//
+// The asynchronous requests are owned by the caller and linked into a queue
+// on the device while outstanding, so the device uses no extra storage.
+// Responses are matched to outstanding requests by command ID. Only one
+// request per command ID is sent at a time, later requests with the same
+// command ID are sent once the earlier one completes.
+//
+// Do not mix asynchronous requests with the blocking managed commands on the
+// same device, as the blocking commands consume the responses directly.
+// ----------------------------------------------------------------------------
+typedef enum {
+    LW_ASYNC_REQUEST_IDLE,
+    LW_ASYNC_REQUEST_QUEUED,
+    LW_ASYNC_REQUEST_SENT,
+} lw_async_request_state;
+
+/*
+ * Asynchronous request completion callback.
+ *
+ * @param device The callback device.
+ * @param async_request The completed request. It can be resubmitted from the callback.
+ * @param result LW_RESULT_SUCCESS if the response arrived, LW_RESULT_EXCEEDED_RETRIES
+ *        if all attempts timed out, or LW_RESULT_ERROR if the connection was lost.
+ * @param response The response on success, otherwise NULL. Only valid during the callback.
+ */
+typedef void (*lw_async_request_callback)(lw_callback_device *device, lw_async_request *async_request, lw_result result, lw_response *response);
+
+struct lw_async_request_s {
+    lw_request request;
+    lw_async_request_callback callback;
+    void *user_data;
+
+    lw_async_request_state state;
+    uint32_t send_time_ms;
+    uint32_t timeout_ms;
+    int32_t attempts;
+    lw_async_request *next;
+};
+
+/*
+ * Initialize an asynchronous request. Create the packet in async_request->request
+ * with a request generator before submitting it.
+ *
+ * @param async_request The request to initialize.
+ * @param callback The completion callback.
+ * @param user_data User data stored on the request.
+ */
+void lw_init_async_request(lw_async_request *async_request, lw_async_request_callback callback, void *user_data);
+
+/*
+ * Queue a request on the device. The request is sent by the next call to
+ * lw_device_poll and must stay valid until its callback is issued or it is
+ * cancelled.
+ *
+ * @param device The callback device.
+ * @param async_request The request to submit.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the
+ *         request is already outstanding.
+ */
+lw_result lw_device_submit_request(lw_callback_device *device, lw_async_request *async_request);
+
+/*
+ * Remove an outstanding request from the device without issuing its callback.
+ * A response that arrives later for a sent request is passed to the packet
+ * callback instead.
+ *
+ * @param device The callback device.
+ * @param async_request The request to cancel.
+ */
+void lw_device_cancel_request(lw_callback_device *device, lw_async_request *async_request);
+
+/*
+ * Send queued requests, receive packets, and complete requests. Requests
+ * that time out are resent up to LW_REQUEST_RETRIES attempts in total. Packets
+ * that do not answer a request are passed to the packet callback.
+ *
+ * @param device The callback device.
+ * @param timeout_ms The time to wait for the first packet in milliseconds, or
+ *        0 for non-blocking. The wait ends early when a request times out.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if the connection
+ *         was lost, in which case all outstanding requests are failed.
+ */
+lw_result lw_device_poll(lw_callback_device *device, uint32_t timeout_ms);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,6 +1,19 @@
 #include "lw_serial_api_grf250.h"
+#include <stddef.h>
 #include <string.h>
 
+static lw_grf250_config_cache *lw_grf250_find_config_cache(lw_callback_device *device, uint32_t field);
+
+// Return the value of a configuration field from an attached cache that holds it.
+#define LW_GRF250_RETURN_CACHED(device, field, member, value)                       \
+    {                                                                               \
+        lw_grf250_config_cache *cache = lw_grf250_find_config_cache(device, field); \
+        if (cache != NULL) {                                                        \
+            *(value) = cache->device_config.member;                                 \
+            return LW_RESULT_SUCCESS;                                               \
+        }                                                                           \
+    }                                                                               \
+
 // ----------------------------------------------------------------------------
 // Fully managed request/response commands.
 // ----------------------------------------------------------------------------
@@ -56,6 +69,7 @@ lw_result lw_grf250_set_reset(lw_callback_device *device, uint16_t token) {
 }
 
 lw_result lw_grf250_get_distance_config(lw_callback_device *device, lw_grf_distance_config *distance_config) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_DISTANCE_CONFIG, distance_config, distance_config)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_distance_config(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_distance_config(&device->response, distance_config);
@@ -67,6 +81,7 @@ lw_result lw_grf250_set_distance_config(lw_callback_device *device, lw_grf_dista
 }
 
 lw_result lw_grf250_get_stream(lw_callback_device *device, lw_grf250_stream *stream) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_STREAM, stream, stream)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_stream(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_stream(&device->response, stream);
@@ -90,6 +105,7 @@ lw_result lw_grf250_get_multi_data(lw_callback_device *device, lw_grf250_multi_d
 }
 
 lw_result lw_grf250_get_laser_firing(lw_callback_device *device, lw_grf250_enable *enable) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_LASER_FIRING, laser_firing, enable)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_laser_firing(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_laser_firing(&device->response, enable);
@@ -107,6 +123,7 @@ lw_result lw_grf250_get_temperature(lw_callback_device *device, int32_t *tempera
 }
 
 lw_result lw_grf250_get_auto_exposure(lw_callback_device *device, lw_grf250_enable *enable) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_AUTO_EXPOSURE, auto_exposure, enable)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_auto_exposure(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_auto_exposure(&device->response, enable);
@@ -118,6 +135,7 @@ lw_result lw_grf250_set_auto_exposure(lw_callback_device *device, lw_grf250_enab
 }
 
 lw_result lw_grf250_get_update_rate(lw_callback_device *device, uint32_t *rate) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_UPDATE_RATE, update_rate, rate)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_update_rate(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_update_rate(&device->response, rate);
@@ -135,6 +153,7 @@ lw_result lw_grf250_get_alarm_status(lw_callback_device *device, lw_grf250_alarm
 }
 
 lw_result lw_grf250_get_alarm_return_mode(lw_callback_device *device, lw_grf250_return_mode *mode) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ALARM_RETURN_MODE, alarm_return_mode, mode)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_alarm_return_mode(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_alarm_return_mode(&device->response, mode);
@@ -146,6 +165,7 @@ lw_result lw_grf250_set_alarm_return_mode(lw_callback_device *device, lw_grf250_
 }
 
 lw_result lw_grf250_get_lost_signal_counter(lw_callback_device *device, uint32_t *counter) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_LOST_SIGNAL_COUNTER, lost_signal_counter, counter)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_lost_signal_counter(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_lost_signal_counter(&device->response, counter);
@@ -157,6 +177,7 @@ lw_result lw_grf250_set_lost_signal_counter(lw_callback_device *device, uint32_t
 }
 
 lw_result lw_grf250_get_alarm_a_distance(lw_callback_device *device, uint32_t *distance_cm) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ALARM_A_DISTANCE, alarm_a_distance_cm, distance_cm)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_alarm_a_distance(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_alarm_a_distance(&device->response, distance_cm);
@@ -168,6 +189,7 @@ lw_result lw_grf250_set_alarm_a_distance(lw_callback_device *device, uint32_t di
 }
 
 lw_result lw_grf250_get_alarm_b_distance(lw_callback_device *device, uint32_t *distance_cm) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ALARM_B_DISTANCE, alarm_b_distance_cm, distance_cm)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_alarm_b_distance(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_alarm_b_distance(&device->response, distance_cm);
@@ -179,6 +201,7 @@ lw_result lw_grf250_set_alarm_b_distance(lw_callback_device *device, uint32_t di
 }
 
 lw_result lw_grf250_get_alarm_hysteresis(lw_callback_device *device, uint32_t *hysteresis_cm) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ALARM_HYSTERESIS, alarm_hysteresis_cm, hysteresis_cm)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_alarm_hysteresis(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_alarm_hysteresis(&device->response, hysteresis_cm);
@@ -190,6 +213,7 @@ lw_result lw_grf250_set_alarm_hysteresis(lw_callback_device *device, uint32_t hy
 }
 
 lw_result lw_grf250_get_gpio_mode(lw_callback_device *device, lw_grf250_gpio_mode *mode) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_GPIO_MODE, gpio_mode, mode)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_gpio_mode(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_gpio_mode(&device->response, mode);
@@ -201,6 +225,7 @@ lw_result lw_grf250_set_gpio_mode(lw_callback_device *device, lw_grf250_gpio_mod
 }
 
 lw_result lw_grf250_get_gpio_alarm_confirm_count(lw_callback_device *device, uint32_t *count) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_GPIO_ALARM_CONFIRM_COUNT, gpio_alarm_confirm_count, count)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_gpio_alarm_confirm_count(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_gpio_alarm_confirm_count(&device->response, count);
@@ -212,6 +237,7 @@ lw_result lw_grf250_set_gpio_alarm_confirm_count(lw_callback_device *device, uin
 }
 
 lw_result lw_grf250_get_median_filter_enable(lw_callback_device *device, lw_grf250_enable *enable) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_MEDIAN_FILTER_ENABLE, median_filter_enable, enable)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_median_filter_enable(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_median_filter_enable(&device->response, enable);
@@ -223,6 +249,7 @@ lw_result lw_grf250_set_median_filter_enable(lw_callback_device *device, lw_grf2
 }
 
 lw_result lw_grf250_get_median_filter_size(lw_callback_device *device, uint32_t *size) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_MEDIAN_FILTER_SIZE, median_filter_size, size)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_median_filter_size(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_median_filter_size(&device->response, size);
@@ -234,6 +261,7 @@ lw_result lw_grf250_set_median_filter_size(lw_callback_device *device, uint32_t
 }
 
 lw_result lw_grf250_get_smooth_filter_enable(lw_callback_device *device, lw_grf250_enable *enable) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_SMOOTH_FILTER_ENABLE, smooth_filter_enable, enable)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_smooth_filter_enable(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_smooth_filter_enable(&device->response, enable);
@@ -245,6 +273,7 @@ lw_result lw_grf250_set_smooth_filter_enable(lw_callback_device *device, lw_grf2
 }
 
 lw_result lw_grf250_get_smooth_filter_factor(lw_callback_device *device, uint32_t *factor) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_SMOOTH_FILTER_FACTOR, smooth_filter_factor, factor)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_smooth_filter_factor(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_smooth_filter_factor(&device->response, factor);
@@ -256,6 +285,7 @@ lw_result lw_grf250_set_smooth_filter_factor(lw_callback_device *device, uint32_
 }
 
 lw_result lw_grf250_get_baud_rate(lw_callback_device *device, lw_grf250_baud_rate *baud_rate) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_BAUD_RATE, baud_rate, baud_rate)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_baud_rate(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_baud_rate(&device->response, baud_rate);
@@ -267,6 +297,7 @@ lw_result lw_grf250_set_baud_rate(lw_callback_device *device, lw_grf250_baud_rat
 }
 
 lw_result lw_grf250_get_i2c_address(lw_callback_device *device, uint8_t *address) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_I2C_ADDRESS, i2c_address, address)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_i2c_address(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_i2c_address(&device->response, address);
@@ -278,6 +309,7 @@ lw_result lw_grf250_set_i2c_address(lw_callback_device *device, uint8_t address)
 }
 
 lw_result lw_grf250_get_rolling_average_enable(lw_callback_device *device, lw_grf250_enable *enable) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ROLLING_AVERAGE_ENABLE, rolling_average_enable, enable)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_rolling_average_enable(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_rolling_average_enable(&device->response, enable);
@@ -289,6 +321,7 @@ lw_result lw_grf250_set_rolling_average_enable(lw_callback_device *device, lw_gr
 }
 
 lw_result lw_grf250_get_rolling_average_size(lw_callback_device *device, uint32_t *size) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ROLLING_AVERAGE_SIZE, rolling_average_size, size)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_rolling_average_size(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_rolling_average_size(&device->response, size);
@@ -305,6 +338,7 @@ lw_result lw_grf250_set_sleep(lw_callback_device *device) {
 }
 
 lw_result lw_grf250_get_led_state(lw_callback_device *device, lw_grf250_enable *enable) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_LED_STATE, led_state, enable)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_led_state(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_led_state(&device->response, enable);
@@ -316,6 +350,7 @@ lw_result lw_grf250_set_led_state(lw_callback_device *device, lw_grf250_enable e
 }
 
 lw_result lw_grf250_get_zero_offset(lw_callback_device *device, int32_t *offset_cm) {
+    LW_GRF250_RETURN_CACHED(device, LW_GRF250_CONFIG_ZERO_OFFSET, zero_offset_cm, offset_cm)
     LW_CHECK_SUCCESS(lw_grf250_create_request_read_zero_offset(&device->request))
     LW_CHECK_SUCCESS(lw_send_request_get_response(device))
     return lw_grf250_parse_response_zero_offset(&device->response, offset_cm);
@@ -337,17 +372,267 @@ lw_result lw_grf250_initiate_serial(lw_callback_device *device) {
     return LW_RESULT_SUCCESS;
 }
 
+static void lw_grf250_product_info_callback(lw_callback_device *device, lw_response *response, void *user_data) {
+    (void)device;
+    lw_grf250_product_info *product_info = (lw_grf250_product_info *)user_data;
+
+    switch (response->command_id) {
+        case LW_GRF250_COMMAND_PRODUCT_NAME: {
+            lw_grf250_parse_response_product_name(response, product_info->product_name);
+            break;
+        }
+
+        case LW_GRF250_COMMAND_HARDWARE_VERSION: {
+            lw_grf250_parse_response_hardware_version(response, &product_info->hardware_version);
+            break;
+        }
+
+        case LW_GRF250_COMMAND_FIRMWARE_VERSION: {
+            lw_grf250_parse_response_firmware_version(response, &product_info->firmware_version_int);
+            break;
+        }
+
+        case LW_GRF250_COMMAND_SERIAL_NUMBER: {
+            lw_grf250_parse_response_serial_number(response, product_info->serial_number);
+            break;
+        }
+    }
+}
+
 lw_result lw_grf250_get_product_info(lw_callback_device *device, lw_grf250_product_info *product_info) {
-    LW_CHECK_SUCCESS(lw_grf250_get_product_name(device, product_info->product_name))
-    LW_CHECK_SUCCESS(lw_grf250_get_hardware_version(device, &product_info->hardware_version))
-    LW_CHECK_SUCCESS(lw_grf250_get_firmware_version(device, &product_info->firmware_version_int))
-    LW_CHECK_SUCCESS(lw_grf250_get_serial_number(device, product_info->serial_number))
+    lw_request request;
+    lw_request_batch batch;
+    lw_init_request_batch(&batch);
+
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_product_name(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_hardware_version(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_firmware_version(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_serial_number(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+
+    LW_CHECK_SUCCESS(lw_send_batch_get_responses(device, &batch, &lw_grf250_product_info_callback, product_info))
 
     product_info->firmware_version = lw_expand_firmware_version(product_info->firmware_version_int);
 
     return LW_RESULT_SUCCESS;
 }
 
+// NOTE: Ordered to match the LW_GRF250_CONFIG_... field bits.
+static const uint8_t lw_grf250_config_commands[] = {
+    LW_GRF250_COMMAND_DISTANCE_CONFIG,
+    LW_GRF250_COMMAND_STREAM,
+    LW_GRF250_COMMAND_LASER_FIRING,
+    LW_GRF250_COMMAND_AUTO_EXPOSURE,
+    LW_GRF250_COMMAND_UPDATE_RATE,
+    LW_GRF250_COMMAND_ALARM_RETURN_MODE,
+    LW_GRF250_COMMAND_LOST_SIGNAL_COUNTER,
+    LW_GRF250_COMMAND_ALARM_A_DISTANCE,
+    LW_GRF250_COMMAND_ALARM_B_DISTANCE,
+    LW_GRF250_COMMAND_ALARM_HYSTERESIS,
+    LW_GRF250_COMMAND_GPIO_MODE,
+    LW_GRF250_COMMAND_GPIO_ALARM_CONFIRM_COUNT,
+    LW_GRF250_COMMAND_MEDIAN_FILTER_ENABLE,
+    LW_GRF250_COMMAND_MEDIAN_FILTER_SIZE,
+    LW_GRF250_COMMAND_SMOOTH_FILTER_ENABLE,
+    LW_GRF250_COMMAND_SMOOTH_FILTER_FACTOR,
+    LW_GRF250_COMMAND_BAUD_RATE,
+    LW_GRF250_COMMAND_I2C_ADDRESS,
+    LW_GRF250_COMMAND_ROLLING_AVERAGE_ENABLE,
+    LW_GRF250_COMMAND_ROLLING_AVERAGE_SIZE,
+    LW_GRF250_COMMAND_LED_STATE,
+    LW_GRF250_COMMAND_ZERO_OFFSET,
+};
+
+#define LW_GRF250_CONFIG_COMMAND_COUNT (sizeof(lw_grf250_config_commands) / sizeof(lw_grf250_config_commands[0]))
+
+uint8_t lw_grf250_get_config_command(uint32_t index) {
+    return (index < LW_GRF250_CONFIG_COMMAND_COUNT) ? lw_grf250_config_commands[index] : 0;
+}
+
+static void lw_grf250_config_callback(lw_callback_device *device, lw_response *response, void *user_data) {
+    (void)device;
+    lw_grf250_parse_response_config(response, (lw_grf250_config *)user_data);
+}
+
+lw_result lw_grf250_get_config(lw_callback_device *device, lw_grf250_config *config) {
+    // NOTE: Some parsers only write the low bytes of enum fields.
+    memset(config, 0, sizeof(*config));
+
+    uint32_t index = 0;
+
+    // Send as many reads per batch as fit, small batch limits just take more round trips.
+    while (index < LW_GRF250_CONFIG_COMMAND_COUNT) {
+        lw_request request;
+        lw_request_batch batch;
+        lw_init_request_batch(&batch);
+
+        while (index < LW_GRF250_CONFIG_COMMAND_COUNT) {
+            lw_create_request_read(&request, lw_grf250_config_commands[index]);
+
+            if (lw_request_batch_add(&batch, &request) != LW_RESULT_SUCCESS) {
+                // NOTE: A request that does not fit an empty batch never will,
+                // sending the empty batch would loop forever.
+                if (batch.count == 0) {
+                    return LW_RESULT_INVALID_PARAMETER;
+                }
+
+                break;
+            }
+
+            ++index;
+        }
+
+        LW_CHECK_SUCCESS(lw_send_batch_get_responses(device, &batch, &lw_grf250_config_callback, config))
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+static lw_result lw_grf250_write_config_fields(lw_callback_device *device, const lw_grf250_config *config, uint32_t fields, lw_batch_response_callback callback, void *user_data) {
+    uint32_t index = 0;
+
+    while (index < LW_GRF250_CONFIG_COMMAND_COUNT) {
+        lw_request request;
+        lw_request_batch batch;
+        lw_init_request_batch(&batch);
+
+        while (index < LW_GRF250_CONFIG_COMMAND_COUNT) {
+            if ((fields & (1u << index)) == 0) {
+                ++index;
+                continue;
+            }
+
+            LW_CHECK_SUCCESS(lw_grf250_create_request_write_config(&request, config, lw_grf250_config_commands[index]))
+
+            if (lw_request_batch_add(&batch, &request) != LW_RESULT_SUCCESS) {
+                // NOTE: See lw_grf250_get_config.
+                if (batch.count == 0) {
+                    return LW_RESULT_INVALID_PARAMETER;
+                }
+
+                break;
+            }
+
+            ++index;
+        }
+
+        LW_CHECK_SUCCESS(lw_send_batch_get_responses(device, &batch, callback, user_data))
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_set_config(lw_callback_device *device, lw_grf250_config *config, uint32_t fields) {
+    // NOTE: Write responses echo the new value, which is parsed back into the config.
+    return lw_grf250_write_config_fields(device, config, fields, &lw_grf250_config_callback, config);
+}
+
+uint32_t lw_grf250_config_diff(const lw_grf250_config *a, const lw_grf250_config *b) {
+    uint32_t fields = 0;
+
+    fields |= (a->distance_config != b->distance_config) ? LW_GRF250_CONFIG_DISTANCE_CONFIG : 0;
+    fields |= (a->stream != b->stream) ? LW_GRF250_CONFIG_STREAM : 0;
+    fields |= (a->laser_firing != b->laser_firing) ? LW_GRF250_CONFIG_LASER_FIRING : 0;
+    fields |= (a->auto_exposure != b->auto_exposure) ? LW_GRF250_CONFIG_AUTO_EXPOSURE : 0;
+    fields |= (a->update_rate != b->update_rate) ? LW_GRF250_CONFIG_UPDATE_RATE : 0;
+    fields |= (a->alarm_return_mode != b->alarm_return_mode) ? LW_GRF250_CONFIG_ALARM_RETURN_MODE : 0;
+    fields |= (a->lost_signal_counter != b->lost_signal_counter) ? LW_GRF250_CONFIG_LOST_SIGNAL_COUNTER : 0;
+    fields |= (a->alarm_a_distance_cm != b->alarm_a_distance_cm) ? LW_GRF250_CONFIG_ALARM_A_DISTANCE : 0;
+    fields |= (a->alarm_b_distance_cm != b->alarm_b_distance_cm) ? LW_GRF250_CONFIG_ALARM_B_DISTANCE : 0;
+    fields |= (a->alarm_hysteresis_cm != b->alarm_hysteresis_cm) ? LW_GRF250_CONFIG_ALARM_HYSTERESIS : 0;
+    fields |= (a->gpio_mode != b->gpio_mode) ? LW_GRF250_CONFIG_GPIO_MODE : 0;
+    fields |= (a->gpio_alarm_confirm_count != b->gpio_alarm_confirm_count) ? LW_GRF250_CONFIG_GPIO_ALARM_CONFIRM_COUNT : 0;
+    fields |= (a->median_filter_enable != b->median_filter_enable) ? LW_GRF250_CONFIG_MEDIAN_FILTER_ENABLE : 0;
+    fields |= (a->median_filter_size != b->median_filter_size) ? LW_GRF250_CONFIG_MEDIAN_FILTER_SIZE : 0;
+    fields |= (a->smooth_filter_enable != b->smooth_filter_enable) ? LW_GRF250_CONFIG_SMOOTH_FILTER_ENABLE : 0;
+    fields |= (a->smooth_filter_factor != b->smooth_filter_factor) ? LW_GRF250_CONFIG_SMOOTH_FILTER_FACTOR : 0;
+    fields |= (a->baud_rate != b->baud_rate) ? LW_GRF250_CONFIG_BAUD_RATE : 0;
+    fields |= (a->i2c_address != b->i2c_address) ? LW_GRF250_CONFIG_I2C_ADDRESS : 0;
+    fields |= (a->rolling_average_enable != b->rolling_average_enable) ? LW_GRF250_CONFIG_ROLLING_AVERAGE_ENABLE : 0;
+    fields |= (a->rolling_average_size != b->rolling_average_size) ? LW_GRF250_CONFIG_ROLLING_AVERAGE_SIZE : 0;
+    fields |= (a->led_state != b->led_state) ? LW_GRF250_CONFIG_LED_STATE : 0;
+    fields |= (a->zero_offset_cm != b->zero_offset_cm) ? LW_GRF250_CONFIG_ZERO_OFFSET : 0;
+
+    return fields;
+}
+
+lw_result lw_grf250_config_cache_load(lw_callback_device *device, lw_grf250_config_cache *cache) {
+    LW_CHECK_SUCCESS(lw_grf250_get_config(device, &cache->device_config))
+    cache->config = cache->device_config;
+    cache->valid_fields = LW_GRF250_CONFIG_ALL;
+    return LW_RESULT_SUCCESS;
+}
+
+uint32_t lw_grf250_config_cache_dirty(const lw_grf250_config_cache *cache) {
+    return lw_grf250_config_diff(&cache->config, &cache->device_config);
+}
+
+static void lw_grf250_config_cache_callback(lw_callback_device *device, lw_response *response, void *user_data) {
+    (void)device;
+    lw_grf250_config_cache *cache = (lw_grf250_config_cache *)user_data;
+
+    // Keep both copies in step with the value the device accepted.
+    lw_grf250_parse_response_config(response, &cache->device_config);
+    lw_grf250_parse_response_config(response, &cache->config);
+}
+
+lw_result lw_grf250_config_cache_apply(lw_callback_device *device, lw_grf250_config_cache *cache) {
+    return lw_grf250_write_config_fields(device, &cache->config, lw_grf250_config_cache_dirty(cache), &lw_grf250_config_cache_callback, cache);
+}
+
+static void lw_grf250_config_cache_tap(lw_callback_device *device, lw_response_tap *tap, lw_response *response) {
+    (void)device;
+    lw_grf250_config_cache *cache = (lw_grf250_config_cache *)tap->user_data;
+
+    // NOTE: A reset restores the saved parameters, which are not known here.
+    if (response->command_id == LW_GRF250_COMMAND_RESET) {
+        cache->valid_fields = 0;
+        return;
+    }
+
+    for (uint32_t i = 0; i < LW_GRF250_CONFIG_COMMAND_COUNT; ++i) {
+        if (lw_grf250_config_commands[i] != response->command_id) {
+            continue;
+        }
+
+        uint32_t dirty = lw_grf250_config_cache_dirty(cache);
+
+        if (lw_grf250_parse_response_config(response, &cache->device_config) != LW_RESULT_SUCCESS) {
+            return;
+        }
+
+        // A field seen for the first time has no pending change to keep.
+        if ((cache->valid_fields & (1u << i)) == 0 || (dirty & (1u << i)) == 0) {
+            lw_grf250_parse_response_config(response, &cache->config);
+        }
+
+        cache->valid_fields |= (1u << i);
+        return;
+    }
+}
+
+void lw_grf250_config_cache_attach(lw_callback_device *device, lw_grf250_config_cache *cache) {
+    lw_device_add_response_tap(device, &cache->tap, &lw_grf250_config_cache_tap, cache);
+}
+
+void lw_grf250_config_cache_detach(lw_callback_device *device, lw_grf250_config_cache *cache) {
+    lw_device_remove_response_tap(device, &cache->tap);
+}
+
+static lw_grf250_config_cache *lw_grf250_find_config_cache(lw_callback_device *device, uint32_t field) {
+    for (lw_response_tap *tap = device->response_taps; tap != NULL; tap = tap->next) {
+        if (tap->callback == &lw_grf250_config_cache_tap) {
+            lw_grf250_config_cache *cache = (lw_grf250_config_cache *)tap->user_data;
+            return (cache->valid_fields & field) ? cache : NULL;
+        }
+    }
+
+    return NULL;
+}
+
 lw_result lw_grf250_sleep(lw_callback_device *device) {
     LW_CHECK_SUCCESS(lw_grf250_set_sleep(device))
     return LW_RESULT_SUCCESS;
@@ -368,13 +653,15 @@ lw_result lw_grf250_save_parameters(lw_callback_device *device) {
 }
 
 lw_result lw_grf250_wait_for_streamed_distance(lw_callback_device *device, lw_grf_distance_config config, lw_grf250_distance_data *distance_data, uint32_t timeout_ms) {
-    LW_CHECK_SUCCESS(lw_wait_for_next_response(device, LW_GRF250_COMMAND_DISTANCE_DATA, timeout_ms))
-    return lw_grf250_parse_response_distance_data(&device->response, config, distance_data);
+    lw_response *response;
+    LW_CHECK_SUCCESS(lw_wait_for_stream_packet(device, LW_GRF250_COMMAND_DISTANCE_DATA, timeout_ms, &response))
+    return lw_grf250_parse_response_distance_data(response, config, distance_data);
 }
 
 lw_result lw_grf250_wait_for_streamed_multi_data(lw_callback_device *device, lw_grf250_multi_data *multi_data, uint32_t timeout_ms) {
-    LW_CHECK_SUCCESS(lw_wait_for_next_response(device, LW_GRF250_COMMAND_MULTI_DATA, timeout_ms))
-    return lw_grf250_parse_response_multi_data(&device->response, multi_data);
+    lw_response *response;
+    LW_CHECK_SUCCESS(lw_wait_for_stream_packet(device, LW_GRF250_COMMAND_MULTI_DATA, timeout_ms, &response))
+    return lw_grf250_parse_response_multi_data(response, multi_data);
 }
 
 // ----------------------------------------------------------------------------
@@ -756,6 +1043,100 @@ lw_result lw_grf250_create_request_write_zero_offset(lw_request *request, int32_
     return LW_RESULT_SUCCESS;
 }
 
+lw_result lw_grf250_create_request_write_config(lw_request *request, const lw_grf250_config *config, uint8_t command_id) {
+    switch (command_id) {
+        case LW_GRF250_COMMAND_DISTANCE_CONFIG: {
+            return lw_grf250_create_request_write_distance_config(request, config->distance_config);
+        }
+
+        case LW_GRF250_COMMAND_STREAM: {
+            return lw_grf250_create_request_write_stream(request, config->stream);
+        }
+
+        case LW_GRF250_COMMAND_LASER_FIRING: {
+            return lw_grf250_create_request_write_laser_firing(request, config->laser_firing);
+        }
+
+        case LW_GRF250_COMMAND_AUTO_EXPOSURE: {
+            return lw_grf250_create_request_write_auto_exposure(request, config->auto_exposure);
+        }
+
+        case LW_GRF250_COMMAND_UPDATE_RATE: {
+            return lw_grf250_create_request_write_update_rate(request, config->update_rate);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_RETURN_MODE: {
+            return lw_grf250_create_request_write_alarm_return_mode(request, config->alarm_return_mode);
+        }
+
+        case LW_GRF250_COMMAND_LOST_SIGNAL_COUNTER: {
+            return lw_grf250_create_request_write_lost_signal_counter(request, config->lost_signal_counter);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_A_DISTANCE: {
+            return lw_grf250_create_request_write_alarm_a_distance(request, config->alarm_a_distance_cm);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_B_DISTANCE: {
+            return lw_grf250_create_request_write_alarm_b_distance(request, config->alarm_b_distance_cm);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_HYSTERESIS: {
+            return lw_grf250_create_request_write_alarm_hysteresis(request, config->alarm_hysteresis_cm);
+        }
+
+        case LW_GRF250_COMMAND_GPIO_MODE: {
+            return lw_grf250_create_request_write_gpio_mode(request, config->gpio_mode);
+        }
+
+        case LW_GRF250_COMMAND_GPIO_ALARM_CONFIRM_COUNT: {
+            return lw_grf250_create_request_write_gpio_alarm_confirm_count(request, config->gpio_alarm_confirm_count);
+        }
+
+        case LW_GRF250_COMMAND_MEDIAN_FILTER_ENABLE: {
+            return lw_grf250_create_request_write_median_filter_enable(request, config->median_filter_enable);
+        }
+
+        case LW_GRF250_COMMAND_MEDIAN_FILTER_SIZE: {
+            return lw_grf250_create_request_write_median_filter_size(request, config->median_filter_size);
+        }
+
+        case LW_GRF250_COMMAND_SMOOTH_FILTER_ENABLE: {
+            return lw_grf250_create_request_write_smooth_filter_enable(request, config->smooth_filter_enable);
+        }
+
+        case LW_GRF250_COMMAND_SMOOTH_FILTER_FACTOR: {
+            return lw_grf250_create_request_write_smooth_filter_factor(request, config->smooth_filter_factor);
+        }
+
+        case LW_GRF250_COMMAND_BAUD_RATE: {
+            return lw_grf250_create_request_write_baud_rate(request, config->baud_rate);
+        }
+
+        case LW_GRF250_COMMAND_I2C_ADDRESS: {
+            return lw_grf250_create_request_write_i2c_address(request, config->i2c_address);
+        }
+
+        case LW_GRF250_COMMAND_ROLLING_AVERAGE_ENABLE: {
+            return lw_grf250_create_request_write_rolling_average_enable(request, config->rolling_average_enable);
+        }
+
+        case LW_GRF250_COMMAND_ROLLING_AVERAGE_SIZE: {
+            return lw_grf250_create_request_write_rolling_average_size(request, config->rolling_average_size);
+        }
+
+        case LW_GRF250_COMMAND_LED_STATE: {
+            return lw_grf250_create_request_write_led_state(request, config->led_state);
+        }
+
+        case LW_GRF250_COMMAND_ZERO_OFFSET: {
+            return lw_grf250_create_request_write_zero_offset(request, config->zero_offset_cm);
+        }
+    }
+
+    return LW_RESULT_INVALID_PARAMETER;
+}
+
 // ----------------------------------------------------------------------------
 // Response parsers.
 // ----------------------------------------------------------------------------
@@ -814,54 +1195,8 @@ lw_result lw_grf250_parse_response_stream(lw_response *response, lw_grf250_strea
 }
 
 lw_result lw_grf250_parse_response_distance_data(lw_response *response, lw_grf_distance_config config, lw_grf250_distance_data *distance_data) {
-    LW_CHECK_COMMAND_ID(response, LW_GRF250_COMMAND_DISTANCE_DATA)
-    uint32_t offset = 0;
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW) {
-        lw_parse_response_int32(response, &distance_data->first_return_raw_mm, offset);
-        distance_data->first_return_raw_mm *= 100;
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_FILTERED) {
-        lw_parse_response_int32(response, &distance_data->first_return_filtered_mm, offset);
-        distance_data->first_return_filtered_mm *= 100;
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_STRENGTH) {
-        lw_parse_response_int32(response, &distance_data->first_return_strength, offset);
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_LAST_RETURN_RAW) {
-        lw_parse_response_int32(response, &distance_data->last_return_raw_mm, offset);
-        distance_data->last_return_raw_mm *= 100;
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_LAST_RETURN_FILTERED) {
-        lw_parse_response_int32(response, &distance_data->last_return_filtered_mm, offset);
-        distance_data->last_return_filtered_mm *= 100;
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_LAST_RETURN_STRENGTH) {
-        lw_parse_response_int32(response, &distance_data->last_return_strength, offset);
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_TEMPERATURE) {
-        lw_parse_response_int32(response, &distance_data->temperature, offset);
-        offset += sizeof(uint32_t);
-    }
-
-    if (config & LW_GRF250_DISTANCE_CONFIG_ALARM_STATUS) {
-        lw_parse_response_int32(response, &distance_data->alarm_status, offset);
-        offset += sizeof(uint32_t);
-    }
-
-    return LW_RESULT_SUCCESS;
+    lw_grf250_distance_decoder decoder = lw_grf250_create_distance_decoder(config);
+    return lw_grf250_decode_distance_data(&decoder, response, distance_data);
 }
 
 lw_result lw_grf250_parse_response_multi_data(lw_response *response, lw_grf250_multi_data *multi_data) {
@@ -877,6 +1212,7 @@ lw_result lw_grf250_parse_response_multi_data(lw_response *response, lw_grf250_m
     }
 
     lw_parse_response_int32(response, &multi_data->temperature, offset);
+    multi_data->timestamp_ns = response->start_time_ns;
     return LW_RESULT_SUCCESS;
 }
 
@@ -1021,3 +1357,731 @@ lw_result lw_grf250_parse_response_zero_offset(lw_response *response, int32_t *o
     *offset_cm *= 10;
     return LW_RESULT_SUCCESS;
 }
+
+lw_result lw_grf250_parse_response_config(lw_response *response, lw_grf250_config *config) {
+    switch (response->command_id) {
+        case LW_GRF250_COMMAND_DISTANCE_CONFIG: {
+            return lw_grf250_parse_response_distance_config(response, &config->distance_config);
+        }
+
+        case LW_GRF250_COMMAND_STREAM: {
+            return lw_grf250_parse_response_stream(response, &config->stream);
+        }
+
+        case LW_GRF250_COMMAND_LASER_FIRING: {
+            return lw_grf250_parse_response_laser_firing(response, &config->laser_firing);
+        }
+
+        case LW_GRF250_COMMAND_AUTO_EXPOSURE: {
+            return lw_grf250_parse_response_auto_exposure(response, &config->auto_exposure);
+        }
+
+        case LW_GRF250_COMMAND_UPDATE_RATE: {
+            return lw_grf250_parse_response_update_rate(response, &config->update_rate);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_RETURN_MODE: {
+            return lw_grf250_parse_response_alarm_return_mode(response, &config->alarm_return_mode);
+        }
+
+        case LW_GRF250_COMMAND_LOST_SIGNAL_COUNTER: {
+            return lw_grf250_parse_response_lost_signal_counter(response, &config->lost_signal_counter);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_A_DISTANCE: {
+            return lw_grf250_parse_response_alarm_a_distance(response, &config->alarm_a_distance_cm);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_B_DISTANCE: {
+            return lw_grf250_parse_response_alarm_b_distance(response, &config->alarm_b_distance_cm);
+        }
+
+        case LW_GRF250_COMMAND_ALARM_HYSTERESIS: {
+            return lw_grf250_parse_response_alarm_hysteresis(response, &config->alarm_hysteresis_cm);
+        }
+
+        case LW_GRF250_COMMAND_GPIO_MODE: {
+            return lw_grf250_parse_response_gpio_mode(response, &config->gpio_mode);
+        }
+
+        case LW_GRF250_COMMAND_GPIO_ALARM_CONFIRM_COUNT: {
+            return lw_grf250_parse_response_gpio_alarm_confirm_count(response, &config->gpio_alarm_confirm_count);
+        }
+
+        case LW_GRF250_COMMAND_MEDIAN_FILTER_ENABLE: {
+            return lw_grf250_parse_response_median_filter_enable(response, &config->median_filter_enable);
+        }
+
+        case LW_GRF250_COMMAND_MEDIAN_FILTER_SIZE: {
+            return lw_grf250_parse_response_median_filter_size(response, &config->median_filter_size);
+        }
+
+        case LW_GRF250_COMMAND_SMOOTH_FILTER_ENABLE: {
+            return lw_grf250_parse_response_smooth_filter_enable(response, &config->smooth_filter_enable);
+        }
+
+        case LW_GRF250_COMMAND_SMOOTH_FILTER_FACTOR: {
+            return lw_grf250_parse_response_smooth_filter_factor(response, &config->smooth_filter_factor);
+        }
+
+        case LW_GRF250_COMMAND_BAUD_RATE: {
+            return lw_grf250_parse_response_baud_rate(response, &config->baud_rate);
+        }
+
+        case LW_GRF250_COMMAND_I2C_ADDRESS: {
+            return lw_grf250_parse_response_i2c_address(response, &config->i2c_address);
+        }
+
+        case LW_GRF250_COMMAND_ROLLING_AVERAGE_ENABLE: {
+            return lw_grf250_parse_response_rolling_average_enable(response, &config->rolling_average_enable);
+        }
+
+        case LW_GRF250_COMMAND_ROLLING_AVERAGE_SIZE: {
+            return lw_grf250_parse_response_rolling_average_size(response, &config->rolling_average_size);
+        }
+
+        case LW_GRF250_COMMAND_LED_STATE: {
+            return lw_grf250_parse_response_led_state(response, &config->led_state);
+        }
+
+        case LW_GRF250_COMMAND_ZERO_OFFSET: {
+            return lw_grf250_parse_response_zero_offset(response, &config->zero_offset_cm);
+        }
+    }
+
+    return LW_RESULT_INCORRECT_COMMAND_ID;
+}
+
+uint32_t lw_grf250_get_response_data_size(uint8_t command_id) {
+    switch (command_id) {
+        case LW_GRF250_COMMAND_PRODUCT_NAME: {
+            return LW_GRF250_RESPONSE_SIZE_PRODUCT_NAME;
+        }
+
+        case LW_GRF250_COMMAND_HARDWARE_VERSION: {
+            return LW_GRF250_RESPONSE_SIZE_HARDWARE_VERSION;
+        }
+
+        case LW_GRF250_COMMAND_FIRMWARE_VERSION: {
+            return LW_GRF250_RESPONSE_SIZE_FIRMWARE_VERSION;
+        }
+
+        case LW_GRF250_COMMAND_SERIAL_NUMBER: {
+            return LW_GRF250_RESPONSE_SIZE_SERIAL_NUMBER;
+        }
+
+        case LW_GRF250_COMMAND_USER_DATA: {
+            return LW_GRF250_RESPONSE_SIZE_USER_DATA;
+        }
+
+        case LW_GRF250_COMMAND_TOKEN: {
+            return LW_GRF250_RESPONSE_SIZE_TOKEN;
+        }
+
+        case LW_GRF250_COMMAND_SAVE_PARAMETERS: {
+            return LW_GRF250_RESPONSE_SIZE_SAVE_PARAMETERS;
+        }
+
+        case LW_GRF250_COMMAND_RESET: {
+            return LW_GRF250_RESPONSE_SIZE_RESET;
+        }
+
+        case LW_GRF250_COMMAND_DISTANCE_CONFIG: {
+            return LW_GRF250_RESPONSE_SIZE_DISTANCE_CONFIG;
+        }
+
+        case LW_GRF250_COMMAND_STREAM: {
+            return LW_GRF250_RESPONSE_SIZE_STREAM;
+        }
+
+        case LW_GRF250_COMMAND_DISTANCE_DATA: {
+            return LW_GRF250_RESPONSE_SIZE_DISTANCE_DATA;
+        }
+
+        case LW_GRF250_COMMAND_MULTI_DATA: {
+            return LW_GRF250_RESPONSE_SIZE_MULTI_DATA;
+        }
+
+        case LW_GRF250_COMMAND_LASER_FIRING: {
+            return LW_GRF250_RESPONSE_SIZE_LASER_FIRING;
+        }
+
+        case LW_GRF250_COMMAND_TEMPERATURE: {
+            return LW_GRF250_RESPONSE_SIZE_TEMPERATURE;
+        }
+
+        case LW_GRF250_COMMAND_AUTO_EXPOSURE: {
+            return LW_GRF250_RESPONSE_SIZE_AUTO_EXPOSURE;
+        }
+
+        case LW_GRF250_COMMAND_UPDATE_RATE: {
+            return LW_GRF250_RESPONSE_SIZE_UPDATE_RATE;
+        }
+
+        case LW_GRF250_COMMAND_ALARM_STATUS: {
+            return LW_GRF250_RESPONSE_SIZE_ALARM_STATUS;
+        }
+
+        case LW_GRF250_COMMAND_ALARM_RETURN_MODE: {
+            return LW_GRF250_RESPONSE_SIZE_ALARM_RETURN_MODE;
+        }
+
+        case LW_GRF250_COMMAND_LOST_SIGNAL_COUNTER: {
+            return LW_GRF250_RESPONSE_SIZE_LOST_SIGNAL_COUNTER;
+        }
+
+        case LW_GRF250_COMMAND_ALARM_A_DISTANCE: {
+            return LW_GRF250_RESPONSE_SIZE_ALARM_A_DISTANCE;
+        }
+
+        case LW_GRF250_COMMAND_ALARM_B_DISTANCE: {
+            return LW_GRF250_RESPONSE_SIZE_ALARM_B_DISTANCE;
+        }
+
+        case LW_GRF250_COMMAND_ALARM_HYSTERESIS: {
+            return LW_GRF250_RESPONSE_SIZE_ALARM_HYSTERESIS;
+        }
+
+        case LW_GRF250_COMMAND_GPIO_MODE: {
+            return LW_GRF250_RESPONSE_SIZE_GPIO_MODE;
+        }
+
+        case LW_GRF250_COMMAND_GPIO_ALARM_CONFIRM_COUNT: {
+            return LW_GRF250_RESPONSE_SIZE_GPIO_ALARM_CONFIRM_COUNT;
+        }
+
+        case LW_GRF250_COMMAND_MEDIAN_FILTER_ENABLE: {
+            return LW_GRF250_RESPONSE_SIZE_MEDIAN_FILTER_ENABLE;
+        }
+
+        case LW_GRF250_COMMAND_MEDIAN_FILTER_SIZE: {
+            return LW_GRF250_RESPONSE_SIZE_MEDIAN_FILTER_SIZE;
+        }
+
+        case LW_GRF250_COMMAND_SMOOTH_FILTER_ENABLE: {
+            return LW_GRF250_RESPONSE_SIZE_SMOOTH_FILTER_ENABLE;
+        }
+
+        case LW_GRF250_COMMAND_SMOOTH_FILTER_FACTOR: {
+            return LW_GRF250_RESPONSE_SIZE_SMOOTH_FILTER_FACTOR;
+        }
+
+        case LW_GRF250_COMMAND_BAUD_RATE: {
+            return LW_GRF250_RESPONSE_SIZE_BAUD_RATE;
+        }
+
+        case LW_GRF250_COMMAND_I2C_ADDRESS: {
+            return LW_GRF250_RESPONSE_SIZE_I2C_ADDRESS;
+        }
+
+        case LW_GRF250_COMMAND_ROLLING_AVERAGE_ENABLE: {
+            return LW_GRF250_RESPONSE_SIZE_ROLLING_AVERAGE_ENABLE;
+        }
+
+        case LW_GRF250_COMMAND_ROLLING_AVERAGE_SIZE: {
+            return LW_GRF250_RESPONSE_SIZE_ROLLING_AVERAGE_SIZE;
+        }
+
+        case LW_GRF250_COMMAND_SLEEP: {
+            return LW_GRF250_RESPONSE_SIZE_SLEEP;
+        }
+
+        case LW_GRF250_COMMAND_LED_STATE: {
+            return LW_GRF250_RESPONSE_SIZE_LED_STATE;
+        }
+
+        case LW_GRF250_COMMAND_ZERO_OFFSET: {
+            return LW_GRF250_RESPONSE_SIZE_ZERO_OFFSET;
+        }
+    }
+
+    return LW_GRF250_RESPONSE_SIZE_UNKNOWN;
+}
+
+lw_result lw_grf250_check_response_header(uint8_t command_id, uint32_t payload_size) {
+    uint32_t data_size = lw_grf250_get_response_data_size(command_id);
+
+    if (data_size == LW_GRF250_RESPONSE_SIZE_UNKNOWN) {
+        return LW_RESULT_ERROR;
+    }
+
+    // The payload size includes the command ID.
+    if (command_id == LW_GRF250_COMMAND_DISTANCE_DATA) {
+        uint32_t field_bytes = payload_size - 1;
+
+        if (field_bytes > data_size || (field_bytes % sizeof(int32_t)) != 0) {
+            return LW_RESULT_ERROR;
+        }
+    } else if (payload_size - 1 != data_size) {
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+uint32_t lw_grf250_get_command_timeout(uint8_t command_id) {
+    switch (command_id) {
+        case LW_GRF250_COMMAND_SAVE_PARAMETERS: {
+            return LW_GRF250_SAVE_TIMEOUT_MS;
+        }
+
+        case LW_GRF250_COMMAND_RESET: {
+            return LW_GRF250_SAVE_TIMEOUT_MS;
+        }
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Distance data decoding.
+// ----------------------------------------------------------------------------
+static const int32_t lw_grf250_distance_field_scales[LW_GRF250_DISTANCE_FIELD_COUNT] = {100, 100, 1, 100, 100, 1, 1, 1};
+
+static const size_t lw_grf250_distance_field_offsets[LW_GRF250_DISTANCE_FIELD_COUNT] = {
+    offsetof(lw_grf250_distance_data, first_return_raw_mm),
+    offsetof(lw_grf250_distance_data, first_return_filtered_mm),
+    offsetof(lw_grf250_distance_data, first_return_strength),
+    offsetof(lw_grf250_distance_data, last_return_raw_mm),
+    offsetof(lw_grf250_distance_data, last_return_filtered_mm),
+    offsetof(lw_grf250_distance_data, last_return_strength),
+    offsetof(lw_grf250_distance_data, temperature),
+    offsetof(lw_grf250_distance_data, alarm_status),
+};
+
+static inline int32_t lw_grf250_read_distance_field(const uint8_t *fields, uint32_t index) {
+    // NOTE: A fixed size memcpy compiles down to a single unaligned load.
+    int32_t value;
+    memcpy(&value, fields + index * sizeof(int32_t), sizeof(int32_t));
+    return value;
+}
+
+lw_grf250_distance_decoder lw_grf250_create_distance_decoder(lw_grf_distance_config config) {
+    lw_grf250_distance_decoder decoder;
+    decoder.config = config;
+    decoder.field_count = 0;
+
+    // Fields are packed in bit order, only for the bits that are set.
+    for (uint8_t i = 0; i < LW_GRF250_DISTANCE_FIELD_COUNT; ++i) {
+        if (config & (1u << i)) {
+            decoder.fields[decoder.field_count++] = i;
+        }
+    }
+
+    return decoder;
+}
+
+lw_result lw_grf250_decode_distance_data(const lw_grf250_distance_decoder *decoder, lw_response *response, lw_grf250_distance_data *distance_data) {
+    LW_CHECK_COMMAND_ID(response, LW_GRF250_COMMAND_DISTANCE_DATA)
+    const uint8_t *fields = response->data + 4;
+    distance_data->timestamp_ns = response->start_time_ns;
+
+    if (decoder->config == LW_GRF250_DISTANCE_CONFIG_ALL) {
+        distance_data->first_return_raw_mm = lw_grf250_read_distance_field(fields, 0) * 100;
+        distance_data->first_return_filtered_mm = lw_grf250_read_distance_field(fields, 1) * 100;
+        distance_data->first_return_strength = lw_grf250_read_distance_field(fields, 2);
+        distance_data->last_return_raw_mm = lw_grf250_read_distance_field(fields, 3) * 100;
+        distance_data->last_return_filtered_mm = lw_grf250_read_distance_field(fields, 4) * 100;
+        distance_data->last_return_strength = lw_grf250_read_distance_field(fields, 5);
+        distance_data->temperature = lw_grf250_read_distance_field(fields, 6);
+        distance_data->alarm_status = lw_grf250_read_distance_field(fields, 7);
+        return LW_RESULT_SUCCESS;
+    }
+
+    for (uint32_t i = 0; i < decoder->field_count; ++i) {
+        uint8_t field = decoder->fields[i];
+        int32_t *value = (int32_t *)((uint8_t *)distance_data + lw_grf250_distance_field_offsets[field]);
+        *value = lw_grf250_read_distance_field(fields, i) * lw_grf250_distance_field_scales[field];
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_decode_distance_data_batch(const lw_grf250_distance_decoder *decoder, lw_response *response, lw_grf250_distance_batch *batch) {
+    LW_CHECK_COMMAND_ID(response, LW_GRF250_COMMAND_DISTANCE_DATA)
+
+    if (batch->count >= batch->capacity) {
+        return LW_RESULT_AGAIN;
+    }
+
+    const uint8_t *fields = response->data + 4;
+    uint32_t sample = batch->count;
+
+    for (uint32_t i = 0; i < LW_GRF250_DISTANCE_FIELD_COUNT; ++i) {
+        if (batch->columns[i] != NULL) {
+            batch->columns[i][sample] = 0;
+        }
+    }
+
+    for (uint32_t i = 0; i < decoder->field_count; ++i) {
+        uint8_t field = decoder->fields[i];
+
+        if (batch->columns[field] != NULL) {
+            batch->columns[field][sample] = lw_grf250_read_distance_field(fields, i) * lw_grf250_distance_field_scales[field];
+        }
+    }
+
+    if (batch->timestamps_ns != NULL) {
+        batch->timestamps_ns[sample] = response->start_time_ns;
+    }
+
+    batch->count += 1;
+
+    return LW_RESULT_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Sample period estimation.
+// ----------------------------------------------------------------------------
+// The estimates move by 1/2^shift of each error.
+#define LW_GRF250_PERIOD_GAIN_SHIFT 8
+#define LW_GRF250_PHASE_GAIN_SHIFT 4
+#define LW_GRF250_DELAY_GAIN_SHIFT 6
+#define LW_GRF250_JITTER_GAIN_SHIFT 4
+
+void lw_grf250_init_period_estimator(lw_grf250_period_estimator *estimator, uint32_t update_rate) {
+    estimator->count = 0;
+    estimator->period_ns = (update_rate != 0) ? (int64_t)(1000000000 / update_rate) : 0;
+    estimator->jitter_ns = 0;
+    estimator->line_time_ns = 0;
+    estimator->delay_ns = 0;
+}
+
+uint64_t lw_grf250_period_estimator_add(lw_grf250_period_estimator *estimator, uint64_t timestamp_ns) {
+    int64_t gap = (int64_t)(timestamp_ns - estimator->line_time_ns);
+
+    // NOTE: The estimate restarts from samples that do not move forward. An
+    // unknown period is taken from the first two samples.
+    if (estimator->count == 0 || gap <= 0 || estimator->period_ns == 0) {
+        if (estimator->period_ns == 0 && estimator->count != 0 && gap > 0) {
+            estimator->period_ns = gap;
+        }
+
+        estimator->count = (estimator->count != 0 && gap > 0) ? estimator->count + 1 : 1;
+        estimator->line_time_ns = timestamp_ns;
+        estimator->delay_ns = 0;
+        return timestamp_ns;
+    }
+
+    int64_t periods = (gap + estimator->period_ns / 2) / estimator->period_ns;
+
+    if (periods < 1) {
+        periods = 1;
+    }
+
+    uint64_t predicted = estimator->line_time_ns + (uint64_t)(periods * estimator->period_ns);
+    int64_t error = (int64_t)(timestamp_ns - predicted);
+    int64_t error_magnitude = (error < 0) ? -error : error;
+
+    // The line through the timestamps gives the period, delays average out.
+    estimator->line_time_ns = predicted + (uint64_t)(error / (1 << LW_GRF250_PHASE_GAIN_SHIFT));
+    estimator->period_ns += (error / periods) / (1 << LW_GRF250_PERIOD_GAIN_SHIFT);
+    estimator->jitter_ns += (error_magnitude - estimator->jitter_ns) / (1 << LW_GRF250_JITTER_GAIN_SHIFT);
+
+    // The least delayed samples relative to the line give its offset.
+    if (error < estimator->delay_ns) {
+        estimator->delay_ns = error;
+    } else {
+        estimator->delay_ns += (error - estimator->delay_ns) / (1 << LW_GRF250_DELAY_GAIN_SHIFT);
+    }
+
+    estimator->count += 1;
+
+    return predicted + (uint64_t)estimator->delay_ns;
+}
+
+// ----------------------------------------------------------------------------
+// Baud rate negotiation.
+// ----------------------------------------------------------------------------
+static const uint32_t lw_grf250_baud_rate_values[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+
+#define LW_GRF250_BAUD_RATE_COUNT (sizeof(lw_grf250_baud_rate_values) / sizeof(lw_grf250_baud_rate_values[0]))
+
+uint32_t lw_grf250_baud_rate_to_bps(lw_grf250_baud_rate baud_rate) {
+    if ((uint32_t)baud_rate >= LW_GRF250_BAUD_RATE_COUNT) {
+        return 0;
+    }
+
+    return lw_grf250_baud_rate_values[baud_rate];
+}
+
+static lw_result lw_grf250_set_host_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate baud_rate) {
+    uint32_t bps = lw_grf250_baud_rate_to_bps(baud_rate);
+
+    if (bps == 0) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    LW_CHECK_SUCCESS(set_host_baud_rate(device, bps))
+
+    // Bytes received at the old rate are meaningless at the new one.
+    device->receive_buffer_offset = device->receive_buffer_size;
+    lw_reset_response(&device->response);
+
+    if (device->get_time_ns != NULL) {
+        lw_device_enable_timestamps(device, device->get_time_ns, bps);
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_probe(lw_callback_device *device) {
+    LW_CHECK_SUCCESS(lw_grf250_initiate_serial(device))
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_product_name(&device->request))
+
+    if (device->serial_send(device, device->request.data, device->request.data_size) == 0) {
+        return LW_RESULT_ERROR;
+    }
+
+    return lw_wait_for_next_response(device, LW_GRF250_COMMAND_PRODUCT_NAME, LW_GRF250_PROBE_TIMEOUT_MS);
+}
+
+lw_result lw_grf250_find_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate *baud_rate) {
+    for (int32_t i = (int32_t)LW_GRF250_BAUD_RATE_COUNT - 1; i >= 0; --i) {
+        LW_CHECK_SUCCESS(lw_grf250_set_host_baud_rate(device, set_host_baud_rate, (lw_grf250_baud_rate)i))
+        lw_result result = lw_grf250_probe(device);
+
+        if (result == LW_RESULT_SUCCESS) {
+            LW_DEBUG_LVL_1("Found device at %u baud\n", lw_grf250_baud_rate_values[i]);
+            *baud_rate = (lw_grf250_baud_rate)i;
+            return LW_RESULT_SUCCESS;
+        }
+
+        if (result == LW_RESULT_ERROR) {
+            return LW_RESULT_ERROR;
+        }
+    }
+
+    LW_DEBUG_LVL_1("Device did not answer at any baud rate\n");
+    return LW_RESULT_TIMEOUT;
+}
+
+lw_result lw_grf250_soak_test(lw_callback_device *device) {
+    lw_device_stats *user_stats = device->stats;
+    lw_device_stats stats;
+    lw_device_enable_stats(device, &stats);
+
+    lw_result result = LW_RESULT_SUCCESS;
+    lw_grf250_config config;
+
+    for (uint32_t i = 0; i < LW_GRF250_SOAK_ROUNDS && result == LW_RESULT_SUCCESS; ++i) {
+        result = lw_grf250_get_config(device, &config);
+    }
+
+    device->stats = user_stats;
+
+    if (result != LW_RESULT_SUCCESS) {
+        return result;
+    }
+
+    uint32_t errors = stats.crc_errors + stats.payload_size_errors + stats.header_errors + stats.skipped_bytes + stats.timeouts;
+
+    if (errors != 0) {
+        LW_DEBUG_LVL_1("Soak test failed with %u errors\n", errors);
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_switch_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate baud_rate) {
+    if (lw_grf250_baud_rate_to_bps(baud_rate) == 0) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    LW_DEBUG_LVL_1("Switching to %u baud\n", lw_grf250_baud_rate_to_bps(baud_rate));
+    LW_CHECK_SUCCESS(lw_grf250_set_baud_rate(device, baud_rate))
+    LW_CHECK_SUCCESS(lw_grf250_save_parameters(device))
+    LW_CHECK_SUCCESS(lw_grf250_reset(device))
+    LW_CHECK_SUCCESS(lw_grf250_set_host_baud_rate(device, set_host_baud_rate, baud_rate))
+    lw_device_reset_rtt(device);
+
+    uint32_t end_time = device->get_time_ms(device) + LW_GRF250_BOOT_TIMEOUT_MS;
+
+    while ((int32_t)(end_time - device->get_time_ms(device)) > 0) {
+        lw_result result = lw_grf250_probe(device);
+
+        if (result != LW_RESULT_TIMEOUT) {
+            return result;
+        }
+    }
+
+    return LW_RESULT_TIMEOUT;
+}
+
+lw_result lw_grf250_negotiate_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate max_baud_rate, lw_grf250_baud_rate *baud_rate) {
+    if (lw_grf250_baud_rate_to_bps(max_baud_rate) == 0) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    lw_grf250_baud_rate stable_baud_rate = LW_GRF250_BAUD_9600;
+    LW_CHECK_SUCCESS(lw_grf250_find_baud_rate(device, set_host_baud_rate, &stable_baud_rate))
+
+    // Step down from a found rate that is not clean.
+    while (lw_grf250_soak_test(device) != LW_RESULT_SUCCESS) {
+        if (stable_baud_rate == LW_GRF250_BAUD_9600) {
+            return LW_RESULT_ERROR;
+        }
+
+        stable_baud_rate = (lw_grf250_baud_rate)(stable_baud_rate - 1);
+
+        // NOTE: Rates that already failed are not tried again on the way up.
+        if (max_baud_rate > stable_baud_rate) {
+            max_baud_rate = stable_baud_rate;
+        }
+
+        LW_CHECK_SUCCESS(lw_grf250_switch_baud_rate(device, set_host_baud_rate, stable_baud_rate))
+    }
+
+    for (uint32_t i = (uint32_t)stable_baud_rate + 1; i <= (uint32_t)max_baud_rate; ++i) {
+        lw_result result = lw_grf250_switch_baud_rate(device, set_host_baud_rate, (lw_grf250_baud_rate)i);
+
+        if (result == LW_RESULT_SUCCESS) {
+            result = lw_grf250_soak_test(device);
+        }
+
+        if (result == LW_RESULT_SUCCESS) {
+            stable_baud_rate = (lw_grf250_baud_rate)i;
+            continue;
+        }
+
+        LW_DEBUG_LVL_1("Falling back to %u baud\n", lw_grf250_baud_rate_to_bps(stable_baud_rate));
+
+        // NOTE: The step can fail on either side of the restart, so the device
+        // is found again if it does not answer at the new rate.
+        if (lw_grf250_switch_baud_rate(device, set_host_baud_rate, stable_baud_rate) != LW_RESULT_SUCCESS) {
+            lw_grf250_baud_rate found_baud_rate = stable_baud_rate;
+            LW_CHECK_SUCCESS(lw_grf250_find_baud_rate(device, set_host_baud_rate, &found_baud_rate))
+
+            if (found_baud_rate != stable_baud_rate) {
+                LW_CHECK_SUCCESS(lw_grf250_switch_baud_rate(device, set_host_baud_rate, stable_baud_rate))
+            }
+        }
+
+        break;
+    }
+
+    *baud_rate = stable_baud_rate;
+
+    return LW_RESULT_SUCCESS;
+}
+
+// ----------------------------------------------------------------------------
+// Session resume.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_grf250_product_info product_info;
+    lw_grf_distance_config distance_config;
+    lw_grf250_stream stream;
+} lw_grf250_session_state;
+
+static void lw_grf250_session_state_callback(lw_callback_device *device, lw_response *response, void *user_data) {
+    lw_grf250_session_state *state = (lw_grf250_session_state *)user_data;
+
+    switch (response->command_id) {
+        case LW_GRF250_COMMAND_DISTANCE_CONFIG: {
+            lw_grf250_parse_response_distance_config(response, &state->distance_config);
+            break;
+        }
+
+        case LW_GRF250_COMMAND_STREAM: {
+            lw_grf250_parse_response_stream(response, &state->stream);
+            break;
+        }
+
+        default: {
+            lw_grf250_product_info_callback(device, response, &state->product_info);
+            break;
+        }
+    }
+}
+
+void lw_grf250_init_session(lw_grf250_session *session, lw_grf_distance_config distance_config, lw_grf250_stream stream) {
+    memset(session, 0, sizeof(*session));
+    session->distance_config = distance_config;
+    session->stream = stream;
+}
+
+lw_result lw_grf250_resume_session(lw_callback_device *device, lw_grf250_session *session) {
+    lw_request request;
+    lw_request_batch batch;
+    lw_grf250_session_state state;
+    uint32_t packets = 0;
+
+    lw_init_request_batch(&batch);
+    memset(&state, 0, sizeof(state));
+    session->steps = 0;
+
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_serial_number(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_distance_config(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+    LW_CHECK_SUCCESS(lw_grf250_create_request_read_stream(&request))
+    LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+
+    // NOTE: A session that never connected is most likely meeting a device
+    // that just started, so serial mode is initiated up front instead of
+    // waiting for the probe to time out. The product info is read with the
+    // same batch.
+    if (!session->product_info_valid) {
+        LW_CHECK_SUCCESS(lw_grf250_create_request_read_product_name(&request))
+        LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+        LW_CHECK_SUCCESS(lw_grf250_create_request_read_hardware_version(&request))
+        LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+        LW_CHECK_SUCCESS(lw_grf250_create_request_read_firmware_version(&request))
+        LW_CHECK_SUCCESS(lw_request_batch_add(&batch, &request))
+
+        LW_CHECK_SUCCESS(lw_grf250_initiate_serial(device))
+        session->steps |= LW_GRF250_RESUME_INITIATED;
+    }
+
+    lw_result probe_result = lw_send_batch_once(device, &batch, &lw_grf250_session_state_callback, &state, LW_GRF250_PROBE_TIMEOUT_MS, &packets);
+
+    if (probe_result == LW_RESULT_ERROR) {
+        return LW_RESULT_ERROR;
+    }
+
+    if (probe_result != LW_RESULT_SUCCESS) {
+        // NOTE: Any packet, even a streamed one, means the device is already
+        // in serial mode and was only slow to answer.
+        if (packets == 0 && (session->steps & LW_GRF250_RESUME_INITIATED) == 0) {
+            LW_DEBUG_LVL_2("Device did not answer, initiating serial mode\n");
+            LW_CHECK_SUCCESS(lw_grf250_initiate_serial(device))
+            session->steps |= LW_GRF250_RESUME_INITIATED;
+        }
+
+        LW_CHECK_SUCCESS(lw_send_batch_get_responses(device, &batch, &lw_grf250_session_state_callback, &state))
+    }
+
+    if (!session->product_info_valid) {
+        state.product_info.firmware_version = lw_expand_firmware_version(state.product_info.firmware_version_int);
+        session->product_info = state.product_info;
+        session->product_info_valid = 1;
+        session->steps |= LW_GRF250_RESUME_PRODUCT_INFO;
+    } else if (memcmp(session->product_info.serial_number, state.product_info.serial_number, sizeof(state.product_info.serial_number)) != 0) {
+        // A different device answered on the same port.
+        session->product_info_valid = 0;
+        LW_CHECK_SUCCESS(lw_grf250_get_product_info(device, &session->product_info))
+        session->product_info_valid = 1;
+        session->steps |= LW_GRF250_RESUME_PRODUCT_INFO;
+    }
+
+    lw_grf250_config config;
+    memset(&config, 0, sizeof(config));
+    config.distance_config = session->distance_config;
+    config.stream = session->stream;
+
+    uint32_t fields = 0;
+    fields |= (state.distance_config != session->distance_config) ? LW_GRF250_CONFIG_DISTANCE_CONFIG : 0;
+    fields |= (state.stream != session->stream) ? LW_GRF250_CONFIG_STREAM : 0;
+
+    // NOTE: The distance config is written first, so a restored stream
+    // starts with the right layout.
+    if (fields != 0) {
+        LW_CHECK_SUCCESS(lw_grf250_set_config(device, &config, fields))
+        session->steps |= (fields & LW_GRF250_CONFIG_DISTANCE_CONFIG) ? LW_GRF250_RESUME_DISTANCE_CONFIG : 0;
+        session->steps |= (fields & LW_GRF250_CONFIG_STREAM) ? LW_GRF250_RESUME_STREAM : 0;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
@@ -74,6 +74,60 @@ extern "C" {
 #define LW_GRF250_COMMAND_LED_STATE 110
 #define LW_GRF250_COMMAND_ZERO_OFFSET 114
 
+// ----------------------------------------------------------------------------
+// Response data sizes.
+//
+// The number of data bytes after the command ID in each response, which is
+// the same for reads and for the echo of a write. Distance data holds an
+// int32 for each field in the distance config, so its size is a maximum.
+// ----------------------------------------------------------------------------
+#define LW_GRF250_RESPONSE_SIZE_PRODUCT_NAME 16
+#define LW_GRF250_RESPONSE_SIZE_HARDWARE_VERSION 4
+#define LW_GRF250_RESPONSE_SIZE_FIRMWARE_VERSION 4
+#define LW_GRF250_RESPONSE_SIZE_SERIAL_NUMBER 16
+#define LW_GRF250_RESPONSE_SIZE_USER_DATA 16
+#define LW_GRF250_RESPONSE_SIZE_TOKEN 2
+#define LW_GRF250_RESPONSE_SIZE_SAVE_PARAMETERS 2
+#define LW_GRF250_RESPONSE_SIZE_RESET 2
+#define LW_GRF250_RESPONSE_SIZE_DISTANCE_CONFIG 4
+#define LW_GRF250_RESPONSE_SIZE_STREAM 4
+#define LW_GRF250_RESPONSE_SIZE_DISTANCE_DATA 32
+#define LW_GRF250_RESPONSE_SIZE_MULTI_DATA 44
+#define LW_GRF250_RESPONSE_SIZE_LASER_FIRING 1
+#define LW_GRF250_RESPONSE_SIZE_TEMPERATURE 4
+#define LW_GRF250_RESPONSE_SIZE_AUTO_EXPOSURE 1
+#define LW_GRF250_RESPONSE_SIZE_UPDATE_RATE 4
+#define LW_GRF250_RESPONSE_SIZE_ALARM_STATUS 4
+#define LW_GRF250_RESPONSE_SIZE_ALARM_RETURN_MODE 1
+#define LW_GRF250_RESPONSE_SIZE_LOST_SIGNAL_COUNTER 4
+#define LW_GRF250_RESPONSE_SIZE_ALARM_A_DISTANCE 4
+#define LW_GRF250_RESPONSE_SIZE_ALARM_B_DISTANCE 4
+#define LW_GRF250_RESPONSE_SIZE_ALARM_HYSTERESIS 4
+#define LW_GRF250_RESPONSE_SIZE_GPIO_MODE 1
+#define LW_GRF250_RESPONSE_SIZE_GPIO_ALARM_CONFIRM_COUNT 4
+#define LW_GRF250_RESPONSE_SIZE_MEDIAN_FILTER_ENABLE 1
+#define LW_GRF250_RESPONSE_SIZE_MEDIAN_FILTER_SIZE 4
+#define LW_GRF250_RESPONSE_SIZE_SMOOTH_FILTER_ENABLE 1
+#define LW_GRF250_RESPONSE_SIZE_SMOOTH_FILTER_FACTOR 4
+#define LW_GRF250_RESPONSE_SIZE_BAUD_RATE 1
+#define LW_GRF250_RESPONSE_SIZE_I2C_ADDRESS 1
+#define LW_GRF250_RESPONSE_SIZE_ROLLING_AVERAGE_ENABLE 1
+#define LW_GRF250_RESPONSE_SIZE_ROLLING_AVERAGE_SIZE 4
+#define LW_GRF250_RESPONSE_SIZE_SLEEP 1
+#define LW_GRF250_RESPONSE_SIZE_LED_STATE 1
+#define LW_GRF250_RESPONSE_SIZE_ZERO_OFFSET 4
+
+// Multi data is the largest response.
+#define LW_GRF250_RESPONSE_SIZE_MAX LW_GRF250_RESPONSE_SIZE_MULTI_DATA
+#define LW_GRF250_RESPONSE_SIZE_UNKNOWN UINT32_MAX
+
+// A full packet: start byte, flags, command ID, data and CRC.
+#define LW_GRF250_RESPONSE_PACKET_SIZE (LW_GRF250_RESPONSE_SIZE_MAX + 6)
+
+#if LW_PACKET_RECV_SIZE < LW_GRF250_RESPONSE_PACKET_SIZE
+#error "LW_PACKET_RECV_SIZE is too small for GRF250 responses"
+#endif
+
 // ----------------------------------------------------------------------------
 // Per-command types.
 // ----------------------------------------------------------------------------
@@ -140,6 +194,9 @@ typedef struct {
 
     int32_t temperature;
     int32_t alarm_status;
+
+    // The start_time_ns of the response the sample was decoded from.
+    uint64_t timestamp_ns;
 } lw_grf250_distance_data;
 
 typedef struct {
@@ -150,6 +207,9 @@ typedef struct {
 typedef struct {
     lw_grf250_multi_data_signal signals[5];
     int32_t temperature;
+
+    // The start_time_ns of the response the sample was decoded from.
+    uint64_t timestamp_ns;
 } lw_grf250_multi_data;
 
 typedef struct {
@@ -157,6 +217,79 @@ typedef struct {
     uint8_t alarm_b;
 } lw_grf250_alarm_status;
 
+// The persistable and runtime configuration of the device, as read by
+// lw_grf250_get_config.
+typedef struct {
+    lw_grf_distance_config distance_config;
+    lw_grf250_stream stream;
+    lw_grf250_enable laser_firing;
+    lw_grf250_enable auto_exposure;
+    uint32_t update_rate;
+    lw_grf250_return_mode alarm_return_mode;
+    uint32_t lost_signal_counter;
+    uint32_t alarm_a_distance_cm;
+    uint32_t alarm_b_distance_cm;
+    uint32_t alarm_hysteresis_cm;
+    lw_grf250_gpio_mode gpio_mode;
+    uint32_t gpio_alarm_confirm_count;
+    lw_grf250_enable median_filter_enable;
+    uint32_t median_filter_size;
+    lw_grf250_enable smooth_filter_enable;
+    uint32_t smooth_filter_factor;
+    lw_grf250_baud_rate baud_rate;
+    uint8_t i2c_address;
+    lw_grf250_enable rolling_average_enable;
+    uint32_t rolling_average_size;
+    lw_grf250_enable led_state;
+    int32_t zero_offset_cm;
+} lw_grf250_config;
+
+// A bit for each field of lw_grf250_config, as returned by lw_grf250_config_diff.
+#define LW_GRF250_CONFIG_DISTANCE_CONFIG (1 << 0)
+#define LW_GRF250_CONFIG_STREAM (1 << 1)
+#define LW_GRF250_CONFIG_LASER_FIRING (1 << 2)
+#define LW_GRF250_CONFIG_AUTO_EXPOSURE (1 << 3)
+#define LW_GRF250_CONFIG_UPDATE_RATE (1 << 4)
+#define LW_GRF250_CONFIG_ALARM_RETURN_MODE (1 << 5)
+#define LW_GRF250_CONFIG_LOST_SIGNAL_COUNTER (1 << 6)
+#define LW_GRF250_CONFIG_ALARM_A_DISTANCE (1 << 7)
+#define LW_GRF250_CONFIG_ALARM_B_DISTANCE (1 << 8)
+#define LW_GRF250_CONFIG_ALARM_HYSTERESIS (1 << 9)
+#define LW_GRF250_CONFIG_GPIO_MODE (1 << 10)
+#define LW_GRF250_CONFIG_GPIO_ALARM_CONFIRM_COUNT (1 << 11)
+#define LW_GRF250_CONFIG_MEDIAN_FILTER_ENABLE (1 << 12)
+#define LW_GRF250_CONFIG_MEDIAN_FILTER_SIZE (1 << 13)
+#define LW_GRF250_CONFIG_SMOOTH_FILTER_ENABLE (1 << 14)
+#define LW_GRF250_CONFIG_SMOOTH_FILTER_FACTOR (1 << 15)
+#define LW_GRF250_CONFIG_BAUD_RATE (1 << 16)
+#define LW_GRF250_CONFIG_I2C_ADDRESS (1 << 17)
+#define LW_GRF250_CONFIG_ROLLING_AVERAGE_ENABLE (1 << 18)
+#define LW_GRF250_CONFIG_ROLLING_AVERAGE_SIZE (1 << 19)
+#define LW_GRF250_CONFIG_LED_STATE (1 << 20)
+#define LW_GRF250_CONFIG_ZERO_OFFSET (1 << 21)
+#define LW_GRF250_CONFIG_ALL (0x3FFFFF)
+#define LW_GRF250_CONFIG_FIELD_COUNT 22
+
+// A shadow copy of the device configuration.
+//
+// Edit the fields of 'config' and lw_grf250_config_cache_apply writes only
+// the fields that differ from 'device_config', the values last read from or
+// written to the device.
+//
+// Once attached to the device with lw_grf250_config_cache_attach, the managed
+// setters keep the cache up to date and the managed getters of configuration
+// fields answer from 'device_config' without a round trip.
+typedef struct {
+    lw_grf250_config config;
+    lw_grf250_config device_config;
+
+    // The LW_GRF250_CONFIG_... bits of the fields 'device_config' holds.
+    uint32_t valid_fields;
+
+    // NOTE: Used internally while attached.
+    lw_response_tap tap;
+} lw_grf250_config_cache;
+
 // ----------------------------------------------------------------------------
 // Fully managed request/response commands.
 //
@@ -236,7 +369,8 @@ lw_result lw_grf250_set_user_data(lw_callback_device *device, uint8_t *data, uin
 lw_result lw_grf250_get_token(lw_callback_device *device, uint16_t *token);
 
 /*
- * Save the current persistable device parameters.
+ * Save the current persistable device parameters. The save takes longer than
+ * the adaptive response timeout allows for, see lw_grf250_get_command_timeout.
  *
  * @param device Connected device.
  * @param token The latest unused safety token.
@@ -763,6 +897,102 @@ lw_result lw_grf250_initiate_serial(lw_callback_device *device);
  */
 lw_result lw_grf250_get_product_info(lw_callback_device *device, lw_grf250_product_info *product_info);
 
+/*
+ * Get a snapshot of the entire device configuration. The values are read
+ * with batched requests, so only a few round trips are needed.
+ *
+ * @param device Connected device.
+ * @param config Device configuration.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_get_config(lw_callback_device *device, lw_grf250_config *config);
+
+/*
+ * Write the selected fields of a configuration with batched requests.
+ *
+ * @param device Connected device.
+ * @param config Device configuration. Every field written is updated with the
+ *        value the device responded with, which can differ by rounding.
+ * @param fields The LW_GRF250_CONFIG_... bits of the fields to write.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_set_config(lw_callback_device *device, lw_grf250_config *config, uint32_t fields);
+
+/*
+ * Compare two configurations.
+ *
+ * @param a The first configuration.
+ * @param b The second configuration.
+ * @return The LW_GRF250_CONFIG_... bits of the fields that differ.
+ */
+uint32_t lw_grf250_config_diff(const lw_grf250_config *a, const lw_grf250_config *b);
+
+/*
+ * Get the command ID of a configuration field, such as for building
+ * configuration requests with lw_grf250_create_request_write_config.
+ *
+ * @param index The bit index of the LW_GRF250_CONFIG_... field, eg: 4 for
+ *        LW_GRF250_CONFIG_UPDATE_RATE, below LW_GRF250_CONFIG_FIELD_COUNT.
+ * @return The command ID, or 0 if the index is out of range.
+ */
+uint8_t lw_grf250_get_config_command(uint32_t index);
+
+/*
+ * Fill a configuration cache from the device, usually once after connecting.
+ *
+ * @param device Connected device.
+ * @param cache The cache to fill.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_config_cache_load(lw_callback_device *device, lw_grf250_config_cache *cache);
+
+/*
+ * Get the fields of the cached configuration that have changed since they
+ * were last read from or written to the device.
+ *
+ * @param cache The cache.
+ * @return The LW_GRF250_CONFIG_... bits of the changed fields.
+ */
+uint32_t lw_grf250_config_cache_dirty(const lw_grf250_config_cache *cache);
+
+/*
+ * Write only the changed fields of the cached configuration to the device.
+ * Does nothing if no fields have changed.
+ *
+ * @param device Connected device.
+ * @param cache The cache.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure. Fields
+ *         that were written before a failure are no longer dirty.
+ */
+lw_result lw_grf250_config_cache_apply(lw_callback_device *device, lw_grf250_config_cache *cache);
+
+/*
+ * Keep a configuration cache in step with every config value the device
+ * responds with, whether to a managed setter, a batch or an asynchronous
+ * request. 'device_config' always takes the new value, 'config' only takes it
+ * if the field has no pending change, so a later apply still writes the
+ * change. A reset invalidates the whole cache.
+ *
+ * While attached, the managed getters of the configuration fields in
+ * 'valid_fields' return the cached value instead of reading the device.
+ * Only one cache can be attached to a device at a time.
+ *
+ * The cache is added as a response tap, alongside any other taps.
+ *
+ * @param device The callback device.
+ * @param cache The cache, filled with lw_grf250_config_cache_load or zero
+ *        initialized, in which case the fields are cached as they are read.
+ */
+void lw_grf250_config_cache_attach(lw_callback_device *device, lw_grf250_config_cache *cache);
+
+/*
+ * Stop keeping a configuration cache in step with the device.
+ *
+ * @param device The callback device.
+ * @param cache The attached cache.
+ */
+void lw_grf250_config_cache_detach(lw_callback_device *device, lw_grf250_config_cache *cache);
+
 /*
  * Puts the device into sleep mode. This mode is only available in serial
  * UART communication mode. The device is then awakened by any activity on the
@@ -783,7 +1013,8 @@ lw_result lw_grf250_sleep(lw_callback_device *device);
 lw_result lw_grf250_reset(lw_callback_device *device);
 
 /*
- * Save the current persistable device parameters.
+ * Save the current persistable device parameters. The save takes longer than
+ * the adaptive response timeout allows for, see lw_grf250_get_command_timeout.
  *
  * @param device Connected device.
  * @return LW_RESULT_SUCCESS on success, or an error code on failure.
@@ -800,6 +1031,8 @@ lw_result lw_grf250_save_parameters(lw_callback_device *device);
  * either LW_RESULT_SUCCESS if distance data response is available, or
  * LW_RESULT_AGAIN if it is still building a response.
  *
+ * Samples held in the device stream queue are returned first.
+ *
  * @param device Connected device.
  * @param distance_data Distance data.
  * @param config Distance configuration.
@@ -819,6 +1052,8 @@ lw_result lw_grf250_wait_for_streamed_distance(lw_callback_device *device, lw_gr
  * either LW_RESULT_SUCCESS if distance data response is available, or
  * LW_RESULT_AGAIN if it is still building a response.
  *
+ * Samples held in the device stream queue are returned first.
+ *
  * @param device Connected device.
  * @param multi_data Multi data.
  * @return LW_RESULT_SUCCESS on success, or an error code on failure, or
@@ -897,6 +1132,16 @@ lw_result lw_grf250_create_request_write_led_state(lw_request *request, lw_grf25
 lw_result lw_grf250_create_request_read_zero_offset(lw_request *request);
 lw_result lw_grf250_create_request_write_zero_offset(lw_request *request, int32_t offset_cm);
 
+/*
+ * Create a write request for one field of a configuration.
+ *
+ * @param request The request to create.
+ * @param config The configuration holding the value to write.
+ * @param command_id The command ID of the field, eg: LW_GRF250_COMMAND_UPDATE_RATE.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_create_request_write_config(lw_request *request, const lw_grf250_config *config, uint8_t command_id);
+
 // ----------------------------------------------------------------------------
 // Response parsers.
 // These functions extract information from responses sent by the device.
@@ -940,6 +1185,323 @@ lw_result lw_grf250_parse_response_rolling_average_size(lw_response *response, u
 lw_result lw_grf250_parse_response_led_state(lw_response *response, lw_grf250_enable *enable);
 lw_result lw_grf250_parse_response_zero_offset(lw_response *response, int32_t *offset);
 
+/*
+ * Parse any configuration response into the matching field of a configuration.
+ *
+ * @param response The response to parse.
+ * @param config The configuration to update.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INCORRECT_COMMAND_ID if
+ *         the response is not a configuration command.
+ */
+lw_result lw_grf250_parse_response_config(lw_response *response, lw_grf250_config *config);
+
+/*
+ * Get the number of data bytes in a response.
+ *
+ * @param command_id The command ID of the response.
+ * @return One of the LW_GRF250_RESPONSE_SIZE_... values, or LW_GRF250_RESPONSE_SIZE_UNKNOWN for an unknown command ID.
+ */
+uint32_t lw_grf250_get_response_data_size(uint8_t command_id);
+
+/*
+ * Check that a response header names a GRF250 command with the expected
+ * payload size. Set it as the header check of a response so noise that
+ * happens to contain a start byte is rejected as soon as the command ID
+ * arrives, rather than after the CRC, eg:
+ * lw_response_set_header_check(&device.response, &lw_grf250_check_response_header);
+ *
+ * @param command_id The command ID of the response.
+ * @param payload_size The payload size from the header, including the command ID.
+ * @return LW_RESULT_SUCCESS if the header is plausible, otherwise LW_RESULT_ERROR.
+ */
+lw_result lw_grf250_check_response_header(uint8_t command_id, uint32_t payload_size);
+
+// Saving parameters writes to flash, which takes much longer than the round
+// trip the adaptive response timeout is based on.
+#ifndef LW_GRF250_SAVE_TIMEOUT_MS
+#define LW_GRF250_SAVE_TIMEOUT_MS 1000
+#endif
+
+/*
+ * Get the fixed response timeout of the GRF250 commands that are slower than
+ * a round trip. Set it as the command timeout of a device so saving
+ * parameters and resetting are not cut short, eg:
+ * lw_device_set_command_timeout(&device, &lw_grf250_get_command_timeout);
+ *
+ * @param command_id The command ID of the request.
+ * @return LW_GRF250_SAVE_TIMEOUT_MS for save parameters and reset, otherwise
+ *         0 to use the adaptive timeout.
+ */
+uint32_t lw_grf250_get_command_timeout(uint8_t command_id);
+
+// ----------------------------------------------------------------------------
+// Distance data decoding.
+//
+// A decoder is created once for a distance config, usually when the stream
+// is started, so the fields present in the packet do not have to be worked
+// out again for every packet. The common LW_GRF250_DISTANCE_CONFIG_ALL layout
+// is decoded with a fully unrolled path.
+//
+// Decoding can also append straight into a struct-of-arrays batch, where
+// each field has its own column. This suits filtering and bulk processing
+// of many samples.
+// ----------------------------------------------------------------------------
+#define LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_RAW 0
+#define LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_FILTERED 1
+#define LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_STRENGTH 2
+#define LW_GRF250_DISTANCE_FIELD_LAST_RETURN_RAW 3
+#define LW_GRF250_DISTANCE_FIELD_LAST_RETURN_FILTERED 4
+#define LW_GRF250_DISTANCE_FIELD_LAST_RETURN_STRENGTH 5
+#define LW_GRF250_DISTANCE_FIELD_TEMPERATURE 6
+#define LW_GRF250_DISTANCE_FIELD_ALARM_STATUS 7
+#define LW_GRF250_DISTANCE_FIELD_COUNT 8
+
+typedef struct {
+    lw_grf_distance_config config;
+    uint32_t field_count;
+    uint8_t fields[LW_GRF250_DISTANCE_FIELD_COUNT];
+} lw_grf250_distance_decoder;
+
+// Struct-of-arrays distance samples. Each column is indexed by a
+// LW_GRF250_DISTANCE_FIELD_... value and holds capacity samples, set a
+// column to NULL to skip that field. Fields missing from the distance config
+// are written as 0 so the columns stay aligned. The sample timestamps are
+// written to timestamps_ns unless it is NULL.
+typedef struct {
+    int32_t *columns[LW_GRF250_DISTANCE_FIELD_COUNT];
+    uint64_t *timestamps_ns;
+    uint32_t capacity;
+    uint32_t count;
+} lw_grf250_distance_batch;
+
+/*
+ * Create a decoder for a distance config.
+ *
+ * @param config The distance config the device is streaming with.
+ * @return The decoder.
+ */
+lw_grf250_distance_decoder lw_grf250_create_distance_decoder(lw_grf_distance_config config);
+
+/*
+ * Decode a distance data response. Gives the same result as
+ * lw_grf250_parse_response_distance_data with the decoder's config.
+ *
+ * @param decoder The decoder.
+ * @param response The response to decode.
+ * @param distance_data Distance data. Fields missing from the config are not written.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_decode_distance_data(const lw_grf250_distance_decoder *decoder, lw_response *response, lw_grf250_distance_data *distance_data);
+
+/*
+ * Decode a distance data response and append it to a batch.
+ *
+ * @param decoder The decoder.
+ * @param response The response to decode.
+ * @param batch The batch to append to.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_AGAIN if the batch is full,
+ *         or an error code on failure.
+ */
+lw_result lw_grf250_decode_distance_data_batch(const lw_grf250_distance_decoder *decoder, lw_response *response, lw_grf250_distance_batch *batch);
+
+// ----------------------------------------------------------------------------
+// Sample period estimation.
+//
+// Tracks the period and jitter of streamed samples from their timestamps, and
+// gives a smoothed timestamp for each sample on the device's own time line.
+//
+// Transport only ever delays a sample, so the estimate follows early samples
+// straight away and late samples slowly. Samples lost in between are counted
+// as whole periods.
+// ----------------------------------------------------------------------------
+typedef struct {
+    uint32_t count;
+    int64_t period_ns;
+    int64_t jitter_ns;
+
+    // NOTE: Used internally to track the sample time line.
+    uint64_t line_time_ns;
+    int64_t delay_ns;
+} lw_grf250_period_estimator;
+
+/*
+ * Initialize a period estimator.
+ *
+ * @param estimator The estimator to initialize.
+ * @param update_rate The configured update rate in Hz, or 0 to measure the
+ *        initial period from the first two samples.
+ */
+void lw_grf250_init_period_estimator(lw_grf250_period_estimator *estimator, uint32_t update_rate);
+
+/*
+ * Add a sample timestamp to a period estimator.
+ *
+ * @param estimator The estimator.
+ * @param timestamp_ns The sample timestamp in nanoseconds.
+ * @return The smoothed sample timestamp in nanoseconds.
+ */
+uint64_t lw_grf250_period_estimator_add(lw_grf250_period_estimator *estimator, uint64_t timestamp_ns);
+
+// ----------------------------------------------------------------------------
+// Baud rate negotiation.
+//
+// Steps the device and the host port up together to the fastest baud rate
+// that passes a soak test, and falls back to the last good rate on errors.
+//
+// The device only applies a new baud rate after a restart, so every step
+// saves the persistable parameters and restarts the device. Any unsaved
+// parameter changes are saved with it, so negotiate before changing other
+// parameters. Streaming is stopped by the restart.
+// ----------------------------------------------------------------------------
+#ifndef LW_GRF250_PROBE_TIMEOUT_MS
+#define LW_GRF250_PROBE_TIMEOUT_MS 100
+#endif
+
+#ifndef LW_GRF250_BOOT_TIMEOUT_MS
+#define LW_GRF250_BOOT_TIMEOUT_MS 3000
+#endif
+
+// The number of full config reads that must complete without a single
+// discarded byte for a baud rate to be kept.
+#ifndef LW_GRF250_SOAK_ROUNDS
+#define LW_GRF250_SOAK_ROUNDS 8
+#endif
+
+/*
+ * Host baud rate callback. Switch the host side of the link to a new baud
+ * rate and discard any bytes received so far.
+ *
+ * @param device The callback device.
+ * @param baud_rate The baud rate in bits per second.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+typedef lw_result (*lw_grf250_callback_set_host_baud_rate)(lw_callback_device *device, uint32_t baud_rate);
+
+/*
+ * Get the bits per second for a baud rate.
+ *
+ * @param baud_rate The baud rate.
+ * @return The baud rate in bits per second, or 0 if it is not valid.
+ */
+uint32_t lw_grf250_baud_rate_to_bps(lw_grf250_baud_rate baud_rate);
+
+/*
+ * Check that the device answers at the current host baud rate. Initiates the
+ * serial interface and waits up to LW_GRF250_PROBE_TIMEOUT_MS for the product
+ * name, without retries.
+ *
+ * @param device Connected device.
+ * @return LW_RESULT_SUCCESS if the device answered, LW_RESULT_TIMEOUT if it
+ *         did not, or LW_RESULT_ERROR on a connection error.
+ */
+lw_result lw_grf250_probe(lw_callback_device *device);
+
+/*
+ * Find the baud rate the device is using by probing every rate from the
+ * fastest down. The host is left at the found rate.
+ *
+ * @param device Connected device.
+ * @param set_host_baud_rate The host baud rate callback.
+ * @param baud_rate The found baud rate is written here.
+ * @return LW_RESULT_SUCCESS on success, or an error code if the device did
+ *         not answer at any rate.
+ */
+lw_result lw_grf250_find_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate *baud_rate);
+
+/*
+ * Read the full config LW_GRF250_SOAK_ROUNDS times and check that no bytes
+ * were discarded and no request timed out. A stats block attached to the
+ * device does not see the soak test.
+ *
+ * @param device Connected device.
+ * @return LW_RESULT_SUCCESS if the link is clean, or an error code on failure.
+ */
+lw_result lw_grf250_soak_test(lw_callback_device *device);
+
+/*
+ * Move the device and the host to a new baud rate. The device is restarted
+ * and probed until it answers at the new rate, for up to
+ * LW_GRF250_BOOT_TIMEOUT_MS.
+ *
+ * @param device Connected device.
+ * @param set_host_baud_rate The host baud rate callback.
+ * @param baud_rate The new baud rate.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_switch_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate baud_rate);
+
+/*
+ * Find the device, then step it up to the fastest baud rate, up to
+ * max_baud_rate, that passes lw_grf250_soak_test. A rate that fails is
+ * abandoned for the last good one, and a found rate that fails is stepped
+ * down until one passes.
+ *
+ * @param device Connected device.
+ * @param set_host_baud_rate The host baud rate callback.
+ * @param max_baud_rate The fastest baud rate to try.
+ * @param baud_rate The negotiated baud rate is written here.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_negotiate_baud_rate(lw_callback_device *device, lw_grf250_callback_set_host_baud_rate set_host_baud_rate, lw_grf250_baud_rate max_baud_rate, lw_grf250_baud_rate *baud_rate);
+
+// ----------------------------------------------------------------------------
+// Session resume.
+//
+// Connects to a device with as few round trips as possible, for startup and
+// for reconnecting after the link drops. The serial number, distance config
+// and stream are read with a single batch, which also shows whether the
+// device is already in serial mode: if it answers, or streams anything while
+// the batch is waiting, serial mode is not initiated again.
+//
+// A new session reads the product info with the same batch. It is then kept
+// in the session and only read again when the serial number changes, and the
+// distance config and stream are only written when the device differs from
+// the session.
+// ----------------------------------------------------------------------------
+
+// A bit for each step taken by the last lw_grf250_resume_session.
+#define LW_GRF250_RESUME_INITIATED (1 << 0)
+#define LW_GRF250_RESUME_PRODUCT_INFO (1 << 1)
+#define LW_GRF250_RESUME_DISTANCE_CONFIG (1 << 2)
+#define LW_GRF250_RESUME_STREAM (1 << 3)
+
+typedef struct {
+    // The distance config and stream the device is restored to. Update them
+    // when changing the device so a resume restores the current values.
+    lw_grf_distance_config distance_config;
+    lw_grf250_stream stream;
+
+    lw_grf250_product_info product_info;
+    uint8_t product_info_valid;
+
+    // The LW_GRF250_RESUME_... bits of the steps the last resume took.
+    uint32_t steps;
+} lw_grf250_session;
+
+/*
+ * Initialize a session that has not connected yet.
+ *
+ * @param session The session.
+ * @param distance_config The distance config to restore.
+ * @param stream The stream to restore.
+ */
+void lw_grf250_init_session(lw_grf250_session *session, lw_grf_distance_config distance_config, lw_grf250_stream stream);
+
+/*
+ * Connect to the device, or reconnect after the port has been opened again,
+ * and restore the session distance config and stream.
+ *
+ * The first batch waits up to LW_GRF250_PROBE_TIMEOUT_MS without retries,
+ * then it is sent again with the normal retries. A session that has connected
+ * before only initiates serial mode when nothing at all was received, a new
+ * session initiates it before the first batch.
+ *
+ * @param device Connected device.
+ * @param session The session. The product info is valid on success.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_grf250_resume_session(lw_callback_device *device, lw_grf250_session *session);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,1080 @@
+// Benchmarks of the protocol stack against a simulated GRF250.
+//
+// Microbenchmarks time the hot protocol functions in isolation. The end to
+// end benchmarks measure request round trip latency and the sustained stream
+// rate, first on the in-memory simulated device, which measures the stack on
+// its own, and then through each platform serial backend that can be paired
+// with the simulator.
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lw_serial_api_grf250.h"
+#include "lw_serial_api_grf250_alarm.h"
+#include "lw_serial_api_grf250_archive.h"
+#include "lw_serial_api_grf250_filter.h"
+#include "lw_serial_api_grf250_multi.h"
+#include "lw_serial_api_grf250_provision.h"
+#include "lw_serial_api_grf250_shared.h"
+#include "lw_sim_grf250.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+// NOTE: Results are folded in here so the compiler cannot drop the work.
+static volatile uint32_t bench_sink;
+
+// ----------------------------------------------------------------------------
+// Microbenchmarks.
+// ----------------------------------------------------------------------------
+#define BENCH_MIN_TIME_NS 200000000ull
+#define BENCH_STREAM_PACKETS 1024
+
+typedef void (*bench_function)(void *context, uint32_t iterations);
+
+typedef struct {
+    uint8_t packet[64];
+    uint32_t packet_size;
+    uint8_t stream[BENCH_STREAM_PACKETS * 64];
+    uint32_t stream_size;
+    lw_response response;
+    lw_grf250_distance_decoder decoder;
+} bench_context;
+
+// Run a function with a doubling number of iterations until it takes long
+// enough to time, and report the time per operation.
+static void bench_run(const char *name, bench_function function, void *context, uint32_t operations_per_iteration, uint32_t bytes_per_iteration) {
+    uint32_t iterations = 1;
+    uint64_t elapsed_ns = 0;
+
+    while (1) {
+        uint64_t start_ns = lw_platform_get_time_ns();
+        function(context, iterations);
+        elapsed_ns = lw_platform_get_time_ns() - start_ns;
+
+        if (elapsed_ns >= BENCH_MIN_TIME_NS || iterations >= (1u << 30)) {
+            break;
+        }
+
+        iterations *= 2;
+    }
+
+    double operations = (double)iterations * operations_per_iteration;
+    printf("  %-40s %10.2f ns/op", name, (double)elapsed_ns / operations);
+
+    if (bytes_per_iteration != 0) {
+        printf(" %10.2f MB/s", ((double)iterations * bytes_per_iteration) / ((double)elapsed_ns / 1000000000.0) / 1000000.0);
+    }
+
+    printf("\n");
+}
+
+static void bench_crc(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        bench_sink += lw_create_crc(bench->packet, (uint16_t)(bench->packet_size - 2));
+    }
+}
+
+static void bench_create_packet(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+    uint8_t packet[64];
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        bench_sink += lw_create_packet(packet, LW_GRF250_COMMAND_DISTANCE_DATA, 0, bench->packet + 4, bench->packet_size - 6);
+    }
+}
+
+static void bench_feed_response(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        for (uint32_t j = 0; j < bench->stream_size; ++j) {
+            if (lw_feed_response(&bench->response, bench->stream[j]) == LW_RESULT_SUCCESS) {
+                bench_sink += bench->response.command_id;
+            }
+        }
+    }
+}
+
+static void bench_feed_response_buffer(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        uint32_t offset = 0;
+
+        while (offset < bench->stream_size) {
+            uint32_t consumed = 0;
+
+            if (lw_feed_response_buffer(&bench->response, bench->stream + offset, bench->stream_size - offset, &consumed) == LW_RESULT_SUCCESS) {
+                bench_sink += bench->response.command_id;
+            }
+
+            offset += consumed;
+        }
+    }
+}
+
+static void bench_parse_distance_all(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+    lw_grf250_distance_data distance_data;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        lw_grf250_parse_response_distance_data(&bench->response, LW_GRF250_DISTANCE_CONFIG_ALL, &distance_data);
+        bench_sink += (uint32_t)distance_data.first_return_raw_mm;
+    }
+}
+
+static void bench_parse_distance_partial(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+    lw_grf250_distance_data distance_data;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        lw_grf250_parse_response_distance_data(&bench->response, bench->decoder.config, &distance_data);
+        bench_sink += (uint32_t)distance_data.first_return_raw_mm;
+    }
+}
+
+static void bench_decode_distance_partial(void *context, uint32_t iterations) {
+    bench_context *bench = (bench_context *)context;
+    lw_grf250_distance_data distance_data;
+
+    for (uint32_t i = 0; i < iterations; ++i) {
+        lw_grf250_decode_distance_data(&bench->decoder, &bench->response, &distance_data);
+        bench_sink += (uint32_t)distance_data.first_return_raw_mm;
+    }
+}
+
+// Parse a single packet into a response.
+static void bench_load_response_into(lw_response *response, const uint8_t *packet, uint32_t size) {
+    lw_init_response(response);
+
+    for (uint32_t i = 0; i < size; ++i) {
+        lw_feed_response(response, packet[i]);
+    }
+}
+
+static void bench_load_response(bench_context *bench, const uint8_t *packet, uint32_t size) {
+    bench_load_response_into(&bench->response, packet, size);
+}
+
+static void bench_micro(void) {
+    static bench_context bench;
+    int32_t fields[8] = {1234, 1230, 80, 1300, 1298, 40, 2500, 0};
+
+    bench.packet_size = lw_create_packet(bench.packet, LW_GRF250_COMMAND_DISTANCE_DATA, 0, (uint8_t *)fields, sizeof(fields));
+    bench.stream_size = 0;
+
+    for (uint32_t i = 0; i < BENCH_STREAM_PACKETS; ++i) {
+        memcpy(bench.stream + bench.stream_size, bench.packet, bench.packet_size);
+        bench.stream_size += bench.packet_size;
+    }
+
+    printf("Microbenchmarks, %u byte distance packets:\n", bench.packet_size);
+
+    bench_run("lw_create_crc", &bench_crc, &bench, 1, bench.packet_size - 2);
+    bench_run("lw_create_packet", &bench_create_packet, &bench, 1, bench.packet_size);
+
+    lw_init_response(&bench.response);
+    bench_run("lw_feed_response (per packet)", &bench_feed_response, &bench, BENCH_STREAM_PACKETS, bench.stream_size);
+    lw_init_response(&bench.response);
+    bench_run("lw_feed_response_buffer (per packet)", &bench_feed_response_buffer, &bench, BENCH_STREAM_PACKETS, bench.stream_size);
+
+    bench_load_response(&bench, bench.packet, bench.packet_size);
+    bench_run("lw_grf250_parse_response_distance_data", &bench_parse_distance_all, &bench, 1, 0);
+
+    // Two fields, so the generic decoder path is taken.
+    int32_t partial_fields[2] = {1234, 80};
+    uint8_t partial_packet[32];
+    uint32_t partial_size = lw_create_packet(partial_packet, LW_GRF250_COMMAND_DISTANCE_DATA, 0, (uint8_t *)partial_fields, sizeof(partial_fields));
+    bench.decoder = lw_grf250_create_distance_decoder(LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW | LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_STRENGTH);
+
+    bench_load_response(&bench, partial_packet, partial_size);
+    bench_run("  ... with 2 fields", &bench_parse_distance_partial, &bench, 1, 0);
+    bench_run("lw_grf250_decode_distance_data, 2 fields", &bench_decode_distance_partial, &bench, 1, 0);
+}
+
+#define BENCH_MULTI_SAMPLES 256
+
+typedef struct {
+    lw_response responses[BENCH_MULTI_SAMPLES];
+    float distance_m[BENCH_MULTI_SAMPLES * LW_GRF250_MULTI_SIGNAL_COUNT];
+    int32_t strength[BENCH_MULTI_SAMPLES * LW_GRF250_MULTI_SIGNAL_COUNT];
+    int32_t temperature[BENCH_MULTI_SAMPLES];
+    uint64_t timestamps_ns[BENCH_MULTI_SAMPLES];
+    lw_grf250_multi_batch batch;
+} bench_multi_context;
+
+// The per response path a caller would write without batches.
+static void bench_multi_parse(void *context, uint32_t iterations) {
+    bench_multi_context *bench = (bench_multi_context *)context;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        for (uint32_t i = 0; i < BENCH_MULTI_SAMPLES; ++i) {
+            lw_grf250_multi_data multi_data;
+            lw_grf250_parse_response_multi_data(&bench->responses[i], &multi_data);
+
+            for (uint32_t signal = 0; signal < LW_GRF250_MULTI_SIGNAL_COUNT; ++signal) {
+                uint32_t index = i * LW_GRF250_MULTI_SIGNAL_COUNT + signal;
+                bench->distance_m[index] = multi_data.signals[signal].strength < 20 ? NAN : (float)multi_data.signals[signal].distance_cm * 0.01f;
+                bench->strength[index] = multi_data.signals[signal].strength;
+            }
+
+            bench->temperature[i] = multi_data.temperature;
+            bench->timestamps_ns[i] = multi_data.timestamp_ns;
+        }
+
+        bench_sink += (uint32_t)bench->strength[iteration % BENCH_MULTI_SAMPLES];
+    }
+}
+
+static void bench_multi_batch(void *context, uint32_t iterations) {
+    bench_multi_context *bench = (bench_multi_context *)context;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        uint32_t consumed;
+        uint32_t kept;
+        bench->batch.count = 0;
+        lw_grf250_decode_multi_data_batch(&bench->batch, bench->responses, BENCH_MULTI_SAMPLES, &consumed);
+        lw_grf250_mask_multi_data_batch(&bench->batch, 20, &kept);
+        bench_sink += kept;
+    }
+}
+
+static void bench_multi_scale(void *context, uint32_t iterations) {
+    bench_multi_context *bench = (bench_multi_context *)context;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        lw_grf250_scale_distances(bench->strength, bench->distance_m, BENCH_MULTI_SAMPLES * LW_GRF250_MULTI_SIGNAL_COUNT);
+        bench_sink += (uint32_t)bench->distance_m[iteration % BENCH_MULTI_SAMPLES];
+    }
+}
+
+static void bench_multi(void) {
+    static bench_multi_context bench;
+
+    for (uint32_t i = 0; i < BENCH_MULTI_SAMPLES; ++i) {
+        int32_t fields[11];
+
+        for (uint32_t signal = 0; signal < LW_GRF250_MULTI_SIGNAL_COUNT; ++signal) {
+            fields[signal * 2] = (int32_t)(1000 + i * 10 + signal * 2500);
+            fields[signal * 2 + 1] = (int32_t)((i * 7 + signal * 13) % 100);
+        }
+
+        fields[10] = 2500;
+
+        uint8_t packet[64];
+        uint32_t packet_size = lw_create_packet(packet, LW_GRF250_COMMAND_MULTI_DATA, 0, (uint8_t *)fields, sizeof(fields));
+        bench_load_response_into(&bench.responses[i], packet, packet_size);
+    }
+
+    bench.batch.distance_m = bench.distance_m;
+    bench.batch.strength = bench.strength;
+    bench.batch.temperature = bench.temperature;
+    bench.batch.timestamps_ns = bench.timestamps_ns;
+    bench.batch.capacity = BENCH_MULTI_SAMPLES;
+
+    printf("Multi data, %u samples per batch, SIMD mode %d:\n", BENCH_MULTI_SAMPLES, LW_SIMD_MODE);
+
+    bench_run("parse and mask per response (per sample)", &bench_multi_parse, &bench, BENCH_MULTI_SAMPLES, 0);
+    bench_run("decode and mask batch (per sample)", &bench_multi_batch, &bench, BENCH_MULTI_SAMPLES, 0);
+    bench_run("lw_grf250_scale_distances (per value)", &bench_multi_scale, &bench, BENCH_MULTI_SAMPLES * LW_GRF250_MULTI_SIGNAL_COUNT, 0);
+}
+
+#define BENCH_FILTER_SAMPLES 4096
+
+typedef struct {
+    int32_t samples[BENCH_FILTER_SAMPLES];
+    lw_filter_stage stage;
+} bench_filter_context;
+
+static void bench_filter_update(void *context, uint32_t iterations) {
+    bench_filter_context *bench = (bench_filter_context *)context;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        for (uint32_t i = 0; i < BENCH_FILTER_SAMPLES; ++i) {
+            bench_sink += (uint32_t)lw_filter_update(&bench->stage, bench->samples[i]);
+        }
+    }
+}
+
+static void bench_filters(void) {
+    static bench_filter_context bench;
+    static lw_filter_median_entry median_entries[1001];
+    static int32_t mean_values[1001];
+    uint32_t random_state = 1;
+
+    // A noisy ramp, so the window contents keep changing order.
+    for (uint32_t i = 0; i < BENCH_FILTER_SAMPLES; ++i) {
+        random_state = random_state * 1664525 + 1013904223;
+        bench.samples[i] = (int32_t)(10000 + i + (random_state >> 24));
+    }
+
+    printf("Filters, per sample:\n");
+
+    const uint32_t windows[] = {5, 101, 1001};
+
+    for (uint32_t i = 0; i < sizeof(windows) / sizeof(windows[0]); ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "median, window %u", windows[i]);
+        lw_filter_init_median(&bench.stage, median_entries, windows[i]);
+        bench_run(name, &bench_filter_update, &bench, BENCH_FILTER_SAMPLES, 0);
+    }
+
+    lw_filter_init_mean(&bench.stage, mean_values, 1001);
+    bench_run("mean, window 1001", &bench_filter_update, &bench, BENCH_FILTER_SAMPLES, 0);
+    lw_filter_init_ema(&bench.stage, LW_FILTER_EMA_ALPHA(0.1));
+    bench_run("ema", &bench_filter_update, &bench, BENCH_FILTER_SAMPLES, 0);
+    lw_filter_init_gate(&bench.stage, 100, 5);
+    bench_run("gate", &bench_filter_update, &bench, BENCH_FILTER_SAMPLES, 0);
+}
+
+#define BENCH_SHARED_CAPACITY 1024
+#define BENCH_SHARED_SAMPLES 256
+
+typedef struct {
+    lw_grf250_shared_ring *ring;
+    lw_grf250_shared_reader reader;
+    lw_grf250_stream_sample sample;
+} bench_shared_context;
+
+static void bench_shared_publish(void *context, uint32_t iterations) {
+    bench_shared_context *bench = (bench_shared_context *)context;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        for (uint32_t i = 0; i < BENCH_SHARED_SAMPLES; ++i) {
+            lw_grf250_shared_ring_publish(bench->ring, &bench->sample);
+        }
+    }
+}
+
+static void bench_shared_publish_read(void *context, uint32_t iterations) {
+    bench_shared_context *bench = (bench_shared_context *)context;
+    lw_grf250_stream_sample sample;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        for (uint32_t i = 0; i < BENCH_SHARED_SAMPLES; ++i) {
+            lw_grf250_shared_ring_publish(bench->ring, &bench->sample);
+        }
+
+        while (lw_grf250_shared_reader_next(&bench->reader, &sample) == LW_RESULT_SUCCESS) {
+            bench_sink += (uint32_t)sample.data.distance_data.first_return_raw_mm;
+        }
+    }
+}
+
+static void bench_shared(void) {
+    static uint64_t memory[(sizeof(lw_grf250_shared_ring) + BENCH_SHARED_CAPACITY * sizeof(lw_grf250_shared_slot)) / sizeof(uint64_t) + 1];
+    static bench_shared_context bench;
+
+    bench.ring = (lw_grf250_shared_ring *)memory;
+    check_success(lw_grf250_shared_ring_init(bench.ring, BENCH_SHARED_CAPACITY), "Failed to init shared ring");
+    check_success(lw_grf250_shared_reader_init(&bench.reader, bench.ring, sizeof(memory)), "Failed to attach shared reader");
+
+    bench.sample.stream = LW_GRF250_STREAM_DISTANCE;
+    bench.sample.data.distance_data.first_return_raw_mm = 12345;
+
+    printf("Shared memory ring, per sample:\n");
+    bench_run("publish", &bench_shared_publish, &bench, BENCH_SHARED_SAMPLES, 0);
+
+    check_success(lw_grf250_shared_reader_init(&bench.reader, bench.ring, sizeof(memory)), "Failed to attach shared reader");
+    bench_run("publish and read in order", &bench_shared_publish_read, &bench, BENCH_SHARED_SAMPLES, 0);
+    printf("  %-40s %u lost\n", "Reader", bench.reader.lost);
+}
+
+// ----------------------------------------------------------------------------
+// End to end benchmarks.
+// ----------------------------------------------------------------------------
+#define BENCH_ROUND_TRIPS 20000
+
+static uint32_t bench_latencies_ns[BENCH_ROUND_TRIPS];
+
+static int bench_compare_uint32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a;
+    uint32_t y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+// Time blocking reads of the update rate, each a full request and response.
+static void bench_round_trip(lw_callback_device *device, uint32_t count) {
+    uint32_t failures = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t update_rate = 0;
+        uint64_t start_ns = lw_platform_get_time_ns();
+
+        if (lw_grf250_get_update_rate(device, &update_rate) != LW_RESULT_SUCCESS) {
+            failures += 1;
+        }
+
+        uint64_t elapsed_ns = lw_platform_get_time_ns() - start_ns;
+        bench_latencies_ns[i] = elapsed_ns > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed_ns;
+    }
+
+    qsort(bench_latencies_ns, count, sizeof(bench_latencies_ns[0]), &bench_compare_uint32);
+
+    uint64_t total_ns = 0;
+
+    for (uint32_t i = 0; i < count; ++i) {
+        total_ns += bench_latencies_ns[i];
+    }
+
+    printf("  %-40s min %9.2f us, mean %9.2f us, p50 %9.2f us, p99 %9.2f us, %u failed\n", "Round trip",
+           bench_latencies_ns[0] / 1000.0, (double)total_ns / count / 1000.0,
+           bench_latencies_ns[count / 2] / 1000.0, bench_latencies_ns[(count * 99) / 100] / 1000.0, failures);
+}
+
+// NOTE: The real device streams at up to 50 Hz and lw_grf250_set_update_rate
+// enforces that, the simulator takes any rate so the register is written
+// directly to stress the stack.
+static lw_result bench_set_update_rate(lw_callback_device *device, uint32_t update_rate) {
+    lw_create_request_write_uint32(&device->request, LW_GRF250_COMMAND_UPDATE_RATE, update_rate);
+    return lw_send_request_get_response(device);
+}
+
+typedef struct {
+    uint32_t received;
+    uint32_t missing;
+    uint64_t elapsed_ns;
+} bench_stream_result;
+
+// Stream distance data for a while and count the samples that arrived. The
+// simulator streams a sawtooth, so gaps in it are samples that were lost.
+// With a request interval a request is sent after every that many samples,
+// as configuration traffic would be.
+static bench_stream_result bench_stream(lw_callback_device *device, uint32_t update_rate, uint32_t max_samples, uint32_t max_time_ms, uint32_t request_interval) {
+    bench_stream_result result = {0};
+    int32_t last_distance = -1;
+
+    check_success(bench_set_update_rate(device, update_rate), "Failed to set update rate");
+    check_success(lw_grf250_set_stream(device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream");
+
+    uint64_t start_ns = lw_platform_get_time_ns();
+    uint64_t end_ns = start_ns + (uint64_t)max_time_ms * 1000000;
+
+    while (result.received < max_samples && lw_platform_get_time_ns() < end_ns) {
+        lw_grf250_distance_data distance_data;
+
+        if (lw_grf250_wait_for_streamed_distance(device, LW_GRF250_DISTANCE_CONFIG_ALL, &distance_data, 100) != LW_RESULT_SUCCESS) {
+            continue;
+        }
+
+        int32_t distance = distance_data.first_return_raw_mm / 100;
+
+        if (last_distance >= 0) {
+            result.missing += (uint32_t)((distance - last_distance - 1 + 1000) % 1000);
+        }
+
+        last_distance = distance;
+        result.received += 1;
+
+        if (request_interval != 0 && result.received % request_interval == 0) {
+            uint32_t current_rate;
+            lw_grf250_get_update_rate(device, &current_rate);
+        }
+    }
+
+    result.elapsed_ns = lw_platform_get_time_ns() - start_ns;
+    check_success(lw_grf250_set_stream(device, LW_GRF250_STREAM_NONE), "Failed to stop stream");
+
+    return result;
+}
+
+static void bench_print_stream(const char *name, bench_stream_result result) {
+    printf("  %-40s %9u samples, %8.0f samples/s, %u missing\n", name, result.received,
+           result.received / ((double)result.elapsed_ns / 1000000000.0), result.missing);
+}
+
+static void bench_in_memory(void) {
+    static lw_sim_device sim_device;
+    lw_device_stats stats;
+
+    printf("In-memory simulated device:\n");
+
+    lw_sim_create_device(&sim_device, 1);
+    bench_round_trip(&sim_device.device, BENCH_ROUND_TRIPS);
+
+    // NOTE: The simulated clock jumps to each sample, so this is the rate
+    // the stack can parse at rather than a rate of the simulated device.
+    bench_print_stream("Stream, maximum rate", bench_stream(&sim_device.device, 10000, 1000000, 5000, 0));
+
+    printf("In-memory simulated device, 1%% corrupted and 1%% dropped packets:\n");
+
+    lw_sim_create_device(&sim_device, 1);
+    sim_device.sim.corrupt_rate_ppm = 10000;
+    sim_device.sim.drop_rate_ppm = 10000;
+    lw_response_set_header_check(&sim_device.device.response, &lw_grf250_check_response_header);
+    lw_device_enable_stats(&sim_device.device, &stats);
+
+    // NOTE: The simulator answers at once, so its clock only moves while
+    // waiting out timeouts.
+    uint64_t start_ns = sim_device.time_ns;
+    bench_round_trip(&sim_device.device, BENCH_ROUND_TRIPS / 10);
+    printf("  %-40s %u timeouts, %.0f ms waited in simulated time, response timeout %u ms\n", "Recovery",
+           stats.timeouts, (double)(sim_device.time_ns - start_ns) / 1000000.0, lw_device_get_response_timeout(&sim_device.device, LW_GRF250_COMMAND_UPDATE_RATE));
+
+    bench_print_stream("Stream, maximum rate", bench_stream(&sim_device.device, 10000, 200000, 5000, 0));
+
+    printf("  %-40s %u CRC errors, %u header errors, %u skipped bytes, %u resyncs, %u timeouts, %u retries\n", "Link",
+           stats.crc_errors, stats.header_errors, stats.skipped_bytes, stats.resyncs, stats.timeouts, stats.retries);
+    lw_device_enable_stats(&sim_device.device, NULL);
+}
+
+// ----------------------------------------------------------------------------
+// Alarm monitor.
+//
+// Alarm A is set inside the simulator's sawtooth so it changes twice every
+// 1000 samples. Monitoring the streamed status is compared with polling it at
+// the sample period, which is what the application has to do without it.
+// ----------------------------------------------------------------------------
+#define BENCH_ALARM_SAMPLES 10000
+
+static void bench_alarm_callback(lw_grf250_alarm_monitor *monitor, const lw_grf250_alarm_event *event) {
+    (void)monitor;
+
+    bench_sink += event->changed;
+}
+
+static void bench_print_alarms(const char *name, const lw_grf250_alarm_monitor *monitor, uint32_t requests) {
+    const lw_stats_histogram *window = &monitor->stats.detection_window;
+
+    printf("  %-40s %6u changes, %6u requests, detection window mean %5.1f ms, max %3u ms\n", name, monitor->stats.events, requests,
+           window->count != 0 ? (double)window->total_ms / window->count : 0.0, window->max_ms);
+}
+
+static void bench_alarms(void) {
+    static lw_sim_device sim_device;
+    lw_callback_device *device = &sim_device.device;
+    lw_grf250_alarm_monitor monitor;
+
+    printf("Alarm monitor, simulated device at 100 Hz:\n");
+
+    lw_sim_create_device(&sim_device, 1);
+    check_success(bench_set_update_rate(device, 100), "Failed to set update rate");
+    check_success(lw_grf250_set_alarm_a_distance(device, 12000), "Failed to set alarm A distance");
+    check_success(lw_grf250_set_stream(device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream");
+
+    lw_grf250_init_alarm_monitor(&monitor, device, &bench_alarm_callback, NULL, 100);
+    uint32_t requests = sim_device.sim.stats.requests;
+
+    while (monitor.stats.samples < BENCH_ALARM_SAMPLES) {
+        lw_grf250_distance_data distance_data;
+        lw_grf250_wait_for_alarm_distance(&monitor, LW_GRF250_DISTANCE_CONFIG_ALL, &distance_data, 100);
+        lw_grf250_poll_alarm_monitor(&monitor);
+    }
+
+    bench_print_alarms("Streamed status", &monitor, sim_device.sim.stats.requests - requests);
+    check_success(lw_grf250_set_stream(device, LW_GRF250_STREAM_NONE), "Failed to stop stream");
+
+    lw_grf250_init_alarm_monitor(&monitor, device, &bench_alarm_callback, NULL, 10);
+    requests = sim_device.sim.stats.requests;
+
+    while (monitor.stats.samples < BENCH_ALARM_SAMPLES) {
+        if (lw_grf250_poll_alarm_monitor(&monitor) == LW_RESULT_AGAIN) {
+            device->sleep(device, 1);
+        }
+    }
+
+    bench_print_alarms("Polled every 10 ms", &monitor, sim_device.sim.stats.requests - requests);
+}
+
+// ----------------------------------------------------------------------------
+// Provisioning.
+//
+// A profile is applied to a factory default device and then again to the
+// same device, which only has to be read and verified the second time. A
+// fleet of devices is then provisioned at once from a single thread.
+// ----------------------------------------------------------------------------
+#define BENCH_PROVISION_FLEET_SIZE 8
+
+static uint32_t bench_count_bits(uint32_t value) {
+    uint32_t count = 0;
+
+    while (value) {
+        value &= value - 1;
+        ++count;
+    }
+
+    return count;
+}
+
+static void bench_print_provision(const char *name, const lw_grf250_provision_report *report, uint32_t requests) {
+    printf("  %-40s %s, %2u fields changed, %3u requests\n", name, lw_grf250_provision_step_name(report->step),
+           bench_count_bits(report->changed), requests);
+}
+
+static void bench_provision(void) {
+    static lw_sim_device sim_device;
+    lw_grf250_provision_profile profile;
+    lw_grf250_provision_report report;
+
+    printf("Provisioning, simulated device:\n");
+
+    lw_grf250_init_provision_profile(&profile);
+    profile.config.update_rate = 20;
+    profile.config.alarm_a_distance_cm = 500;
+    profile.config.alarm_hysteresis_cm = 20;
+    profile.config.gpio_mode = LW_GRF250_GPIO_MODE_ALARM_A;
+    profile.config.lost_signal_counter = 3;
+    profile.config.zero_offset_cm = -10;
+    profile.fields = LW_GRF250_CONFIG_UPDATE_RATE | LW_GRF250_CONFIG_ALARM_A_DISTANCE | LW_GRF250_CONFIG_ALARM_HYSTERESIS | LW_GRF250_CONFIG_GPIO_MODE | LW_GRF250_CONFIG_LOST_SIGNAL_COUNTER | LW_GRF250_CONFIG_ZERO_OFFSET;
+
+    lw_sim_create_device(&sim_device, 1);
+    uint32_t requests = sim_device.sim.stats.requests;
+    check_success(lw_grf250_provision(&sim_device.device, &profile, &report), "Failed to provision");
+    bench_print_provision("Factory default device", &report, sim_device.sim.stats.requests - requests);
+
+    requests = sim_device.sim.stats.requests;
+    check_success(lw_grf250_provision(&sim_device.device, &profile, &report), "Failed to provision");
+    bench_print_provision("Already provisioned device", &report, sim_device.sim.stats.requests - requests);
+
+    static lw_sim_device fleet_devices[BENCH_PROVISION_FLEET_SIZE];
+    static lw_grf250_provision_job jobs[BENCH_PROVISION_FLEET_SIZE];
+    lw_callback_device *fleet[BENCH_PROVISION_FLEET_SIZE];
+    lw_grf250_provision_report reports[BENCH_PROVISION_FLEET_SIZE];
+
+    for (uint32_t i = 0; i < BENCH_PROVISION_FLEET_SIZE; ++i) {
+        lw_sim_create_device(&fleet_devices[i], 1 + i);
+        fleet[i] = &fleet_devices[i].device;
+    }
+
+    check_success(lw_grf250_provision_fleet(fleet, BENCH_PROVISION_FLEET_SIZE, &profile, jobs, reports), "Failed to provision fleet");
+
+    requests = 0;
+    uint32_t done = 0;
+
+    for (uint32_t i = 0; i < BENCH_PROVISION_FLEET_SIZE; ++i) {
+        requests += fleet_devices[i].sim.stats.requests;
+        done += (reports[i].step == LW_GRF250_PROVISION_DONE) ? 1 : 0;
+    }
+
+    printf("  %-40s %u of %u done, %3u requests\n", "Fleet of factory default devices", done, BENCH_PROVISION_FLEET_SIZE, requests);
+}
+
+// ----------------------------------------------------------------------------
+// Batch timeouts.
+//
+// A managed batch is sent to a device streaming distance data, once with every
+// response arriving and once with every response dropped. The stream must not
+// keep the batch waiting for the dropped responses.
+// ----------------------------------------------------------------------------
+static void bench_print_batch_timeout(const char *name, lw_result result, lw_sim_device *sim_device, uint64_t start_ns) {
+    printf("  %-40s result %d, %7.1f ms waiting, %u samples streamed\n", name, result,
+           (double)(sim_device->time_ns - start_ns) / 1000000.0, sim_device->sim.stats.samples);
+}
+
+static void bench_batch_timeout(void) {
+    static lw_sim_device sim_device;
+    lw_grf250_config config;
+
+    printf("Batch timeouts, simulated device streaming at 50 Hz:\n");
+
+    lw_sim_create_device(&sim_device, 1);
+    check_success(lw_grf250_set_update_rate(&sim_device.device, 50), "Failed to set update rate");
+    check_success(lw_grf250_set_stream(&sim_device.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream");
+
+    uint64_t start_ns = sim_device.time_ns;
+    lw_result result = lw_grf250_get_config(&sim_device.device, &config);
+    check_success(result, "Failed to get config while streaming");
+    bench_print_batch_timeout("Every response arrives", result, &sim_device, start_ns);
+
+    sim_device.sim.drop_rate_ppm = LW_SIM_PPM;
+    start_ns = sim_device.time_ns;
+    result = lw_grf250_get_config(&sim_device.device, &config);
+
+    if (result != LW_RESULT_EXCEEDED_RETRIES) {
+        printf("Batch with dropped responses did not time out\n");
+        exit(1);
+    }
+
+    bench_print_batch_timeout("Every response dropped", result, &sim_device, start_ns);
+}
+
+static lw_device_callback_serial_send bench_session_serial_send;
+static uint32_t bench_session_sends;
+
+static uint32_t bench_counting_serial_send(lw_callback_device *device, uint8_t *buffer, uint32_t size) {
+    bench_session_sends += 1;
+    return bench_session_serial_send(device, buffer, size);
+}
+
+static void bench_print_session(const char *name, lw_sim_device *sim_device, uint32_t requests, uint32_t sends, uint64_t start_ns) {
+    printf("  %-40s %3u requests in %u sends, %6.1f ms waiting\n", name, sim_device->sim.stats.requests - requests,
+           bench_session_sends - sends, (double)(sim_device->time_ns - start_ns) / 1000000.0);
+}
+
+static void bench_create_session_device(lw_sim_device *sim_device, lw_stream_queue *queue) {
+    lw_sim_create_device(sim_device, 1);
+    lw_device_enable_stream_queue(&sim_device->device, queue);
+    sim_device->sim.wait_for_interface = 1;
+    bench_session_serial_send = sim_device->device.serial_send;
+    sim_device->device.serial_send = &bench_counting_serial_send;
+}
+
+// Drop everything the host has received, as if the port had been reopened.
+static void bench_flap_link(lw_sim_device *sim_device) {
+    sim_device->device.receive_buffer_offset = sim_device->device.receive_buffer_size;
+    lw_reset_response(&sim_device->device.response);
+}
+
+static void bench_session(void) {
+    static lw_sim_device sim_device;
+    static lw_stream_queue queue;
+    lw_grf250_product_info product_info;
+    lw_grf250_session session;
+    lw_grf250_distance_data distance_data;
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_FILTERED | LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_STRENGTH;
+
+    printf("Connecting, simulated device:\n");
+
+    bench_create_session_device(&sim_device, &queue);
+
+    uint32_t requests = sim_device.sim.stats.requests;
+    uint32_t sends = bench_session_sends;
+    uint64_t start_ns = sim_device.time_ns;
+    check_success(lw_grf250_initiate_serial(&sim_device.device), "Failed to initiate serial");
+    check_success(lw_grf250_get_product_info(&sim_device.device, &product_info), "Failed to get product info");
+    check_success(lw_grf250_set_distance_config(&sim_device.device, distance_config), "Failed to set distance config");
+    check_success(lw_grf250_set_stream(&sim_device.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream");
+    bench_print_session("Full handshake", &sim_device, requests, sends, start_ns);
+
+    bench_create_session_device(&sim_device, &queue);
+    lw_grf250_init_session(&session, distance_config, LW_GRF250_STREAM_DISTANCE);
+
+    requests = sim_device.sim.stats.requests;
+    sends = bench_session_sends;
+    start_ns = sim_device.time_ns;
+    check_success(lw_grf250_resume_session(&sim_device.device, &session), "Failed to resume session");
+    bench_print_session("Resume, new session", &sim_device, requests, sends, start_ns);
+
+    for (uint32_t i = 0; i < 10; ++i) {
+        check_success(lw_grf250_wait_for_streamed_distance(&sim_device.device, distance_config, &distance_data, 1000), "Failed to get streamed distance");
+    }
+
+    bench_flap_link(&sim_device);
+    requests = sim_device.sim.stats.requests;
+    sends = bench_session_sends;
+    start_ns = sim_device.time_ns;
+    check_success(lw_grf250_resume_session(&sim_device.device, &session), "Failed to resume session");
+    bench_print_session("Resume, link dropped while streaming", &sim_device, requests, sends, start_ns);
+
+    check_success(session.steps == 0 ? LW_RESULT_SUCCESS : LW_RESULT_ERROR, "Resume repeated handshake steps");
+
+    // NOTE: A power cycled device waits for the interface again and has lost
+    // its unsaved stream.
+    lw_sim_grf250_init(&sim_device.sim, 1);
+    sim_device.sim.wait_for_interface = 1;
+    bench_flap_link(&sim_device);
+    requests = sim_device.sim.stats.requests;
+    sends = bench_session_sends;
+    start_ns = sim_device.time_ns;
+    check_success(lw_grf250_resume_session(&sim_device.device, &session), "Failed to resume session");
+    bench_print_session("Resume, device power cycled", &sim_device, requests, sends, start_ns);
+}
+
+#define BENCH_ARCHIVE_SAMPLES 65536
+#define BENCH_ARCHIVE_SIZE (BENCH_ARCHIVE_SAMPLES * 40)
+
+typedef struct {
+    lw_grf250_distance_data samples[BENCH_ARCHIVE_SAMPLES];
+    lw_grf250_archive_writer writer;
+    lw_grf250_archive_reader reader;
+    uint8_t data[BENCH_ARCHIVE_SIZE];
+    uint32_t size;
+    uint64_t timestamps_ns[LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+    int32_t columns[LW_GRF250_DISTANCE_FIELD_COUNT][LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+} bench_archive_context;
+
+static uint32_t bench_archive_write_callback(void *user_data, const void *data, uint32_t size) {
+    bench_archive_context *bench = (bench_archive_context *)user_data;
+
+    if (size > BENCH_ARCHIVE_SIZE - bench->size) {
+        return 0;
+    }
+
+    memcpy(bench->data + bench->size, data, size);
+    bench->size += size;
+
+    return size;
+}
+
+static void bench_archive_write(void *context, uint32_t iterations) {
+    bench_archive_context *bench = (bench_archive_context *)context;
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        bench->size = 0;
+        lw_grf250_archive_writer_init(&bench->writer, LW_GRF250_ARCHIVE_DISTANCE, &bench_archive_write_callback, bench, bench->samples[0].timestamp_ns);
+
+        for (uint32_t i = 0; i < BENCH_ARCHIVE_SAMPLES; ++i) {
+            lw_grf250_archive_write_distance(&bench->writer, &bench->samples[i]);
+        }
+
+        lw_grf250_archive_writer_finish(&bench->writer);
+    }
+}
+
+// Scan the archive with the columns set up in the batch.
+static uint32_t bench_archive_scan(bench_archive_context *bench, lw_grf250_distance_batch *batch) {
+    uint32_t count = 0;
+
+    lw_grf250_archive_reader_init(&bench->reader, bench->data, bench->size);
+    batch->capacity = LW_GRF250_ARCHIVE_BLOCK_SAMPLES;
+    batch->count = 0;
+
+    while (lw_grf250_archive_read_distance(&bench->reader, batch) == LW_RESULT_SUCCESS) {
+        bench_sink += (uint32_t)bench->columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_FILTERED][batch->count - 1];
+        count += batch->count;
+        batch->count = 0;
+    }
+
+    return count;
+}
+
+static void bench_archive_scan_all(void *context, uint32_t iterations) {
+    bench_archive_context *bench = (bench_archive_context *)context;
+    lw_grf250_distance_batch batch;
+    batch.timestamps_ns = bench->timestamps_ns;
+
+    for (uint32_t i = 0; i < LW_GRF250_DISTANCE_FIELD_COUNT; ++i) {
+        batch.columns[i] = bench->columns[i];
+    }
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        bench_archive_scan(bench, &batch);
+    }
+}
+
+static void bench_archive_scan_column(void *context, uint32_t iterations) {
+    bench_archive_context *bench = (bench_archive_context *)context;
+    lw_grf250_distance_batch batch;
+    memset(&batch, 0, sizeof(batch));
+    batch.columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_FILTERED] = bench->columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_FILTERED];
+
+    for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+        bench_archive_scan(bench, &batch);
+    }
+}
+
+static void bench_archives(void) {
+    static bench_archive_context bench;
+    uint32_t random_state = 1;
+    int32_t distance_mm = 12000;
+    uint64_t time_ns = 1000000000ull;
+
+    // A 50 Hz stream of a slowly moving target with a few millimetres of
+    // noise, a drifting temperature and the odd alarm.
+    for (uint32_t i = 0; i < BENCH_ARCHIVE_SAMPLES; ++i) {
+        lw_grf250_distance_data *sample = &bench.samples[i];
+        random_state = random_state * 1664525 + 1013904223;
+        distance_mm += (int32_t)((random_state >> 28) & 3) - 1;
+        time_ns += 20000000 + (random_state >> 16 & 0xFF) * 100;
+
+        sample->first_return_raw_mm = distance_mm + (int32_t)(random_state >> 20 & 15) - 8;
+        sample->first_return_filtered_mm = distance_mm;
+        sample->first_return_strength = 80 + (int32_t)(random_state >> 12 & 7);
+        sample->last_return_raw_mm = sample->first_return_raw_mm;
+        sample->last_return_filtered_mm = distance_mm;
+        sample->last_return_strength = sample->first_return_strength;
+        sample->temperature = 25 + (int32_t)(i / 3000);
+        sample->alarm_status = (i % 5000) < 50 ? 1 : 0;
+        sample->timestamp_ns = time_ns;
+    }
+
+    printf("Archive, %u distance samples:\n", BENCH_ARCHIVE_SAMPLES);
+    bench_run("write", &bench_archive_write, &bench, BENCH_ARCHIVE_SAMPLES, 0);
+    check_success(bench.writer.records.result, "Failed to write archive");
+    printf("  %-40s %10.2f bytes/sample, %u bytes of fields raw\n", "size", (double)bench.size / BENCH_ARCHIVE_SAMPLES, LW_GRF250_DISTANCE_FIELD_COUNT * 4);
+
+    // Check the round trip before timing the scans.
+    lw_grf250_distance_batch batch;
+    batch.timestamps_ns = bench.timestamps_ns;
+
+    for (uint32_t i = 0; i < LW_GRF250_DISTANCE_FIELD_COUNT; ++i) {
+        batch.columns[i] = bench.columns[i];
+    }
+
+    uint32_t index = 0;
+    check_success(lw_grf250_archive_reader_init(&bench.reader, bench.data, bench.size), "Failed to open archive");
+    batch.capacity = LW_GRF250_ARCHIVE_BLOCK_SAMPLES;
+    batch.count = 0;
+
+    while (lw_grf250_archive_read_distance(&bench.reader, &batch) == LW_RESULT_SUCCESS) {
+        for (uint32_t i = 0; i < batch.count; ++i, ++index) {
+            const lw_grf250_distance_data *sample = &bench.samples[index];
+            uint8_t same = bench.timestamps_ns[i] == sample->timestamp_ns &&
+                           bench.columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_RAW][i] == sample->first_return_raw_mm &&
+                           bench.columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_STRENGTH][i] == sample->first_return_strength &&
+                           bench.columns[LW_GRF250_DISTANCE_FIELD_TEMPERATURE][i] == sample->temperature &&
+                           bench.columns[LW_GRF250_DISTANCE_FIELD_ALARM_STATUS][i] == sample->alarm_status;
+            check_success(same ? LW_RESULT_SUCCESS : LW_RESULT_ERROR, "Archive samples do not match");
+        }
+
+        batch.count = 0;
+    }
+
+    check_success(index == BENCH_ARCHIVE_SAMPLES ? LW_RESULT_SUCCESS : LW_RESULT_ERROR, "Archive lost samples");
+
+    uint64_t seek_time_ns = bench.samples[BENCH_ARCHIVE_SAMPLES / 3].timestamp_ns;
+    lw_grf250_archive_reader_seek(&bench.reader, seek_time_ns);
+    check_success(lw_grf250_archive_read_distance(&bench.reader, &batch), "Failed to read after seek");
+    check_success(bench.timestamps_ns[0] <= seek_time_ns && bench.timestamps_ns[batch.count - 1] >= seek_time_ns ? LW_RESULT_SUCCESS : LW_RESULT_ERROR, "Seek missed");
+
+    bench_run("scan all columns", &bench_archive_scan_all, &bench, BENCH_ARCHIVE_SAMPLES, 0);
+    bench_run("scan first return filtered", &bench_archive_scan_column, &bench, BENCH_ARCHIVE_SAMPLES, 0);
+}
+
+#ifdef __linux__
+// ----------------------------------------------------------------------------
+// Pseudo terminal backend.
+//
+// The simulator serves the master end of a pty pair on its own thread with
+// real time, while the host connects to the slave end through the normal
+// Linux serial backend.
+// ----------------------------------------------------------------------------
+typedef struct {
+    int32_t master;
+    atomic_int running;
+    lw_sim_grf250 sim;
+    lw_platform_thread thread;
+} bench_pty_server;
+
+static void bench_pty_server_run(void *user_data) {
+    bench_pty_server *server = (bench_pty_server *)user_data;
+    uint8_t receive_buffer[4096];
+    uint8_t send_buffer[4096];
+    uint32_t send_size = 0;
+    uint32_t send_offset = 0;
+
+    while (atomic_load(&server->running)) {
+        lw_sim_grf250_update(&server->sim, lw_platform_get_time_ns());
+
+        if (send_offset == send_size) {
+            send_size = lw_sim_grf250_transmit(&server->sim, send_buffer, sizeof(send_buffer));
+            send_offset = 0;
+        }
+
+        if (send_offset < send_size) {
+            ssize_t written = write(server->master, send_buffer + send_offset, send_size - send_offset);
+
+            if (written > 0) {
+                send_offset += (uint32_t)written;
+            }
+        }
+
+        struct pollfd descriptor = {0};
+        descriptor.fd = server->master;
+        descriptor.events = POLLIN | (send_offset < send_size ? POLLOUT : 0);
+
+        if (poll(&descriptor, 1, 1) > 0 && (descriptor.revents & POLLIN)) {
+            ssize_t bytes_read = read(server->master, receive_buffer, sizeof(receive_buffer));
+
+            if (bytes_read > 0) {
+                lw_sim_grf250_update(&server->sim, lw_platform_get_time_ns());
+                lw_sim_grf250_receive(&server->sim, receive_buffer, (uint32_t)bytes_read);
+            }
+        }
+    }
+}
+
+static void bench_pty(void) {
+    static bench_pty_server server;
+
+    printf("Linux serial backend over a pty:\n");
+
+    server.master = posix_openpt(O_RDWR | O_NOCTTY);
+
+    if (server.master < 0 || grantpt(server.master) != 0 || unlockpt(server.master) != 0) {
+        printf("  Failed to open a pty, skipped\n");
+        return;
+    }
+
+    fcntl(server.master, F_SETFL, fcntl(server.master, F_GETFL) | O_NONBLOCK);
+
+    lw_platform_serial_device host;
+    check_success(lw_platform_create_serial_device(ptsname(server.master), 115200, &host), "Failed to open pty");
+
+    lw_sim_grf250_init(&server.sim, 1);
+    atomic_store(&server.running, 1);
+    check_success(lw_platform_thread_create(&server.thread, &bench_pty_server_run, &server), "Failed to start simulator");
+
+    bench_round_trip(&host.device, BENCH_ROUND_TRIPS / 10);
+
+    // Step the rate up and report where samples start to go missing.
+    const uint32_t update_rates[] = {1000, 5000, 10000, 20000, 50000};
+
+    for (uint32_t i = 0; i < sizeof(update_rates) / sizeof(update_rates[0]); ++i) {
+        char name[64];
+        snprintf(name, sizeof(name), "Stream at %u Hz", update_rates[i]);
+        bench_print_stream(name, bench_stream(&host.device, update_rates[i], UINT32_MAX, 1000, 0));
+
+        // Let the tail of the stream drain before the next step.
+        while (lw_wait_for_next_response(&host.device, LW_ANY_COMMAND, 50) == LW_RESULT_SUCCESS) {
+        }
+    }
+
+    // Samples that arrive while a request waits for its response are only
+    // kept when the device has a stream queue.
+    static lw_stream_queue stream_queue;
+    bench_print_stream("Stream at 5000 Hz, request every 10", bench_stream(&host.device, 5000, UINT32_MAX, 1000, 10));
+    lw_device_enable_stream_queue(&host.device, &stream_queue);
+    bench_print_stream("  ... with a stream queue", bench_stream(&host.device, 5000, UINT32_MAX, 1000, 10));
+    printf("  %-40s %u overruns\n", "Stream queue", stream_queue.overruns);
+    lw_device_enable_stream_queue(&host.device, NULL);
+
+    atomic_store(&server.running, 0);
+    lw_platform_thread_join(&server.thread);
+    lw_platform_serial_disconnect(&host.serial_port);
+    close(server.master);
+}
+#endif
+
+int main(void) {
+    check_success(lw_platform_init(), "Failed to initialize platform");
+
+    bench_micro();
+    bench_multi();
+    bench_filters();
+    bench_shared();
+    bench_in_memory();
+    bench_alarms();
+    bench_provision();
+    bench_batch_timeout();
+    bench_session();
+    bench_archives();
+
+#ifdef __linux__
+    bench_pty();
+#endif
+
+    printf("Sample completed\n");
+
+    return 0;
+}
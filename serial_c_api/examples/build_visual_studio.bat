@@ -12,3 +12,15 @@ if not exist %OUT_DIR% mkdir %OUT_DIR%
 cl -Fe%OUT_DIR%/example_basic.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% example_basic.c
 cl -Fe%OUT_DIR%/example_callbacks.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% example_callbacks.c
 cl -Fe%OUT_DIR%/example_unmanaged.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% example_unmanaged.c
+cl -Fe%OUT_DIR%/example_multi_sensor.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% lw_platform_win_reactor.c example_multi_sensor.c
+cl -Fe%OUT_DIR%/example_stream_ring.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_grf250_ring.c example_stream_ring.c
+cl -Fe%OUT_DIR%/example_async.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% example_async.c
+cl -Fe%OUT_DIR%/example_baud_rate.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% example_baud_rate.c
+cl -Fe%OUT_DIR%/example_capture.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_capture.c example_capture.c
+cl -Fe%OUT_DIR%/example_filter.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_grf250_filter.c example_filter.c
+cl -Fe%OUT_DIR%/example_alarm.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_grf250_alarm.c example_alarm.c
+cl -Fe%OUT_DIR%/example_provision.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_grf250_provision.c example_provision.c
+cl -Fe%OUT_DIR%/example_shared_memory.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_grf250_shared.c example_shared_memory.c
+cl -Fe%OUT_DIR%/example_resume.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% example_resume.c
+cl -Fe%OUT_DIR%/example_archive.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% ..\lw_serial_api_capture.c ..\lw_serial_api_grf250_archive.c example_archive.c
+cl -Fe%OUT_DIR%/bench.exe %CFLAGS% %INCLUDES% %SHARED_SOURCES% lw_sim_grf250.c ..\lw_serial_api_grf250_alarm.c ..\lw_serial_api_grf250_multi.c ..\lw_serial_api_grf250_filter.c ..\lw_serial_api_grf250_provision.c ..\lw_serial_api_grf250_shared.c ..\lw_serial_api_capture.c ..\lw_serial_api_grf250_archive.c bench.c
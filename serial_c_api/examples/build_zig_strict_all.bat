@@ -7,7 +7,9 @@ set SHARED_SOURCES_LINUX=../lw_serial_api.c ../lw_serial_api_grf250.c lw_platfor
 zig cc -o ./bin/example_basic.exe example_basic.c %SHARED_SOURCES_WIN% %CFLAGS% -target native-windows -s
 zig cc -o ./bin/example_callback.exe example_basic.c %SHARED_SOURCES_WIN% %CFLAGS% -target native-windows -s
 zig cc -o ./bin/example_unmanaged.exe example_unmanaged.c %SHARED_SOURCES_WIN% %CFLAGS% -target native-windows -s
+zig cc -o ./bin/example_multi_sensor.exe example_multi_sensor.c lw_platform_win_reactor.c %SHARED_SOURCES_WIN% %CFLAGS% -target native-windows -s
 
 zig cc -o ./bin/example_basic example_basic.c %SHARED_SOURCES_LINUX% %CFLAGS% -target native-linux -s
 zig cc -o ./bin/example_callback example_basic.c %SHARED_SOURCES_LINUX% %CFLAGS% -target native-linux -s
-zig cc -o ./bin/example_unmanaged example_unmanaged.c %SHARED_SOURCES_LINUX% %CFLAGS% -target native-linux -s
\ No newline at end of file
+zig cc -o ./bin/example_unmanaged example_unmanaged.c %SHARED_SOURCES_LINUX% %CFLAGS% -target native-linux -s
+zig cc -o ./bin/example_multi_sensor example_multi_sensor.c lw_platform_linux_reactor.c %SHARED_SOURCES_LINUX% %CFLAGS% -target native-linux -s
\ No newline at end of file
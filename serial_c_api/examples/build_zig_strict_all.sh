@@ -9,7 +9,31 @@ SHARED_SOURCES_LINUX="../lw_serial_api.c ../lw_serial_api_grf250.c lw_platform_l
 zig cc -o ./bin/example_basic.exe example_basic.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
 zig cc -o ./bin/example_callback.exe example_basic.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
 zig cc -o ./bin/example_unmanaged.exe example_unmanaged.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_multi_sensor.exe example_multi_sensor.c lw_platform_win_reactor.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_stream_ring.exe example_stream_ring.c ../lw_serial_api_grf250_ring.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_async.exe example_async.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_baud_rate.exe example_baud_rate.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_capture.exe example_capture.c ../lw_serial_api_capture.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_filter.exe example_filter.c ../lw_serial_api_grf250_filter.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_alarm.exe example_alarm.c ../lw_serial_api_grf250_alarm.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_provision.exe example_provision.c ../lw_serial_api_grf250_provision.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_shared_memory.exe example_shared_memory.c ../lw_serial_api_grf250_shared.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_resume.exe example_resume.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/example_archive.exe example_archive.c ../lw_serial_api_capture.c ../lw_serial_api_grf250_archive.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
+zig cc -o ./bin/bench.exe bench.c lw_sim_grf250.c ../lw_serial_api_grf250_alarm.c ../lw_serial_api_grf250_multi.c ../lw_serial_api_grf250_filter.c ../lw_serial_api_grf250_provision.c ../lw_serial_api_grf250_shared.c ../lw_serial_api_capture.c ../lw_serial_api_grf250_archive.c $SHARED_SOURCES_WIN $CFLAGS -target native-windows -s
 
 zig cc -o ./bin/example_basic example_basic.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
 zig cc -o ./bin/example_callback example_basic.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
-zig cc -o ./bin/example_unmanaged example_unmanaged.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
\ No newline at end of file
+zig cc -o ./bin/example_unmanaged example_unmanaged.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_multi_sensor example_multi_sensor.c lw_platform_linux_reactor.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_stream_ring example_stream_ring.c ../lw_serial_api_grf250_ring.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s -pthread
+zig cc -o ./bin/example_async example_async.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_baud_rate example_baud_rate.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_capture example_capture.c ../lw_serial_api_capture.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_filter example_filter.c ../lw_serial_api_grf250_filter.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_alarm example_alarm.c ../lw_serial_api_grf250_alarm.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_provision example_provision.c ../lw_serial_api_grf250_provision.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_shared_memory example_shared_memory.c ../lw_serial_api_grf250_shared.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_resume example_resume.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/example_archive example_archive.c ../lw_serial_api_capture.c ../lw_serial_api_grf250_archive.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s
+zig cc -o ./bin/bench bench.c lw_sim_grf250.c ../lw_serial_api_grf250_alarm.c ../lw_serial_api_grf250_multi.c ../lw_serial_api_grf250_filter.c ../lw_serial_api_grf250_provision.c ../lw_serial_api_grf250_shared.c ../lw_serial_api_capture.c ../lw_serial_api_grf250_archive.c $SHARED_SOURCES_LINUX $CFLAGS -target native-linux -s -pthread
\ No newline at end of file
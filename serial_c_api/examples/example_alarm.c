@@ -0,0 +1,113 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250_alarm.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+void alarm_callback(lw_grf250_alarm_monitor *monitor, const lw_grf250_alarm_event *event) {
+    (void)monitor;
+
+    if (event->changed & LW_GRF250_ALARM_A) {
+        printf("Alarm A %s", event->status.alarm_a ? "active" : "cleared");
+    }
+
+    if (event->changed & LW_GRF250_ALARM_B) {
+        printf("%sAlarm B %s", (event->changed & LW_GRF250_ALARM_A) ? ", " : "", event->status.alarm_b ? "active" : "cleared");
+    }
+
+    printf(" (%s, within %u ms)\n", event->polled ? "polled" : "streamed", event->detection_window_ms);
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    lw_platform_serial_device grf250;
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+
+    // ----------------------------------------------------------------------------
+    // Alarm A at 5 m, alarm B at 20 m.
+    // ----------------------------------------------------------------------------
+    check_success(lw_grf250_set_alarm_a_distance(&grf250.device, 500), "Failed to set alarm A distance\n");
+    check_success(lw_grf250_set_alarm_b_distance(&grf250.device, 2000), "Failed to set alarm B distance\n");
+    check_success(lw_grf250_set_alarm_hysteresis(&grf250.device, 20), "Failed to set alarm hysteresis\n");
+
+    lw_grf250_alarm_monitor monitor;
+    lw_grf250_init_alarm_monitor(&monitor, &grf250.device, &alarm_callback, NULL, 100);
+
+    // ----------------------------------------------------------------------------
+    // Without a stream the monitor polls the alarm status every 100 ms.
+    // ----------------------------------------------------------------------------
+    printf("Polling alarm status...\n");
+
+    while (monitor.stats.polls < 50) {
+        lw_result result = lw_grf250_poll_alarm_monitor(&monitor);
+
+        if (result == LW_RESULT_AGAIN) {
+            lw_platform_sleep(10);
+        } else if (result != LW_RESULT_SUCCESS) {
+            printf("Failed to poll alarm status\n");
+        }
+    }
+
+    // ----------------------------------------------------------------------------
+    // With the alarm status in the stream no requests are sent.
+    // ----------------------------------------------------------------------------
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW | LW_GRF250_DISTANCE_CONFIG_ALARM_STATUS;
+
+    check_success(lw_grf250_set_update_rate(&grf250.device, 50), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    printf("Streaming alarm status...\n");
+    uint32_t polls = monitor.stats.polls;
+
+    for (int i = 0; i < 500; ++i) {
+        lw_grf250_distance_data distance_data;
+
+        if (lw_grf250_wait_for_alarm_distance(&monitor, distance_config, &distance_data, 1000) != LW_RESULT_SUCCESS) {
+            printf("Failed to get streamed distance\n");
+        }
+
+        // Only polls if the stream stalls.
+        lw_grf250_poll_alarm_monitor(&monitor);
+    }
+
+    printf("Samples: %u, changes: %u, polls while streaming: %u\n", monitor.stats.samples, monitor.stats.events, monitor.stats.polls - polls);
+    printf("Sample interval: mean %u ms, max %u ms\n",
+           monitor.stats.sample_interval.count != 0 ? monitor.stats.sample_interval.total_ms / monitor.stats.sample_interval.count : 0,
+           monitor.stats.sample_interval.max_ms);
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+
+    printf("Sample completed\n");
+
+    return 0;
+}
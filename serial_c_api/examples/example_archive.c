@@ -0,0 +1,144 @@
+// NOTE: fopen is deprecated by the MSVC runtime, which fails the warnings as errors build.
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250_archive.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+static lw_grf250_archive_writer writer;
+static lw_grf250_archive_reader reader;
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    lw_platform_serial_device grf250;
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
+
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    check_success(lw_grf250_set_update_rate(&grf250.device, 50), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+
+    // ----------------------------------------------------------------------------
+    // Archive 10 seconds of the distance stream, flushing every second so a
+    // power loss only takes the last second.
+    // ----------------------------------------------------------------------------
+    FILE *file = fopen("samples.lwa", "wb");
+
+    if (file == NULL) {
+        printf("Failed to create archive file\n");
+        return 1;
+    }
+
+    uint64_t start_time_ns = lw_platform_get_time_ns();
+    check_success(lw_grf250_archive_writer_init(&writer, LW_GRF250_ARCHIVE_DISTANCE, &lw_capture_file_write_callback, file, start_time_ns), "Failed to write archive header");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    uint32_t end_time = lw_platform_get_time_ms() + 10000;
+    uint32_t flush_time = lw_platform_get_time_ms() + 1000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        lw_grf250_distance_data distance_data;
+        lw_result result = lw_grf250_wait_for_streamed_distance(&grf250.device, distance_config, &distance_data, 100);
+
+        if (result == LW_RESULT_SUCCESS) {
+            check_success(lw_grf250_archive_write_distance(&writer, &distance_data), "Failed to write archive");
+        } else if (result != LW_RESULT_TIMEOUT) {
+            printf("Communication error\n");
+            break;
+        }
+
+        if ((int32_t)(flush_time - lw_platform_get_time_ms()) <= 0) {
+            check_success(lw_grf250_archive_writer_flush(&writer), "Failed to write archive");
+            fflush(file);
+            flush_time += 1000;
+        }
+    }
+
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+
+    lw_result result = lw_grf250_archive_writer_finish(&writer);
+    fclose(file);
+    check_success(result, "Failed to write archive");
+
+    printf("Archived %llu samples in %llu bytes\n", (unsigned long long)writer.sample_count, (unsigned long long)writer.records.offset);
+
+    // ----------------------------------------------------------------------------
+    // Scan a single column, then seek to the middle of the recording.
+    // ----------------------------------------------------------------------------
+    lw_platform_file_mapping mapping;
+    check_success(lw_platform_map_file("samples.lwa", &mapping), "Failed to map archive file");
+    check_success(lw_grf250_archive_reader_init(&reader, mapping.data, mapping.size), "Failed to open archive");
+
+    static int32_t distances_mm[LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+    static uint64_t timestamps_ns[LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+
+    lw_grf250_distance_batch batch = {0};
+    batch.columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_FILTERED] = distances_mm;
+    batch.capacity = LW_GRF250_ARCHIVE_BLOCK_SAMPLES;
+
+    int64_t total_mm = 0;
+    uint32_t count = 0;
+    int32_t min_mm = INT32_MAX;
+    int32_t max_mm = INT32_MIN;
+
+    while (lw_grf250_archive_read_distance(&reader, &batch) == LW_RESULT_SUCCESS) {
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            total_mm += distances_mm[i];
+            min_mm = (distances_mm[i] < min_mm) ? distances_mm[i] : min_mm;
+            max_mm = (distances_mm[i] > max_mm) ? distances_mm[i] : max_mm;
+        }
+
+        count += batch.count;
+        batch.count = 0;
+    }
+
+    if (count != 0) {
+        printf("First return filtered: min %d mm, max %d mm, mean %.1f mm\n", min_mm, max_mm, (double)total_mm / count);
+    }
+
+    uint64_t seek_time_ns = start_time_ns + 5000000000ull;
+    batch.timestamps_ns = timestamps_ns;
+    lw_grf250_archive_reader_seek(&reader, seek_time_ns);
+
+    if (lw_grf250_archive_read_distance(&reader, &batch) == LW_RESULT_SUCCESS) {
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            if (timestamps_ns[i] >= seek_time_ns) {
+                printf("Sample at %.3f s: %d mm\n", (double)(timestamps_ns[i] - start_time_ns) / 1000000000.0, distances_mm[i]);
+                break;
+            }
+        }
+    }
+
+    lw_platform_unmap_file(&mapping);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
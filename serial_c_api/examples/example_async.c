@@ -0,0 +1,157 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+static lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
+static lw_grf250_period_estimator period_estimator;
+
+// ----------------------------------------------------------------------------
+// Device callbacks.
+// ----------------------------------------------------------------------------
+void packet_callback(lw_callback_device *device, lw_response *response) {
+    (void)device;
+
+    if (response->command_id == LW_GRF250_COMMAND_DISTANCE_DATA) {
+        lw_grf250_distance_data distance_data = {0};
+
+        if (lw_grf250_parse_response_distance_data(response, distance_config, &distance_data) == LW_RESULT_SUCCESS) {
+            uint64_t sample_time_ns = lw_grf250_period_estimator_add(&period_estimator, distance_data.timestamp_ns);
+            printf("Streamed distance: %d mm at %.3f ms\n", distance_data.first_return_raw_mm, (double)sample_time_ns / 1000000.0);
+        }
+    }
+}
+
+void update_rate_callback(lw_callback_device *device, lw_async_request *async_request, lw_result result, lw_response *response) {
+    (void)device;
+    (void)response;
+
+    uint32_t update_rate = *(uint32_t *)async_request->user_data;
+
+    if (result == LW_RESULT_SUCCESS) {
+        printf("Update rate set to %u Hz\n", update_rate);
+        lw_grf250_init_period_estimator(&period_estimator, update_rate);
+    } else {
+        printf("Failed to set update rate: %d\n", result);
+    }
+}
+
+void product_name_callback(lw_callback_device *device, lw_async_request *async_request, lw_result result, lw_response *response) {
+    (void)device;
+    (void)async_request;
+
+    char product_name[16];
+
+    if (result == LW_RESULT_SUCCESS && lw_grf250_parse_response_product_name(response, product_name) == LW_RESULT_SUCCESS) {
+        printf("Product name: %s\n", product_name);
+    }
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    lw_platform_serial_device grf250;
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    // ----------------------------------------------------------------------------
+    // Start a distance stream with the blocking managed commands.
+    // ----------------------------------------------------------------------------
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    check_success(lw_grf250_set_update_rate(&grf250.device, 5), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    // ----------------------------------------------------------------------------
+    // Keep consuming the stream while requests complete asynchronously.
+    // ----------------------------------------------------------------------------
+    grf250.device.packet_callback = &packet_callback;
+
+    lw_device_stats stats;
+    lw_device_enable_stats(&grf250.device, &stats);
+    lw_grf250_init_period_estimator(&period_estimator, 5);
+
+    lw_async_request product_name_request;
+    lw_init_async_request(&product_name_request, &product_name_callback, NULL);
+    check_success(lw_grf250_create_request_read_product_name(&product_name_request.request), "Failed to create request");
+    check_success(lw_device_submit_request(&grf250.device, &product_name_request), "Failed to submit request");
+
+    uint32_t update_rate = 5;
+    lw_async_request update_rate_request;
+    lw_init_async_request(&update_rate_request, &update_rate_callback, &update_rate);
+
+    uint32_t end_time = lw_platform_get_time_ms() + 10000;
+    uint32_t next_change_time = lw_platform_get_time_ms() + 2000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        // Alternate the update rate every 2 seconds without stalling the stream.
+        if ((int32_t)(next_change_time - lw_platform_get_time_ms()) <= 0 && update_rate_request.state == LW_ASYNC_REQUEST_IDLE) {
+            update_rate = update_rate == 5 ? 20 : 5;
+            check_success(lw_grf250_create_request_write_update_rate(&update_rate_request.request, update_rate), "Failed to create request");
+            check_success(lw_device_submit_request(&grf250.device, &update_rate_request), "Failed to submit request");
+            next_change_time += 2000;
+        }
+
+        check_success(lw_device_poll(&grf250.device, 100), "Communication error");
+    }
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    lw_device_cancel_request(&grf250.device, &product_name_request);
+    lw_device_cancel_request(&grf250.device, &update_rate_request);
+    grf250.device.packet_callback = NULL;
+    lw_device_enable_stats(&grf250.device, NULL);
+
+    printf("Received %u bytes, %u packets, %u CRC errors, %u skipped bytes, %u resyncs, %u timeouts, %u retries\n",
+           stats.bytes_received, stats.packets, stats.crc_errors, stats.skipped_bytes, stats.resyncs, stats.timeouts, stats.retries);
+
+    printf("Sample period %.3f ms, jitter %.3f ms\n", (double)period_estimator.period_ns / 1000000.0, (double)period_estimator.jitter_ns / 1000000.0);
+
+    for (uint32_t i = 0; i < stats.command_count; ++i) {
+        lw_command_stats *command_stats = &stats.commands[i];
+        lw_stats_histogram *latency = &command_stats->latency;
+        lw_stats_histogram *inter_arrival = &command_stats->inter_arrival;
+
+        printf("Command %3u: %u packets", command_stats->command_id, command_stats->packets);
+
+        if (latency->count != 0) {
+            printf(", latency %u/%u/%u ms", latency->min_ms, latency->total_ms / latency->count, latency->max_ms);
+        }
+
+        if (inter_arrival->count != 0) {
+            printf(", interval %u/%u/%u ms", inter_arrival->min_ms, inter_arrival->total_ms / inter_arrival->count, inter_arrival->max_ms);
+        }
+
+        printf("\n");
+    }
+
+    lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
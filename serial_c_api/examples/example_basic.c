@@ -54,6 +54,37 @@ int main(void) {
     lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
     check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
 
+    // ----------------------------------------------------------------------------
+    // Read the entire configuration in a few batched round trips.
+    // ----------------------------------------------------------------------------
+    lw_grf250_config config;
+    check_success(lw_grf250_get_config(&grf250.device, &config), "Failed to get config\n");
+
+    printf("Update rate: %d Hz\n", config.update_rate);
+    printf("Alarm A distance: %d cm\n", config.alarm_a_distance_cm);
+    printf("Zero offset: %d cm\n", config.zero_offset_cm);
+
+    // ----------------------------------------------------------------------------
+    // Change configuration through a local cache, only changed fields are written.
+    // ----------------------------------------------------------------------------
+    lw_grf250_config_cache config_cache;
+    check_success(lw_grf250_config_cache_load(&grf250.device, &config_cache), "Failed to load config cache\n");
+
+    config_cache.config.update_rate = 10;
+    config_cache.config.alarm_a_distance_cm = 500;
+    check_success(lw_grf250_config_cache_apply(&grf250.device, &config_cache), "Failed to apply config cache\n");
+
+    config_cache.config.update_rate = 5;
+    check_success(lw_grf250_config_cache_apply(&grf250.device, &config_cache), "Failed to apply config cache\n");
+
+    // An attached cache answers the config getters without reading the device.
+    uint32_t update_rate = 0;
+    lw_grf250_config_cache_attach(&grf250.device, &config_cache);
+    check_success(lw_grf250_get_update_rate(&grf250.device, &update_rate), "Failed to get update rate\n");
+    lw_grf250_config_cache_detach(&grf250.device, &config_cache);
+
+    printf("Cached update rate: %d Hz\n", update_rate);
+
     // ----------------------------------------------------------------------------
     // Poll for distance data.
     // ----------------------------------------------------------------------------
@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // The initial host baud rate does not matter, the device is found at
+    // whatever rate it is using.
+    lw_platform_serial_device grf250;
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    // NOTE: Switching baud rate saves the parameters, which needs longer than
+    // the adaptive response timeout.
+    lw_device_set_command_timeout(&grf250.device, &lw_grf250_get_command_timeout);
+
+    // ----------------------------------------------------------------------------
+    // Step the device and the host up to the fastest clean baud rate.
+    // ----------------------------------------------------------------------------
+    lw_grf250_baud_rate baud_rate;
+    check_success(lw_grf250_negotiate_baud_rate(&grf250.device, &lw_platform_set_host_baud_rate_callback, LW_GRF250_BAUD_921600, &baud_rate), "Failed to negotiate baud rate\n");
+
+    printf("Negotiated baud rate: %u\n", lw_grf250_baud_rate_to_bps(baud_rate));
+
+    // ----------------------------------------------------------------------------
+    // Use the device as normal at the new rate.
+    // ----------------------------------------------------------------------------
+    lw_grf250_product_info product_info;
+    check_success(lw_grf250_get_product_info(&grf250.device, &product_info), "Failed to get product info\n");
+
+    printf("Product name: %s\n", product_info.product_name);
+    printf("Serial number: %s\n", product_info.serial_number);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
@@ -50,10 +50,8 @@ uint32_t custom_serial_send_callback(lw_callback_device *device, uint8_t *buffer
 }
 
 int32_t custom_serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
-    (void)timeout_ms;
-    
     user_device_context *device_context = (user_device_context *)device->user_data;
-    return lw_platform_serial_read(&device_context->serial_port, buffer, size);
+    return lw_platform_serial_read_timeout(&device_context->serial_port, buffer, size, timeout_ms);
 }
 
 int main(void) {
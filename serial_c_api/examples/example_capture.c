@@ -0,0 +1,127 @@
+// NOTE: fopen is deprecated by the MSVC runtime, which fails the warnings as errors build.
+#define _CRT_SECURE_NO_WARNINGS
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_capture.h"
+#include "lw_serial_api_grf250.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+static lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
+static lw_grf250_period_estimator period_estimator;
+static uint32_t replayed_samples = 0;
+
+// ----------------------------------------------------------------------------
+// Replay callbacks.
+// ----------------------------------------------------------------------------
+void replay_sleep_callback(lw_callback_device *device, uint32_t time_ms) {
+    (void)device;
+    lw_platform_sleep(time_ms);
+}
+
+void replay_packet_callback(lw_callback_device *device, lw_response *response) {
+    (void)device;
+
+    if (response->command_id == LW_GRF250_COMMAND_DISTANCE_DATA) {
+        lw_grf250_distance_data distance_data = {0};
+
+        if (lw_grf250_parse_response_distance_data(response, distance_config, &distance_data) == LW_RESULT_SUCCESS) {
+            lw_grf250_period_estimator_add(&period_estimator, distance_data.timestamp_ns);
+            replayed_samples += 1;
+        }
+    }
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    lw_platform_serial_device grf250;
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    check_success(lw_grf250_set_update_rate(&grf250.device, 50), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+
+    // ----------------------------------------------------------------------------
+    // Record 10 seconds of the distance stream.
+    // ----------------------------------------------------------------------------
+    FILE *file = fopen("capture.lwc", "wb");
+
+    if (file == NULL) {
+        printf("Failed to create capture file\n");
+        return 1;
+    }
+
+    lw_capture_writer writer;
+    check_success(lw_capture_writer_init(&writer, &lw_capture_file_write_callback, file, 115200, lw_platform_get_time_ns()), "Failed to write capture header");
+    lw_capture_attach(&writer, &grf250.device);
+
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    uint32_t end_time = lw_platform_get_time_ms() + 10000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        check_success(lw_device_poll(&grf250.device, 100), "Communication error");
+    }
+
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    lw_device_set_receive_tap(&grf250.device, NULL, NULL);
+
+    lw_result result = lw_capture_writer_finish(&writer);
+    fclose(file);
+    check_success(result, "Failed to write capture");
+
+    printf("Captured %u blocks, %llu bytes\n", writer.data_records, (unsigned long long)writer.data_bytes);
+
+    // ----------------------------------------------------------------------------
+    // Replay the capture at 100 times real time through the same parse path.
+    // ----------------------------------------------------------------------------
+    lw_platform_file_mapping mapping;
+    check_success(lw_platform_map_file("capture.lwc", &mapping), "Failed to map capture file");
+
+    lw_capture_replay_device replay;
+    check_success(lw_capture_create_replay_device(mapping.data, mapping.size, 100, &replay_sleep_callback, &replay), "Failed to open capture");
+
+    replay.device.packet_callback = &replay_packet_callback;
+    lw_grf250_init_period_estimator(&period_estimator, 50);
+
+    uint32_t replay_start_time = lw_platform_get_time_ms();
+
+    // NOTE: Polling fails once the whole capture has been replayed.
+    while (lw_device_poll(&replay.device, 100) == LW_RESULT_SUCCESS) {
+    }
+
+    printf("Replayed %u samples in %u ms, period %.3f ms, jitter %.3f ms\n",
+           replayed_samples, lw_platform_get_time_ms() - replay_start_time,
+           (double)period_estimator.period_ns / 1000000.0, (double)period_estimator.jitter_ns / 1000000.0);
+
+    lw_platform_unmap_file(&mapping);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
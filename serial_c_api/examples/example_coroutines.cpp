@@ -0,0 +1,169 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250_coro.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+
+#include <poll.h>
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+#define DEVICE_COUNT 3
+
+static lw_platform_serial_device grf250[DEVICE_COUNT];
+
+// ----------------------------------------------------------------------------
+// Loop wait.
+//
+// Sleeps until any serial port has data, so the single thread is idle while
+// every sensor is waiting.
+// ----------------------------------------------------------------------------
+void wait_for_ports(void *user_data, uint32_t timeout_ms) {
+    (void)user_data;
+
+#ifdef __linux__
+    struct pollfd descriptors[DEVICE_COUNT];
+
+    for (uint32_t i = 0; i < DEVICE_COUNT; ++i) {
+        descriptors[i].fd = grf250[i].serial_port;
+        descriptors[i].events = POLLIN;
+        descriptors[i].revents = 0;
+    }
+
+    poll(descriptors, DEVICE_COUNT, (int)timeout_ms);
+#else
+    // NOTE: Windows serial handles can not be waited on together without
+    // overlapped I/O, so the loop just polls.
+    (void)timeout_ms;
+
+    lw_platform_sleep(1);
+#endif
+}
+
+// ----------------------------------------------------------------------------
+// Sensor coroutine.
+//
+// Straight-line code for one sensor. Every co_await suspends only this
+// coroutine, the other sensors keep running on the same thread.
+// ----------------------------------------------------------------------------
+lw_grf250_coro::task<lw_result> run_sensor(lw_grf250_coro::sensor &grf, const char *port_name) {
+    auto name = co_await grf.get_product_name();
+
+    if (name.result != LW_RESULT_SUCCESS) {
+        printf("%s: Failed to read product name\n", port_name);
+        co_return name.result;
+    }
+
+    auto rate = co_await grf.set_update_rate(20);
+    auto distance_config = co_await grf.set_distance_config(LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW | LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_STRENGTH);
+
+    if (rate.result != LW_RESULT_SUCCESS || distance_config.result != LW_RESULT_SUCCESS) {
+        printf("%s: Failed to configure\n", port_name);
+        co_return LW_RESULT_ERROR;
+    }
+
+    grf.set_decoder_config(distance_config.value);
+    printf("%s: %s at %u Hz\n", port_name, name.value.value, rate.value);
+
+    auto stream = co_await grf.set_stream(LW_GRF250_STREAM_DISTANCE);
+
+    if (stream.result != LW_RESULT_SUCCESS) {
+        co_return stream.result;
+    }
+
+    for (uint32_t i = 0; i < 100; ++i) {
+        auto sample = co_await grf.next_distance(1000);
+
+        if (sample.result != LW_RESULT_SUCCESS) {
+            printf("%s: Stream stopped: %d\n", port_name, sample.result);
+            co_return sample.result;
+        }
+
+        if (i % 10 == 0) {
+            printf("%s: %d mm, strength %d\n", port_name, sample.value.first_return_raw_mm, sample.value.first_return_strength);
+        }
+
+        // Requests can be awaited mid-stream, samples that arrive meanwhile are queued.
+        if (i == 50) {
+            auto new_rate = co_await grf.set_update_rate(50);
+            printf("%s: Update rate %u Hz\n", port_name, new_rate.value);
+        }
+    }
+
+    co_await grf.set_stream(LW_GRF250_STREAM_NONE);
+    co_return LW_RESULT_SUCCESS;
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    const char *port_names[DEVICE_COUNT] = {"\\\\.\\COM70", "\\\\.\\COM71", "\\\\.\\COM72"};
+
+    for (uint32_t i = 0; i < DEVICE_COUNT; ++i) {
+        check_success(lw_platform_create_serial_device(port_names[i], 115200, &grf250[i]), "Failed to create serial device");
+        check_success(lw_grf250_initiate_serial(&grf250[i].device), "Failed to initiate serial\n");
+        check_success(lw_grf250_set_stream(&grf250[i].device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    }
+
+    // ----------------------------------------------------------------------------
+    // Run a coroutine per sensor on this thread.
+    // ----------------------------------------------------------------------------
+    lw_grf250_coro::loop loop(&wait_for_ports, NULL);
+    lw_grf250_coro::sensor sensors[DEVICE_COUNT] = {
+        {loop, &grf250[0].device, LW_GRF250_DISTANCE_CONFIG_ALL},
+        {loop, &grf250[1].device, LW_GRF250_DISTANCE_CONFIG_ALL},
+        {loop, &grf250[2].device, LW_GRF250_DISTANCE_CONFIG_ALL},
+    };
+
+    lw_grf250_coro::task<lw_result> tasks[DEVICE_COUNT] = {
+        run_sensor(sensors[0], port_names[0]),
+        run_sensor(sensors[1], port_names[1]),
+        run_sensor(sensors[2], port_names[2]),
+    };
+
+    for (uint32_t i = 0; i < DEVICE_COUNT; ++i) {
+        tasks[i].start();
+    }
+
+    uint32_t remaining = DEVICE_COUNT;
+
+    while (remaining != 0) {
+        loop.poll(100);
+        remaining = 0;
+
+        for (uint32_t i = 0; i < DEVICE_COUNT; ++i) {
+            remaining += tasks[i].done() ? 0 : 1;
+        }
+    }
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    for (uint32_t i = 0; i < DEVICE_COUNT; ++i) {
+        printf("%s: %s, %u overruns\n", port_names[i], tasks[i].get() == LW_RESULT_SUCCESS ? "completed" : "failed", sensors[i].overruns());
+    }
+
+    printf("Sample completed\n");
+
+    return 0;
+}
@@ -0,0 +1,97 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250_filter.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    lw_platform_serial_device grf250;
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    // ----------------------------------------------------------------------------
+    // Stream raw distances, the device filters are turned off so every view
+    // starts from the same unfiltered samples.
+    // ----------------------------------------------------------------------------
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW | LW_GRF250_DISTANCE_CONFIG_LAST_RETURN_RAW;
+
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    check_success(lw_grf250_set_median_filter_enable(&grf250.device, LW_GRF250_DISABLED), "Failed to disable median filter\n");
+    check_success(lw_grf250_set_smooth_filter_enable(&grf250.device, LW_GRF250_DISABLED), "Failed to disable smooth filter\n");
+    check_success(lw_grf250_set_rolling_average_enable(&grf250.device, LW_GRF250_DISABLED), "Failed to disable rolling average\n");
+    check_success(lw_grf250_set_update_rate(&grf250.device, 50), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+
+    // ----------------------------------------------------------------------------
+    // Three views of the stream: a gated median for control, a lightly
+    // smoothed first return for display, and a one second mean of the last
+    // return.
+    // ----------------------------------------------------------------------------
+    static lw_filter_median_entry median_entries[15];
+    static int32_t mean_values[50];
+
+    lw_filter_stage control_stages[2];
+    check_success(lw_filter_init_gate(&control_stages[0], 2000, 5), "Failed to init gate");
+    check_success(lw_filter_init_median(&control_stages[1], median_entries, 15), "Failed to init median");
+
+    lw_filter_stage display_stages[1];
+    check_success(lw_filter_init_ema(&display_stages[0], LW_FILTER_EMA_ALPHA(0.3)), "Failed to init ema");
+
+    lw_filter_stage average_stages[1];
+    check_success(lw_filter_init_mean(&average_stages[0], mean_values, 50), "Failed to init mean");
+
+    lw_grf250_filter_view views[3];
+    lw_grf250_init_filter_view(&views[0], LW_GRF250_FILTER_FIRST_RETURN, control_stages, 2);
+    lw_grf250_init_filter_view(&views[1], LW_GRF250_FILTER_FIRST_RETURN, display_stages, 1);
+    lw_grf250_init_filter_view(&views[2], LW_GRF250_FILTER_LAST_RETURN, average_stages, 1);
+
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    for (int i = 0; i < 500; ++i) {
+        lw_grf250_distance_data distance_data;
+        lw_result result = lw_grf250_wait_for_filtered_distance(&grf250.device, distance_config, views, 3, &distance_data, 1000);
+
+        if (result != LW_RESULT_SUCCESS) {
+            printf("Failed to get streamed distance\n");
+            continue;
+        }
+
+        printf("Raw: %6d mm, control: %6d mm, display: %6d mm, last return mean: %6d mm\n",
+               distance_data.first_return_raw_mm, views[0].distance_mm, views[1].distance_mm, views[2].distance_mm);
+    }
+
+    printf("Outliers rejected: %u\n", control_stages[0].rejected);
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+
+    printf("Sample completed\n");
+
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_reactor.h"
+#elif __linux__
+#include "lw_platform_linux_reactor.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Reactor callbacks.
+// ----------------------------------------------------------------------------
+void distance_callback(lw_platform_reactor_device *reactor_device, lw_grf250_distance_data *distance_data) {
+    const char *port_name = (const char *)reactor_device->user_data;
+    printf("%s: %d mm\n", port_name, distance_data->first_return_raw_mm);
+}
+
+void error_callback(lw_platform_reactor_device *reactor_device) {
+    const char *port_name = (const char *)reactor_device->user_data;
+    printf("%s: Connection lost\n", port_name);
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    const char *port_names[] = {"\\\\.\\COM70", "\\\\.\\COM71", "\\\\.\\COM72"};
+    const uint32_t device_count = sizeof(port_names) / sizeof(port_names[0]);
+
+    lw_platform_serial_device grf250[3];
+    lw_platform_reactor_device *reactor_devices[3];
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
+
+    lw_platform_reactor reactor;
+    check_success(lw_platform_reactor_create(&reactor), "Failed to create reactor");
+
+    // ----------------------------------------------------------------------------
+    // Set up each device with the blocking managed commands, then hand it to
+    // the reactor.
+    // ----------------------------------------------------------------------------
+    for (uint32_t i = 0; i < device_count; ++i) {
+        check_success(lw_platform_create_serial_device(port_names[i], 115200, &grf250[i]), "Failed to create serial device");
+        check_success(lw_grf250_initiate_serial(&grf250[i].device), "Failed to initiate serial\n");
+        check_success(lw_grf250_set_stream(&grf250[i].device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+        check_success(lw_grf250_set_update_rate(&grf250[i].device, 20), "Failed to set update rate\n");
+        check_success(lw_grf250_set_distance_config(&grf250[i].device, distance_config), "Failed to set distance config\n");
+        check_success(lw_grf250_set_stream(&grf250[i].device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+        check_success(lw_platform_reactor_add_device(&reactor, &grf250[i], distance_config, (void *)port_names[i], &reactor_devices[i]), "Failed to add device to reactor");
+
+        reactor_devices[i]->distance_callback = &distance_callback;
+        reactor_devices[i]->error_callback = &error_callback;
+    }
+
+    // ----------------------------------------------------------------------------
+    // Service all devices from a single thread.
+    // ----------------------------------------------------------------------------
+    uint32_t end_time = lw_platform_get_time_ms() + 5000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        if (lw_platform_reactor_poll(&reactor, 100) == LW_RESULT_ERROR) {
+            printf("Reactor error\n");
+            return 1;
+        }
+    }
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    for (uint32_t i = 0; i < device_count; ++i) {
+        lw_platform_reactor_remove_device(&reactor, reactor_devices[i]);
+        lw_grf250_set_stream(&grf250[i].device, LW_GRF250_STREAM_NONE);
+    }
+
+    lw_platform_reactor_destroy(&reactor);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
@@ -0,0 +1,106 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lw_serial_api_grf250_provision.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+static lw_platform_serial_device devices[4];
+static lw_grf250_provision_job jobs[4];
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    const char *port_names[] = {"\\\\.\\COM70", "\\\\.\\COM71", "\\\\.\\COM72", "\\\\.\\COM73"};
+    const uint32_t device_count = sizeof(port_names) / sizeof(port_names[0]);
+
+    check_success(lw_platform_init(), "Failed to initialize platform");
+
+    // ----------------------------------------------------------------------------
+    // The fleet profile: 20 Hz, alarm A at 5 m on the GPIO, filters off.
+    // ----------------------------------------------------------------------------
+    lw_grf250_provision_profile profile;
+    lw_grf250_init_provision_profile(&profile);
+
+    profile.config.update_rate = 20;
+    profile.config.alarm_a_distance_cm = 500;
+    profile.config.alarm_hysteresis_cm = 20;
+    profile.config.gpio_mode = LW_GRF250_GPIO_MODE_ALARM_A;
+    profile.config.median_filter_enable = LW_GRF250_DISABLED;
+    profile.config.smooth_filter_enable = LW_GRF250_DISABLED;
+    profile.config.rolling_average_enable = LW_GRF250_DISABLED;
+    profile.fields = LW_GRF250_CONFIG_UPDATE_RATE | LW_GRF250_CONFIG_ALARM_A_DISTANCE | LW_GRF250_CONFIG_ALARM_HYSTERESIS | LW_GRF250_CONFIG_GPIO_MODE | LW_GRF250_CONFIG_MEDIAN_FILTER_ENABLE | LW_GRF250_CONFIG_SMOOTH_FILTER_ENABLE | LW_GRF250_CONFIG_ROLLING_AVERAGE_ENABLE;
+
+    // ----------------------------------------------------------------------------
+    // Provision every port at once from this thread. Ports that fail to open
+    // are reported without being provisioned.
+    // ----------------------------------------------------------------------------
+    lw_callback_device *fleet[4];
+    lw_grf250_provision_report fleet_reports[4];
+    lw_grf250_provision_report reports[4];
+    uint32_t fleet_ports[4];
+    uint32_t fleet_count = 0;
+    uint32_t start_time = lw_platform_get_time_ms();
+
+    for (uint32_t i = 0; i < device_count; ++i) {
+        if (lw_platform_create_serial_device(port_names[i], 115200, &devices[i]) != LW_RESULT_SUCCESS) {
+            memset(&reports[i], 0, sizeof(lw_grf250_provision_report));
+            reports[i].result = LW_RESULT_ERROR;
+            reports[i].step = LW_GRF250_PROVISION_CONNECT;
+            continue;
+        }
+
+        fleet[fleet_count] = &devices[i].device;
+        fleet_ports[fleet_count] = i;
+        ++fleet_count;
+    }
+
+    lw_grf250_provision_fleet(fleet, fleet_count, &profile, jobs, fleet_reports);
+
+    for (uint32_t i = 0; i < fleet_count; ++i) {
+        reports[fleet_ports[i]] = fleet_reports[i];
+        lw_platform_serial_disconnect(&devices[fleet_ports[i]].serial_port);
+    }
+
+    // ----------------------------------------------------------------------------
+    // Report.
+    // ----------------------------------------------------------------------------
+    uint32_t failed = 0;
+
+    for (uint32_t i = 0; i < device_count; ++i) {
+        lw_grf250_provision_report *report = &reports[i];
+
+        if (report->result == LW_RESULT_SUCCESS) {
+            printf("%s: %s changed 0x%06X%s in %u ms\n", port_names[i], report->serial_number, report->changed, report->saved ? " and saved" : "", report->elapsed_ms);
+        } else {
+            printf("%s: Failed at %s (result %d, mismatched 0x%06X)\n", port_names[i], lw_grf250_provision_step_name(report->step), report->result, report->mismatched);
+            ++failed;
+        }
+    }
+
+    printf("Provisioned %u of %u devices in %u ms\n", device_count - failed, device_count, lw_platform_get_time_ms() - start_time);
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Connect, or reconnect, until the device answers.
+// ----------------------------------------------------------------------------
+void resume(lw_platform_serial_device *grf250, lw_grf250_session *session, const char *port_name, uint8_t reopen) {
+    while (1) {
+        if (reopen) {
+            lw_platform_serial_disconnect(&grf250->serial_port);
+
+            if (lw_platform_create_serial_device(port_name, 115200, grf250) != LW_RESULT_SUCCESS) {
+                lw_platform_sleep(500);
+                continue;
+            }
+        }
+
+        uint32_t start_time = lw_platform_get_time_ms();
+
+        if (lw_grf250_resume_session(&grf250->device, session) == LW_RESULT_SUCCESS) {
+            printf("Connected in %u ms:%s%s%s%s\n", lw_platform_get_time_ms() - start_time,
+                   (session->steps & LW_GRF250_RESUME_INITIATED) ? " initiated serial" : "",
+                   (session->steps & LW_GRF250_RESUME_PRODUCT_INFO) ? " read product info" : "",
+                   (session->steps & LW_GRF250_RESUME_DISTANCE_CONFIG) ? " restored distance config" : "",
+                   (session->steps & LW_GRF250_RESUME_STREAM) ? " restored stream" : "");
+
+            if (session->steps & LW_GRF250_RESUME_PRODUCT_INFO) {
+                printf("Product name: %s\n", session->product_info.product_name);
+                printf("Serial number: %s\n", session->product_info.serial_number);
+            }
+
+            return;
+        }
+
+        printf("Device did not answer, retrying\n");
+        reopen = 1;
+        lw_platform_sleep(500);
+    }
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    const char *port_name = "\\\\.\\COM70";
+    lw_platform_serial_device grf250;
+    check_success(lw_platform_create_serial_device(port_name, 115200, &grf250), "Failed to create serial device");
+
+    // ----------------------------------------------------------------------------
+    // Stream distances, and resume the session whenever the link drops or
+    // the stream stops, eg: after the device was power cycled.
+    // ----------------------------------------------------------------------------
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW | LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_STRENGTH;
+
+    lw_grf250_session session;
+    lw_grf250_init_session(&session, distance_config, LW_GRF250_STREAM_DISTANCE);
+    resume(&grf250, &session, port_name, 0);
+
+    uint32_t end_time = lw_platform_get_time_ms() + 60000;
+
+    while (lw_platform_get_time_ms() < end_time) {
+        lw_grf250_distance_data distance_data;
+        lw_result result = lw_grf250_wait_for_streamed_distance(&grf250.device, distance_config, &distance_data, 1000);
+
+        if (result == LW_RESULT_SUCCESS) {
+            printf("Streamed distance: %d mm\n", distance_data.first_return_raw_mm);
+        } else if (result == LW_RESULT_TIMEOUT) {
+            printf("Stream timeout\n");
+            resume(&grf250, &session, port_name, 0);
+        } else {
+            printf("Communication error\n");
+            resume(&grf250, &session, port_name, 1);
+        }
+    }
+
+    lw_platform_serial_disconnect(&grf250.serial_port);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
@@ -0,0 +1,190 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lw_serial_api_grf250_shared.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#define SAMPLES_NAME "Local\\grf250_samples"
+#define COMMANDS_NAME "Local\\grf250_commands"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#define SAMPLES_NAME "/grf250_samples"
+#define COMMANDS_NAME "/grf250_commands"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Publisher.
+//
+// Owns the serial port, publishes every streamed sample and sends the
+// requests of the subscribers between samples.
+// ----------------------------------------------------------------------------
+void run_publisher(void) {
+    lw_platform_serial_device grf250;
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
+
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    check_success(lw_grf250_set_update_rate(&grf250.device, 50), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+
+    lw_platform_shared_memory samples_memory;
+    lw_platform_shared_memory commands_memory;
+    check_success(lw_platform_shared_memory_create(SAMPLES_NAME, lw_grf250_shared_ring_size(1024), &samples_memory), "Failed to create sample memory");
+    check_success(lw_platform_shared_memory_create(COMMANDS_NAME, sizeof(lw_grf250_shared_commands), &commands_memory), "Failed to create command memory");
+
+    lw_grf250_shared_ring *ring = (lw_grf250_shared_ring *)samples_memory.data;
+    lw_grf250_shared_commands *commands = (lw_grf250_shared_commands *)commands_memory.data;
+    check_success(lw_grf250_shared_ring_init(ring, 1024), "Failed to init ring");
+    lw_grf250_shared_commands_init(commands);
+
+    // Samples that arrive while a subscriber request waits are kept for the ring.
+    static lw_stream_queue stream_queue;
+    lw_device_enable_stream_queue(&grf250.device, &stream_queue);
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    printf("Publishing for 60 seconds, run \"example_shared_memory subscribe\" to follow\n");
+    uint32_t end_time = lw_platform_get_time_ms() + 60000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        lw_result result = lw_grf250_shared_ring_receive(&grf250.device, ring, distance_config, 10);
+
+        if (result == LW_RESULT_ERROR) {
+            printf("Publisher: Read failed\n");
+            break;
+        }
+
+        lw_grf250_shared_commands_service(&grf250.device, commands);
+    }
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE);
+    lw_device_enable_stream_queue(&grf250.device, NULL);
+
+    printf("Published %u samples, %u overruns\n", lw_atomic_load_acquire(&ring->head), stream_queue.overruns);
+
+    lw_platform_shared_memory_close(&commands_memory);
+    lw_platform_shared_memory_close(&samples_memory);
+}
+
+// ----------------------------------------------------------------------------
+// Subscriber.
+//
+// Maps the ring read only and follows it, without touching the serial port.
+// ----------------------------------------------------------------------------
+lw_result send_command(lw_grf250_shared_commands *commands, lw_request *request, lw_response *response) {
+    uint32_t slot;
+    LW_CHECK_SUCCESS(lw_grf250_shared_command_submit(commands, request, &slot))
+
+    uint32_t end_time = lw_platform_get_time_ms() + 2000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        lw_result command_result = lw_grf250_shared_command_poll(commands, slot, response);
+
+        if (command_result != LW_RESULT_AGAIN) {
+            return command_result;
+        }
+
+        lw_platform_sleep(1);
+    }
+
+    // NOTE: The slot stays claimed until the publisher answers.
+    return LW_RESULT_TIMEOUT;
+}
+
+void run_subscriber(void) {
+    lw_platform_shared_memory samples_memory;
+    lw_platform_shared_memory commands_memory;
+    check_success(lw_platform_shared_memory_open(SAMPLES_NAME, 0, &samples_memory), "Failed to open sample memory, is the publisher running?");
+    check_success(lw_platform_shared_memory_open(COMMANDS_NAME, 1, &commands_memory), "Failed to open command memory");
+
+    lw_grf250_shared_reader reader;
+    lw_grf250_shared_commands *commands = (lw_grf250_shared_commands *)commands_memory.data;
+    check_success(lw_grf250_shared_reader_init(&reader, (const lw_grf250_shared_ring *)samples_memory.data, samples_memory.size), "Sample memory does not hold a ring");
+    check_success(lw_grf250_shared_commands_check(commands, commands_memory.size), "Command memory does not hold a command channel");
+
+    // ----------------------------------------------------------------------------
+    // Read every sample for 2 seconds.
+    // ----------------------------------------------------------------------------
+    uint32_t count = 0;
+    uint32_t end_time = lw_platform_get_time_ms() + 2000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        lw_grf250_stream_sample sample;
+
+        while (lw_grf250_shared_reader_next(&reader, &sample) == LW_RESULT_SUCCESS) {
+            if (sample.stream == LW_GRF250_STREAM_DISTANCE && count++ % 10 == 0) {
+                printf("Distance: %d mm\n", sample.data.distance_data.first_return_raw_mm);
+            }
+        }
+
+        lw_platform_sleep(10);
+    }
+
+    printf("Read %u samples, %u lost\n", count, reader.lost);
+
+    // ----------------------------------------------------------------------------
+    // Ask the publisher to change the update rate.
+    // ----------------------------------------------------------------------------
+    lw_request request;
+    lw_response response;
+    uint32_t update_rate = 0;
+
+    check_success(lw_grf250_create_request_write_update_rate(&request, 20), "Failed to create request");
+    check_success(send_command(commands, &request, &response), "Failed to send command");
+    check_success(lw_grf250_parse_response_update_rate(&response, &update_rate), "Failed to parse response");
+    printf("Update rate set to %u Hz\n", update_rate);
+
+    // ----------------------------------------------------------------------------
+    // Only follow the most recent sample for 2 seconds.
+    // ----------------------------------------------------------------------------
+    end_time = lw_platform_get_time_ms() + 2000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        lw_grf250_stream_sample sample;
+
+        if (lw_grf250_shared_reader_latest(&reader, &sample) == LW_RESULT_SUCCESS && sample.stream == LW_GRF250_STREAM_DISTANCE) {
+            printf("Latest distance: %d mm\n", sample.data.distance_data.first_return_raw_mm);
+        }
+
+        lw_platform_sleep(250);
+    }
+
+    lw_platform_shared_memory_close(&commands_memory);
+    lw_platform_shared_memory_close(&samples_memory);
+}
+
+int main(int argc, char **argv) {
+    check_success(lw_platform_init(), "Failed to initialize platform");
+
+    if (argc > 1 && strcmp(argv[1], "subscribe") == 0) {
+        run_subscriber();
+    } else {
+        run_publisher();
+    }
+
+    printf("Sample completed\n");
+
+    return 0;
+}
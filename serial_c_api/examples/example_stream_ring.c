@@ -0,0 +1,118 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lw_serial_api_grf250_ring.h"
+
+#ifdef _WIN32
+#include "lw_platform_win_serial.h"
+#elif __linux__
+#include "lw_platform_linux_serial.h"
+#endif
+
+void lw_debug_print(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
+void check_success(lw_result result, const char *error_message) {
+    if (result != LW_RESULT_SUCCESS) {
+        printf("%s\n", error_message);
+        exit(1);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Reader thread.
+//
+// The reader thread owns the serial device and is the only producer for the
+// ring. The main thread is the only consumer.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_platform_serial_device *serial_device;
+    lw_grf250_sample_ring *ring;
+    lw_grf_distance_config distance_config;
+    lw_atomic_uint32 running;
+} reader_context;
+
+void reader_thread(void *user_data) {
+    reader_context *context = (reader_context *)user_data;
+
+    while (lw_atomic_load_acquire(&context->running)) {
+        lw_result result = lw_grf250_sample_ring_receive(&context->serial_device->device, context->ring, context->distance_config, 100);
+
+        if (result == LW_RESULT_ERROR) {
+            printf("Reader: Read failed\n");
+            return;
+        }
+    }
+}
+
+int main(void) {
+    // ----------------------------------------------------------------------------
+    // Platform related setup.
+    // ----------------------------------------------------------------------------
+    // Example Windows COM port: "\\\\.\\COM70"
+    // Example Linux device serial port: "/dev/ttyACM0"
+    lw_platform_serial_device grf250;
+    check_success(lw_platform_create_serial_device("\\\\.\\COM70", 115200, &grf250), "Failed to create serial device");
+
+    // ----------------------------------------------------------------------------
+    // Start a distance stream.
+    // ----------------------------------------------------------------------------
+    lw_grf_distance_config distance_config = LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_RAW | LW_GRF250_DISTANCE_CONFIG_FIRST_RETURN_STRENGTH;
+
+    check_success(lw_grf250_initiate_serial(&grf250.device), "Failed to initiate serial\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE), "Failed to set stream: none\n");
+    check_success(lw_grf250_set_update_rate(&grf250.device, 50), "Failed to set update rate\n");
+    check_success(lw_grf250_set_distance_config(&grf250.device, distance_config), "Failed to set distance config\n");
+    check_success(lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_DISTANCE), "Failed to set stream: distance\n");
+
+    // ----------------------------------------------------------------------------
+    // Fill the ring on a reader thread.
+    // ----------------------------------------------------------------------------
+    static lw_grf250_stream_sample samples[256];
+    lw_grf250_sample_ring ring;
+    check_success(lw_grf250_sample_ring_init(&ring, samples, 256), "Failed to init ring");
+
+    reader_context context;
+    context.serial_device = &grf250;
+    context.ring = &ring;
+    context.distance_config = distance_config;
+    lw_atomic_store_release(&context.running, 1);
+
+    lw_platform_thread thread;
+    check_success(lw_platform_thread_create(&thread, &reader_thread, &context), "Failed to create reader thread");
+
+    // ----------------------------------------------------------------------------
+    // Drain the ring in batches at a slower rate than the stream.
+    // ----------------------------------------------------------------------------
+    uint32_t end_time = lw_platform_get_time_ms() + 5000;
+
+    while ((int32_t)(end_time - lw_platform_get_time_ms()) > 0) {
+        lw_grf250_stream_sample batch[32];
+        uint32_t count = lw_grf250_sample_ring_pop_batch(&ring, batch, 32);
+
+        for (uint32_t i = 0; i < count; ++i) {
+            if (batch[i].stream == LW_GRF250_STREAM_DISTANCE) {
+                printf("Distance: %d mm Strength: %d\n", batch[i].data.distance_data.first_return_raw_mm, batch[i].data.distance_data.first_return_strength);
+            }
+        }
+
+        printf("Batch: %u samples, %u overruns\n", count, lw_grf250_sample_ring_overruns(&ring));
+        lw_platform_sleep(200);
+    }
+
+    // ----------------------------------------------------------------------------
+    // Closing down.
+    // ----------------------------------------------------------------------------
+    lw_atomic_store_release(&context.running, 0);
+    lw_platform_thread_join(&thread);
+
+    lw_grf250_set_stream(&grf250.device, LW_GRF250_STREAM_NONE);
+
+    printf("Sample completed\n");
+
+    return 0;
+}
@@ -2,7 +2,10 @@
 
 #include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <termios.h>
 #include <time.h>
 #include <unistd.h>
@@ -12,6 +15,18 @@
 // ----------------------------------------------------------------------------
 uint32_t convert_baud_rate(uint32_t baud_rate) {
     switch (baud_rate) {
+        case 9600: {
+            return B9600;
+        }
+        case 19200: {
+            return B19200;
+        }
+        case 38400: {
+            return B38400;
+        }
+        case 57600: {
+            return B57600;
+        }
         case 115200: {
             return B115200;
         }
@@ -32,7 +47,7 @@ uint32_t convert_baud_rate(uint32_t baud_rate) {
         }
     }
 
-    return B115200;
+    return B0;
 }
 
 void lw_platform_serial_disconnect(lw_platform_serial_port *serial_port) {
@@ -47,7 +62,9 @@ lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate,
     *serial_port = -1;
     LW_DEBUG_LVL_1("Attempt com connection: %s\n", port_name);
 
-    int32_t descriptor = open(port_name, O_RDWR | O_NOCTTY | O_SYNC | O_NONBLOCK);
+    // NOTE: The descriptor stays non-blocking, lw_platform_serial_read_timeout
+    // waits for data with poll.
+    int32_t descriptor = open(port_name, O_RDWR | O_NOCTTY | O_NONBLOCK);
 
     if (descriptor < 0) {
         LW_DEBUG_LVL_1("Serial Connect: Failed to open.\n");
@@ -61,10 +78,16 @@ lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate,
         return LW_RESULT_ERROR;
     }
 
-    baud_rate = convert_baud_rate(baud_rate);
+    speed_t speed = convert_baud_rate(baud_rate);
 
-    cfsetospeed(&tty, baud_rate);
-    cfsetispeed(&tty, baud_rate);
+    if (speed == B0) {
+        LW_DEBUG_LVL_1("Serial Connect: Unsupported baud rate %u.\n", baud_rate);
+        close(descriptor);
+        return LW_RESULT_ERROR;
+    }
+
+    cfsetospeed(&tty, speed);
+    cfsetispeed(&tty, speed);
 
     tty.c_cflag = (tty.c_cflag & ~(tcflag_t)CSIZE) | CS8;
     tty.c_cflag |= (CLOCAL | CREAD);
@@ -77,6 +100,8 @@ lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate,
     tty.c_iflag &= ~((tcflag_t)IXON | (tcflag_t)IXOFF | (tcflag_t)IXANY);
     tty.c_lflag = 0;
     tty.c_oflag = 0;
+    tty.c_cc[VMIN] = 0;
+    tty.c_cc[VTIME] = 0;
 
     if (tcsetattr(descriptor, TCSANOW, &tty) != 0) {
         LW_DEBUG_LVL_1("Serial Connect: Failed to set attribute.\n");
@@ -90,6 +115,35 @@ lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate,
     return LW_RESULT_SUCCESS;
 }
 
+lw_result lw_platform_serial_set_baud_rate(lw_platform_serial_port *serial_port, uint32_t baud_rate) {
+    speed_t speed = convert_baud_rate(baud_rate);
+
+    if (*serial_port < 0 || speed == B0) {
+        LW_DEBUG_LVL_1("Serial Baud Rate: Invalid port or baud rate %u.\n", baud_rate);
+        return LW_RESULT_ERROR;
+    }
+
+    struct termios tty;
+
+    // NOTE: Bytes still queued for sending go out at the old rate first.
+    if (tcdrain(*serial_port) != 0 || tcgetattr(*serial_port, &tty) != 0) {
+        LW_DEBUG_LVL_1("Serial Baud Rate: Failed to get attribute.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    cfsetospeed(&tty, speed);
+    cfsetispeed(&tty, speed);
+
+    if (tcsetattr(*serial_port, TCSANOW, &tty) != 0) {
+        LW_DEBUG_LVL_1("Serial Baud Rate: Failed to set attribute.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    tcflush(*serial_port, TCIFLUSH);
+
+    return LW_RESULT_SUCCESS;
+}
+
 uint32_t lw_platform_serial_write(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size) {
     if (*serial_port < 0) {
         LW_DEBUG_LVL_1("Serial Write: Invalid Serial Port.\n");
@@ -117,7 +171,7 @@ int32_t lw_platform_serial_read(lw_platform_serial_port *serial_port, uint8_t *b
     ssize_t bytes_read = read(*serial_port, buffer, size);
 
     if (bytes_read == -1) {
-        if (errno == EAGAIN) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
             return 0;
         }
 
@@ -127,17 +181,208 @@ int32_t lw_platform_serial_read(lw_platform_serial_port *serial_port, uint8_t *b
     return (int32_t)bytes_read;
 }
 
+int32_t lw_platform_serial_read_timeout(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
+    if (*serial_port < 0) {
+        LW_DEBUG_LVL_1("Serial Read: Invalid Serial Port.\n");
+        return 0;
+    }
+
+    if (timeout_ms != 0) {
+        struct pollfd descriptor;
+        descriptor.fd = *serial_port;
+        descriptor.events = POLLIN;
+        descriptor.revents = 0;
+
+        int result = poll(&descriptor, 1, (int)timeout_ms);
+
+        if (result == 0) {
+            return 0;
+        }
+
+        if (result < 0) {
+            // NOTE: Interrupted waits are reported as a timeout and re-issued by the API.
+            return errno == EINTR ? 0 : -1;
+        }
+
+        if ((descriptor.revents & POLLIN) == 0) {
+            LW_DEBUG_LVL_1("Serial Read: Port error.\n");
+            return -1;
+        }
+    }
+
+    return lw_platform_serial_read(serial_port, buffer, size);
+}
+
 uint32_t lw_platform_get_time_ms(void) {
     struct timespec time;
-    clock_gettime(CLOCK_REALTIME, &time);
+    clock_gettime(CLOCK_MONOTONIC, &time);
     int64_t microsecond = time.tv_sec * 1000000 + time.tv_nsec / 1000;
     return (uint32_t)(microsecond / 1000);
 }
 
+uint64_t lw_platform_get_time_ns(void) {
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + (uint64_t)time.tv_nsec;
+}
+
 void lw_platform_sleep(uint32_t time_ms) {
     usleep(time_ms * 1000);
 }
 
+static void *lw_platform_thread_entry(void *parameter) {
+    lw_platform_thread *thread = (lw_platform_thread *)parameter;
+    thread->function(thread->user_data);
+    return NULL;
+}
+
+lw_result lw_platform_thread_create(lw_platform_thread *thread, lw_platform_thread_function function, void *user_data) {
+    thread->function = function;
+    thread->user_data = user_data;
+
+    if (pthread_create(&thread->handle, NULL, &lw_platform_thread_entry, thread) != 0) {
+        LW_DEBUG_LVL_1("Thread: Failed to create.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_thread_join(lw_platform_thread *thread) {
+    pthread_join(thread->handle, NULL);
+}
+
+// ----------------------------------------------------------------------------
+// File mapping.
+// ----------------------------------------------------------------------------
+lw_result lw_platform_map_file(const char *path, lw_platform_file_mapping *mapping) {
+    mapping->data = NULL;
+    mapping->size = 0;
+
+    int descriptor = open(path, O_RDONLY);
+
+    if (descriptor < 0) {
+        LW_DEBUG_LVL_1("Map File: Failed to open %s: %s\n", path, strerror(errno));
+        return LW_RESULT_ERROR;
+    }
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+        LW_DEBUG_LVL_1("Map File: Failed to get the size of %s\n", path);
+        close(descriptor);
+        return LW_RESULT_ERROR;
+    }
+
+    void *data = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+    // NOTE: The mapping stays valid after the descriptor is closed.
+    close(descriptor);
+
+    if (data == MAP_FAILED) {
+        LW_DEBUG_LVL_1("Map File: Failed to map %s: %s\n", path, strerror(errno));
+        return LW_RESULT_ERROR;
+    }
+
+    mapping->data = (const uint8_t *)data;
+    mapping->size = (uint64_t)status.st_size;
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_unmap_file(lw_platform_file_mapping *mapping) {
+    if (mapping->data != NULL) {
+        munmap((void *)mapping->data, (size_t)mapping->size);
+    }
+
+    mapping->data = NULL;
+    mapping->size = 0;
+}
+
+// ----------------------------------------------------------------------------
+// Shared memory.
+// ----------------------------------------------------------------------------
+lw_result lw_platform_shared_memory_create(const char *name, uint64_t size, lw_platform_shared_memory *memory) {
+    memset(memory, 0, sizeof(*memory));
+
+    if (strlen(name) >= sizeof(memory->name)) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    // NOTE: A segment left by a crashed owner is replaced, its readers keep
+    // the old mapping until they open the name again.
+    shm_unlink(name);
+    int descriptor = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+
+    if (descriptor < 0) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to create %s: %s\n", name, strerror(errno));
+        return LW_RESULT_ERROR;
+    }
+
+    void *data = MAP_FAILED;
+
+    if (ftruncate(descriptor, (off_t)size) == 0) {
+        data = mmap(NULL, (size_t)size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    }
+
+    close(descriptor);
+
+    if (data == MAP_FAILED) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to map %s: %s\n", name, strerror(errno));
+        shm_unlink(name);
+        return LW_RESULT_ERROR;
+    }
+
+    memory->data = (uint8_t *)data;
+    memory->size = size;
+    memory->owner = 1;
+    strcpy(memory->name, name);
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_platform_shared_memory_open(const char *name, uint8_t writable, lw_platform_shared_memory *memory) {
+    memset(memory, 0, sizeof(*memory));
+
+    int descriptor = shm_open(name, writable ? O_RDWR : O_RDONLY, 0);
+
+    if (descriptor < 0) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to open %s: %s\n", name, strerror(errno));
+        return LW_RESULT_ERROR;
+    }
+
+    struct stat status;
+    void *data = MAP_FAILED;
+
+    if (fstat(descriptor, &status) == 0 && status.st_size != 0) {
+        data = mmap(NULL, (size_t)status.st_size, writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, descriptor, 0);
+    }
+
+    close(descriptor);
+
+    if (data == MAP_FAILED) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to map %s\n", name);
+        return LW_RESULT_ERROR;
+    }
+
+    memory->data = (uint8_t *)data;
+    memory->size = (uint64_t)status.st_size;
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_shared_memory_close(lw_platform_shared_memory *memory) {
+    if (memory->data != NULL) {
+        munmap(memory->data, (size_t)memory->size);
+    }
+
+    if (memory->owner) {
+        shm_unlink(memory->name);
+    }
+
+    memset(memory, 0, sizeof(*memory));
+}
+
 // ----------------------------------------------------------------------------
 // Device service callbacks.
 // ----------------------------------------------------------------------------
@@ -146,6 +391,11 @@ uint32_t lw_platform_get_time_ms_callback(lw_callback_device *device) {
     return lw_platform_get_time_ms();
 }
 
+uint64_t lw_platform_get_time_ns_callback(lw_callback_device *device) {
+    (void)device;
+    return lw_platform_get_time_ns();
+}
+
 void lw_platform_sleep_callback(lw_callback_device *device, uint32_t time_ms) {
     lw_platform_sleep(time_ms);
 }
@@ -157,8 +407,12 @@ uint32_t lw_platform_serial_send_callback(lw_callback_device *device, uint8_t *b
 
 int32_t lw_platform_serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
     lw_platform_serial_device *platform_device = (lw_platform_serial_device *)device->user_data;
-    (void)timeout_ms;
-    return lw_platform_serial_read(&platform_device->serial_port, buffer, size);
+    return lw_platform_serial_read_timeout(&platform_device->serial_port, buffer, size, timeout_ms);
+}
+
+lw_result lw_platform_set_host_baud_rate_callback(lw_callback_device *device, uint32_t baud_rate) {
+    lw_platform_serial_device *platform_device = (lw_platform_serial_device *)device->user_data;
+    return lw_platform_serial_set_baud_rate(&platform_device->serial_port, baud_rate);
 }
 
 // ----------------------------------------------------------------------------
@@ -189,5 +443,7 @@ lw_result lw_platform_create_serial_device(const char *port_name, uint32_t baud_
                                                         &lw_platform_serial_send_callback,
                                                         &lw_platform_serial_receive_callback);
 
+    lw_device_enable_timestamps(&platform_device->device, &lw_platform_get_time_ns_callback, baud_rate);
+
     return LW_RESULT_SUCCESS;
 }
@@ -3,9 +3,10 @@
 
 #include "lw_serial_api.h"
 
+#include <pthread.h>
 #include <stdlib.h>
 
-#ifdef cplusplus
+#ifdef __cplusplus
 extern "C" {
 #endif
 
@@ -16,17 +17,53 @@ typedef struct {
     lw_platform_serial_port serial_port;
 } lw_platform_serial_device;
 
+typedef struct {
+    const uint8_t *data;
+    uint64_t size;
+} lw_platform_file_mapping;
+
+typedef struct {
+    uint8_t *data;
+    uint64_t size;
+    char name[64];
+    uint8_t owner;
+} lw_platform_shared_memory;
+
+typedef void (*lw_platform_thread_function)(void *user_data);
+
+typedef struct {
+    pthread_t handle;
+    lw_platform_thread_function function;
+    void *user_data;
+} lw_platform_thread;
+
 lw_result lw_platform_create_serial_device(const char *port_name, uint32_t baud_rate, lw_platform_serial_device *platform_device);
+lw_result lw_platform_set_host_baud_rate_callback(lw_callback_device *device, uint32_t baud_rate);
 
 lw_result lw_platform_init(void);
 uint32_t lw_platform_get_time_ms(void);
+uint64_t lw_platform_get_time_ns(void);
 void lw_platform_sleep(uint32_t time_ms);
 
 lw_platform_serial_port lw_platform_create_serial_port(void);
 lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate, lw_platform_serial_port *serial_port);
 void lw_platform_serial_disconnect(lw_platform_serial_port *serial_port);
+lw_result lw_platform_serial_set_baud_rate(lw_platform_serial_port *serial_port, uint32_t baud_rate);
 uint32_t lw_platform_serial_write(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size);
 int32_t lw_platform_serial_read(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size);
+int32_t lw_platform_serial_read_timeout(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size, uint32_t timeout_ms);
+
+lw_result lw_platform_thread_create(lw_platform_thread *thread, lw_platform_thread_function function, void *user_data);
+void lw_platform_thread_join(lw_platform_thread *thread);
+
+lw_result lw_platform_map_file(const char *path, lw_platform_file_mapping *mapping);
+void lw_platform_unmap_file(lw_platform_file_mapping *mapping);
+
+// Named shared memory, eg: "/grf250", replaced if it already exists. Removed
+// again when the owner closes it.
+lw_result lw_platform_shared_memory_create(const char *name, uint64_t size, lw_platform_shared_memory *memory);
+lw_result lw_platform_shared_memory_open(const char *name, uint8_t writable, lw_platform_shared_memory *memory);
+void lw_platform_shared_memory_close(lw_platform_shared_memory *memory);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,148 @@
+#include "lw_platform_win_reactor.h"
+
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Packet dispatch.
+// ----------------------------------------------------------------------------
+static void lw_platform_reactor_dispatch(lw_platform_reactor_device *reactor_device, lw_response *response) {
+    if (response->command_id == LW_GRF250_COMMAND_DISTANCE_DATA && reactor_device->distance_callback != NULL) {
+        lw_grf250_distance_data distance_data = {0};
+
+        if (lw_grf250_decode_distance_data(&reactor_device->distance_decoder, response, &distance_data) == LW_RESULT_SUCCESS) {
+            reactor_device->distance_callback(reactor_device, &distance_data);
+        }
+    } else if (response->command_id == LW_GRF250_COMMAND_MULTI_DATA && reactor_device->multi_data_callback != NULL) {
+        lw_grf250_multi_data multi_data;
+
+        if (lw_grf250_parse_response_multi_data(response, &multi_data) == LW_RESULT_SUCCESS) {
+            reactor_device->multi_data_callback(reactor_device, &multi_data);
+        }
+    } else if (reactor_device->response_callback != NULL) {
+        reactor_device->response_callback(reactor_device, response);
+    }
+}
+
+static void lw_platform_reactor_fail_device(lw_platform_reactor *reactor, lw_platform_reactor_device *reactor_device) {
+    LW_DEBUG_LVL_1("Reactor: Device read failed.\n");
+    lw_platform_reactor_error_callback error_callback = reactor_device->error_callback;
+    lw_platform_reactor_remove_device(reactor, reactor_device);
+
+    if (error_callback != NULL) {
+        error_callback(reactor_device);
+    }
+}
+
+static lw_result lw_platform_reactor_service_device(lw_platform_reactor *reactor, lw_platform_reactor_device *reactor_device) {
+    lw_callback_device *device = &reactor_device->serial_device->device;
+
+    // Drain the receive ring without blocking, this also restarts the read.
+    while (1) {
+        lw_result result = lw_wait_for_next_response(device, LW_ANY_COMMAND, 0);
+
+        if (result == LW_RESULT_SUCCESS) {
+            lw_platform_reactor_dispatch(reactor_device, &device->response);
+
+            // NOTE: The callback may have removed the device.
+            if (reactor_device->serial_device == NULL) {
+                return LW_RESULT_SUCCESS;
+            }
+        } else if (result == LW_RESULT_AGAIN) {
+            return LW_RESULT_SUCCESS;
+        } else {
+            lw_platform_reactor_fail_device(reactor, reactor_device);
+            return LW_RESULT_ERROR;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Reactor.
+// ----------------------------------------------------------------------------
+lw_result lw_platform_reactor_create(lw_platform_reactor *reactor) {
+    memset(reactor, 0, sizeof(*reactor));
+    reactor->completion_port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+
+    if (reactor->completion_port == NULL) {
+        LW_DEBUG_LVL_1("Reactor: Failed to create completion port.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_reactor_destroy(lw_platform_reactor *reactor) {
+    for (uint32_t i = 0; i < LW_PLATFORM_REACTOR_MAX_DEVICES; ++i) {
+        lw_platform_reactor_remove_device(reactor, &reactor->devices[i]);
+    }
+
+    if (reactor->completion_port != NULL) {
+        CloseHandle(reactor->completion_port);
+    }
+
+    reactor->completion_port = NULL;
+}
+
+lw_result lw_platform_reactor_add_device(lw_platform_reactor *reactor, lw_platform_serial_device *serial_device, lw_grf_distance_config distance_config, void *user_data, lw_platform_reactor_device **reactor_device) {
+    for (uint32_t i = 0; i < LW_PLATFORM_REACTOR_MAX_DEVICES; ++i) {
+        lw_platform_reactor_device *slot = &reactor->devices[i];
+
+        if (slot->serial_device != NULL) {
+            continue;
+        }
+
+        if (lw_platform_serial_bind_completion_port(&serial_device->serial_port, reactor->completion_port) != LW_RESULT_SUCCESS) {
+            LW_DEBUG_LVL_1("Reactor: Failed to register serial port.\n");
+            return LW_RESULT_ERROR;
+        }
+
+        memset(slot, 0, sizeof(*slot));
+        slot->serial_device = serial_device;
+        slot->distance_config = distance_config;
+        slot->distance_decoder = lw_grf250_create_distance_decoder(distance_config);
+        slot->user_data = user_data;
+
+        *reactor_device = slot;
+
+        return LW_RESULT_SUCCESS;
+    }
+
+    LW_DEBUG_LVL_1("Reactor: No free device slots.\n");
+    return LW_RESULT_ERROR;
+}
+
+void lw_platform_reactor_remove_device(lw_platform_reactor *reactor, lw_platform_reactor_device *reactor_device) {
+    (void)reactor;
+
+    // NOTE: The port stays associated with the completion port, later
+    // completions for it are ignored.
+    reactor_device->serial_device = NULL;
+}
+
+lw_result lw_platform_reactor_poll(lw_platform_reactor *reactor, uint32_t timeout_ms) {
+    OVERLAPPED_ENTRY entries[LW_PLATFORM_REACTOR_MAX_DEVICES];
+    ULONG count = 0;
+
+    if (!GetQueuedCompletionStatusEx(reactor->completion_port, entries, LW_PLATFORM_REACTOR_MAX_DEVICES, &count, timeout_ms, FALSE)) {
+        return GetLastError() == WAIT_TIMEOUT ? LW_RESULT_TIMEOUT : LW_RESULT_ERROR;
+    }
+
+    lw_result result = LW_RESULT_TIMEOUT;
+
+    for (ULONG i = 0; i < count; ++i) {
+        // NOTE: Writes issued by the managed commands on a registered port
+        // also complete here and are ignored, as are completions for devices
+        // that were removed.
+        for (uint32_t j = 0; j < LW_PLATFORM_REACTOR_MAX_DEVICES; ++j) {
+            lw_platform_reactor_device *reactor_device = &reactor->devices[j];
+
+            if (reactor_device->serial_device != NULL && entries[i].lpOverlapped == &reactor_device->serial_device->serial_port.read_overlapped) {
+                lw_platform_reactor_service_device(reactor, reactor_device);
+                result = LW_RESULT_SUCCESS;
+                break;
+            }
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,128 @@
+#ifndef LW_PLATFORM_WIN_REACTOR_H
+#define LW_PLATFORM_WIN_REACTOR_H
+
+#include "lw_platform_win_serial.h"
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Multi-device reactor.
+//
+// The reactor waits on the serial ports of many devices at once with an I/O
+// completion port, which receives the completions of the read each port keeps
+// pending into its receive ring.
+// Whenever a port has data, the bytes are fed into that device's response
+// parser and every completed packet is dispatched to the device callbacks.
+//
+// Registered devices can still be used with the managed request/response
+// commands between calls to lw_platform_reactor_poll, as the reactor parses
+// into the same callback device.
+// ----------------------------------------------------------------------------
+#define LW_PLATFORM_REACTOR_MAX_DEVICES 32
+
+typedef struct lw_platform_reactor_device_s lw_platform_reactor_device;
+
+/*
+ * Called for every completed distance data packet.
+ *
+ * @param reactor_device The device that received the packet.
+ * @param distance_data The decoded distance data.
+ */
+typedef void (*lw_platform_reactor_distance_callback)(lw_platform_reactor_device *reactor_device, lw_grf250_distance_data *distance_data);
+
+/*
+ * Called for every completed multi data packet.
+ *
+ * @param reactor_device The device that received the packet.
+ * @param multi_data The decoded multi data.
+ */
+typedef void (*lw_platform_reactor_multi_data_callback)(lw_platform_reactor_device *reactor_device, lw_grf250_multi_data *multi_data);
+
+/*
+ * Called for every other completed packet.
+ *
+ * @param reactor_device The device that received the packet.
+ * @param response The completed response.
+ */
+typedef void (*lw_platform_reactor_response_callback)(lw_platform_reactor_device *reactor_device, lw_response *response);
+
+/*
+ * Called once when the serial port of a device fails. The device is removed
+ * from the reactor before the callback is issued.
+ *
+ * @param reactor_device The device that failed.
+ */
+typedef void (*lw_platform_reactor_error_callback)(lw_platform_reactor_device *reactor_device);
+
+struct lw_platform_reactor_device_s {
+    lw_platform_serial_device *serial_device;
+    lw_grf_distance_config distance_config;
+    lw_grf250_distance_decoder distance_decoder;
+    void *user_data;
+
+    lw_platform_reactor_distance_callback distance_callback;
+    lw_platform_reactor_multi_data_callback multi_data_callback;
+    lw_platform_reactor_response_callback response_callback;
+    lw_platform_reactor_error_callback error_callback;
+};
+
+typedef struct {
+    HANDLE completion_port;
+    lw_platform_reactor_device devices[LW_PLATFORM_REACTOR_MAX_DEVICES];
+} lw_platform_reactor;
+
+/*
+ * Create a reactor with no registered devices.
+ *
+ * @param reactor The reactor to create.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_platform_reactor_create(lw_platform_reactor *reactor);
+
+/*
+ * Destroy a reactor. The serial ports of registered devices are not closed.
+ *
+ * @param reactor The reactor to destroy.
+ */
+void lw_platform_reactor_destroy(lw_platform_reactor *reactor);
+
+/*
+ * Register a connected serial device with the reactor. Set the callbacks on
+ * the returned reactor device before the next call to lw_platform_reactor_poll.
+ *
+ * @param reactor The reactor.
+ * @param serial_device The connected serial device.
+ * @param distance_config The distance configuration used to decode streamed distance data.
+ * @param user_data User data stored on the reactor device.
+ * @param reactor_device The registered reactor device is written here.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_platform_reactor_add_device(lw_platform_reactor *reactor, lw_platform_serial_device *serial_device, lw_grf_distance_config distance_config, void *user_data, lw_platform_reactor_device **reactor_device);
+
+/*
+ * Remove a device from the reactor.
+ *
+ * @param reactor The reactor.
+ * @param reactor_device The device to remove.
+ */
+void lw_platform_reactor_remove_device(lw_platform_reactor *reactor, lw_platform_reactor_device *reactor_device);
+
+/*
+ * Wait for data on any registered device, then parse it and dispatch all
+ * completed packets.
+ *
+ * @param reactor The reactor.
+ * @param timeout_ms The time to wait for data in milliseconds, or 0 for non-blocking.
+ * @return LW_RESULT_SUCCESS if any data was processed, LW_RESULT_TIMEOUT if
+ *         none arrived, or LW_RESULT_ERROR on failure.
+ */
+lw_result lw_platform_reactor_poll(lw_platform_reactor *reactor, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_PLATFORM_WIN_REACTOR_H
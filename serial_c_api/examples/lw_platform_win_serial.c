@@ -1,20 +1,121 @@
 #include "lw_platform_win_serial.h"
 
+#include <string.h>
+
 static int64_t time_frequency;
 static int64_t time_counter_start;
 
+// ----------------------------------------------------------------------------
+// Receive ring.
+// ----------------------------------------------------------------------------
+static lw_result lw_platform_serial_start_read(lw_platform_serial_port *serial_port) {
+    uint32_t used = serial_port->ring_head - serial_port->ring_tail;
+
+    if (serial_port->read_pending || used == LW_PLATFORM_RECEIVE_RING_SIZE) {
+        return LW_RESULT_SUCCESS;
+    }
+
+    // NOTE: Only the contiguous free space at the head is read into, the next
+    // read continues from the start of the ring.
+    uint32_t head = serial_port->ring_head & (LW_PLATFORM_RECEIVE_RING_SIZE - 1);
+    uint32_t size = LW_PLATFORM_RECEIVE_RING_SIZE - used;
+
+    if (size > LW_PLATFORM_RECEIVE_RING_SIZE - head) {
+        size = LW_PLATFORM_RECEIVE_RING_SIZE - head;
+    }
+
+    HANDLE event = serial_port->read_overlapped.hEvent;
+    memset(&serial_port->read_overlapped, 0, sizeof(serial_port->read_overlapped));
+    serial_port->read_overlapped.hEvent = event;
+    ResetEvent(event);
+
+    // NOTE: The read completes through the event and completion port even if
+    // it finishes immediately.
+    if (!ReadFile(serial_port->handle, serial_port->ring + head, size, NULL, &serial_port->read_overlapped)) {
+        if (GetLastError() != ERROR_IO_PENDING) {
+            LW_DEBUG_LVL_1("Serial Read: Failed to start read: %d.\n", GetLastError());
+            return LW_RESULT_ERROR;
+        }
+    }
+
+    serial_port->read_pending = TRUE;
+
+    return LW_RESULT_SUCCESS;
+}
+
+static lw_result lw_platform_serial_finish_read(lw_platform_serial_port *serial_port, uint32_t timeout_ms) {
+    if (!serial_port->read_pending) {
+        return LW_RESULT_SUCCESS;
+    }
+
+    DWORD wait_result = WaitForSingleObject(serial_port->read_overlapped.hEvent, timeout_ms);
+
+    if (wait_result == WAIT_TIMEOUT) {
+        return LW_RESULT_TIMEOUT;
+    }
+
+    DWORD bytes_read = 0;
+    serial_port->read_pending = FALSE;
+
+    if (wait_result != WAIT_OBJECT_0 || !GetOverlappedResult(serial_port->handle, &serial_port->read_overlapped, &bytes_read, FALSE)) {
+        LW_DEBUG_LVL_1("Serial Read: Waiting Error: %d.\n", GetLastError());
+        return LW_RESULT_ERROR;
+    }
+
+    serial_port->ring_head += bytes_read;
+
+    return LW_RESULT_SUCCESS;
+}
+
+static uint32_t lw_platform_serial_pop_ring(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size) {
+    uint32_t used = serial_port->ring_head - serial_port->ring_tail;
+
+    if (size > used) {
+        size = used;
+    }
+
+    uint32_t tail = serial_port->ring_tail & (LW_PLATFORM_RECEIVE_RING_SIZE - 1);
+    uint32_t first_size = LW_PLATFORM_RECEIVE_RING_SIZE - tail;
+
+    if (first_size > size) {
+        first_size = size;
+    }
+
+    memcpy(buffer, serial_port->ring + tail, first_size);
+    memcpy(buffer + first_size, serial_port->ring, size - first_size);
+    serial_port->ring_tail += size;
+
+    return size;
+}
+
 // ----------------------------------------------------------------------------
 // Platform specific functions.
 // ----------------------------------------------------------------------------
 void lw_platform_serial_disconnect(lw_platform_serial_port *serial_port) {
-    if (*serial_port != INVALID_HANDLE_VALUE)
-        CloseHandle(*serial_port);
+    if (serial_port->handle != INVALID_HANDLE_VALUE) {
+        // NOTE: The pending read must finish before the ring can be released.
+        if (serial_port->read_pending) {
+            DWORD bytes_read = 0;
+            CancelIoEx(serial_port->handle, &serial_port->read_overlapped);
+            GetOverlappedResult(serial_port->handle, &serial_port->read_overlapped, &bytes_read, TRUE);
+        }
+
+        CloseHandle(serial_port->handle);
+    }
+
+    if (serial_port->read_overlapped.hEvent != NULL) {
+        CloseHandle(serial_port->read_overlapped.hEvent);
+    }
+
+    if (serial_port->write_event != NULL) {
+        CloseHandle(serial_port->write_event);
+    }
 
-    *serial_port = INVALID_HANDLE_VALUE;
+    *serial_port = lw_platform_create_serial_port();
 }
 
 lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate, lw_platform_serial_port *serial_port) {
-    *serial_port = INVALID_HANDLE_VALUE;
+    *serial_port = lw_platform_create_serial_port();
     LW_DEBUG_LVL_1("Attempt com connection: %s\n", port_name);
 
     HANDLE handle = CreateFile(port_name, GENERIC_READ | GENERIC_WRITE, 0, 0, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, 0);
@@ -43,106 +144,368 @@ lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate,
         status = SetCommState(handle, &comParams);
 
         if (status == FALSE) {
-            CloseHandle(serial_port);
+            CloseHandle(handle);
             return LW_RESULT_ERROR;
         }
     }
 
     COMMTIMEOUTS timeouts = {0};
     GetCommTimeouts(handle, &timeouts);
-    timeouts.ReadIntervalTimeout = 0;
-    timeouts.ReadTotalTimeoutMultiplier = 0;
-    timeouts.ReadTotalTimeoutConstant = 10;
+    // NOTE: This combination completes a read as soon as any bytes are
+    // available, and otherwise waits for the first byte. Read timeouts are
+    // handled by waiting on the pending read instead.
+    timeouts.ReadIntervalTimeout = MAXDWORD;
+    timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+    timeouts.ReadTotalTimeoutConstant = MAXDWORD - 1;
     timeouts.WriteTotalTimeoutConstant = 0;
     timeouts.WriteTotalTimeoutMultiplier = 0;
     SetCommTimeouts(handle, &timeouts);
 
-    *serial_port = handle;
+    serial_port->handle = handle;
+    serial_port->write_event = CreateEvent(NULL, TRUE, FALSE, NULL);
+    serial_port->read_overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+    if (serial_port->write_event == NULL || serial_port->read_overlapped.hEvent == NULL) {
+        LW_DEBUG_LVL_1("Serial Connect: Failed to create events.\n");
+        lw_platform_serial_disconnect(serial_port);
+        return LW_RESULT_ERROR;
+    }
+
+    if (lw_platform_serial_start_read(serial_port) != LW_RESULT_SUCCESS) {
+        lw_platform_serial_disconnect(serial_port);
+        return LW_RESULT_ERROR;
+    }
 
     LW_DEBUG_LVL_1("Serial Connect: Connected to %s\n", port_name);
 
     return LW_RESULT_SUCCESS;
 }
 
+lw_result lw_platform_serial_bind_completion_port(lw_platform_serial_port *serial_port, HANDLE completion_port) {
+    if (serial_port->handle == INVALID_HANDLE_VALUE) {
+        LW_DEBUG_LVL_1("Serial Bind: Invalid Serial Port.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    if (serial_port->completion_port == completion_port) {
+        return LW_RESULT_SUCCESS;
+    }
+
+    // NOTE: A handle stays associated with a completion port until it is closed.
+    if (serial_port->completion_port != NULL) {
+        LW_DEBUG_LVL_1("Serial Bind: Already bound to another completion port.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    // NOTE: A read started before the association would not be queued on the
+    // completion port, so it is cancelled and restarted. Bytes it already read
+    // are kept in the ring.
+    if (serial_port->read_pending) {
+        DWORD bytes_read = 0;
+        CancelIoEx(serial_port->handle, &serial_port->read_overlapped);
+        serial_port->read_pending = FALSE;
+
+        if (GetOverlappedResult(serial_port->handle, &serial_port->read_overlapped, &bytes_read, TRUE)) {
+            serial_port->ring_head += bytes_read;
+        } else if (GetLastError() != ERROR_OPERATION_ABORTED) {
+            LW_DEBUG_LVL_1("Serial Bind: Waiting Error: %d.\n", GetLastError());
+            return LW_RESULT_ERROR;
+        }
+    }
+
+    if (CreateIoCompletionPort(serial_port->handle, completion_port, 0, 0) == NULL) {
+        LW_DEBUG_LVL_1("Serial Bind: Failed to associate completion port.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    serial_port->completion_port = completion_port;
+
+    return lw_platform_serial_start_read(serial_port);
+}
+
+lw_result lw_platform_serial_set_baud_rate(lw_platform_serial_port *serial_port, uint32_t baud_rate) {
+    if (serial_port->handle == INVALID_HANDLE_VALUE) {
+        LW_DEBUG_LVL_1("Serial Baud Rate: Invalid Serial Port.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    DCB comParams = {0};
+    comParams.DCBlength = sizeof(comParams);
+
+    if (!GetCommState(serial_port->handle, &comParams)) {
+        LW_DEBUG_LVL_1("Serial Baud Rate: Failed to get state.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    comParams.BaudRate = baud_rate;
+
+    if (!SetCommState(serial_port->handle, &comParams)) {
+        LW_DEBUG_LVL_1("Serial Baud Rate: Failed to set %u.\n", baud_rate);
+        return LW_RESULT_ERROR;
+    }
+
+    // NOTE: The pending read is kept, only the received bytes are dropped.
+    PurgeComm(serial_port->handle, PURGE_RXCLEAR);
+    serial_port->ring_tail = serial_port->ring_head;
+
+    return LW_RESULT_SUCCESS;
+}
+
 uint32_t lw_platform_serial_write(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size) {
-    if (*serial_port == INVALID_HANDLE_VALUE) {
+    if (serial_port->handle == INVALID_HANDLE_VALUE) {
         LW_DEBUG_LVL_1("Serial Write: Invalid Serial Port.\n");
         return 0;
     }
 
+    // NOTE: The write needs its own event as a read is always pending on the
+    // same handle.
     OVERLAPPED overlapped = {0};
+    overlapped.hEvent = serial_port->write_event;
     DWORD bytesWritten = 0;
 
-    if (!WriteFile(*serial_port, buffer, size, &bytesWritten, &overlapped)) {
+    if (!WriteFile(serial_port->handle, buffer, size, &bytesWritten, &overlapped)) {
         if (GetLastError() != ERROR_IO_PENDING) {
             LW_DEBUG_LVL_1("Serial Write: Write Failed.\n");
             return 0;
-        } else {
-            if (!GetOverlappedResult(*serial_port, &overlapped, &bytesWritten, TRUE)) {
-                LW_DEBUG_LVL_1("Serial Write: Waiting Error.\n");
-                return 0;
-            } else {
-                if (bytesWritten != size) {
-                    LW_DEBUG_LVL_1("Wrote %d bytes instead of %d.\n", bytesWritten, size);
-                    return 0;
-                }
-
-                return bytesWritten;
-            }
-        }
-    } else {
-        if (bytesWritten != size) {
-            LW_DEBUG_LVL_1("Wrote %d bytes instead of %d.\n", bytesWritten, size);
-            return 0;
         }
+    }
+
+    if (!GetOverlappedResult(serial_port->handle, &overlapped, &bytesWritten, TRUE)) {
+        LW_DEBUG_LVL_1("Serial Write: Waiting Error.\n");
+        return 0;
+    }
 
-        return bytesWritten;
+    if (bytesWritten != size) {
+        LW_DEBUG_LVL_1("Wrote %d bytes instead of %d.\n", bytesWritten, size);
+        return 0;
     }
+
+    return bytesWritten;
 }
 
 int32_t lw_platform_serial_read(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size) {
     // NOTE: This function is non-blocking.
-    
-    if (*serial_port == INVALID_HANDLE_VALUE) {
+    return lw_platform_serial_read_timeout(serial_port, buffer, size, 0);
+}
+
+int32_t lw_platform_serial_read_timeout(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
+    if (serial_port->handle == INVALID_HANDLE_VALUE) {
         LW_DEBUG_LVL_1("Serial Read: Invalid Serial Port.\n");
-        return 0;
+        return -1;
     }
 
-    OVERLAPPED overlapped = {0};
-    DWORD bytesRead;
+    uint32_t end_time = lw_platform_get_time_ms() + timeout_ms;
+    uint32_t wait_ms = 0;
 
-    if (!ReadFile(*serial_port, buffer, size, &bytesRead, &overlapped)) {
-        if (GetLastError() != ERROR_IO_PENDING) {
-            LW_DEBUG_LVL_1("Serial Read: IO Pending Error.\n");
+    while (1) {
+        if (lw_platform_serial_finish_read(serial_port, wait_ms) == LW_RESULT_ERROR) {
             return -1;
-        } else {
-            if (!GetOverlappedResult(*serial_port, &overlapped, &bytesRead, TRUE)) {
-                LW_DEBUG_LVL_1("Serial Read: Waiting Error: %d.\n", GetLastError());
-                return -1;
-            } else if (bytesRead > 0) {
-                return (int32_t)bytesRead;
-            }
         }
-    } else if (bytesRead > 0) {
-        return (int32_t)bytesRead;
-    }
 
-    return 0;
+        uint32_t bytes_read = lw_platform_serial_pop_ring(serial_port, buffer, size);
+
+        // NOTE: Keep a read pending so bytes are collected between calls.
+        if (lw_platform_serial_start_read(serial_port) != LW_RESULT_SUCCESS) {
+            return -1;
+        }
+
+        if (bytes_read > 0) {
+            return (int32_t)bytes_read;
+        }
+
+        int32_t time_left_ms = (int32_t)(end_time - lw_platform_get_time_ms());
+
+        if (timeout_ms == 0 || time_left_ms <= 0) {
+            return 0;
+        }
+
+        wait_ms = (uint32_t)time_left_ms;
+    }
 }
 
 uint32_t lw_platform_get_time_ms(void) {
+    // NOTE: Ports can be used without calling lw_platform_init first.
+    if (time_frequency == 0) {
+        lw_platform_init();
+    }
+
     LARGE_INTEGER counter;
     QueryPerformanceCounter(&counter);
     int64_t time = counter.QuadPart - time_counter_start;
-    double result = (double)time / ((double)time_frequency);
 
-    return (uint32_t)(result * 1000);
+    // NOTE: Split to keep full precision without overflowing.
+    return (uint32_t)((time / time_frequency) * 1000 + ((time % time_frequency) * 1000) / time_frequency);
+}
+
+uint64_t lw_platform_get_time_ns(void) {
+    if (time_frequency == 0) {
+        lw_platform_init();
+    }
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    int64_t time = counter.QuadPart - time_counter_start;
+
+    return (uint64_t)((time / time_frequency) * 1000000000 + ((time % time_frequency) * 1000000000) / time_frequency);
 }
 
 void lw_platform_sleep(uint32_t time_ms) {
     Sleep(time_ms);
 }
 
+static DWORD WINAPI lw_platform_thread_entry(LPVOID parameter) {
+    lw_platform_thread *thread = (lw_platform_thread *)parameter;
+    thread->function(thread->user_data);
+    return 0;
+}
+
+lw_result lw_platform_thread_create(lw_platform_thread *thread, lw_platform_thread_function function, void *user_data) {
+    thread->function = function;
+    thread->user_data = user_data;
+    thread->handle = CreateThread(NULL, 0, &lw_platform_thread_entry, thread, 0, NULL);
+
+    if (thread->handle == NULL) {
+        LW_DEBUG_LVL_1("Thread: Failed to create.\n");
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_thread_join(lw_platform_thread *thread) {
+    WaitForSingleObject(thread->handle, INFINITE);
+    CloseHandle(thread->handle);
+    thread->handle = NULL;
+}
+
+// ----------------------------------------------------------------------------
+// File mapping.
+// ----------------------------------------------------------------------------
+lw_result lw_platform_map_file(const char *path, lw_platform_file_mapping *mapping) {
+    memset(mapping, 0, sizeof(*mapping));
+
+    mapping->file = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+
+    if (mapping->file == INVALID_HANDLE_VALUE) {
+        LW_DEBUG_LVL_1("Map File: Failed to open %s: %lu\n", path, GetLastError());
+        mapping->file = NULL;
+        return LW_RESULT_ERROR;
+    }
+
+    LARGE_INTEGER size;
+
+    if (!GetFileSizeEx(mapping->file, &size) || size.QuadPart == 0) {
+        LW_DEBUG_LVL_1("Map File: Failed to get the size of %s\n", path);
+        lw_platform_unmap_file(mapping);
+        return LW_RESULT_ERROR;
+    }
+
+    mapping->mapping = CreateFileMapping(mapping->file, NULL, PAGE_READONLY, 0, 0, NULL);
+
+    if (mapping->mapping != NULL) {
+        mapping->data = (const uint8_t *)MapViewOfFile(mapping->mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+
+    if (mapping->data == NULL) {
+        LW_DEBUG_LVL_1("Map File: Failed to map %s: %lu\n", path, GetLastError());
+        lw_platform_unmap_file(mapping);
+        return LW_RESULT_ERROR;
+    }
+
+    mapping->size = (uint64_t)size.QuadPart;
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_unmap_file(lw_platform_file_mapping *mapping) {
+    if (mapping->data != NULL) {
+        UnmapViewOfFile(mapping->data);
+    }
+
+    if (mapping->mapping != NULL) {
+        CloseHandle(mapping->mapping);
+    }
+
+    if (mapping->file != NULL) {
+        CloseHandle(mapping->file);
+    }
+
+    memset(mapping, 0, sizeof(*mapping));
+}
+
+// ----------------------------------------------------------------------------
+// Shared memory.
+// ----------------------------------------------------------------------------
+lw_result lw_platform_shared_memory_create(const char *name, uint64_t size, lw_platform_shared_memory *memory) {
+    memset(memory, 0, sizeof(*memory));
+
+    memory->mapping = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), name);
+
+    if (memory->mapping == NULL) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to create %s: %lu\n", name, GetLastError());
+        return LW_RESULT_ERROR;
+    }
+
+    // NOTE: Unlike POSIX shared memory, a mapping that is still open can not
+    // be replaced, so a second publisher is refused.
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        LW_DEBUG_LVL_1("Shared Memory: %s is already in use\n", name);
+        lw_platform_shared_memory_close(memory);
+        return LW_RESULT_ERROR;
+    }
+
+    memory->data = (uint8_t *)MapViewOfFile(memory->mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+
+    if (memory->data == NULL) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to map %s: %lu\n", name, GetLastError());
+        lw_platform_shared_memory_close(memory);
+        return LW_RESULT_ERROR;
+    }
+
+    memory->size = size;
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_platform_shared_memory_open(const char *name, uint8_t writable, lw_platform_shared_memory *memory) {
+    memset(memory, 0, sizeof(*memory));
+
+    DWORD access = writable ? FILE_MAP_ALL_ACCESS : FILE_MAP_READ;
+    memory->mapping = OpenFileMapping(access, FALSE, name);
+
+    if (memory->mapping != NULL) {
+        memory->data = (uint8_t *)MapViewOfFile(memory->mapping, access, 0, 0, 0);
+    }
+
+    if (memory->data == NULL) {
+        LW_DEBUG_LVL_1("Shared Memory: Failed to open %s: %lu\n", name, GetLastError());
+        lw_platform_shared_memory_close(memory);
+        return LW_RESULT_ERROR;
+    }
+
+    // NOTE: The view size is rounded up to whole pages, the ring header holds
+    // the exact layout.
+    MEMORY_BASIC_INFORMATION information;
+
+    if (VirtualQuery(memory->data, &information, sizeof(information)) != 0) {
+        memory->size = (uint64_t)information.RegionSize;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_platform_shared_memory_close(lw_platform_shared_memory *memory) {
+    if (memory->data != NULL) {
+        UnmapViewOfFile(memory->data);
+    }
+
+    if (memory->mapping != NULL) {
+        CloseHandle(memory->mapping);
+    }
+
+    memset(memory, 0, sizeof(*memory));
+}
+
 // ----------------------------------------------------------------------------
 // Device service callbacks.
 // ----------------------------------------------------------------------------
@@ -151,6 +514,11 @@ uint32_t lw_platform_get_time_ms_callback(lw_callback_device *device) {
     return lw_platform_get_time_ms();
 }
 
+uint64_t lw_platform_get_time_ns_callback(lw_callback_device *device) {
+    (void)device;
+    return lw_platform_get_time_ns();
+}
+
 void lw_platform_sleep_callback(lw_callback_device *device, uint32_t time_ms) {
     (void)device;
     lw_platform_sleep(time_ms);
@@ -163,14 +531,23 @@ uint32_t lw_platform_serial_send_callback(lw_callback_device *device, uint8_t *b
 
 int32_t lw_platform_serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
     lw_platform_serial_device *platform_device = (lw_platform_serial_device *)device->user_data;
-    (void)timeout_ms;
-    return lw_platform_serial_read(&platform_device->serial_port, buffer, size);
+    return lw_platform_serial_read_timeout(&platform_device->serial_port, buffer, size, timeout_ms);
+}
+
+lw_result lw_platform_set_host_baud_rate_callback(lw_callback_device *device, uint32_t baud_rate) {
+    lw_platform_serial_device *platform_device = (lw_platform_serial_device *)device->user_data;
+    return lw_platform_serial_set_baud_rate(&platform_device->serial_port, baud_rate);
 }
 
 // ----------------------------------------------------------------------------
 // Platform context creation.
 // ----------------------------------------------------------------------------
 lw_result lw_platform_init(void) {
+    // NOTE: The clocks are shared by all devices and must not restart.
+    if (time_frequency != 0) {
+        return LW_RESULT_SUCCESS;
+    }
+
     LARGE_INTEGER freq;
     LARGE_INTEGER counter;
     QueryPerformanceFrequency(&freq);
@@ -182,7 +559,11 @@ lw_result lw_platform_init(void) {
 }
 
 lw_platform_serial_port lw_platform_create_serial_port(void) {
-    return INVALID_HANDLE_VALUE;
+    lw_platform_serial_port serial_port;
+    memset(&serial_port, 0, sizeof(serial_port));
+    serial_port.handle = INVALID_HANDLE_VALUE;
+
+    return serial_port;
 }
 
 lw_result lw_platform_create_serial_device(const char *port_name, uint32_t baud_rate, lw_platform_serial_device *platform_device) {
@@ -202,5 +583,7 @@ lw_result lw_platform_create_serial_device(const char *port_name, uint32_t baud_
                                                         &lw_platform_serial_send_callback,
                                                         &lw_platform_serial_receive_callback);
 
+    lw_device_enable_timestamps(&platform_device->device, &lw_platform_get_time_ns_callback, baud_rate);
+
     return LW_RESULT_SUCCESS;
 }
@@ -6,28 +6,109 @@
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 
-#ifdef cplusplus
+#ifdef __cplusplus
 extern "C" {
 #endif
 
-typedef HANDLE lw_platform_serial_port;
+// ----------------------------------------------------------------------------
+// Serial port.
+//
+// Every port keeps one overlapped read pending into a receive ring. The read
+// completes as soon as any bytes arrive and takes everything the driver has
+// queued, so received data is moved in bulk and reads wait for exactly the
+// requested timeout instead of polling.
+//
+// The read also completes on an I/O completion port when the port is bound
+// to one with lw_platform_serial_bind_completion_port.
+// ----------------------------------------------------------------------------
+#ifndef LW_PLATFORM_RECEIVE_RING_SIZE
+#define LW_PLATFORM_RECEIVE_RING_SIZE 4096
+#endif
+
+#if (LW_PLATFORM_RECEIVE_RING_SIZE & (LW_PLATFORM_RECEIVE_RING_SIZE - 1)) != 0
+#error "LW_PLATFORM_RECEIVE_RING_SIZE must be a power of 2"
+#endif
+
+typedef struct {
+    HANDLE handle;
+    HANDLE write_event;
+    HANDLE completion_port;
+    OVERLAPPED read_overlapped;
+    BOOL read_pending;
+
+    // NOTE: Free running indices, the ring holds (ring_head - ring_tail) bytes.
+    uint32_t ring_head;
+    uint32_t ring_tail;
+    uint8_t ring[LW_PLATFORM_RECEIVE_RING_SIZE];
+} lw_platform_serial_port;
 
 typedef struct {
     lw_callback_device device;
     lw_platform_serial_port serial_port;
 } lw_platform_serial_device;
 
+typedef struct {
+    const uint8_t *data;
+    uint64_t size;
+    HANDLE file;
+    HANDLE mapping;
+} lw_platform_file_mapping;
+
+typedef struct {
+    uint8_t *data;
+    uint64_t size;
+    HANDLE mapping;
+} lw_platform_shared_memory;
+
+typedef void (*lw_platform_thread_function)(void *user_data);
+
+typedef struct {
+    HANDLE handle;
+    lw_platform_thread_function function;
+    void *user_data;
+} lw_platform_thread;
+
 lw_result lw_platform_create_serial_device(const char *port_name, uint32_t baud_rate, lw_platform_serial_device *platform_device);
+lw_result lw_platform_set_host_baud_rate_callback(lw_callback_device *device, uint32_t baud_rate);
 
 lw_result lw_platform_init(void);
 uint32_t lw_platform_get_time_ms(void);
+uint64_t lw_platform_get_time_ns(void);
 void lw_platform_sleep(uint32_t time_ms);
 
 lw_platform_serial_port lw_platform_create_serial_port(void);
 lw_result lw_platform_serial_connect(const char *port_name, uint32_t baud_rate, lw_platform_serial_port *serial_port);
 void lw_platform_serial_disconnect(lw_platform_serial_port *serial_port);
+lw_result lw_platform_serial_set_baud_rate(lw_platform_serial_port *serial_port, uint32_t baud_rate);
 uint32_t lw_platform_serial_write(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size);
 int32_t lw_platform_serial_read(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size);
+int32_t lw_platform_serial_read_timeout(lw_platform_serial_port *serial_port, uint8_t *buffer, uint32_t size, uint32_t timeout_ms);
+
+/*
+ * Associate a connected serial port with an I/O completion port. Completions
+ * of the pending read are queued with a key of 0 and point at
+ * serial_port->read_overlapped. Bytes already received are kept.
+ *
+ * A port can only be bound to one completion port for as long as it is
+ * connected, binding it to the same one again does nothing.
+ *
+ * @param serial_port The connected serial port.
+ * @param completion_port The completion port.
+ * @return LW_RESULT_SUCCESS on success, or an error code on failure.
+ */
+lw_result lw_platform_serial_bind_completion_port(lw_platform_serial_port *serial_port, HANDLE completion_port);
+
+lw_result lw_platform_thread_create(lw_platform_thread *thread, lw_platform_thread_function function, void *user_data);
+void lw_platform_thread_join(lw_platform_thread *thread);
+
+lw_result lw_platform_map_file(const char *path, lw_platform_file_mapping *mapping);
+void lw_platform_unmap_file(lw_platform_file_mapping *mapping);
+
+// Named shared memory, eg: "Local\\grf250". The mapping is removed when the
+// last process closes it.
+lw_result lw_platform_shared_memory_create(const char *name, uint64_t size, lw_platform_shared_memory *memory);
+lw_result lw_platform_shared_memory_open(const char *name, uint8_t writable, lw_platform_shared_memory *memory);
+void lw_platform_shared_memory_close(lw_platform_shared_memory *memory);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,363 @@
+#include "lw_sim_grf250.h"
+
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Register file.
+// ----------------------------------------------------------------------------
+static void lw_sim_set_register(lw_sim_grf250 *sim, uint8_t command_id, const void *data, uint32_t size) {
+    lw_sim_register *sim_register = &sim->registers[command_id];
+    memset(sim_register->data, 0, sizeof(sim_register->data));
+    memcpy(sim_register->data, data, size);
+    sim_register->size = (uint8_t)size;
+}
+
+static uint32_t lw_sim_get_register_uint32(lw_sim_grf250 *sim, uint8_t command_id) {
+    uint32_t value;
+    memcpy(&value, sim->registers[command_id].data, sizeof(value));
+    return value;
+}
+
+static void lw_sim_reset_registers(lw_sim_grf250 *sim) {
+    memset(sim->registers, 0, sizeof(sim->registers));
+
+    // NOTE: Distance and multi data are built for each sample instead.
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t size = lw_grf250_get_response_data_size((uint8_t)i);
+
+        if (size <= LW_SIM_REGISTER_SIZE && i != LW_GRF250_COMMAND_DISTANCE_DATA) {
+            sim->registers[i].size = (uint8_t)size;
+        }
+    }
+
+    uint32_t hardware_version = 1;
+    uint32_t firmware_version = (1 << 16) | (2 << 8) | 3;
+    uint32_t distance_config = LW_GRF250_DISTANCE_CONFIG_ALL;
+    uint32_t update_rate = 50;
+    uint8_t laser_firing = LW_GRF250_ENABLED;
+    uint8_t baud_rate = LW_GRF250_BAUD_115200;
+    int32_t temperature = 2500;
+    char product_name[16] = "GRF250";
+    char serial_number[16] = "SIM00001";
+
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_PRODUCT_NAME, product_name, 16);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_HARDWARE_VERSION, &hardware_version, 4);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_FIRMWARE_VERSION, &firmware_version, 4);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_SERIAL_NUMBER, serial_number, 16);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_DISTANCE_CONFIG, &distance_config, 4);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_UPDATE_RATE, &update_rate, 4);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_LASER_FIRING, &laser_firing, 1);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_BAUD_RATE, &baud_rate, 1);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_TEMPERATURE, &temperature, 4);
+}
+
+// ----------------------------------------------------------------------------
+// Packet output.
+// ----------------------------------------------------------------------------
+static uint32_t lw_sim_random(lw_sim_grf250 *sim) {
+    // NOTE: xorshift32, the state must never be 0.
+    uint32_t x = sim->random_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->random_state = x;
+    return x;
+}
+
+static uint8_t lw_sim_chance(lw_sim_grf250 *sim, uint32_t rate_ppm) {
+    return rate_ppm != 0 && (lw_sim_random(sim) % LW_SIM_PPM) < rate_ppm;
+}
+
+static void lw_sim_send_packet(lw_sim_grf250 *sim, uint8_t command_id, const uint8_t *data, uint32_t size) {
+    uint8_t packet[LW_SIM_REGISTER_SIZE * 4];
+    uint8_t payload[LW_SIM_REGISTER_SIZE * 4];
+
+    memcpy(payload, data, size);
+    uint32_t packet_size = lw_create_packet(packet, command_id, 0, payload, size);
+
+    if (lw_sim_chance(sim, sim->corrupt_rate_ppm)) {
+        packet[lw_sim_random(sim) % packet_size] ^= (uint8_t)(1 + lw_sim_random(sim) % 255);
+        sim->stats.corrupted += 1;
+    }
+
+    // NOTE: Like a UART FIFO, a packet that does not fit is lost.
+    if (LW_SIM_OUTPUT_SIZE - (sim->output_head - sim->output_tail) < packet_size) {
+        sim->stats.overruns += 1;
+        return;
+    }
+
+    for (uint32_t i = 0; i < packet_size; ++i) {
+        sim->output[(sim->output_head + i) & (LW_SIM_OUTPUT_SIZE - 1)] = packet[i];
+    }
+
+    sim->output_head += packet_size;
+}
+
+// ----------------------------------------------------------------------------
+// Streaming.
+// ----------------------------------------------------------------------------
+static uint8_t lw_sim_is_streaming(lw_sim_grf250 *sim) {
+    uint32_t stream = lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_STREAM);
+    uint32_t update_rate = lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_UPDATE_RATE);
+
+    return (stream == LW_GRF250_STREAM_DISTANCE || stream == LW_GRF250_STREAM_MULTI) && update_rate != 0;
+}
+
+// Alarm A is active closer than its distance and alarm B further than its
+// distance, each resets once the distance is back past the hysteresis. A
+// distance of 0 disables the alarm. The registers are in the same 10 cm units
+// as the streamed distances.
+static uint32_t lw_sim_update_alarms(lw_sim_grf250 *sim, int32_t distance) {
+    int32_t alarm_a = (int32_t)lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_ALARM_A_DISTANCE);
+    int32_t alarm_b = (int32_t)lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_ALARM_B_DISTANCE);
+    int32_t hysteresis = (int32_t)lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_ALARM_HYSTERESIS);
+    uint32_t status = lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_ALARM_STATUS);
+    uint32_t alarm_a_active = (status >> 0) & 0xFF;
+    uint32_t alarm_b_active = (status >> 8) & 0xFF;
+
+    if (alarm_a == 0) {
+        alarm_a_active = 0;
+    } else if (alarm_a_active ? distance >= alarm_a + hysteresis : distance < alarm_a) {
+        alarm_a_active = !alarm_a_active;
+    }
+
+    if (alarm_b == 0) {
+        alarm_b_active = 0;
+    } else if (alarm_b_active ? distance <= alarm_b - hysteresis : distance > alarm_b) {
+        alarm_b_active = !alarm_b_active;
+    }
+
+    status = (alarm_a_active << 0) | (alarm_b_active << 8);
+    lw_sim_set_register(sim, LW_GRF250_COMMAND_ALARM_STATUS, &status, sizeof(status));
+
+    return status;
+}
+
+// The device measures at its update rate whether or not it is streaming, so
+// polled registers follow the same samples a stream would carry.
+static void lw_sim_take_sample(lw_sim_grf250 *sim, uint8_t streaming) {
+    int32_t values[11];
+    uint32_t count = 0;
+    uint32_t sample = sim->stats.samples++;
+
+    // A slow sawtooth so consumers can check for missing samples.
+    int32_t distance = 1000 + (int32_t)(sample % 1000);
+    int32_t alarm_status = (int32_t)lw_sim_update_alarms(sim, distance);
+
+    if (!streaming) {
+        return;
+    }
+
+    if (lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_STREAM) == LW_GRF250_STREAM_DISTANCE) {
+        lw_grf_distance_config config = lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_DISTANCE_CONFIG);
+        const int32_t fields[8] = {distance, distance, 80, distance + 10, distance + 10, 40, 2500, alarm_status};
+
+        for (uint32_t i = 0; i < 8; ++i) {
+            if (config & (1u << i)) {
+                values[count++] = fields[i];
+            }
+        }
+
+        lw_sim_send_packet(sim, LW_GRF250_COMMAND_DISTANCE_DATA, (const uint8_t *)values, count * sizeof(int32_t));
+    } else {
+        for (uint32_t i = 0; i < 5; ++i) {
+            values[count++] = (distance + (int32_t)i * 100) * 10;
+            values[count++] = 80 - (int32_t)i * 10;
+        }
+
+        values[count++] = 2500;
+        lw_sim_send_packet(sim, LW_GRF250_COMMAND_MULTI_DATA, (const uint8_t *)values, count * sizeof(int32_t));
+    }
+}
+
+static uint64_t lw_sim_sample_period_ns(lw_sim_grf250 *sim) {
+    return 1000000000ull / lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_UPDATE_RATE);
+}
+
+// ----------------------------------------------------------------------------
+// Request handling.
+// ----------------------------------------------------------------------------
+static void lw_sim_handle_request(lw_sim_grf250 *sim, lw_response *request) {
+    uint8_t command_id = request->command_id;
+    uint8_t write = request->data[1] & 0x1;
+    uint32_t size = request->payload_size - 1;
+    lw_sim_register *sim_register = &sim->registers[command_id];
+
+    sim->stats.requests += 1;
+
+    if (write) {
+        if (size > LW_SIM_REGISTER_SIZE) {
+            return;
+        }
+
+        uint8_t was_streaming = lw_sim_is_streaming(sim);
+
+        switch (command_id) {
+            case LW_GRF250_COMMAND_RESET: {
+                lw_sim_reset_registers(sim);
+                break;
+            }
+
+            case LW_GRF250_COMMAND_SAVE_PARAMETERS: {
+                break;
+            }
+
+            default: {
+                lw_sim_set_register(sim, command_id, request->data + 4, size);
+                break;
+            }
+        }
+
+        // Start streaming one period after the stream or its rate changes.
+        uint8_t rate_changed = command_id == LW_GRF250_COMMAND_UPDATE_RATE && lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_UPDATE_RATE) != 0;
+
+        if ((lw_sim_is_streaming(sim) && !was_streaming) || rate_changed) {
+            sim->next_sample_ns = sim->time_ns + lw_sim_sample_period_ns(sim);
+        }
+    } else {
+        size = sim_register->size;
+
+        if (command_id == LW_GRF250_COMMAND_TOKEN) {
+            uint16_t token = (uint16_t)(lw_sim_random(sim) | 1);
+            lw_sim_set_register(sim, command_id, &token, sizeof(token));
+        }
+    }
+
+    if (lw_sim_chance(sim, sim->drop_rate_ppm)) {
+        sim->stats.dropped += 1;
+        return;
+    }
+
+    sim->stats.responses += 1;
+    lw_sim_send_packet(sim, command_id, write ? request->data + 4 : sim_register->data, size);
+}
+
+// ----------------------------------------------------------------------------
+// Simulated device.
+// ----------------------------------------------------------------------------
+void lw_sim_grf250_init(lw_sim_grf250 *sim, uint32_t seed) {
+    memset(sim, 0, sizeof(*sim));
+    lw_init_response(&sim->request);
+    sim->random_state = seed != 0 ? seed : 0x9E3779B9u;
+    lw_sim_reset_registers(sim);
+}
+
+void lw_sim_grf250_receive(lw_sim_grf250 *sim, const uint8_t *buffer, uint32_t size) {
+    for (uint32_t i = 0; i < size; ++i) {
+        if (sim->wait_for_interface) {
+            sim->interface_bytes = (buffer[i] == 'U') ? sim->interface_bytes + 1 : 0;
+            sim->wait_for_interface = (sim->interface_bytes < 3);
+            continue;
+        }
+
+        if (lw_feed_response(&sim->request, buffer[i]) == LW_RESULT_SUCCESS) {
+            lw_sim_handle_request(sim, &sim->request);
+        }
+    }
+}
+
+void lw_sim_grf250_update(lw_sim_grf250 *sim, uint64_t time_ns) {
+    if (time_ns > sim->time_ns) {
+        sim->time_ns = time_ns;
+    }
+
+    if (lw_sim_get_register_uint32(sim, LW_GRF250_COMMAND_UPDATE_RATE) == 0) {
+        return;
+    }
+
+    uint64_t period_ns = lw_sim_sample_period_ns(sim);
+    uint8_t streaming = lw_sim_is_streaming(sim);
+
+    while (sim->next_sample_ns <= sim->time_ns) {
+        // NOTE: Only the latest sample is visible when not streaming, so
+        // skip straight to it after the device has been idle.
+        if (!streaming) {
+            uint64_t skipped = (sim->time_ns - sim->next_sample_ns) / period_ns;
+            sim->stats.samples += (uint32_t)skipped;
+            sim->next_sample_ns += skipped * period_ns;
+        }
+
+        lw_sim_take_sample(sim, streaming);
+        sim->next_sample_ns += period_ns;
+    }
+}
+
+uint64_t lw_sim_grf250_next_event_time(lw_sim_grf250 *sim) {
+    return lw_sim_is_streaming(sim) ? sim->next_sample_ns : UINT64_MAX;
+}
+
+uint32_t lw_sim_grf250_transmit(lw_sim_grf250 *sim, uint8_t *buffer, uint32_t size) {
+    uint32_t count = sim->output_head - sim->output_tail;
+
+    if (count > size) {
+        count = size;
+    }
+
+    // Copy out in at most two runs, the second when the data wraps.
+    uint32_t tail = sim->output_tail & (LW_SIM_OUTPUT_SIZE - 1);
+    uint32_t first = LW_SIM_OUTPUT_SIZE - tail;
+
+    if (first > count) {
+        first = count;
+    }
+
+    memcpy(buffer, sim->output + tail, first);
+    memcpy(buffer + first, sim->output, count - first);
+    sim->output_tail += count;
+
+    return count;
+}
+
+// ----------------------------------------------------------------------------
+// In-memory simulated device.
+// ----------------------------------------------------------------------------
+static void lw_sim_sleep_callback(lw_callback_device *device, uint32_t time_ms) {
+    lw_sim_device *sim_device = (lw_sim_device *)device->user_data;
+    sim_device->time_ns += (uint64_t)time_ms * 1000000;
+}
+
+static uint32_t lw_sim_get_time_ms_callback(lw_callback_device *device) {
+    lw_sim_device *sim_device = (lw_sim_device *)device->user_data;
+    return (uint32_t)(sim_device->time_ns / 1000000);
+}
+
+static uint64_t lw_sim_get_time_ns_callback(lw_callback_device *device) {
+    lw_sim_device *sim_device = (lw_sim_device *)device->user_data;
+    return sim_device->time_ns;
+}
+
+static uint32_t lw_sim_serial_send_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size) {
+    lw_sim_device *sim_device = (lw_sim_device *)device->user_data;
+    lw_sim_grf250_update(&sim_device->sim, sim_device->time_ns);
+    lw_sim_grf250_receive(&sim_device->sim, buffer, size);
+    return size;
+}
+
+static int32_t lw_sim_serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
+    lw_sim_device *sim_device = (lw_sim_device *)device->user_data;
+    lw_sim_grf250_update(&sim_device->sim, sim_device->time_ns);
+
+    if (sim_device->sim.output_head == sim_device->sim.output_tail && timeout_ms != 0) {
+        // Wait for the next sample, or the whole timeout when nothing is due.
+        uint64_t deadline_ns = sim_device->time_ns + (uint64_t)timeout_ms * 1000000;
+        uint64_t event_time_ns = lw_sim_grf250_next_event_time(&sim_device->sim);
+
+        sim_device->time_ns = event_time_ns < deadline_ns ? event_time_ns : deadline_ns;
+        lw_sim_grf250_update(&sim_device->sim, sim_device->time_ns);
+    }
+
+    return (int32_t)lw_sim_grf250_transmit(&sim_device->sim, buffer, size);
+}
+
+void lw_sim_create_device(lw_sim_device *sim_device, uint32_t seed) {
+    memset(sim_device, 0, sizeof(*sim_device));
+    lw_sim_grf250_init(&sim_device->sim, seed);
+
+    sim_device->device = lw_create_callback_device(sim_device,
+                                                   &lw_sim_sleep_callback,
+                                                   &lw_sim_get_time_ms_callback,
+                                                   &lw_sim_serial_send_callback,
+                                                   &lw_sim_serial_receive_callback);
+
+    lw_device_enable_timestamps(&sim_device->device, &lw_sim_get_time_ns_callback, 0);
+}
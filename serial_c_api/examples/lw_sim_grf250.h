@@ -0,0 +1,142 @@
+#ifndef LW_SIM_GRF250_H
+#define LW_SIM_GRF250_H
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Simulated GRF250.
+//
+// A software model of the device end of the serial protocol. Requests are
+// fed in as raw bytes, reads are answered from a per-command register file
+// and writes are stored and echoed. Distance and multi data are streamed at
+// the configured update rate against a time supplied by the caller.
+//
+// Errors are injected per packet: a corrupted packet has one byte flipped,
+// and a dropped response is never sent, so the host sees a timeout.
+// ----------------------------------------------------------------------------
+#ifndef LW_SIM_OUTPUT_SIZE
+#define LW_SIM_OUTPUT_SIZE 16384
+#endif
+
+#if (LW_SIM_OUTPUT_SIZE & (LW_SIM_OUTPUT_SIZE - 1)) != 0
+#error "LW_SIM_OUTPUT_SIZE must be a power of 2"
+#endif
+
+#define LW_SIM_REGISTER_SIZE 16
+#define LW_SIM_PPM 1000000
+
+typedef struct {
+    uint8_t size;
+    uint8_t data[LW_SIM_REGISTER_SIZE];
+} lw_sim_register;
+
+typedef struct {
+    uint32_t requests;
+    uint32_t responses;
+    uint32_t samples;
+    uint32_t corrupted;
+    uint32_t dropped;
+    uint32_t overruns;
+} lw_sim_stats;
+
+typedef struct {
+    // Injected error rates in parts per million of packets.
+    uint32_t corrupt_rate_ppm;
+    uint32_t drop_rate_ppm;
+
+    // When set, requests are ignored until the host sends "UUU", like a device
+    // with the 'Wait for interface' startup mode.
+    uint8_t wait_for_interface;
+
+    lw_sim_stats stats;
+
+    // NOTE: Used internally.
+    lw_response request;
+    uint8_t interface_bytes;
+    lw_sim_register registers[256];
+    uint32_t random_state;
+    uint64_t time_ns;
+    uint64_t next_sample_ns;
+
+    // NOTE: Free running indices, the ring holds (output_head - output_tail) bytes.
+    uint32_t output_head;
+    uint32_t output_tail;
+    uint8_t output[LW_SIM_OUTPUT_SIZE];
+} lw_sim_grf250;
+
+/*
+ * Initialize a simulated device with its default registers, not streaming.
+ *
+ * @param sim The simulated device.
+ * @param seed Seed for error injection, the same seed gives the same errors.
+ */
+void lw_sim_grf250_init(lw_sim_grf250 *sim, uint32_t seed);
+
+/*
+ * Pass bytes sent by the host to the simulated device. Complete requests are
+ * answered immediately.
+ *
+ * @param sim The simulated device.
+ * @param buffer The bytes sent by the host.
+ * @param size The number of bytes.
+ */
+void lw_sim_grf250_receive(lw_sim_grf250 *sim, const uint8_t *buffer, uint32_t size);
+
+/*
+ * Move the simulated device to a time and take the samples that are due,
+ * streaming them when a stream is enabled.
+ *
+ * @param sim The simulated device.
+ * @param time_ns The current time, must not go backwards.
+ */
+void lw_sim_grf250_update(lw_sim_grf250 *sim, uint64_t time_ns);
+
+/*
+ * Get the time the next streamed sample is due.
+ *
+ * @param sim The simulated device.
+ * @return The time of the next sample, or UINT64_MAX when not streaming.
+ */
+uint64_t lw_sim_grf250_next_event_time(lw_sim_grf250 *sim);
+
+/*
+ * Take bytes sent by the simulated device to the host.
+ *
+ * @param sim The simulated device.
+ * @param buffer The bytes are written here.
+ * @param size The size of the buffer.
+ * @return The number of bytes written.
+ */
+uint32_t lw_sim_grf250_transmit(lw_sim_grf250 *sim, uint8_t *buffer, uint32_t size);
+
+// ----------------------------------------------------------------------------
+// In-memory simulated device.
+//
+// A callback device wired straight to a simulated GRF250 without a serial
+// port, so the protocol stack can be measured on its own. It runs on its own
+// clock that only moves forward when the API sleeps or waits in the receive
+// callback, and a wait ends as soon as the next sample is due.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_callback_device device;
+    lw_sim_grf250 sim;
+    uint64_t time_ns;
+} lw_sim_device;
+
+/*
+ * Create an in-memory simulated device.
+ *
+ * @param sim_device The simulated device to create.
+ * @param seed Seed for error injection.
+ */
+void lw_sim_create_device(lw_sim_device *sim_device, uint32_t seed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_SIM_GRF250_H
@@ -0,0 +1,364 @@
+#include "lw_serial_api_capture.h"
+#include <string.h>
+
+static const uint8_t lw_capture_padding[8] = {0};
+
+// ----------------------------------------------------------------------------
+// Record framing.
+// ----------------------------------------------------------------------------
+void lw_capture_record_writer_init(lw_capture_record_writer *records, lw_capture_callback_write write, void *user_data) {
+    records->write = write;
+    records->user_data = user_data;
+    records->result = LW_RESULT_SUCCESS;
+    records->offset = 0;
+}
+
+lw_result lw_capture_record_write_bytes(lw_capture_record_writer *records, const void *data, uint32_t size) {
+    if (records->result != LW_RESULT_SUCCESS) {
+        return records->result;
+    }
+
+    if (size != 0 && records->write(records->user_data, data, size) != size) {
+        LW_DEBUG_LVL_1("Capture: Write failed.\n");
+        records->result = LW_RESULT_ERROR;
+        return LW_RESULT_ERROR;
+    }
+
+    records->offset += size;
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_capture_record_write(lw_capture_record_writer *records, uint16_t type, uint64_t time_ns, const void *header, uint32_t header_size, const void *payload, uint32_t payload_size) {
+    lw_capture_record_header record_header;
+    record_header.time_ns = time_ns;
+    record_header.size = header_size + payload_size;
+    record_header.type = type;
+    record_header.reserved = 0;
+
+    LW_CHECK_SUCCESS(lw_capture_record_write_bytes(records, &record_header, sizeof(record_header)))
+    LW_CHECK_SUCCESS(lw_capture_record_write_bytes(records, header, header_size))
+    LW_CHECK_SUCCESS(lw_capture_record_write_bytes(records, payload, payload_size))
+    LW_CHECK_SUCCESS(lw_capture_record_write_bytes(records, lw_capture_padding, lw_capture_record_padding_size(record_header.size)))
+
+    return LW_RESULT_SUCCESS;
+}
+
+uint32_t lw_capture_record_padding_size(uint32_t size) {
+    return (8 - (size & 7)) & 7;
+}
+
+lw_result lw_capture_record_read(const uint8_t *data, uint64_t size, uint64_t offset, lw_capture_record_header *header, uint64_t *next_offset) {
+    if (offset > size || size - offset < sizeof(*header)) {
+        return LW_RESULT_AGAIN;
+    }
+
+    memcpy(header, data + offset, sizeof(*header));
+
+    // NOTE: A record cut short by a file that did not finish ends the file.
+    if (size - offset - sizeof(*header) < header->size) {
+        return LW_RESULT_AGAIN;
+    }
+
+    *next_offset = offset + sizeof(*header) + header->size + lw_capture_record_padding_size(header->size);
+
+    return LW_RESULT_SUCCESS;
+}
+
+uint64_t lw_capture_record_find_last_index(const uint8_t *data, uint64_t size, uint64_t first_offset, uint16_t end_type, uint32_t end_size) {
+    lw_capture_record_header header;
+    uint64_t record_size = sizeof(header) + end_size + lw_capture_record_padding_size(end_size);
+    uint64_t next_offset = 0;
+    uint64_t last_index_offset = 0;
+
+    if (first_offset > size || size - first_offset < record_size || end_size < sizeof(last_index_offset) ||
+        lw_capture_record_read(data, size, size - record_size, &header, &next_offset) != LW_RESULT_SUCCESS ||
+        header.type != end_type || header.size != end_size) {
+        return 0;
+    }
+
+    memcpy(&last_index_offset, data + size - record_size + sizeof(header), sizeof(last_index_offset));
+
+    if (last_index_offset < first_offset || last_index_offset >= size - record_size) {
+        return 0;
+    }
+
+    return last_index_offset;
+}
+
+uint32_t lw_capture_file_write_callback(void *user_data, const void *data, uint32_t size) {
+    return (uint32_t)fwrite(data, 1, size, (FILE *)user_data);
+}
+
+// ----------------------------------------------------------------------------
+// Capture writer.
+// ----------------------------------------------------------------------------
+static lw_result lw_capture_write_index(lw_capture_writer *writer) {
+    lw_capture_index index;
+    index.previous_index_offset = writer->last_index_offset;
+    index.data_bytes = writer->data_bytes;
+    index.data_records = writer->data_records;
+    index.reserved = 0;
+
+    uint64_t index_offset = writer->records.offset;
+    LW_CHECK_SUCCESS(lw_capture_record_write(&writer->records, LW_CAPTURE_RECORD_INDEX, writer->last_time_ns, &index, sizeof(index), NULL, 0))
+
+    writer->last_index_offset = index_offset;
+    writer->records_since_index = 0;
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_capture_writer_init(lw_capture_writer *writer, lw_capture_callback_write write, void *user_data, uint32_t baud_rate, uint64_t start_time_ns) {
+    memset(writer, 0, sizeof(*writer));
+    lw_capture_record_writer_init(&writer->records, write, user_data);
+    writer->last_time_ns = start_time_ns;
+    writer->index_interval = LW_CAPTURE_INDEX_INTERVAL;
+
+    lw_capture_file_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LW_CAPTURE_MAGIC;
+    header.version = LW_CAPTURE_VERSION;
+    header.header_size = sizeof(header);
+    header.baud_rate = baud_rate;
+    header.index_interval = writer->index_interval;
+    header.start_time_ns = start_time_ns;
+
+    return lw_capture_record_write_bytes(&writer->records, &header, sizeof(header));
+}
+
+lw_result lw_capture_write(lw_capture_writer *writer, const uint8_t *data, uint32_t size, uint64_t time_ns) {
+    LW_CHECK_SUCCESS(lw_capture_record_write(&writer->records, LW_CAPTURE_RECORD_DATA, time_ns, data, size, NULL, 0))
+
+    writer->data_bytes += size;
+    writer->data_records += 1;
+    writer->last_time_ns = time_ns;
+
+    if (++writer->records_since_index >= writer->index_interval) {
+        return lw_capture_write_index(writer);
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_capture_writer_finish(lw_capture_writer *writer) {
+    // NOTE: Always end on an index so the end record has one to point at.
+    if (writer->records_since_index != 0 || writer->last_index_offset == 0) {
+        LW_CHECK_SUCCESS(lw_capture_write_index(writer))
+    }
+
+    lw_capture_end end;
+    end.last_index_offset = writer->last_index_offset;
+
+    return lw_capture_record_write(&writer->records, LW_CAPTURE_RECORD_END, writer->last_time_ns, &end, sizeof(end), NULL, 0);
+}
+
+static void lw_capture_receive_tap(lw_callback_device *device, const uint8_t *buffer, uint32_t size, uint64_t time_ns) {
+    lw_capture_write((lw_capture_writer *)device->receive_tap_user_data, buffer, size, time_ns);
+}
+
+void lw_capture_attach(lw_capture_writer *writer, lw_callback_device *device) {
+    lw_device_set_receive_tap(device, &lw_capture_receive_tap, writer);
+}
+
+// ----------------------------------------------------------------------------
+// Capture reader.
+// ----------------------------------------------------------------------------
+static lw_result lw_capture_read_record(const lw_capture_reader *reader, uint64_t offset, lw_capture_record_header *header, uint64_t *next_offset) {
+    return lw_capture_record_read(reader->data, reader->size, offset, header, next_offset);
+}
+
+lw_result lw_capture_reader_init(lw_capture_reader *reader, const void *data, uint64_t size) {
+    memset(reader, 0, sizeof(*reader));
+
+    if (data == NULL || size < sizeof(reader->header)) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    memcpy(&reader->header, data, sizeof(reader->header));
+
+    if (reader->header.magic != LW_CAPTURE_MAGIC || reader->header.version != LW_CAPTURE_VERSION ||
+        reader->header.header_size < sizeof(reader->header) || reader->header.header_size > size) {
+        LW_DEBUG_LVL_1("Capture: Not a capture.\n");
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    reader->data = (const uint8_t *)data;
+    reader->size = size;
+    reader->offset = reader->header.header_size;
+
+    // Use the end record to find the index when the capture was finished.
+    reader->last_index_offset = lw_capture_record_find_last_index(reader->data, size, reader->header.header_size, LW_CAPTURE_RECORD_END, sizeof(lw_capture_end));
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_capture_reader_next(lw_capture_reader *reader, lw_capture_chunk *chunk) {
+    lw_capture_record_header header;
+    uint64_t next_offset = 0;
+
+    while (lw_capture_read_record(reader, reader->offset, &header, &next_offset) == LW_RESULT_SUCCESS) {
+        uint64_t payload_offset = reader->offset + sizeof(header);
+        reader->offset = next_offset;
+
+        if (header.type == LW_CAPTURE_RECORD_DATA) {
+            chunk->data = reader->data + payload_offset;
+            chunk->size = header.size;
+            chunk->time_ns = header.time_ns;
+            return LW_RESULT_SUCCESS;
+        }
+    }
+
+    return LW_RESULT_AGAIN;
+}
+
+void lw_capture_reader_seek(lw_capture_reader *reader, uint64_t time_ns) {
+    lw_capture_record_header header;
+    uint64_t next_offset = 0;
+    uint64_t offset = reader->header.header_size;
+
+    if (time_ns == 0) {
+        reader->offset = offset;
+        return;
+    }
+
+    // Walk the index chain back to the last index before the time. Every
+    // data record before an index was received at or before its time.
+    uint64_t index_offset = reader->last_index_offset;
+
+    while (index_offset != 0 && lw_capture_read_record(reader, index_offset, &header, &next_offset) == LW_RESULT_SUCCESS) {
+        if (header.type != LW_CAPTURE_RECORD_INDEX || header.size != sizeof(lw_capture_index)) {
+            break;
+        }
+
+        if (header.time_ns < time_ns) {
+            offset = next_offset;
+            break;
+        }
+
+        lw_capture_index index;
+        memcpy(&index, reader->data + index_offset + sizeof(header), sizeof(index));
+
+        // NOTE: Indices only ever point back, anything else is a corrupt capture.
+        if (index.previous_index_offset >= index_offset) {
+            break;
+        }
+
+        index_offset = index.previous_index_offset;
+    }
+
+    // Scan forward over the record headers for the first record at the time.
+    while (lw_capture_read_record(reader, offset, &header, &next_offset) == LW_RESULT_SUCCESS) {
+        if (header.type == LW_CAPTURE_RECORD_DATA && header.time_ns >= time_ns) {
+            break;
+        }
+
+        offset = next_offset;
+    }
+
+    reader->offset = offset;
+}
+
+// ----------------------------------------------------------------------------
+// Replay device.
+// ----------------------------------------------------------------------------
+static void lw_capture_replay_advance(lw_capture_replay_device *replay_device, uint64_t time_ns) {
+    if (time_ns <= replay_device->time_ns) {
+        return;
+    }
+
+    uint64_t elapsed_ns = time_ns - replay_device->time_ns;
+    replay_device->time_ns = time_ns;
+
+    if (replay_device->sleep == NULL || replay_device->speed == 0) {
+        return;
+    }
+
+    // NOTE: Waits shorter than a millisecond at speed are carried over so the
+    // replay keeps the average rate.
+    replay_device->sleep_debt_ns += elapsed_ns / replay_device->speed;
+
+    if (replay_device->sleep_debt_ns >= 1000000) {
+        uint32_t sleep_ms = (uint32_t)(replay_device->sleep_debt_ns / 1000000);
+        replay_device->sleep_debt_ns -= (uint64_t)sleep_ms * 1000000;
+        replay_device->sleep(&replay_device->device, sleep_ms);
+    }
+}
+
+static void lw_capture_replay_sleep_callback(lw_callback_device *device, uint32_t time_ms) {
+    lw_capture_replay_device *replay_device = (lw_capture_replay_device *)device->user_data;
+    lw_capture_replay_advance(replay_device, replay_device->time_ns + (uint64_t)time_ms * 1000000);
+}
+
+static uint32_t lw_capture_replay_get_time_ms_callback(lw_callback_device *device) {
+    lw_capture_replay_device *replay_device = (lw_capture_replay_device *)device->user_data;
+    return (uint32_t)(replay_device->time_ns / 1000000);
+}
+
+static uint64_t lw_capture_replay_get_time_ns_callback(lw_callback_device *device) {
+    lw_capture_replay_device *replay_device = (lw_capture_replay_device *)device->user_data;
+    return replay_device->time_ns;
+}
+
+static uint32_t lw_capture_replay_serial_send_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size) {
+    (void)device;
+    (void)buffer;
+    return size;
+}
+
+static int32_t lw_capture_replay_serial_receive_callback(lw_callback_device *device, uint8_t *buffer, uint32_t size, uint32_t timeout_ms) {
+    lw_capture_replay_device *replay_device = (lw_capture_replay_device *)device->user_data;
+
+    if (!replay_device->has_chunk) {
+        if (lw_capture_reader_next(&replay_device->reader, &replay_device->chunk) != LW_RESULT_SUCCESS) {
+            LW_DEBUG_LVL_2("Capture: Replay finished.\n");
+            return -1;
+        }
+
+        replay_device->has_chunk = 1;
+        replay_device->chunk_offset = 0;
+    }
+
+    uint64_t deadline_ns = replay_device->time_ns + (uint64_t)timeout_ms * 1000000;
+
+    if (replay_device->chunk.time_ns > deadline_ns) {
+        lw_capture_replay_advance(replay_device, deadline_ns);
+        return 0;
+    }
+
+    lw_capture_replay_advance(replay_device, replay_device->chunk.time_ns);
+
+    uint32_t count = replay_device->chunk.size - replay_device->chunk_offset;
+
+    if (count > size) {
+        count = size;
+    }
+
+    memcpy(buffer, replay_device->chunk.data + replay_device->chunk_offset, count);
+    replay_device->chunk_offset += count;
+
+    if (replay_device->chunk_offset == replay_device->chunk.size) {
+        replay_device->has_chunk = 0;
+    }
+
+    return (int32_t)count;
+}
+
+lw_result lw_capture_create_replay_device(const void *data, uint64_t size, uint32_t speed, lw_device_callback_sleep sleep, lw_capture_replay_device *replay_device) {
+    memset(replay_device, 0, sizeof(*replay_device));
+    LW_CHECK_SUCCESS(lw_capture_reader_init(&replay_device->reader, data, size))
+
+    replay_device->sleep = sleep;
+    replay_device->speed = speed;
+    replay_device->time_ns = replay_device->reader.header.start_time_ns;
+
+    replay_device->device = lw_create_callback_device(replay_device,
+                                                      &lw_capture_replay_sleep_callback,
+                                                      &lw_capture_replay_get_time_ms_callback,
+                                                      &lw_capture_replay_serial_send_callback,
+                                                      &lw_capture_replay_serial_receive_callback);
+
+    lw_device_enable_timestamps(&replay_device->device, &lw_capture_replay_get_time_ns_callback, replay_device->reader.header.baud_rate);
+
+    return LW_RESULT_SUCCESS;
+}
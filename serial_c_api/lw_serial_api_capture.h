@@ -0,0 +1,364 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API Capture
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_CAPTURE_H
+#define LW_API_CAPTURE_H
+
+#include "lw_serial_api.h"
+
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Capture file format.
+//
+// A capture is an append-only recording of the raw bytes received from a
+// device together with their receive times. It starts with a file header
+// followed by a sequence of records. Every record is a record header and a
+// payload padded to 8 bytes, so all headers stay aligned when the file is
+// memory mapped.
+//
+// Data records hold one block of received bytes, timed like
+// lw_callback_device::receive_time_ns. An index record is appended after
+// every index_interval data records and points back at the previous index
+// record, which lets a reader seek by time without touching the data. A
+// capture that was finished ends with an end record pointing at the last
+// index, a capture that was cut short is still readable up to the last
+// complete record.
+//
+// Fields are stored in host byte order, which is little endian on every
+// supported host.
+// ----------------------------------------------------------------------------
+#define LW_CAPTURE_MAGIC 0x5043574Cu // "LWCP"
+#define LW_CAPTURE_VERSION 1
+
+#ifndef LW_CAPTURE_INDEX_INTERVAL
+#define LW_CAPTURE_INDEX_INTERVAL 256
+#endif
+
+typedef enum {
+    LW_CAPTURE_RECORD_DATA = 1,
+    LW_CAPTURE_RECORD_INDEX = 2,
+    LW_CAPTURE_RECORD_END = 3,
+} lw_capture_record_type;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint32_t baud_rate;
+    uint32_t index_interval;
+    uint64_t start_time_ns;
+    uint64_t reserved;
+} lw_capture_file_header;
+
+typedef struct {
+    uint64_t time_ns;
+    uint32_t size;
+    uint16_t type;
+    uint16_t reserved;
+} lw_capture_record_header;
+
+typedef struct {
+    // NOTE: 0 for the first index record, the file header is at offset 0.
+    uint64_t previous_index_offset;
+    uint64_t data_bytes;
+    uint32_t data_records;
+    uint32_t reserved;
+} lw_capture_index;
+
+typedef struct {
+    uint64_t last_index_offset;
+} lw_capture_end;
+
+// ----------------------------------------------------------------------------
+// Record framing.
+//
+// The record layer under the capture format, public so other append-only
+// formats can share it, the GRF-250 sample archive is framed the same way.
+// A file is a header of its own followed by records, and a finished file
+// ends with an end record whose payload starts with the offset of the last
+// index record.
+//
+// Write errors are sticky, once the callback fails every later write is
+// dropped and the error is kept in the record writer.
+// ----------------------------------------------------------------------------
+
+/*
+ * Capture write callback.
+ *
+ * @param user_data The writer user data.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
+ * @return The number of bytes written, anything less than size is an error.
+ */
+typedef uint32_t (*lw_capture_callback_write)(void *user_data, const void *data, uint32_t size);
+
+typedef struct {
+    lw_capture_callback_write write;
+    void *user_data;
+    lw_result result;
+
+    // The number of bytes written so far, which is the offset of the next record.
+    uint64_t offset;
+} lw_capture_record_writer;
+
+/*
+ * Initialize a record writer. Nothing is written.
+ *
+ * @param records The record writer to initialize.
+ * @param write The write callback.
+ * @param user_data User data for the write callback.
+ */
+void lw_capture_record_writer_init(lw_capture_record_writer *records, lw_capture_callback_write write, void *user_data);
+
+/*
+ * Write bytes as they are, for file headers and records framed by the caller.
+ *
+ * @param records The record writer.
+ * @param data The bytes to write.
+ * @param size The number of bytes to write.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if this or an
+ *         earlier write failed.
+ */
+lw_result lw_capture_record_write_bytes(lw_capture_record_writer *records, const void *data, uint32_t size);
+
+/*
+ * Write a record with a payload made of two parts, either can be empty.
+ *
+ * @param records The record writer.
+ * @param type The record type.
+ * @param time_ns The record time.
+ * @param header The first part of the payload.
+ * @param header_size The size of the first part.
+ * @param payload The second part of the payload.
+ * @param payload_size The size of the second part.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if this or an
+ *         earlier write failed.
+ */
+lw_result lw_capture_record_write(lw_capture_record_writer *records, uint16_t type, uint64_t time_ns, const void *header, uint32_t header_size, const void *payload, uint32_t payload_size);
+
+/*
+ * Get the padding that follows a record payload.
+ *
+ * @param size The payload size.
+ * @return The number of padding bytes.
+ */
+uint32_t lw_capture_record_padding_size(uint32_t size);
+
+/*
+ * Read a record header from a file in memory.
+ *
+ * @param data The file.
+ * @param size The size of the file in bytes.
+ * @param offset The offset of the record.
+ * @param header The record header is written here.
+ * @param next_offset The offset of the following record is written here.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN if the record
+ *         does not fit in the file.
+ */
+lw_result lw_capture_record_read(const uint8_t *data, uint64_t size, uint64_t offset, lw_capture_record_header *header, uint64_t *next_offset);
+
+/*
+ * Find the last index of a finished file through its end record.
+ *
+ * @param data The file.
+ * @param size The size of the file in bytes.
+ * @param first_offset The offset of the first record.
+ * @param end_type The type of the end record.
+ * @param end_size The payload size of the end record.
+ * @return The offset of the last index record, or 0 if the file has no valid
+ *         end record.
+ */
+uint64_t lw_capture_record_find_last_index(const uint8_t *data, uint64_t size, uint64_t first_offset, uint16_t end_type, uint32_t end_size);
+
+/*
+ * Write callback for stdio files, user_data is the FILE pointer.
+ */
+uint32_t lw_capture_file_write_callback(void *user_data, const void *data, uint32_t size);
+
+// ----------------------------------------------------------------------------
+// Capture writer.
+//
+// The writer hands the record header, the received bytes and the padding
+// straight to a write callback, so the received bytes are never copied by
+// the writer. The writer can be attached to a device as its receive tap, or
+// fed directly when bytes are passed to lw_feed_response_buffer by hand.
+// A failed write is returned by every later call, lw_capture_writer_finish
+// included.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_capture_record_writer records;
+
+    uint64_t last_index_offset;
+    uint64_t last_time_ns;
+    uint64_t data_bytes;
+    uint32_t data_records;
+    uint32_t index_interval;
+    uint32_t records_since_index;
+} lw_capture_writer;
+
+/*
+ * Initialize a writer and write the file header.
+ *
+ * @param writer The writer to initialize.
+ * @param write The write callback.
+ * @param user_data User data for the write callback.
+ * @param baud_rate The baud rate of the captured link, used to time packets on replay.
+ * @param start_time_ns The time the capture started.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if the write failed.
+ */
+lw_result lw_capture_writer_init(lw_capture_writer *writer, lw_capture_callback_write write, void *user_data, uint32_t baud_rate, uint64_t start_time_ns);
+
+/*
+ * Append a data record.
+ *
+ * @param writer The writer.
+ * @param data The received bytes.
+ * @param size The number of received bytes.
+ * @param time_ns The receive time.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if this or an
+ *         earlier write failed.
+ */
+lw_result lw_capture_write(lw_capture_writer *writer, const uint8_t *data, uint32_t size, uint64_t time_ns);
+
+/*
+ * Append the final index and end records. The writer must not be used again.
+ *
+ * @param writer The writer.
+ * @return LW_RESULT_SUCCESS if every write succeeded, or LW_RESULT_ERROR.
+ */
+lw_result lw_capture_writer_finish(lw_capture_writer *writer);
+
+/*
+ * Record everything a device receives. Set the receive tap to NULL to stop.
+ *
+ * @param writer The writer.
+ * @param device The callback device.
+ */
+void lw_capture_attach(lw_capture_writer *writer, lw_callback_device *device);
+
+// ----------------------------------------------------------------------------
+// Capture reader.
+//
+// The reader works in place on a capture held in memory, usually a memory
+// mapped file, and hands out pointers into it.
+// ----------------------------------------------------------------------------
+typedef struct {
+    const uint8_t *data;
+    uint32_t size;
+    uint64_t time_ns;
+} lw_capture_chunk;
+
+typedef struct {
+    const uint8_t *data;
+    uint64_t size;
+    lw_capture_file_header header;
+
+    uint64_t offset;
+
+    // NOTE: 0 when the capture has no end record.
+    uint64_t last_index_offset;
+} lw_capture_reader;
+
+/*
+ * Initialize a reader over a capture in memory.
+ *
+ * @param reader The reader to initialize.
+ * @param data The capture, must stay valid while the reader is used.
+ * @param size The size of the capture in bytes.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the
+ *         data is not a capture.
+ */
+lw_result lw_capture_reader_init(lw_capture_reader *reader, const void *data, uint64_t size);
+
+/*
+ * Read the next data record.
+ *
+ * @param reader The reader.
+ * @param chunk The received bytes and their time, pointing into the capture.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN at the end of the capture.
+ */
+lw_result lw_capture_reader_next(lw_capture_reader *reader, lw_capture_chunk *chunk);
+
+/*
+ * Move the reader to the first data record received at or after a time.
+ *
+ * @param reader The reader.
+ * @param time_ns The time to seek to, 0 rewinds to the start.
+ */
+void lw_capture_reader_seek(lw_capture_reader *reader, uint64_t time_ns);
+
+// ----------------------------------------------------------------------------
+// Replay device.
+//
+// A callback device that plays a capture back through the normal managed
+// receive path. The device runs on its own clock that starts at the capture
+// start time and only moves forward when the API sleeps or waits in the
+// receive callback, so timestamps and timeouts see the captured times.
+//
+// With a sleep callback and a speed, waits are paced in real time at speed
+// times real time, otherwise the capture is replayed as fast as it can be
+// parsed. Sent requests are discarded. At the end of the capture the receive
+// callback reports a lost connection.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_callback_device device;
+    lw_capture_reader reader;
+
+    lw_device_callback_sleep sleep;
+    uint32_t speed;
+
+    uint64_t time_ns;
+    uint64_t sleep_debt_ns;
+
+    lw_capture_chunk chunk;
+    uint32_t chunk_offset;
+    uint8_t has_chunk;
+} lw_capture_replay_device;
+
+/*
+ * Create a replay device over a capture in memory.
+ *
+ * @param data The capture, must stay valid while the device is used.
+ * @param size The size of the capture in bytes.
+ * @param speed The replay speed as a multiple of real time, or 0 for no pacing.
+ * @param sleep Real sleep callback used for pacing, or NULL for no pacing.
+ * @param replay_device The replay device to create.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the
+ *         data is not a capture.
+ */
+lw_result lw_capture_create_replay_device(const void *data, uint64_t size, uint32_t speed, lw_device_callback_sleep sleep, lw_capture_replay_device *replay_device);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_CAPTURE_H
@@ -0,0 +1,112 @@
+#include "lw_serial_api_grf250_alarm.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Alarm monitor.
+// ----------------------------------------------------------------------------
+static void lw_grf250_alarm_observe(lw_grf250_alarm_monitor *monitor, lw_grf250_alarm_status status, uint64_t timestamp_ns, uint8_t polled) {
+    uint32_t time_ms = monitor->device->get_time_ms(monitor->device);
+
+    if (timestamp_ns == 0) {
+        timestamp_ns = (uint64_t)time_ms * 1000000;
+    }
+
+    // NOTE: Clamped to 0 if the millisecond clock wrapped between samples.
+    uint32_t interval_ms = 0;
+
+    if (monitor->primed && timestamp_ns > monitor->last_sample_ns) {
+        interval_ms = (uint32_t)((timestamp_ns - monitor->last_sample_ns) / 1000000);
+    }
+
+    if (monitor->primed) {
+        lw_stats_histogram_add(&monitor->stats.sample_interval, interval_ms);
+    }
+
+    monitor->primed = 1;
+    monitor->last_sample_ns = timestamp_ns;
+    monitor->last_sample_ms = time_ms;
+    monitor->stats.samples += 1;
+
+    uint32_t changed = 0;
+    changed |= (status.alarm_a != monitor->status.alarm_a) ? LW_GRF250_ALARM_A : 0;
+    changed |= (status.alarm_b != monitor->status.alarm_b) ? LW_GRF250_ALARM_B : 0;
+
+    if (changed == 0) {
+        return;
+    }
+
+    lw_grf250_alarm_event event;
+    event.status = status;
+    event.previous = monitor->status;
+    event.changed = changed;
+    event.timestamp_ns = timestamp_ns;
+    event.detection_window_ms = interval_ms;
+    event.polled = polled;
+
+    monitor->status = status;
+    monitor->stats.events += 1;
+    lw_stats_histogram_add(&monitor->stats.detection_window, interval_ms);
+
+    if (monitor->callback != NULL) {
+        monitor->callback(monitor, &event);
+    }
+}
+
+void lw_grf250_init_alarm_monitor(lw_grf250_alarm_monitor *monitor, lw_callback_device *device, lw_grf250_alarm_callback callback, void *user_data, uint32_t poll_interval_ms) {
+    memset(monitor, 0, sizeof(*monitor));
+    monitor->device = device;
+    monitor->callback = callback;
+    monitor->user_data = user_data;
+    monitor->poll_interval_ms = poll_interval_ms;
+
+    // The first poll is due straight away.
+    uint32_t time_ms = device->get_time_ms(device);
+    monitor->last_sample_ms = time_ms - poll_interval_ms;
+    monitor->last_poll_ms = time_ms - poll_interval_ms;
+}
+
+void lw_grf250_update_alarm_monitor(lw_grf250_alarm_monitor *monitor, const lw_grf250_distance_data *distance_data) {
+    uint32_t alarm_status = (uint32_t)distance_data->alarm_status;
+
+    lw_grf250_alarm_status status;
+    status.alarm_a = (alarm_status >> 0) & 0xFF;
+    status.alarm_b = (alarm_status >> 8) & 0xFF;
+
+    lw_grf250_alarm_observe(monitor, status, distance_data->timestamp_ns, 0);
+}
+
+lw_result lw_grf250_poll_alarm_monitor(lw_grf250_alarm_monitor *monitor) {
+    lw_callback_device *device = monitor->device;
+    uint32_t start_ms = device->get_time_ms(device);
+
+    if (start_ms - monitor->last_sample_ms < monitor->poll_interval_ms || start_ms - monitor->last_poll_ms < monitor->poll_interval_ms) {
+        return LW_RESULT_AGAIN;
+    }
+
+    monitor->last_poll_ms = start_ms;
+    monitor->stats.polls += 1;
+
+    lw_grf250_alarm_status status;
+    lw_result poll_result = lw_grf250_get_alarm_status(device, &status);
+
+    if (poll_result != LW_RESULT_SUCCESS) {
+        monitor->stats.poll_errors += 1;
+        return poll_result;
+    }
+
+    lw_stats_histogram_add(&monitor->stats.poll_latency, device->get_time_ms(device) - start_ms);
+    lw_grf250_alarm_observe(monitor, status, device->response.start_time_ns, 1);
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_wait_for_alarm_distance(lw_grf250_alarm_monitor *monitor, lw_grf_distance_config config, lw_grf250_distance_data *distance_data, uint32_t timeout_ms) {
+    if ((config & LW_GRF250_DISTANCE_CONFIG_ALARM_STATUS) == 0) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    LW_CHECK_SUCCESS(lw_grf250_wait_for_streamed_distance(monitor->device, config, distance_data, timeout_ms))
+    lw_grf250_update_alarm_monitor(monitor, distance_data);
+
+    return LW_RESULT_SUCCESS;
+}
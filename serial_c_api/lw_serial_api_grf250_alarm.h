@@ -0,0 +1,168 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Alarm Monitor
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_ALARM_H
+#define LW_API_GRF250_ALARM_H
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Alarm monitor.
+//
+// Watches the alarm status and calls back only when alarm A or B changes,
+// instead of the application polling lw_grf250_get_alarm_status in a loop.
+//
+// While distance data is streamed with LW_GRF250_DISTANCE_CONFIG_ALARM_STATUS
+// the status comes for free with every sample, so no requests are sent and an
+// alarm is seen within one stream period. When no sample has been seen for
+// poll_interval_ms, eg: the stream is off or has stalled, the monitor falls
+// back to polling the status at that interval.
+//
+// The monitor starts with both alarms inactive, so an alarm that is already
+// active is reported by the first status seen.
+// ----------------------------------------------------------------------------
+#define LW_GRF250_ALARM_A (1 << 0)
+#define LW_GRF250_ALARM_B (1 << 1)
+
+typedef struct lw_grf250_alarm_monitor_s lw_grf250_alarm_monitor;
+
+typedef struct {
+    lw_grf250_alarm_status status;
+    lw_grf250_alarm_status previous;
+
+    // LW_GRF250_ALARM_A and/or LW_GRF250_ALARM_B for the alarms that changed.
+    uint32_t changed;
+
+    // When the new status was seen: the packet start time when the device has
+    // timestamps enabled, otherwise get_time_ms in nanoseconds.
+    uint64_t timestamp_ns;
+
+    // The time since the previous status was seen, or 0 for the first. The
+    // change happened somewhere in this window, so it bounds how late the
+    // change is reported.
+    uint32_t detection_window_ms;
+
+    // Whether the status came from a poll rather than the stream.
+    uint8_t polled;
+} lw_grf250_alarm_event;
+
+/*
+ * Alarm callback. Called from the monitor functions for every change.
+ *
+ * @param monitor The alarm monitor.
+ * @param event The change, only valid during the callback.
+ */
+typedef void (*lw_grf250_alarm_callback)(lw_grf250_alarm_monitor *monitor, const lw_grf250_alarm_event *event);
+
+typedef struct {
+    uint32_t samples;
+    uint32_t polls;
+    uint32_t poll_errors;
+    uint32_t events;
+
+    // Time between each status seen and the one before it.
+    lw_stats_histogram sample_interval;
+
+    // Round trip time of the poll requests.
+    lw_stats_histogram poll_latency;
+
+    // Detection window of the reported changes.
+    lw_stats_histogram detection_window;
+} lw_grf250_alarm_stats;
+
+struct lw_grf250_alarm_monitor_s {
+    lw_callback_device *device;
+    lw_grf250_alarm_callback callback;
+    void *user_data;
+    uint32_t poll_interval_ms;
+    lw_grf250_alarm_stats stats;
+
+    // The latest status seen.
+    lw_grf250_alarm_status status;
+
+    // NOTE: Used internally.
+    uint8_t primed;
+    uint64_t last_sample_ns;
+    uint32_t last_sample_ms;
+    uint32_t last_poll_ms;
+};
+
+/*
+ * Initialize an alarm monitor.
+ *
+ * @param monitor The monitor to initialize.
+ * @param device Connected device.
+ * @param callback Called for every alarm change.
+ * @param user_data Passed through to the callback in monitor->user_data.
+ * @param poll_interval_ms The time without a streamed status before polling,
+ *        and then the time between polls. 0 polls on every call.
+ */
+void lw_grf250_init_alarm_monitor(lw_grf250_alarm_monitor *monitor, lw_callback_device *device, lw_grf250_alarm_callback callback, void *user_data, uint32_t poll_interval_ms);
+
+/*
+ * Pass a streamed distance sample to the monitor. For applications that
+ * already decode the stream themselves.
+ *
+ * @param monitor The alarm monitor.
+ * @param distance_data The sample, decoded with a distance config that
+ *        includes LW_GRF250_DISTANCE_CONFIG_ALARM_STATUS.
+ */
+void lw_grf250_update_alarm_monitor(lw_grf250_alarm_monitor *monitor, const lw_grf250_distance_data *distance_data);
+
+/*
+ * Poll the alarm status if no status has been seen for poll_interval_ms.
+ *
+ * @param monitor The alarm monitor.
+ * @return LW_RESULT_SUCCESS if the status was polled.
+ *         LW_RESULT_AGAIN if a poll is not due yet, no request is sent.
+ *         Failed polls are also rate limited to poll_interval_ms.
+ *         Otherwise the result of the status request.
+ */
+lw_result lw_grf250_poll_alarm_monitor(lw_grf250_alarm_monitor *monitor);
+
+/*
+ * Wait for the next streamed distance data and pass it to the monitor.
+ *
+ * @param monitor The alarm monitor.
+ * @param config Distance configuration, must include
+ *        LW_GRF250_DISTANCE_CONFIG_ALARM_STATUS.
+ * @param distance_data The sample is written here.
+ * @param timeout_ms The timeout in milliseconds, or 0 for non-blocking.
+ * @return The result of lw_grf250_wait_for_streamed_distance, or
+ *         LW_RESULT_INVALID_PARAMETER if the config has no alarm status.
+ */
+lw_result lw_grf250_wait_for_alarm_distance(lw_grf250_alarm_monitor *monitor, lw_grf_distance_config config, lw_grf250_distance_data *distance_data, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_ALARM_H
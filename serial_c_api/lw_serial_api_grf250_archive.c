@@ -0,0 +1,688 @@
+#include "lw_serial_api_grf250_archive.h"
+#include <string.h>
+
+typedef enum {
+    LW_GRF250_ARCHIVE_ENCODING_DELTA = 0,
+    LW_GRF250_ARCHIVE_ENCODING_RUN = 1,
+} lw_grf250_archive_encoding;
+
+// NOTE: Ordered to match the LW_GRF250_DISTANCE_FIELD_... values.
+static const uint8_t lw_grf250_archive_distance_encodings[LW_GRF250_ARCHIVE_DISTANCE_COLUMNS] = {
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_RUN,
+    LW_GRF250_ARCHIVE_ENCODING_RUN,
+};
+
+static const uint8_t lw_grf250_archive_multi_encodings[LW_GRF250_ARCHIVE_MULTI_COLUMNS] = {
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_DELTA,
+    LW_GRF250_ARCHIVE_ENCODING_RUN,
+};
+
+static const uint8_t *lw_grf250_archive_get_encodings(uint32_t kind) {
+    return (kind == LW_GRF250_ARCHIVE_DISTANCE) ? lw_grf250_archive_distance_encodings : lw_grf250_archive_multi_encodings;
+}
+
+// ----------------------------------------------------------------------------
+// Varint coding.
+// ----------------------------------------------------------------------------
+static uint64_t lw_grf250_archive_zigzag(int64_t value) {
+    return ((uint64_t)value << 1) ^ (value < 0 ? UINT64_MAX : 0);
+}
+
+static int64_t lw_grf250_archive_unzigzag(uint64_t value) {
+    return (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static uint32_t lw_grf250_archive_put_varint(uint8_t *data, uint64_t value) {
+    uint32_t size = 0;
+
+    while (value >= 0x80) {
+        data[size++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+
+    data[size++] = (uint8_t)value;
+
+    return size;
+}
+
+// Returns the number of bytes read, or 0 if the varint runs past the end.
+static uint32_t lw_grf250_archive_get_varint(const uint8_t *data, uint32_t size, uint64_t *value) {
+    // NOTE: Most values fit in a single byte.
+    if (size != 0 && data[0] < 0x80) {
+        *value = data[0];
+        return 1;
+    }
+
+    uint64_t decoded = 0;
+
+    for (uint32_t i = 0; i < size && i < 10; ++i) {
+        decoded |= (uint64_t)(data[i] & 0x7F) << (7 * i);
+
+        if ((data[i] & 0x80) == 0) {
+            *value = decoded;
+            return i + 1;
+        }
+    }
+
+    return 0;
+}
+
+// ----------------------------------------------------------------------------
+// Column coding.
+// ----------------------------------------------------------------------------
+static uint32_t lw_grf250_archive_encode_timestamps(uint8_t *data, const uint64_t *timestamps_ns, uint32_t count) {
+    uint32_t size = 0;
+    uint64_t previous_period_ns = 0;
+
+    // NOTE: Unsigned differences keep the coding exact for any sequence of
+    // times, a steady stream just codes smaller.
+    for (uint32_t i = 1; i < count; ++i) {
+        uint64_t period_ns = timestamps_ns[i] - timestamps_ns[i - 1];
+        size += lw_grf250_archive_put_varint(data + size, lw_grf250_archive_zigzag((int64_t)(period_ns - previous_period_ns)));
+        previous_period_ns = period_ns;
+    }
+
+    return size;
+}
+
+static uint32_t lw_grf250_archive_encode_column(uint8_t *data, const int32_t *values, uint32_t count, uint8_t encoding) {
+    uint32_t size = 0;
+
+    switch (encoding) {
+        case LW_GRF250_ARCHIVE_ENCODING_DELTA: {
+            int64_t previous = 0;
+
+            for (uint32_t i = 0; i < count; ++i) {
+                size += lw_grf250_archive_put_varint(data + size, lw_grf250_archive_zigzag((int64_t)values[i] - previous));
+                previous = values[i];
+            }
+
+            break;
+        }
+
+        case LW_GRF250_ARCHIVE_ENCODING_RUN: {
+            uint32_t i = 0;
+
+            while (i < count) {
+                uint32_t run = 1;
+
+                while (i + run < count && values[i + run] == values[i]) {
+                    ++run;
+                }
+
+                size += lw_grf250_archive_put_varint(data + size, lw_grf250_archive_zigzag(values[i]));
+                size += lw_grf250_archive_put_varint(data + size, run);
+                i += run;
+            }
+
+            break;
+        }
+    }
+
+    return size;
+}
+
+static lw_result lw_grf250_archive_decode_timestamps(const uint8_t *data, uint32_t size, uint64_t first_time_ns, uint64_t *timestamps_ns, uint32_t count) {
+    uint32_t offset = 0;
+    uint64_t period_ns = 0;
+
+    timestamps_ns[0] = first_time_ns;
+
+    for (uint32_t i = 1; i < count; ++i) {
+        uint64_t value = 0;
+        uint32_t value_size = lw_grf250_archive_get_varint(data + offset, size - offset, &value);
+
+        if (value_size == 0) {
+            return LW_RESULT_ERROR;
+        }
+
+        offset += value_size;
+        period_ns += (uint64_t)lw_grf250_archive_unzigzag(value);
+        timestamps_ns[i] = timestamps_ns[i - 1] + period_ns;
+    }
+
+    return (offset == size) ? LW_RESULT_SUCCESS : LW_RESULT_ERROR;
+}
+
+static lw_result lw_grf250_archive_decode_column(const uint8_t *data, uint32_t size, uint8_t encoding, int32_t *values, uint32_t count) {
+    uint32_t offset = 0;
+    uint64_t value = 0;
+    uint32_t value_size = 0;
+
+    switch (encoding) {
+        case LW_GRF250_ARCHIVE_ENCODING_DELTA: {
+            int64_t previous = 0;
+
+            for (uint32_t i = 0; i < count; ++i) {
+                value_size = lw_grf250_archive_get_varint(data + offset, size - offset, &value);
+
+                if (value_size == 0) {
+                    return LW_RESULT_ERROR;
+                }
+
+                offset += value_size;
+                previous += lw_grf250_archive_unzigzag(value);
+                values[i] = (int32_t)previous;
+            }
+
+            break;
+        }
+
+        case LW_GRF250_ARCHIVE_ENCODING_RUN: {
+            uint32_t i = 0;
+
+            while (i < count) {
+                uint64_t run = 0;
+                value_size = lw_grf250_archive_get_varint(data + offset, size - offset, &value);
+
+                if (value_size == 0) {
+                    return LW_RESULT_ERROR;
+                }
+
+                offset += value_size;
+                value_size = lw_grf250_archive_get_varint(data + offset, size - offset, &run);
+
+                if (value_size == 0 || run == 0 || run > count - i) {
+                    return LW_RESULT_ERROR;
+                }
+
+                offset += value_size;
+
+                for (uint32_t end = i + (uint32_t)run; i < end; ++i) {
+                    values[i] = (int32_t)lw_grf250_archive_unzigzag(value);
+                }
+            }
+
+            break;
+        }
+    }
+
+    return (offset == size) ? LW_RESULT_SUCCESS : LW_RESULT_ERROR;
+}
+
+// ----------------------------------------------------------------------------
+// Archive writer.
+// ----------------------------------------------------------------------------
+static lw_result lw_grf250_archive_write_index(lw_grf250_archive_writer *writer) {
+    lw_grf250_archive_index_header index;
+    index.previous_index_offset = writer->last_index_offset;
+    index.entry_count = writer->index_count;
+    index.reserved = 0;
+
+    uint64_t index_offset = writer->records.offset;
+    LW_CHECK_SUCCESS(lw_capture_record_write(&writer->records, LW_GRF250_ARCHIVE_RECORD_INDEX, writer->last_time_ns, &index, sizeof(index), writer->index, writer->index_count * (uint32_t)sizeof(writer->index[0])))
+
+    writer->last_index_offset = index_offset;
+    writer->index_count = 0;
+
+    return LW_RESULT_SUCCESS;
+}
+
+static lw_result lw_grf250_archive_write_block(lw_grf250_archive_writer *writer) {
+    if (writer->records.result != LW_RESULT_SUCCESS) {
+        return writer->records.result;
+    }
+
+    uint32_t count = writer->block_count;
+
+    if (count == 0) {
+        return LW_RESULT_SUCCESS;
+    }
+
+    // The whole record is encoded in place and written with a single call.
+    const uint8_t *encodings = lw_grf250_archive_get_encodings(writer->kind);
+    lw_grf250_archive_column columns[LW_GRF250_ARCHIVE_MAX_COLUMNS + 1];
+    uint32_t columns_offset = sizeof(lw_capture_record_header) + sizeof(lw_grf250_archive_block_header);
+    uint32_t columns_size = (writer->column_count + 1) * (uint32_t)sizeof(columns[0]);
+    uint32_t size = columns_offset + columns_size;
+
+    for (uint32_t i = 0; i <= writer->column_count; ++i) {
+        uint8_t *column = writer->encoded + size;
+
+        if (i == 0) {
+            columns[i].size = lw_grf250_archive_encode_timestamps(column, writer->timestamps_ns, count);
+        } else {
+            columns[i].size = lw_grf250_archive_encode_column(column, writer->columns[i - 1], count, encodings[i - 1]);
+        }
+
+        columns[i].crc = lw_update_crc(0, column, columns[i].size);
+        columns[i].reserved = 0;
+        size += columns[i].size;
+    }
+
+    memcpy(writer->encoded + columns_offset, columns, columns_size);
+
+    lw_capture_record_header record_header;
+    record_header.time_ns = writer->timestamps_ns[count - 1];
+    record_header.size = size - (uint32_t)sizeof(record_header);
+    record_header.type = LW_GRF250_ARCHIVE_RECORD_BLOCK;
+    record_header.reserved = 0;
+
+    lw_grf250_archive_block_header block_header;
+    block_header.first_time_ns = writer->timestamps_ns[0];
+    block_header.last_time_ns = writer->timestamps_ns[count - 1];
+    block_header.sample_count = count;
+    block_header.column_count = (uint16_t)writer->column_count;
+    block_header.crc = lw_update_crc(0, writer->encoded + columns_offset, columns_size);
+
+    memcpy(writer->encoded, &record_header, sizeof(record_header));
+    memcpy(writer->encoded + sizeof(record_header), &block_header, sizeof(block_header));
+
+    uint32_t padding_size = lw_capture_record_padding_size(record_header.size);
+    memset(writer->encoded + size, 0, padding_size);
+
+    uint64_t block_offset = writer->records.offset;
+    LW_CHECK_SUCCESS(lw_capture_record_write_bytes(&writer->records, writer->encoded, size + padding_size))
+
+    writer->block_count = 0;
+    writer->sample_count += count;
+    writer->last_time_ns = block_header.last_time_ns;
+    writer->index[writer->index_count].block_offset = block_offset;
+    writer->index[writer->index_count].last_time_ns = block_header.last_time_ns;
+
+    if (++writer->index_count >= LW_GRF250_ARCHIVE_INDEX_INTERVAL) {
+        return lw_grf250_archive_write_index(writer);
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_archive_writer_init(lw_grf250_archive_writer *writer, lw_grf250_archive_kind kind, lw_capture_callback_write write, void *user_data, uint64_t start_time_ns) {
+    memset(writer, 0, sizeof(*writer));
+
+    if (kind != LW_GRF250_ARCHIVE_DISTANCE && kind != LW_GRF250_ARCHIVE_MULTI) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    lw_capture_record_writer_init(&writer->records, write, user_data);
+    writer->kind = kind;
+    writer->last_time_ns = start_time_ns;
+    writer->column_count = (kind == LW_GRF250_ARCHIVE_DISTANCE) ? LW_GRF250_ARCHIVE_DISTANCE_COLUMNS : LW_GRF250_ARCHIVE_MULTI_COLUMNS;
+
+    lw_grf250_archive_file_header header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LW_GRF250_ARCHIVE_MAGIC;
+    header.version = LW_GRF250_ARCHIVE_VERSION;
+    header.header_size = sizeof(header);
+    header.kind = (uint16_t)kind;
+    header.column_count = (uint16_t)writer->column_count;
+    header.block_samples = LW_GRF250_ARCHIVE_BLOCK_SAMPLES;
+    header.index_interval = LW_GRF250_ARCHIVE_INDEX_INTERVAL;
+    header.start_time_ns = start_time_ns;
+
+    return lw_capture_record_write_bytes(&writer->records, &header, sizeof(header));
+}
+
+lw_result lw_grf250_archive_write_distance(lw_grf250_archive_writer *writer, const lw_grf250_distance_data *distance_data) {
+    if (writer->kind != LW_GRF250_ARCHIVE_DISTANCE) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    if (writer->records.result != LW_RESULT_SUCCESS) {
+        return writer->records.result;
+    }
+
+    uint32_t i = writer->block_count++;
+    writer->timestamps_ns[i] = distance_data->timestamp_ns;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_RAW][i] = distance_data->first_return_raw_mm;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_FILTERED][i] = distance_data->first_return_filtered_mm;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_FIRST_RETURN_STRENGTH][i] = distance_data->first_return_strength;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_LAST_RETURN_RAW][i] = distance_data->last_return_raw_mm;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_LAST_RETURN_FILTERED][i] = distance_data->last_return_filtered_mm;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_LAST_RETURN_STRENGTH][i] = distance_data->last_return_strength;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_TEMPERATURE][i] = distance_data->temperature;
+    writer->columns[LW_GRF250_DISTANCE_FIELD_ALARM_STATUS][i] = distance_data->alarm_status;
+
+    if (writer->block_count == LW_GRF250_ARCHIVE_BLOCK_SAMPLES) {
+        return lw_grf250_archive_write_block(writer);
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_archive_write_multi(lw_grf250_archive_writer *writer, const lw_grf250_multi_data *multi_data) {
+    if (writer->kind != LW_GRF250_ARCHIVE_MULTI) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    if (writer->records.result != LW_RESULT_SUCCESS) {
+        return writer->records.result;
+    }
+
+    uint32_t i = writer->block_count++;
+    writer->timestamps_ns[i] = multi_data->timestamp_ns;
+
+    for (uint32_t signal = 0; signal < 5; ++signal) {
+        writer->columns[signal][i] = multi_data->signals[signal].distance_cm;
+        writer->columns[5 + signal][i] = multi_data->signals[signal].strength;
+    }
+
+    writer->columns[10][i] = multi_data->temperature;
+
+    if (writer->block_count == LW_GRF250_ARCHIVE_BLOCK_SAMPLES) {
+        return lw_grf250_archive_write_block(writer);
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_archive_writer_flush(lw_grf250_archive_writer *writer) {
+    return lw_grf250_archive_write_block(writer);
+}
+
+lw_result lw_grf250_archive_writer_finish(lw_grf250_archive_writer *writer) {
+    LW_CHECK_SUCCESS(lw_grf250_archive_write_block(writer))
+
+    // NOTE: Seeks only find blocks through the index, so the blocks since the
+    // last index get one. An empty archive still gets an empty index, as the
+    // end record has to point at one.
+    if (writer->index_count != 0 || writer->last_index_offset == 0) {
+        LW_CHECK_SUCCESS(lw_grf250_archive_write_index(writer))
+    }
+
+    lw_grf250_archive_end end;
+    end.last_index_offset = writer->last_index_offset;
+    end.sample_count = writer->sample_count;
+
+    return lw_capture_record_write(&writer->records, LW_GRF250_ARCHIVE_RECORD_END, writer->last_time_ns, &end, sizeof(end), NULL, 0);
+}
+
+// ----------------------------------------------------------------------------
+// Archive reader.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_grf250_archive_block_header header;
+    lw_grf250_archive_column columns[LW_GRF250_ARCHIVE_MAX_COLUMNS + 1];
+
+    // The start of every column.
+    const uint8_t *data[LW_GRF250_ARCHIVE_MAX_COLUMNS + 1];
+    uint64_t next_offset;
+} lw_grf250_archive_block;
+
+static lw_result lw_grf250_archive_read_record(const lw_grf250_archive_reader *reader, uint64_t offset, lw_capture_record_header *header, uint64_t *next_offset) {
+    return lw_capture_record_read(reader->data, reader->size, offset, header, next_offset);
+}
+
+// Check the layout of a block record. The columns are only checked when they
+// are decoded.
+static lw_result lw_grf250_archive_check_block(const lw_grf250_archive_reader *reader, uint64_t offset, const lw_capture_record_header *record_header, lw_grf250_archive_block *block) {
+    const uint8_t *payload = reader->data + offset + sizeof(*record_header);
+    uint32_t column_count = reader->header.column_count;
+    uint32_t columns_size = (column_count + 1) * (uint32_t)sizeof(block->columns[0]);
+
+    if (record_header->size < sizeof(block->header) + columns_size) {
+        return LW_RESULT_ERROR;
+    }
+
+    memcpy(&block->header, payload, sizeof(block->header));
+    memcpy(block->columns, payload + sizeof(block->header), columns_size);
+
+    if (block->header.column_count != column_count || block->header.sample_count == 0 || block->header.sample_count > reader->header.block_samples ||
+        lw_update_crc(0, payload + sizeof(block->header), columns_size) != block->header.crc) {
+        return LW_RESULT_ERROR;
+    }
+
+    const uint8_t *data = payload + sizeof(block->header) + columns_size;
+    uint32_t data_size = record_header->size - (uint32_t)sizeof(block->header) - columns_size;
+    uint32_t total_size = 0;
+
+    for (uint32_t i = 0; i <= column_count; ++i) {
+        if (block->columns[i].size > data_size - total_size) {
+            return LW_RESULT_ERROR;
+        }
+
+        block->data[i] = data + total_size;
+        total_size += block->columns[i].size;
+    }
+
+    return (total_size == data_size) ? LW_RESULT_SUCCESS : LW_RESULT_ERROR;
+}
+
+static lw_result lw_grf250_archive_check_column(const lw_grf250_archive_block *block, uint32_t column) {
+    return (lw_update_crc(0, block->data[column], block->columns[column].size) == block->columns[column].crc) ? LW_RESULT_SUCCESS : LW_RESULT_ERROR;
+}
+
+static lw_result lw_grf250_archive_decode_block_timestamps(const lw_grf250_archive_block *block, uint64_t *timestamps_ns) {
+    LW_CHECK_SUCCESS(lw_grf250_archive_check_column(block, 0))
+    return lw_grf250_archive_decode_timestamps(block->data[0], block->columns[0].size, block->header.first_time_ns, timestamps_ns, block->header.sample_count);
+}
+
+static lw_result lw_grf250_archive_decode_block_column(const lw_grf250_archive_block *block, uint32_t column, const uint8_t *encodings, int32_t *values) {
+    LW_CHECK_SUCCESS(lw_grf250_archive_check_column(block, column + 1))
+    return lw_grf250_archive_decode_column(block->data[column + 1], block->columns[column + 1].size, encodings[column], values, block->header.sample_count);
+}
+
+// Find the next good block from the reader offset. Index records and blocks
+// that fail the check are passed over.
+static lw_result lw_grf250_archive_next_block(lw_grf250_archive_reader *reader, lw_grf250_archive_block *block) {
+    lw_capture_record_header header;
+
+    while (lw_grf250_archive_read_record(reader, reader->offset, &header, &block->next_offset) == LW_RESULT_SUCCESS) {
+        if (header.type == LW_GRF250_ARCHIVE_RECORD_BLOCK) {
+            if (lw_grf250_archive_check_block(reader, reader->offset, &header, block) == LW_RESULT_SUCCESS) {
+                return LW_RESULT_SUCCESS;
+            }
+
+            LW_DEBUG_LVL_1("Archive: Skipping corrupt block.\n");
+            reader->corrupt_blocks += 1;
+        }
+
+        reader->offset = block->next_offset;
+    }
+
+    return LW_RESULT_AGAIN;
+}
+
+lw_result lw_grf250_archive_reader_init(lw_grf250_archive_reader *reader, const void *data, uint64_t size) {
+    memset(reader, 0, sizeof(*reader));
+
+    if (data == NULL || size < sizeof(reader->header)) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    memcpy(&reader->header, data, sizeof(reader->header));
+
+    uint32_t column_count = (reader->header.kind == LW_GRF250_ARCHIVE_DISTANCE) ? LW_GRF250_ARCHIVE_DISTANCE_COLUMNS : LW_GRF250_ARCHIVE_MULTI_COLUMNS;
+
+    if (reader->header.magic != LW_GRF250_ARCHIVE_MAGIC || reader->header.version != LW_GRF250_ARCHIVE_VERSION ||
+        reader->header.header_size < sizeof(reader->header) || reader->header.header_size > size ||
+        (reader->header.kind != LW_GRF250_ARCHIVE_DISTANCE && reader->header.kind != LW_GRF250_ARCHIVE_MULTI) ||
+        reader->header.column_count != column_count || reader->header.block_samples > LW_GRF250_ARCHIVE_BLOCK_SAMPLES) {
+        LW_DEBUG_LVL_1("Archive: Not a readable archive.\n");
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    reader->data = (const uint8_t *)data;
+    reader->size = size;
+    reader->offset = reader->header.header_size;
+
+    // NOTE: Only a finished archive has an index to seek with, reads work either way.
+    reader->last_index_offset = lw_capture_record_find_last_index(reader->data, size, reader->header.header_size, LW_GRF250_ARCHIVE_RECORD_END, sizeof(lw_grf250_archive_end));
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_archive_read_distance(lw_grf250_archive_reader *reader, lw_grf250_distance_batch *batch) {
+    if (reader->header.kind != LW_GRF250_ARCHIVE_DISTANCE) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    lw_grf250_archive_block block;
+
+    while (lw_grf250_archive_next_block(reader, &block) == LW_RESULT_SUCCESS) {
+        uint32_t count = block.header.sample_count;
+
+        if (batch->capacity - batch->count < count) {
+            return LW_RESULT_INVALID_PARAMETER;
+        }
+
+        // NOTE: Columns that are not wanted are never touched.
+        lw_result decode_result = LW_RESULT_SUCCESS;
+
+        if (batch->timestamps_ns != NULL) {
+            decode_result = lw_grf250_archive_decode_block_timestamps(&block, batch->timestamps_ns + batch->count);
+        }
+
+        for (uint32_t i = 0; i < LW_GRF250_ARCHIVE_DISTANCE_COLUMNS && decode_result == LW_RESULT_SUCCESS; ++i) {
+            if (batch->columns[i] != NULL) {
+                decode_result = lw_grf250_archive_decode_block_column(&block, i, lw_grf250_archive_distance_encodings, batch->columns[i] + batch->count);
+            }
+        }
+
+        reader->offset = block.next_offset;
+
+        if (decode_result == LW_RESULT_SUCCESS) {
+            batch->count += count;
+            return LW_RESULT_SUCCESS;
+        }
+
+        LW_DEBUG_LVL_1("Archive: Skipping corrupt block.\n");
+        reader->corrupt_blocks += 1;
+    }
+
+    return LW_RESULT_AGAIN;
+}
+
+lw_result lw_grf250_archive_read_multi(lw_grf250_archive_reader *reader, lw_grf250_multi_data *samples, uint32_t capacity, uint32_t *count) {
+    if (reader->header.kind != LW_GRF250_ARCHIVE_MULTI) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    lw_grf250_archive_block block;
+
+    while (lw_grf250_archive_next_block(reader, &block) == LW_RESULT_SUCCESS) {
+        uint32_t sample_count = block.header.sample_count;
+
+        if (capacity < sample_count) {
+            return LW_RESULT_INVALID_PARAMETER;
+        }
+
+        lw_result decode_result = lw_grf250_archive_decode_block_timestamps(&block, reader->timestamps_ns);
+
+        for (uint32_t i = 0; i < sample_count; ++i) {
+            samples[i].timestamp_ns = reader->timestamps_ns[i];
+        }
+
+        for (uint32_t c = 0; c < LW_GRF250_ARCHIVE_MULTI_COLUMNS && decode_result == LW_RESULT_SUCCESS; ++c) {
+            decode_result = lw_grf250_archive_decode_block_column(&block, c, lw_grf250_archive_multi_encodings, reader->column);
+
+            for (uint32_t i = 0; i < sample_count; ++i) {
+                if (c < 5) {
+                    samples[i].signals[c].distance_cm = reader->column[i];
+                } else if (c < 10) {
+                    samples[i].signals[c - 5].strength = reader->column[i];
+                } else {
+                    samples[i].temperature = reader->column[i];
+                }
+            }
+        }
+
+        reader->offset = block.next_offset;
+
+        if (decode_result == LW_RESULT_SUCCESS) {
+            *count = sample_count;
+            return LW_RESULT_SUCCESS;
+        }
+
+        LW_DEBUG_LVL_1("Archive: Skipping corrupt block.\n");
+        reader->corrupt_blocks += 1;
+    }
+
+    return LW_RESULT_AGAIN;
+}
+
+void lw_grf250_archive_reader_seek(lw_grf250_archive_reader *reader, uint64_t time_ns) {
+    lw_capture_record_header header;
+    uint64_t next_offset = 0;
+    uint64_t offset = reader->header.header_size;
+
+    if (time_ns == 0) {
+        reader->offset = offset;
+        return;
+    }
+
+    // Walk the index chain back to the index that holds the time, then
+    // search its entries for the first block that ends at or after it.
+    uint64_t index_offset = reader->last_index_offset;
+
+    while (index_offset != 0 && lw_grf250_archive_read_record(reader, index_offset, &header, &next_offset) == LW_RESULT_SUCCESS) {
+        lw_grf250_archive_index_header index;
+
+        if (header.type != LW_GRF250_ARCHIVE_RECORD_INDEX || header.size < sizeof(index)) {
+            break;
+        }
+
+        memcpy(&index, reader->data + index_offset + sizeof(header), sizeof(index));
+
+        if (index.entry_count > (header.size - sizeof(index)) / sizeof(lw_grf250_archive_index_entry)) {
+            break;
+        }
+
+        const uint8_t *entries = reader->data + index_offset + sizeof(header) + sizeof(index);
+        lw_grf250_archive_index_entry entry = {0, 0};
+
+        if (index.entry_count != 0) {
+            memcpy(&entry, entries, sizeof(entry));
+        }
+
+        if (index.entry_count != 0 && entry.last_time_ns < time_ns) {
+            uint32_t low = 1;
+            uint32_t high = index.entry_count;
+
+            while (low < high) {
+                uint32_t middle = low + (high - low) / 2;
+                memcpy(&entry, entries + middle * sizeof(entry), sizeof(entry));
+
+                if (entry.last_time_ns < time_ns) {
+                    low = middle + 1;
+                } else {
+                    high = middle;
+                }
+            }
+
+            offset = next_offset;
+
+            if (low < index.entry_count) {
+                memcpy(&entry, entries + low * sizeof(entry), sizeof(entry));
+                offset = (entry.block_offset < index_offset) ? entry.block_offset : next_offset;
+            }
+
+            break;
+        }
+
+        // NOTE: Each index is written after the one it points at, so an offset
+        // that does not go back means the chain is damaged and the scan takes over.
+        if (index.previous_index_offset >= index_offset) {
+            break;
+        }
+
+        index_offset = index.previous_index_offset;
+    }
+
+    // Pass over blocks that end before the time by their record time, without
+    // reading the block headers.
+    while (lw_grf250_archive_read_record(reader, offset, &header, &next_offset) == LW_RESULT_SUCCESS) {
+        if (header.type == LW_GRF250_ARCHIVE_RECORD_BLOCK && header.time_ns >= time_ns) {
+            break;
+        }
+
+        offset = next_offset;
+    }
+
+    reader->offset = offset;
+}
@@ -0,0 +1,312 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Sample Archive
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_ARCHIVE_H
+#define LW_API_GRF250_ARCHIVE_H
+
+#include "lw_serial_api_capture.h"
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Sample archive format.
+//
+// An archive is an append-only recording of decoded samples for long term
+// logging, where a capture of the raw bytes would be too large. Samples are
+// grouped into blocks of up to block_samples, and every block stores each
+// field as its own column:
+//
+// - Timestamps: the first time is in the block header, the rest as the
+//   zigzag varint change in the sample period, which is 1-3 bytes for a
+//   steady stream.
+// - Distances and strengths: the zigzag varint delta from the previous
+//   sample, usually 1-2 bytes.
+// - Temperature and alarm status: runs of a zigzag varint value and a varint
+//   count, a few bytes per block.
+//
+// A column can be decoded, or skipped by its size, without touching the
+// others, so a scan only pays for the fields it reads. Every column carries
+// its own CRC and every block stands on its own, a reader skips blocks with a
+// column it reads that fails its CRC.
+//
+// After the file header the archive uses the capture record framing, see
+// lw_serial_api_capture.h. A block record is timed by its last sample, so a
+// scan can pass over blocks by their record headers alone. An index record
+// lists the blocks written since the previous index and points back at it,
+// and the end record of a finished archive also holds the sample count. An
+// archive that was cut short is readable up to the last complete block, so
+// flushing the writer periodically bounds what a power loss can take.
+// ----------------------------------------------------------------------------
+#define LW_GRF250_ARCHIVE_MAGIC 0x5241574Cu // "LWAR"
+#define LW_GRF250_ARCHIVE_VERSION 1
+
+#ifndef LW_GRF250_ARCHIVE_BLOCK_SAMPLES
+#define LW_GRF250_ARCHIVE_BLOCK_SAMPLES 256
+#endif
+
+#ifndef LW_GRF250_ARCHIVE_INDEX_INTERVAL
+#define LW_GRF250_ARCHIVE_INDEX_INTERVAL 64
+#endif
+
+// Distance archives hold a column for each LW_GRF250_DISTANCE_FIELD_... value,
+// multi data archives hold the 5 distances, then the 5 strengths, then the
+// temperature.
+#define LW_GRF250_ARCHIVE_DISTANCE_COLUMNS LW_GRF250_DISTANCE_FIELD_COUNT
+#define LW_GRF250_ARCHIVE_MULTI_COLUMNS 11
+#define LW_GRF250_ARCHIVE_MAX_COLUMNS 11
+
+// The largest block record: the timestamps take at most 10 bytes per sample
+// and the other columns at most 6. The 64 bytes cover the record and block
+// headers and the padding.
+#define LW_GRF250_ARCHIVE_MAX_BLOCK_SIZE (64 + (LW_GRF250_ARCHIVE_MAX_COLUMNS + 1) * 8 + LW_GRF250_ARCHIVE_BLOCK_SAMPLES * (10 + LW_GRF250_ARCHIVE_MAX_COLUMNS * 6))
+
+typedef enum {
+    LW_GRF250_ARCHIVE_DISTANCE = 1,
+    LW_GRF250_ARCHIVE_MULTI = 2,
+} lw_grf250_archive_kind;
+
+typedef enum {
+    LW_GRF250_ARCHIVE_RECORD_BLOCK = 1,
+    LW_GRF250_ARCHIVE_RECORD_INDEX = 2,
+    LW_GRF250_ARCHIVE_RECORD_END = 3,
+} lw_grf250_archive_record_type;
+
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t header_size;
+    uint16_t kind;
+    uint16_t column_count;
+    uint32_t block_samples;
+    uint32_t index_interval;
+    uint32_t reserved;
+    uint64_t start_time_ns;
+} lw_grf250_archive_file_header;
+
+// Followed by a column entry for the timestamps and for every value column,
+// then the columns themselves.
+typedef struct {
+    uint64_t first_time_ns;
+    uint64_t last_time_ns;
+    uint32_t sample_count;
+    uint16_t column_count;
+
+    // NOTE: Covers the column entries.
+    uint16_t crc;
+} lw_grf250_archive_block_header;
+
+typedef struct {
+    uint32_t size;
+    uint16_t crc;
+    uint16_t reserved;
+} lw_grf250_archive_column;
+
+// Followed by entry_count index entries.
+typedef struct {
+    // NOTE: 0 ends the chain, no record can start at the file header.
+    uint64_t previous_index_offset;
+    uint32_t entry_count;
+    uint32_t reserved;
+} lw_grf250_archive_index_header;
+
+typedef struct {
+    uint64_t block_offset;
+    uint64_t last_time_ns;
+} lw_grf250_archive_index_entry;
+
+typedef struct {
+    uint64_t last_index_offset;
+    uint64_t sample_count;
+} lw_grf250_archive_end;
+
+// ----------------------------------------------------------------------------
+// Archive writer.
+//
+// Samples are collected into the current block, which is encoded and written
+// with a single call to the write callback once it is full or the writer is
+// flushed, so a block is never split across writes. Once a write fails the
+// samples are dropped and every call returns the error, which is also kept
+// in records.result.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_capture_record_writer records;
+    lw_grf250_archive_kind kind;
+    uint32_t column_count;
+
+    uint64_t last_index_offset;
+    uint64_t last_time_ns;
+    uint64_t sample_count;
+
+    uint32_t index_count;
+    lw_grf250_archive_index_entry index[LW_GRF250_ARCHIVE_INDEX_INTERVAL];
+
+    // The samples of the current block.
+    uint32_t block_count;
+    uint64_t timestamps_ns[LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+    int32_t columns[LW_GRF250_ARCHIVE_MAX_COLUMNS][LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+
+    uint8_t encoded[LW_GRF250_ARCHIVE_MAX_BLOCK_SIZE];
+} lw_grf250_archive_writer;
+
+/*
+ * Initialize a writer and write the file header.
+ *
+ * @param writer The writer to initialize.
+ * @param kind The kind of samples the archive holds.
+ * @param write The write callback, lw_capture_file_write_callback for stdio files.
+ * @param user_data User data for the write callback.
+ * @param start_time_ns The time the archive started.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_INVALID_PARAMETER if the
+ *         kind is not valid, or LW_RESULT_ERROR if the write failed.
+ */
+lw_result lw_grf250_archive_writer_init(lw_grf250_archive_writer *writer, lw_grf250_archive_kind kind, lw_capture_callback_write write, void *user_data, uint64_t start_time_ns);
+
+/*
+ * Append a distance sample, timed by its timestamp_ns.
+ *
+ * @param writer A writer for a distance archive.
+ * @param distance_data The sample.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_INVALID_PARAMETER if the
+ *         archive holds multi data, or LW_RESULT_ERROR if this or an earlier
+ *         write failed.
+ */
+lw_result lw_grf250_archive_write_distance(lw_grf250_archive_writer *writer, const lw_grf250_distance_data *distance_data);
+
+/*
+ * Append a multi data sample, timed by its timestamp_ns.
+ *
+ * @param writer A writer for a multi data archive.
+ * @param multi_data The sample.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_INVALID_PARAMETER if the
+ *         archive holds distance data, or LW_RESULT_ERROR if this or an
+ *         earlier write failed.
+ */
+lw_result lw_grf250_archive_write_multi(lw_grf250_archive_writer *writer, const lw_grf250_multi_data *multi_data);
+
+/*
+ * Write the current block now, even if it is not full. Does nothing if the
+ * block is empty. Blocks written early compress a little worse.
+ *
+ * @param writer The writer.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if this or an
+ *         earlier write failed.
+ */
+lw_result lw_grf250_archive_writer_flush(lw_grf250_archive_writer *writer);
+
+/*
+ * Close the archive: write the current block, index the blocks written since
+ * the last index and write the end record. Anything written after this
+ * leaves the archive without an end record, so seeks fall back to a scan.
+ *
+ * @param writer The writer.
+ * @return LW_RESULT_SUCCESS if every write succeeded, or LW_RESULT_ERROR.
+ */
+lw_result lw_grf250_archive_writer_finish(lw_grf250_archive_writer *writer);
+
+// ----------------------------------------------------------------------------
+// Archive reader.
+//
+// The reader decodes one block per call straight out of an archive in memory,
+// such as a file opened with lw_platform_map_file, and only decodes the
+// columns that are asked for.
+// ----------------------------------------------------------------------------
+typedef struct {
+    const uint8_t *data;
+    uint64_t size;
+    lw_grf250_archive_file_header header;
+
+    uint64_t offset;
+
+    // NOTE: 0 for an archive that was not finished, seeks then scan from the start.
+    uint64_t last_index_offset;
+
+    // The number of blocks skipped because they failed the CRC check.
+    uint32_t corrupt_blocks;
+
+    // NOTE: Used internally to decode multi data.
+    uint64_t timestamps_ns[LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+    int32_t column[LW_GRF250_ARCHIVE_BLOCK_SAMPLES];
+} lw_grf250_archive_reader;
+
+/*
+ * Initialize a reader over an archive in memory.
+ *
+ * @param reader The reader to initialize.
+ * @param data The archive, must stay valid while the reader is used.
+ * @param size The size of the archive in bytes.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the
+ *         data is not an archive or has larger blocks than
+ *         LW_GRF250_ARCHIVE_BLOCK_SAMPLES.
+ */
+lw_result lw_grf250_archive_reader_init(lw_grf250_archive_reader *reader, const void *data, uint64_t size);
+
+/*
+ * Decode the next block of a distance archive and append it to a batch.
+ * Columns set to NULL in the batch are skipped without being decoded.
+ *
+ * @param reader The reader.
+ * @param batch The batch to append to. A batch with room for
+ *        LW_GRF250_ARCHIVE_BLOCK_SAMPLES samples takes any block.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_AGAIN at the end of the
+ *         archive, or LW_RESULT_INVALID_PARAMETER if the archive holds multi
+ *         data or the batch has no room for the block, which is then kept
+ *         for the next call.
+ */
+lw_result lw_grf250_archive_read_distance(lw_grf250_archive_reader *reader, lw_grf250_distance_batch *batch);
+
+/*
+ * Decode the next block of a multi data archive.
+ *
+ * @param reader The reader.
+ * @param samples The decoded samples are written here.
+ * @param capacity The number of samples that fit, at least
+ *        LW_GRF250_ARCHIVE_BLOCK_SAMPLES takes any block.
+ * @param count The number of decoded samples is written here.
+ * @return LW_RESULT_SUCCESS on success, LW_RESULT_AGAIN at the end of the
+ *         archive, or LW_RESULT_INVALID_PARAMETER if the archive holds
+ *         distance data or the block does not fit, which is then kept for the
+ *         next call.
+ */
+lw_result lw_grf250_archive_read_multi(lw_grf250_archive_reader *reader, lw_grf250_multi_data *samples, uint32_t capacity, uint32_t *count);
+
+/*
+ * Move the reader to the first block with samples at or after a time, found
+ * through the index chain without decoding any blocks.
+ *
+ * @param reader The reader.
+ * @param time_ns The time to seek to, 0 rewinds to the start.
+ */
+void lw_grf250_archive_reader_seek(lw_grf250_archive_reader *reader, uint64_t time_ns);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_ARCHIVE_H
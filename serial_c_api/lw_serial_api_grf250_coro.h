@@ -0,0 +1,534 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Coroutines
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_CORO_H
+#define LW_API_GRF250_CORO_H
+
+#if __cplusplus < 202002L
+#error "lw_serial_api_grf250_coro.h needs C++20, eg: add -std=c++20 to the compiler flags"
+#endif
+
+#include "lw_serial_api_grf250.h"
+
+#include <coroutine>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+/*
+ * C++20 coroutines over the asynchronous request pipeline.
+ *
+ * Commands and streamed samples are awaited from straight-line coroutine code,
+ * while one thread drives every sensor from a loop. Each awaited command is an
+ * lw_async_request held in the coroutine frame, so a suspended coroutine costs
+ * its frame and no stack. Coroutines are resumed from lw_device_poll when their
+ * response arrives, or from loop::poll when a sample arrives.
+ *
+ * Do not use the blocking managed commands on a device that is driven by a
+ * loop, as they consume the responses directly.
+ *
+ * Example:
+ *     lw_grf250_coro::task<lw_result> run(lw_grf250_coro::sensor &grf) {
+ *         auto rate = co_await grf.get_update_rate();
+ *         co_await grf.set_stream(LW_GRF250_STREAM_DISTANCE);
+ *
+ *         while (true) {
+ *             auto sample = co_await grf.next_distance(1000);
+ *
+ *             if (sample.result != LW_RESULT_SUCCESS) {
+ *                 co_return sample.result;
+ *             }
+ *         }
+ *     }
+ *
+ */
+namespace lw_grf250_coro {
+
+    // The result of an awaited command or sample, with the value only set on success.
+    template <typename T>
+    struct result {
+        lw_result result;
+        T value;
+    };
+
+    struct product_name {
+        char value[16];
+    };
+
+    // ----------------------------------------------------------------------------
+    // Tasks.
+    // ----------------------------------------------------------------------------
+    template <typename T>
+    class task;
+
+    namespace detail {
+        // NOTE: A finished task resumes the coroutine awaiting it, which keeps
+        // chains of awaited tasks from growing the stack.
+        struct final_awaiter {
+            bool await_ready() noexcept { return false; }
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() noexcept {}
+        };
+
+        struct promise_base {
+            std::coroutine_handle<> continuation;
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+            final_awaiter final_suspend() noexcept { return {}; }
+            void unhandled_exception() noexcept { std::terminate(); }
+        };
+
+        template <typename T>
+        struct promise : promise_base {
+            T value{};
+
+            task<T> get_return_object() noexcept;
+            void return_value(T return_value) noexcept { value = std::move(return_value); }
+        };
+
+        template <>
+        struct promise<void> : promise_base {
+            task<void> get_return_object() noexcept;
+            void return_void() noexcept {}
+        };
+    } // namespace detail
+
+    /*
+     * A lazily started coroutine. Another coroutine starts it by awaiting it,
+     * the application starts it with start() and drives it with loop::poll
+     * until done() is true. The frame is destroyed with the task.
+     *
+     * @tparam T The type returned with co_return.
+     */
+    template <typename T = void>
+    class task {
+    public:
+        using promise_type = detail::promise<T>;
+
+        explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+        task(task &&other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+        task(const task &) = delete;
+        task &operator=(const task &) = delete;
+
+        ~task() {
+            if (handle_) {
+                handle_.destroy();
+            }
+        }
+
+        // Run the coroutine up to its first suspension, only the first call has an effect.
+        void start() {
+            if (!started_) {
+                started_ = true;
+                handle_.resume();
+            }
+        }
+
+        bool done() const { return handle_.done(); }
+
+        // The value returned with co_return, only valid once done() is true.
+        std::add_lvalue_reference_t<T> get() requires(!std::is_void_v<T>) { return handle_.promise().value; }
+
+        bool await_ready() const noexcept { return false; }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept {
+            started_ = true;
+            handle_.promise().continuation = continuation;
+            return handle_;
+        }
+
+        decltype(auto) await_resume() {
+            if constexpr (!std::is_void_v<T>) {
+                return std::move(handle_.promise().value);
+            }
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+        bool started_ = false;
+    };
+
+    template <typename T>
+    inline task<T> detail::promise<T>::get_return_object() noexcept {
+        return task<T>(std::coroutine_handle<promise<T>>::from_promise(*this));
+    }
+
+    inline task<void> detail::promise<void>::get_return_object() noexcept {
+        return task<void>(std::coroutine_handle<promise<void>>::from_promise(*this));
+    }
+
+    // ----------------------------------------------------------------------------
+    // Commands.
+    // ----------------------------------------------------------------------------
+    /*
+     * Awaits one request and its response. The packet is created on
+     * construction and submitted when awaited, the response is parsed in the
+     * completion callback before the awaiting coroutine is resumed.
+     *
+     * A command that is destroyed while outstanding, such as with the task
+     * awaiting it, is cancelled.
+     *
+     * @tparam T The parsed value type.
+     */
+    template <typename T>
+    class command {
+    public:
+        using parser = lw_result (*)(lw_response *response, T *value);
+
+        command(lw_callback_device *device, lw_result (*create)(lw_request *request), parser parse) : device_(device), parse_(parse) {
+            lw_init_async_request(&async_request_, &complete, nullptr);
+            outcome_.result = create(&async_request_.request);
+        }
+
+        template <typename Argument>
+        command(lw_callback_device *device, lw_result (*create)(lw_request *request, Argument argument), Argument argument, parser parse) : device_(device), parse_(parse) {
+            lw_init_async_request(&async_request_, &complete, nullptr);
+            outcome_.result = create(&async_request_.request, argument);
+        }
+
+        command(const command &) = delete;
+        command &operator=(const command &) = delete;
+
+        ~command() {
+            if (async_request_.state != LW_ASYNC_REQUEST_IDLE) {
+                lw_device_cancel_request(device_, &async_request_);
+            }
+        }
+
+        // NOTE: A request that could not be created completes at once.
+        bool await_ready() const noexcept { return outcome_.result != LW_RESULT_SUCCESS; }
+
+        bool await_suspend(std::coroutine_handle<> handle) noexcept {
+            handle_ = handle;
+            async_request_.user_data = this;
+            outcome_.result = lw_device_submit_request(device_, &async_request_);
+            return outcome_.result == LW_RESULT_SUCCESS;
+        }
+
+        result<T> await_resume() noexcept { return outcome_; }
+
+    private:
+        static void complete(lw_callback_device *device, lw_async_request *async_request, lw_result request_result, lw_response *response) {
+            (void)device;
+
+            command *self = (command *)async_request->user_data;
+            self->outcome_.result = request_result == LW_RESULT_SUCCESS ? self->parse_(response, &self->outcome_.value) : request_result;
+            self->handle_.resume();
+        }
+
+        lw_callback_device *device_;
+        parser parse_;
+        lw_async_request async_request_;
+        std::coroutine_handle<> handle_;
+        result<T> outcome_{};
+    };
+
+    namespace detail {
+        inline lw_result parse_product_name(lw_response *response, product_name *name) {
+            return lw_grf250_parse_response_product_name(response, name->value);
+        }
+    } // namespace detail
+
+    // ----------------------------------------------------------------------------
+    // Sensors and the loop.
+    // ----------------------------------------------------------------------------
+    class loop;
+    class sensor;
+
+    /*
+     * Called by loop::poll to wait for data on any device, eg: with poll() or
+     * epoll on the serial ports. It can return early.
+     *
+     * @param user_data The user data given to the loop.
+     * @param timeout_ms The longest time to wait in milliseconds.
+     */
+    typedef void (*loop_wait_callback)(void *user_data, uint32_t timeout_ms);
+
+    /*
+     * Awaits the next streamed distance sample of a sensor.
+     */
+    class distance_awaiter {
+    public:
+        distance_awaiter(sensor *owner, uint32_t timeout_ms) : owner_(owner), timeout_ms_(timeout_ms) {}
+        distance_awaiter(const distance_awaiter &) = delete;
+        distance_awaiter &operator=(const distance_awaiter &) = delete;
+        ~distance_awaiter();
+
+        bool await_ready() noexcept;
+        void await_suspend(std::coroutine_handle<> handle) noexcept;
+        result<lw_grf250_distance_data> await_resume() noexcept { return outcome_; }
+
+    private:
+        friend class sensor;
+
+        sensor *owner_;
+        uint32_t timeout_ms_;
+        uint32_t start_ms_ = 0;
+        std::coroutine_handle<> handle_;
+        result<lw_grf250_distance_data> outcome_{};
+    };
+
+    /*
+     * A device driven by a loop. Streamed packets are held in a stream queue
+     * on the sensor until a coroutine awaits them.
+     *
+     * Only one coroutine at a time can await the samples of a sensor. Any
+     * number can await its commands, which are sent in order, one at a time
+     * per command ID.
+     */
+    class sensor {
+    public:
+        /*
+         * @param owner The loop that drives the device.
+         * @param device Connected device, not used with the blocking commands from now on.
+         * @param distance_config The distance configuration the device streams with.
+         */
+        sensor(loop &owner, lw_callback_device *device, lw_grf_distance_config distance_config);
+        sensor(const sensor &) = delete;
+        sensor &operator=(const sensor &) = delete;
+        ~sensor();
+
+        lw_callback_device *device() const { return device_; }
+
+        // Use a new distance configuration to decode samples, after setting it on the device.
+        void set_decoder_config(lw_grf_distance_config distance_config) { decoder_ = lw_grf250_create_distance_decoder(distance_config); }
+
+        uint32_t overruns() const { return stream_queue_.overruns; }
+
+        command<uint32_t> get_update_rate() { return command<uint32_t>(device_, &lw_grf250_create_request_read_update_rate, &lw_grf250_parse_response_update_rate); }
+        command<uint32_t> set_update_rate(uint32_t rate) { return command<uint32_t>(device_, &lw_grf250_create_request_write_update_rate, rate, &lw_grf250_parse_response_update_rate); }
+        command<lw_grf_distance_config> get_distance_config() { return command<lw_grf_distance_config>(device_, &lw_grf250_create_request_read_distance_config, &lw_grf250_parse_response_distance_config); }
+        command<lw_grf_distance_config> set_distance_config(lw_grf_distance_config distance_config) { return command<lw_grf_distance_config>(device_, &lw_grf250_create_request_write_distance_config, distance_config, &lw_grf250_parse_response_distance_config); }
+        command<lw_grf250_stream> get_stream() { return command<lw_grf250_stream>(device_, &lw_grf250_create_request_read_stream, &lw_grf250_parse_response_stream); }
+        command<lw_grf250_stream> set_stream(lw_grf250_stream stream) { return command<lw_grf250_stream>(device_, &lw_grf250_create_request_write_stream, stream, &lw_grf250_parse_response_stream); }
+        command<product_name> get_product_name() { return command<product_name>(device_, &lw_grf250_create_request_read_product_name, &detail::parse_product_name); }
+
+        /*
+         * Await the next streamed distance sample.
+         *
+         * @param timeout_ms The time to wait for the sample in milliseconds.
+         * @return An awaiter giving LW_RESULT_SUCCESS and the sample, LW_RESULT_TIMEOUT,
+         *         LW_RESULT_ERROR if the connection was lost, or LW_RESULT_INVALID_PARAMETER
+         *         if another coroutine is already waiting.
+         */
+        distance_awaiter next_distance(uint32_t timeout_ms) { return distance_awaiter(this, timeout_ms); }
+
+    private:
+        friend class loop;
+        friend class distance_awaiter;
+
+        // Take the next queued distance sample, other streamed packets are dropped.
+        bool pop_distance(lw_grf250_distance_data *distance_data) {
+            while (stream_queue_.head != stream_queue_.tail) {
+                lw_response *packet = &stream_queue_.packets[stream_queue_.tail & (LW_STREAM_QUEUE_SIZE - 1)];
+                stream_queue_.tail += 1;
+
+                if (packet->command_id == LW_GRF250_COMMAND_DISTANCE_DATA && lw_grf250_decode_distance_data(&decoder_, packet, distance_data) == LW_RESULT_SUCCESS) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // Poll the device, then resume the waiting coroutine if its sample arrived or timed out.
+        bool service() {
+            lw_result poll_result = lw_device_poll(device_, 0);
+            distance_awaiter *awaiter = waiter_;
+
+            if (awaiter == nullptr) {
+                return false;
+            }
+
+            if (poll_result != LW_RESULT_SUCCESS) {
+                awaiter->outcome_.result = poll_result;
+            } else if (pop_distance(&awaiter->outcome_.value)) {
+                awaiter->outcome_.result = LW_RESULT_SUCCESS;
+            } else if (device_->get_time_ms(device_) - awaiter->start_ms_ >= awaiter->timeout_ms_) {
+                awaiter->outcome_.result = LW_RESULT_TIMEOUT;
+            } else {
+                return false;
+            }
+
+            waiter_ = nullptr;
+            awaiter->handle_.resume();
+            return true;
+        }
+
+        loop &owner_;
+        lw_callback_device *device_;
+        lw_grf250_distance_decoder decoder_;
+        lw_stream_queue stream_queue_;
+        distance_awaiter *waiter_ = nullptr;
+        sensor *next_ = nullptr;
+    };
+
+    /*
+     * Drives the sensors and resumes their coroutines. All sensors, tasks and
+     * the loop belong to the thread that calls poll, and sensors must outlive
+     * the coroutines that use them.
+     */
+    class loop {
+    public:
+        /*
+         * @param wait Waits for data on the devices, or nullptr to sleep on the first device.
+         * @param user_data User data for the wait callback.
+         */
+        explicit loop(loop_wait_callback wait = nullptr, void *user_data = nullptr) : wait_(wait), user_data_(user_data) {}
+        loop(const loop &) = delete;
+        loop &operator=(const loop &) = delete;
+
+        /*
+         * Poll every sensor once, and wait for data if no coroutine was resumed.
+         *
+         * NOTE: The wait is limited to LW_RTO_MIN_MS while requests or samples
+         * are awaited, so timeouts are noticed while the ports are quiet.
+         *
+         * @param timeout_ms The longest time to wait in milliseconds, or 0 for non-blocking.
+         * @return true if any coroutine was resumed.
+         */
+        bool poll(uint32_t timeout_ms) {
+            if (service()) {
+                return true;
+            }
+
+            if (timeout_ms == 0 || sensors_ == nullptr) {
+                return false;
+            }
+
+            if (timeout_ms > LW_RTO_MIN_MS && awaiting()) {
+                timeout_ms = LW_RTO_MIN_MS;
+            }
+
+            if (wait_ != nullptr) {
+                wait_(user_data_, timeout_ms);
+            } else {
+                sensors_->device_->sleep(sensors_->device_, timeout_ms);
+            }
+
+            return service();
+        }
+
+        /*
+         * Start a task and poll until it is done.
+         *
+         * @param work The task to run.
+         */
+        template <typename T>
+        void run(task<T> &work) {
+            work.start();
+
+            while (!work.done()) {
+                poll(LW_RTO_MAX_MS);
+            }
+        }
+
+    private:
+        friend class sensor;
+
+        bool service() {
+            bool resumed = false;
+
+            // NOTE: Coroutines run inside this loop, so sensors must only be
+            // destroyed between polls.
+            for (sensor *current = sensors_, *next = nullptr; current != nullptr; current = next) {
+                next = current->next_;
+                resumed |= current->service();
+            }
+
+            return resumed;
+        }
+
+        bool awaiting() const {
+            for (const sensor *current = sensors_; current != nullptr; current = current->next_) {
+                if (current->waiter_ != nullptr || current->device_->async_requests != nullptr) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        loop_wait_callback wait_;
+        void *user_data_;
+        sensor *sensors_ = nullptr;
+    };
+
+    inline sensor::sensor(loop &owner, lw_callback_device *device, lw_grf_distance_config distance_config) : owner_(owner), device_(device) {
+        decoder_ = lw_grf250_create_distance_decoder(distance_config);
+        lw_device_enable_stream_queue(device_, &stream_queue_);
+
+        next_ = owner_.sensors_;
+        owner_.sensors_ = this;
+    }
+
+    inline sensor::~sensor() {
+        for (sensor **link = &owner_.sensors_; *link != nullptr; link = &(*link)->next_) {
+            if (*link == this) {
+                *link = next_;
+                break;
+            }
+        }
+
+        lw_device_enable_stream_queue(device_, nullptr);
+    }
+
+    inline distance_awaiter::~distance_awaiter() {
+        if (owner_->waiter_ == this) {
+            owner_->waiter_ = nullptr;
+        }
+    }
+
+    inline bool distance_awaiter::await_ready() noexcept {
+        if (owner_->waiter_ != nullptr) {
+            outcome_.result = LW_RESULT_INVALID_PARAMETER;
+            return true;
+        }
+
+        if (owner_->pop_distance(&outcome_.value)) {
+            outcome_.result = LW_RESULT_SUCCESS;
+            return true;
+        }
+
+        return false;
+    }
+
+    inline void distance_awaiter::await_suspend(std::coroutine_handle<> handle) noexcept {
+        handle_ = handle;
+        start_ms_ = owner_->device_->get_time_ms(owner_->device_);
+        owner_->waiter_ = this;
+    }
+
+} // namespace lw_grf250_coro
+
+#endif // LW_API_GRF250_CORO_H
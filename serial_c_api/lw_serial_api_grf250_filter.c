@@ -0,0 +1,357 @@
+#include "lw_serial_api_grf250_filter.h"
+
+// ----------------------------------------------------------------------------
+// Sliding median.
+//
+// The window is split between a max heap of the lower half and a min heap of
+// the upper half, each holding window slots ordered by value. The lower heap
+// holds the extra sample when the count is odd, so its top is the median.
+// Replacing the oldest sample moves it within its heap, and at most one
+// exchange of the two tops restores the split.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_filter_median_entry *entries;
+    uint32_t base;
+    uint32_t size;
+    uint8_t is_max;
+} lw_filter_heap;
+
+static int32_t lw_filter_heap_value(const lw_filter_heap *heap, uint32_t index) {
+    return heap->entries[heap->entries[heap->base + index].slot].value;
+}
+
+// Whether a value belongs nearer the top of the heap than another.
+static uint8_t lw_filter_heap_above(const lw_filter_heap *heap, int32_t a, int32_t b) {
+    return heap->is_max ? (a > b) : (a < b);
+}
+
+static void lw_filter_heap_swap(const lw_filter_heap *heap, uint32_t a, uint32_t b) {
+    lw_filter_median_entry *entries = heap->entries;
+    uint16_t slot_a = entries[heap->base + a].slot;
+    uint16_t slot_b = entries[heap->base + b].slot;
+
+    entries[heap->base + a].slot = slot_b;
+    entries[heap->base + b].slot = slot_a;
+    entries[slot_a].position = (uint16_t)(heap->base + b);
+    entries[slot_b].position = (uint16_t)(heap->base + a);
+}
+
+static void lw_filter_heap_sift_up(const lw_filter_heap *heap, uint32_t index) {
+    while (index > 0) {
+        uint32_t parent = (index - 1) / 2;
+
+        if (!lw_filter_heap_above(heap, lw_filter_heap_value(heap, index), lw_filter_heap_value(heap, parent))) {
+            break;
+        }
+
+        lw_filter_heap_swap(heap, index, parent);
+        index = parent;
+    }
+}
+
+static void lw_filter_heap_sift_down(const lw_filter_heap *heap, uint32_t index) {
+    while (1) {
+        uint32_t best = index;
+        uint32_t child = index * 2 + 1;
+
+        if (child < heap->size && lw_filter_heap_above(heap, lw_filter_heap_value(heap, child), lw_filter_heap_value(heap, best))) {
+            best = child;
+        }
+
+        if (child + 1 < heap->size && lw_filter_heap_above(heap, lw_filter_heap_value(heap, child + 1), lw_filter_heap_value(heap, best))) {
+            best = child + 1;
+        }
+
+        if (best == index) {
+            break;
+        }
+
+        lw_filter_heap_swap(heap, index, best);
+        index = best;
+    }
+}
+
+// Append a window slot to the bottom of a heap and sift it into place.
+static void lw_filter_heap_push(lw_filter_heap *heap, uint16_t slot) {
+    uint32_t position = heap->base + heap->size;
+
+    heap->entries[position].slot = slot;
+    heap->entries[slot].position = (uint16_t)position;
+    heap->size += 1;
+    lw_filter_heap_sift_up(heap, heap->size - 1);
+}
+
+static void lw_filter_median_heaps(lw_filter_stage *stage, lw_filter_heap *lower, lw_filter_heap *upper) {
+    uint32_t count = stage->state.median.count;
+
+    lower->entries = stage->state.median.entries;
+    lower->base = 0;
+    lower->size = (count + 1) / 2;
+    lower->is_max = 1;
+
+    upper->entries = stage->state.median.entries;
+    upper->base = (stage->state.median.window + 1) / 2;
+    upper->size = count / 2;
+    upper->is_max = 0;
+}
+
+static void lw_filter_median_insert(lw_filter_stage *stage, int32_t value) {
+    lw_filter_median_entry *entries = stage->state.median.entries;
+    uint16_t slot = (uint16_t)stage->state.median.count;
+    lw_filter_heap lower;
+    lw_filter_heap upper;
+
+    lw_filter_median_heaps(stage, &lower, &upper);
+    entries[slot].value = value;
+
+    if (lower.size == upper.size) {
+        // The lower heap grows, taking the top of the upper heap if the new
+        // sample belongs above it.
+        if (upper.size != 0 && value > lw_filter_heap_value(&upper, 0)) {
+            uint16_t top = entries[upper.base].slot;
+            entries[upper.base].slot = slot;
+            entries[slot].position = (uint16_t)upper.base;
+            lw_filter_heap_sift_down(&upper, 0);
+            slot = top;
+        }
+
+        lw_filter_heap_push(&lower, slot);
+    } else {
+        if (value < lw_filter_heap_value(&lower, 0)) {
+            uint16_t top = entries[lower.base].slot;
+            entries[lower.base].slot = slot;
+            entries[slot].position = (uint16_t)lower.base;
+            lw_filter_heap_sift_down(&lower, 0);
+            slot = top;
+        }
+
+        lw_filter_heap_push(&upper, slot);
+    }
+
+    stage->state.median.count += 1;
+}
+
+static void lw_filter_median_replace(lw_filter_stage *stage, int32_t value) {
+    lw_filter_median_entry *entries = stage->state.median.entries;
+    uint32_t slot = stage->state.median.oldest;
+    lw_filter_heap lower;
+    lw_filter_heap upper;
+
+    lw_filter_median_heaps(stage, &lower, &upper);
+    stage->state.median.oldest = (slot + 1 == stage->state.median.window) ? 0 : slot + 1;
+    entries[slot].value = value;
+
+    uint32_t position = entries[slot].position;
+    lw_filter_heap *heap = (position < upper.base) ? &lower : &upper;
+    lw_filter_heap_sift_up(heap, position - heap->base);
+    lw_filter_heap_sift_down(heap, entries[slot].position - heap->base);
+
+    if (upper.size != 0 && lw_filter_heap_value(&lower, 0) > lw_filter_heap_value(&upper, 0)) {
+        uint16_t lower_top = entries[lower.base].slot;
+        uint16_t upper_top = entries[upper.base].slot;
+
+        entries[lower.base].slot = upper_top;
+        entries[upper.base].slot = lower_top;
+        entries[upper_top].position = (uint16_t)lower.base;
+        entries[lower_top].position = (uint16_t)upper.base;
+
+        lw_filter_heap_sift_down(&lower, 0);
+        lw_filter_heap_sift_down(&upper, 0);
+    }
+}
+
+static int32_t lw_filter_median_update(lw_filter_stage *stage, int32_t value) {
+    if (stage->state.median.count < stage->state.median.window) {
+        lw_filter_median_insert(stage, value);
+    } else {
+        lw_filter_median_replace(stage, value);
+    }
+
+    lw_filter_heap lower;
+    lw_filter_heap upper;
+    lw_filter_median_heaps(stage, &lower, &upper);
+
+    int32_t median = lw_filter_heap_value(&lower, 0);
+
+    if (lower.size == upper.size) {
+        median = (int32_t)(((int64_t)median + lw_filter_heap_value(&upper, 0)) / 2);
+    }
+
+    return median;
+}
+
+// ----------------------------------------------------------------------------
+// Filter stages.
+// ----------------------------------------------------------------------------
+lw_result lw_filter_init_median(lw_filter_stage *stage, lw_filter_median_entry *entries, uint32_t window) {
+    if (window < 1 || window > LW_FILTER_MEDIAN_MAX_WINDOW) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    stage->type = LW_FILTER_MEDIAN;
+    stage->state.median.entries = entries;
+    stage->state.median.window = window;
+    stage->rejected = 0;
+    lw_filter_reset(stage);
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_filter_init_ema(lw_filter_stage *stage, uint32_t alpha_q16) {
+    if (alpha_q16 < 1 || alpha_q16 > 65536) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    stage->type = LW_FILTER_EMA;
+    stage->state.ema.alpha_q16 = alpha_q16;
+    stage->rejected = 0;
+    lw_filter_reset(stage);
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_filter_init_mean(lw_filter_stage *stage, int32_t *values, uint32_t window) {
+    if (window < 1) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    stage->type = LW_FILTER_MEAN;
+    stage->state.mean.values = values;
+    stage->state.mean.window = window;
+    stage->rejected = 0;
+    lw_filter_reset(stage);
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_filter_init_gate(lw_filter_stage *stage, int32_t threshold_mm, uint32_t max_rejects) {
+    stage->type = LW_FILTER_GATE;
+    stage->state.gate.threshold_mm = threshold_mm;
+    stage->state.gate.max_rejects = max_rejects;
+    stage->rejected = 0;
+    lw_filter_reset(stage);
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_filter_reset(lw_filter_stage *stage) {
+    switch (stage->type) {
+        case LW_FILTER_MEDIAN: {
+            stage->state.median.count = 0;
+            stage->state.median.oldest = 0;
+            break;
+        }
+
+        case LW_FILTER_EMA: {
+            stage->state.ema.value_q16 = 0;
+            stage->state.ema.primed = 0;
+            break;
+        }
+
+        case LW_FILTER_MEAN: {
+            stage->state.mean.count = 0;
+            stage->state.mean.oldest = 0;
+            stage->state.mean.sum = 0;
+            break;
+        }
+
+        case LW_FILTER_GATE: {
+            stage->state.gate.rejects = 0;
+            stage->state.gate.reference_mm = 0;
+            stage->state.gate.primed = 0;
+            break;
+        }
+    }
+}
+
+int32_t lw_filter_update(lw_filter_stage *stage, int32_t value_mm) {
+    switch (stage->type) {
+        case LW_FILTER_MEDIAN: {
+            return lw_filter_median_update(stage, value_mm);
+        }
+
+        case LW_FILTER_EMA: {
+            int64_t sample_q16 = (int64_t)value_mm * 65536;
+
+            if (!stage->state.ema.primed) {
+                stage->state.ema.value_q16 = sample_q16;
+                stage->state.ema.primed = 1;
+            } else {
+                // NOTE: The delta of two full range samples is 48 bits, so it is
+                // split into whole and fractional mm before the weight is applied
+                // to keep the product in 64 bits. The result is the same as the
+                // truncated (delta * alpha) / 65536.
+                int64_t delta_q16 = sample_q16 - stage->state.ema.value_q16;
+                int64_t alpha_q16 = stage->state.ema.alpha_q16;
+                stage->state.ema.value_q16 += (delta_q16 / 65536) * alpha_q16 + ((delta_q16 % 65536) * alpha_q16) / 65536;
+            }
+
+            int64_t value_q16 = stage->state.ema.value_q16;
+            return (int32_t)((value_q16 + (value_q16 >= 0 ? 32768 : -32768)) / 65536);
+        }
+
+        case LW_FILTER_MEAN: {
+            if (stage->state.mean.count < stage->state.mean.window) {
+                stage->state.mean.values[stage->state.mean.count] = value_mm;
+                stage->state.mean.count += 1;
+            } else {
+                uint32_t oldest = stage->state.mean.oldest;
+                stage->state.mean.sum -= stage->state.mean.values[oldest];
+                stage->state.mean.values[oldest] = value_mm;
+                stage->state.mean.oldest = (oldest + 1 == stage->state.mean.window) ? 0 : oldest + 1;
+            }
+
+            stage->state.mean.sum += value_mm;
+            return (int32_t)(stage->state.mean.sum / stage->state.mean.count);
+        }
+
+        case LW_FILTER_GATE: {
+            int64_t jump = (int64_t)value_mm - stage->state.gate.reference_mm;
+            uint8_t outlier = stage->state.gate.primed && (jump > stage->state.gate.threshold_mm || -jump > stage->state.gate.threshold_mm);
+
+            if (outlier && (stage->state.gate.max_rejects == 0 || stage->state.gate.rejects < stage->state.gate.max_rejects)) {
+                stage->state.gate.rejects += 1;
+                stage->rejected += 1;
+                return stage->state.gate.reference_mm;
+            }
+
+            stage->state.gate.reference_mm = value_mm;
+            stage->state.gate.rejects = 0;
+            stage->state.gate.primed = 1;
+            return value_mm;
+        }
+    }
+
+    return value_mm;
+}
+
+// ----------------------------------------------------------------------------
+// Filter views.
+// ----------------------------------------------------------------------------
+void lw_grf250_init_filter_view(lw_grf250_filter_view *view, lw_grf250_filter_source source, lw_filter_stage *stages, uint32_t stage_count) {
+    view->source = source;
+    view->stages = stages;
+    view->stage_count = stage_count;
+    view->distance_mm = 0;
+    view->timestamp_ns = 0;
+}
+
+void lw_grf250_filter_distance(lw_grf250_filter_view *views, uint32_t view_count, const lw_grf250_distance_data *distance_data) {
+    for (uint32_t i = 0; i < view_count; ++i) {
+        lw_grf250_filter_view *view = &views[i];
+        int32_t distance_mm = (view->source == LW_GRF250_FILTER_LAST_RETURN) ? distance_data->last_return_raw_mm : distance_data->first_return_raw_mm;
+
+        for (uint32_t stage = 0; stage < view->stage_count; ++stage) {
+            distance_mm = lw_filter_update(&view->stages[stage], distance_mm);
+        }
+
+        view->distance_mm = distance_mm;
+        view->timestamp_ns = distance_data->timestamp_ns;
+    }
+}
+
+lw_result lw_grf250_wait_for_filtered_distance(lw_callback_device *device, lw_grf_distance_config config, lw_grf250_filter_view *views, uint32_t view_count, lw_grf250_distance_data *distance_data, uint32_t timeout_ms) {
+    LW_CHECK_SUCCESS(lw_grf250_wait_for_streamed_distance(device, config, distance_data, timeout_ms))
+    lw_grf250_filter_distance(views, view_count, distance_data);
+    return LW_RESULT_SUCCESS;
+}
@@ -0,0 +1,231 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Distance Filters
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_FILTER_H
+#define LW_API_GRF250_FILTER_H
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Filter stages.
+//
+// Incremental filters over a stream of distances in millimetres, each with a
+// fixed cost per sample however large its window:
+//
+// Median: Sliding window median, O(log n) per sample.
+// EMA: Exponential moving average, O(1) per sample.
+// Mean: Rolling window mean, O(1) per sample.
+// Gate: Holds the last accepted distance while samples jump further than a
+//       threshold from it, and accepts the new distance if the jump persists.
+//
+// Stages that keep a window use caller provided storage. While a window is
+// filling, the median and mean cover the samples seen so far.
+// ----------------------------------------------------------------------------
+#define LW_FILTER_MEDIAN_MAX_WINDOW 65535
+
+// EMA weights are 16.16 fixed point, eg: LW_FILTER_EMA_ALPHA(0.25).
+#define LW_FILTER_EMA_ALPHA(alpha) ((uint32_t)((alpha) * 65536.0 + 0.5))
+
+typedef enum {
+    LW_FILTER_MEDIAN,
+    LW_FILTER_EMA,
+    LW_FILTER_MEAN,
+    LW_FILTER_GATE,
+} lw_filter_type;
+
+/*
+ * Median window storage, one entry per window slot. Entry i holds the value
+ * and heap position of window slot i, and the window slot at heap index i.
+ */
+typedef struct {
+    int32_t value;
+    uint16_t position;
+    uint16_t slot;
+} lw_filter_median_entry;
+
+typedef struct {
+    lw_filter_type type;
+
+    // NOTE: Used internally.
+    union {
+        struct {
+            lw_filter_median_entry *entries;
+            uint32_t window;
+            uint32_t count;
+            uint32_t oldest;
+        } median;
+
+        struct {
+            int64_t value_q16;
+            uint32_t alpha_q16;
+            uint8_t primed;
+        } ema;
+
+        struct {
+            int32_t *values;
+            uint32_t window;
+            uint32_t count;
+            uint32_t oldest;
+            int64_t sum;
+        } mean;
+
+        struct {
+            int32_t threshold_mm;
+            uint32_t max_rejects;
+            uint32_t rejects;
+            int32_t reference_mm;
+            uint8_t primed;
+        } gate;
+    } state;
+
+    // Samples rejected by a gate, never reset.
+    uint32_t rejected;
+} lw_filter_stage;
+
+/*
+ * Initialize a sliding median stage.
+ *
+ * @param stage The stage to initialize.
+ * @param entries Storage for the window.
+ * @param window The window size in samples, 1 to LW_FILTER_MEDIAN_MAX_WINDOW.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the window is out of range.
+ */
+lw_result lw_filter_init_median(lw_filter_stage *stage, lw_filter_median_entry *entries, uint32_t window);
+
+/*
+ * Initialize an exponential moving average stage. The first sample primes
+ * the average. Any int32_t distance is accepted with any weight, the average
+ * is kept in 64 bits and cannot overflow.
+ *
+ * @param stage The stage to initialize.
+ * @param alpha_q16 The weight of each new sample, 1 to 65536, see LW_FILTER_EMA_ALPHA.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if alpha is out of range.
+ */
+lw_result lw_filter_init_ema(lw_filter_stage *stage, uint32_t alpha_q16);
+
+/*
+ * Initialize a rolling mean stage.
+ *
+ * @param stage The stage to initialize.
+ * @param values Storage for the window.
+ * @param window The window size in samples, at least 1.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the window is 0.
+ */
+lw_result lw_filter_init_mean(lw_filter_stage *stage, int32_t *values, uint32_t window);
+
+/*
+ * Initialize an outlier gate. The first sample is always accepted.
+ *
+ * @param stage The stage to initialize.
+ * @param threshold_mm Samples further than this from the last accepted one are rejected.
+ * @param max_rejects After this many rejections in a row the next sample is
+ *        accepted, so a real step in distance is followed. 0 never accepts.
+ * @return LW_RESULT_SUCCESS.
+ */
+lw_result lw_filter_init_gate(lw_filter_stage *stage, int32_t threshold_mm, uint32_t max_rejects);
+
+/*
+ * Clear the samples held by a stage, keeping its settings.
+ *
+ * @param stage The stage.
+ */
+void lw_filter_reset(lw_filter_stage *stage);
+
+/*
+ * Add a sample to a stage.
+ *
+ * @param stage The stage.
+ * @param value_mm The sample.
+ * @return The filtered value.
+ */
+int32_t lw_filter_update(lw_filter_stage *stage, int32_t value_mm);
+
+// ----------------------------------------------------------------------------
+// Filter views.
+//
+// A view runs one return of the streamed distance data through a chain of
+// stages, so one raw stream can be filtered several ways at once, eg: a gated
+// median for control next to a lightly smoothed view for display. The device
+// filters should be turned off so the views see raw distances.
+// ----------------------------------------------------------------------------
+typedef enum {
+    LW_GRF250_FILTER_FIRST_RETURN,
+    LW_GRF250_FILTER_LAST_RETURN,
+} lw_grf250_filter_source;
+
+typedef struct {
+    lw_grf250_filter_source source;
+    lw_filter_stage *stages;
+    uint32_t stage_count;
+
+    // The output of the last stage for the latest sample.
+    int32_t distance_mm;
+    uint64_t timestamp_ns;
+} lw_grf250_filter_view;
+
+/*
+ * Initialize a filter view.
+ *
+ * @param view The view to initialize.
+ * @param source The return to filter, which must be in the distance config.
+ * @param stages The initialized stages, run in order.
+ * @param stage_count The number of stages.
+ */
+void lw_grf250_init_filter_view(lw_grf250_filter_view *view, lw_grf250_filter_source source, lw_filter_stage *stages, uint32_t stage_count);
+
+/*
+ * Run a distance sample through every view.
+ *
+ * @param views The views.
+ * @param view_count The number of views.
+ * @param distance_data The sample.
+ */
+void lw_grf250_filter_distance(lw_grf250_filter_view *views, uint32_t view_count, const lw_grf250_distance_data *distance_data);
+
+/*
+ * Wait for the next streamed distance data and run it through every view.
+ *
+ * @param device Connected device.
+ * @param config Distance configuration.
+ * @param views The views.
+ * @param view_count The number of views.
+ * @param distance_data The raw sample is written here.
+ * @param timeout_ms The timeout in milliseconds, or 0 for non-blocking.
+ * @return The result of lw_grf250_wait_for_streamed_distance, the views are
+ *         only updated on LW_RESULT_SUCCESS.
+ */
+lw_result lw_grf250_wait_for_filtered_distance(lw_callback_device *device, lw_grf_distance_config config, lw_grf250_filter_view *views, uint32_t view_count, lw_grf250_distance_data *distance_data, uint32_t timeout_ms);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_FILTER_H
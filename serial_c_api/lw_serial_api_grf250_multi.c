@@ -0,0 +1,218 @@
+#include "lw_serial_api_grf250_multi.h"
+#include <math.h>
+#include <string.h>
+
+#if LW_SIMD_MODE == LW_SIMD_MODE_SSE2
+#include <emmintrin.h>
+#elif LW_SIMD_MODE == LW_SIMD_MODE_AVX2
+#include <immintrin.h>
+#elif LW_SIMD_MODE == LW_SIMD_MODE_NEON
+#include <arm_neon.h>
+#endif
+
+// Raw multi data distances are in millimetres.
+#define LW_GRF250_MULTI_DISTANCE_SCALE 0.001f
+
+// ----------------------------------------------------------------------------
+// Kernels.
+//
+// Each SIMD kernel runs as many full vectors as fit and leaves the tail to
+// the scalar code, so every mode gives the same result for every count.
+// ----------------------------------------------------------------------------
+static void lw_grf250_scale_distances_scalar(const int32_t *raw_mm, float *distance_m, uint32_t start, uint32_t count) {
+    for (uint32_t i = start; i < count; ++i) {
+        // NOTE: The raw values can share memory with the output, so they are
+        // read through memcpy instead of as int32_t.
+        int32_t value;
+        memcpy(&value, raw_mm + i, sizeof(value));
+        distance_m[i] = (float)value * LW_GRF250_MULTI_DISTANCE_SCALE;
+    }
+}
+
+static uint32_t lw_grf250_mask_distances_scalar(float *distance_m, const int32_t *strength, int32_t min_strength, uint32_t start, uint32_t count) {
+    uint32_t masked = 0;
+
+    for (uint32_t i = start; i < count; ++i) {
+        if (strength[i] < min_strength) {
+            distance_m[i] = NAN;
+            masked += 1;
+        }
+    }
+
+    return masked;
+}
+
+#if LW_SIMD_MODE == LW_SIMD_MODE_SSE2
+void lw_grf250_scale_distances(const int32_t *raw_mm, float *distance_m, uint32_t count) {
+    const __m128 scale = _mm_set1_ps(LW_GRF250_MULTI_DISTANCE_SCALE);
+    uint32_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        __m128i raw = _mm_loadu_si128((const __m128i *)(raw_mm + i));
+        _mm_storeu_ps(distance_m + i, _mm_mul_ps(_mm_cvtepi32_ps(raw), scale));
+    }
+
+    lw_grf250_scale_distances_scalar(raw_mm, distance_m, i, count);
+}
+
+static uint32_t lw_grf250_mask_distances(float *distance_m, const int32_t *strength, int32_t min_strength, uint32_t count) {
+    const __m128i threshold = _mm_set1_epi32(min_strength);
+    const __m128 nan = _mm_set1_ps(NAN);
+    __m128i masked = _mm_setzero_si128();
+    uint32_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        // NOTE: Each weak lane is all ones, which is -1 when counted.
+        __m128i weak = _mm_cmplt_epi32(_mm_loadu_si128((const __m128i *)(strength + i)), threshold);
+        __m128 weak_mask = _mm_castsi128_ps(weak);
+        __m128 distance = _mm_loadu_ps(distance_m + i);
+        _mm_storeu_ps(distance_m + i, _mm_or_ps(_mm_and_ps(weak_mask, nan), _mm_andnot_ps(weak_mask, distance)));
+        masked = _mm_sub_epi32(masked, weak);
+    }
+
+    int32_t lanes[4];
+    _mm_storeu_si128((__m128i *)lanes, masked);
+    uint32_t total = (uint32_t)(lanes[0] + lanes[1] + lanes[2] + lanes[3]);
+
+    return total + lw_grf250_mask_distances_scalar(distance_m, strength, min_strength, i, count);
+}
+#elif LW_SIMD_MODE == LW_SIMD_MODE_AVX2
+void lw_grf250_scale_distances(const int32_t *raw_mm, float *distance_m, uint32_t count) {
+    const __m256 scale = _mm256_set1_ps(LW_GRF250_MULTI_DISTANCE_SCALE);
+    uint32_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        __m256i raw = _mm256_loadu_si256((const __m256i *)(raw_mm + i));
+        _mm256_storeu_ps(distance_m + i, _mm256_mul_ps(_mm256_cvtepi32_ps(raw), scale));
+    }
+
+    lw_grf250_scale_distances_scalar(raw_mm, distance_m, i, count);
+}
+
+static uint32_t lw_grf250_mask_distances(float *distance_m, const int32_t *strength, int32_t min_strength, uint32_t count) {
+    const __m256i threshold = _mm256_set1_epi32(min_strength);
+    const __m256 nan = _mm256_set1_ps(NAN);
+    __m256i masked = _mm256_setzero_si256();
+    uint32_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        // NOTE: Each weak lane is all ones, which is -1 when counted.
+        __m256i weak = _mm256_cmpgt_epi32(threshold, _mm256_loadu_si256((const __m256i *)(strength + i)));
+        __m256 distance = _mm256_loadu_ps(distance_m + i);
+        _mm256_storeu_ps(distance_m + i, _mm256_blendv_ps(distance, nan, _mm256_castsi256_ps(weak)));
+        masked = _mm256_sub_epi32(masked, weak);
+    }
+
+    int32_t lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, masked);
+    uint32_t total = 0;
+
+    for (uint32_t lane = 0; lane < 8; ++lane) {
+        total += (uint32_t)lanes[lane];
+    }
+
+    return total + lw_grf250_mask_distances_scalar(distance_m, strength, min_strength, i, count);
+}
+#elif LW_SIMD_MODE == LW_SIMD_MODE_NEON
+void lw_grf250_scale_distances(const int32_t *raw_mm, float *distance_m, uint32_t count) {
+    const float32x4_t scale = vdupq_n_f32(LW_GRF250_MULTI_DISTANCE_SCALE);
+    uint32_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        int32x4_t raw = vld1q_s32(raw_mm + i);
+        vst1q_f32(distance_m + i, vmulq_f32(vcvtq_f32_s32(raw), scale));
+    }
+
+    lw_grf250_scale_distances_scalar(raw_mm, distance_m, i, count);
+}
+
+static uint32_t lw_grf250_mask_distances(float *distance_m, const int32_t *strength, int32_t min_strength, uint32_t count) {
+    const int32x4_t threshold = vdupq_n_s32(min_strength);
+    const float32x4_t nan = vdupq_n_f32(NAN);
+    uint32x4_t masked = vdupq_n_u32(0);
+    uint32_t i = 0;
+
+    for (; i + 4 <= count; i += 4) {
+        uint32x4_t weak = vcltq_s32(vld1q_s32(strength + i), threshold);
+        vst1q_f32(distance_m + i, vbslq_f32(weak, nan, vld1q_f32(distance_m + i)));
+        masked = vsubq_u32(masked, weak);
+    }
+
+    uint32_t lanes[4];
+    vst1q_u32(lanes, masked);
+    uint32_t total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+    return total + lw_grf250_mask_distances_scalar(distance_m, strength, min_strength, i, count);
+}
+#else
+void lw_grf250_scale_distances(const int32_t *raw_mm, float *distance_m, uint32_t count) {
+    lw_grf250_scale_distances_scalar(raw_mm, distance_m, 0, count);
+}
+
+static uint32_t lw_grf250_mask_distances(float *distance_m, const int32_t *strength, int32_t min_strength, uint32_t count) {
+    return lw_grf250_mask_distances_scalar(distance_m, strength, min_strength, 0, count);
+}
+#endif
+
+// ----------------------------------------------------------------------------
+// Multi data batches.
+// ----------------------------------------------------------------------------
+lw_result lw_grf250_decode_multi_data_batch(lw_grf250_multi_batch *batch, const lw_response *responses, uint32_t response_count, uint32_t *consumed) {
+    uint32_t first_sample = batch->count;
+    lw_result result = LW_RESULT_SUCCESS;
+    uint32_t i = 0;
+
+    for (; i < response_count; ++i) {
+        const lw_response *response = &responses[i];
+
+        if (response->command_id != LW_GRF250_COMMAND_MULTI_DATA) {
+            continue;
+        }
+
+        if (batch->count >= batch->capacity) {
+            result = LW_RESULT_AGAIN;
+            break;
+        }
+
+        // NOTE: Signals are (distance, strength) int32 pairs followed by the temperature.
+        const uint8_t *fields = response->data + 4;
+        uint32_t sample = batch->count * LW_GRF250_MULTI_SIGNAL_COUNT;
+
+        for (uint32_t signal = 0; signal < LW_GRF250_MULTI_SIGNAL_COUNT; ++signal) {
+            // The raw distance is held in the output until the batch is scaled.
+            memcpy(batch->distance_m + sample + signal, fields + signal * 8, sizeof(int32_t));
+
+            if (batch->strength != NULL) {
+                memcpy(batch->strength + sample + signal, fields + signal * 8 + 4, sizeof(int32_t));
+            }
+        }
+
+        if (batch->temperature != NULL) {
+            memcpy(batch->temperature + batch->count, fields + LW_GRF250_MULTI_SIGNAL_COUNT * 8, sizeof(int32_t));
+        }
+
+        if (batch->timestamps_ns != NULL) {
+            batch->timestamps_ns[batch->count] = response->start_time_ns;
+        }
+
+        batch->count += 1;
+    }
+
+    uint32_t first = first_sample * LW_GRF250_MULTI_SIGNAL_COUNT;
+    uint32_t count = (batch->count - first_sample) * LW_GRF250_MULTI_SIGNAL_COUNT;
+    lw_grf250_scale_distances((const int32_t *)(void *)(batch->distance_m + first), batch->distance_m + first, count);
+
+    *consumed = i;
+    return result;
+}
+
+lw_result lw_grf250_mask_multi_data_batch(lw_grf250_multi_batch *batch, int32_t min_strength, uint32_t *kept) {
+    if (batch->strength == NULL) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    uint32_t count = batch->count * LW_GRF250_MULTI_SIGNAL_COUNT;
+    *kept = count - lw_grf250_mask_distances(batch->distance_m, batch->strength, min_strength, count);
+
+    return LW_RESULT_SUCCESS;
+}
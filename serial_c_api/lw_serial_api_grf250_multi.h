@@ -0,0 +1,131 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Multi Data Batches
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_MULTI_H
+#define LW_API_GRF250_MULTI_H
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// SIMD selection.
+//
+// LW_SIMD_MODE selects the kernels that scale and mask batches:
+//
+// LW_SIMD_MODE_SCALAR: Plain C, for any target.
+// LW_SIMD_MODE_SSE2: 4 values per step, any x86-64 target.
+// LW_SIMD_MODE_AVX2: 8 values per step, needs -mavx2 or /arch:AVX2.
+// LW_SIMD_MODE_NEON: 4 values per step, ARMv7 with NEON or AArch64.
+//
+// All modes produce identical output. By default the widest mode the
+// compiler targets is used, define LW_SIMD_MODE as a compiler flag to
+// override it, eg: -DLW_SIMD_MODE=0.
+// ----------------------------------------------------------------------------
+#define LW_SIMD_MODE_SCALAR 0
+#define LW_SIMD_MODE_SSE2 1
+#define LW_SIMD_MODE_AVX2 2
+#define LW_SIMD_MODE_NEON 3
+
+#ifndef LW_SIMD_MODE
+#if defined(__AVX2__)
+#define LW_SIMD_MODE LW_SIMD_MODE_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LW_SIMD_MODE LW_SIMD_MODE_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define LW_SIMD_MODE LW_SIMD_MODE_NEON
+#else
+#define LW_SIMD_MODE LW_SIMD_MODE_SCALAR
+#endif
+#endif
+
+// ----------------------------------------------------------------------------
+// Multi data batches.
+//
+// Decodes many multi data responses at once into struct-of-arrays outputs
+// ready for building point clouds. Each sample holds the five signals of
+// one response, stored signal by signal so sample i, signal s is at index
+// i * LW_GRF250_MULTI_SIGNAL_COUNT + s of the per-signal arrays.
+//
+// The raw distances are copied out while the responses are walked, then
+// converted to metres for the whole batch in one SIMD pass. Weak returns can
+// be masked afterwards, which sets their distance to NaN in the same way.
+// ----------------------------------------------------------------------------
+#define LW_GRF250_MULTI_SIGNAL_COUNT 5
+
+typedef struct {
+    // capacity * LW_GRF250_MULTI_SIGNAL_COUNT values each, set strength to
+    // NULL to skip it.
+    float *distance_m;
+    int32_t *strength;
+
+    // capacity values each, set to NULL to skip.
+    int32_t *temperature;
+    uint64_t *timestamps_ns;
+
+    uint32_t capacity;
+    uint32_t count;
+} lw_grf250_multi_batch;
+
+/*
+ * Decode multi data responses and append them to a batch. Responses for
+ * other commands are skipped.
+ *
+ * @param batch The batch to append to.
+ * @param responses The completed responses.
+ * @param response_count The number of responses.
+ * @param consumed The number of responses used, decoded or skipped, is written here.
+ * @return LW_RESULT_SUCCESS if all responses were used, or LW_RESULT_AGAIN if the batch is full.
+ */
+lw_result lw_grf250_decode_multi_data_batch(lw_grf250_multi_batch *batch, const lw_response *responses, uint32_t response_count, uint32_t *consumed);
+
+/*
+ * Set the distance of every signal in a batch weaker than a threshold to NaN.
+ *
+ * @param batch The batch, which must have strengths.
+ * @param min_strength Signals with a lower strength are masked.
+ * @param kept The number of signals that were not masked is written here.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the batch has no strengths.
+ */
+lw_result lw_grf250_mask_multi_data_batch(lw_grf250_multi_batch *batch, int32_t min_strength, uint32_t *kept);
+
+/*
+ * Convert raw distances in millimetres to metres.
+ *
+ * @param raw_mm The raw distances.
+ * @param distance_m The distances are written here, can be the same memory as raw_mm.
+ * @param count The number of distances.
+ */
+void lw_grf250_scale_distances(const int32_t *raw_mm, float *distance_m, uint32_t count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_MULTI_H
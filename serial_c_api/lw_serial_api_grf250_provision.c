@@ -0,0 +1,346 @@
+#include "lw_serial_api_grf250_provision.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Provisioning.
+// ----------------------------------------------------------------------------
+void lw_grf250_init_provision_profile(lw_grf250_provision_profile *profile) {
+    memset(profile, 0, sizeof(lw_grf250_provision_profile));
+    profile->save = 1;
+}
+
+static void lw_grf250_provision_finish(lw_grf250_provision_job *job, lw_grf250_provision_step step, lw_result step_result) {
+    job->report->step = step;
+    job->report->result = step_result;
+    job->report->elapsed_ms = job->device->get_time_ms(job->device) - job->start_ms;
+    job->done = 1;
+}
+
+static void lw_grf250_provision_fail(lw_grf250_provision_job *job, lw_grf250_provision_step step, lw_result step_result) {
+    // Only the first failure of a step is reported.
+    if (job->failed_result == LW_RESULT_SUCCESS) {
+        job->failed_step = step;
+        job->failed_result = step_result;
+    }
+}
+
+static void lw_grf250_provision_submit(lw_grf250_provision_job *job, lw_async_request *async_request) {
+    lw_result submit_result = lw_device_submit_request(job->device, async_request);
+
+    if (submit_result != LW_RESULT_SUCCESS) {
+        lw_grf250_provision_fail(job, job->report->step, submit_result);
+        return;
+    }
+
+    job->outstanding += 1;
+}
+
+static void lw_grf250_provision_callback(lw_callback_device *device, lw_async_request *async_request, lw_result result, lw_response *response);
+
+static void lw_grf250_provision_advance(lw_grf250_provision_job *job);
+
+// Submit a read for every field in fields, the requests are sent back to back.
+static void lw_grf250_provision_submit_reads(lw_grf250_provision_job *job, uint32_t fields) {
+    for (uint32_t i = 0; i < LW_GRF250_CONFIG_FIELD_COUNT; ++i) {
+        if (fields & (1u << i)) {
+            lw_async_request *async_request = &job->requests[1 + i];
+            lw_init_async_request(async_request, &lw_grf250_provision_callback, job);
+            lw_create_request_read(&async_request->request, lw_grf250_get_config_command(i));
+            lw_grf250_provision_submit(job, async_request);
+        }
+    }
+}
+
+static void lw_grf250_provision_begin_verify(lw_grf250_provision_job *job) {
+    // NOTE: Fields that did not change are verified too, against the values
+    // read before writing, so the report covers the whole profile.
+    job->report->step = LW_GRF250_PROVISION_VERIFY;
+    lw_grf250_provision_submit_reads(job, job->profile->fields);
+}
+
+static void lw_grf250_provision_begin_save(lw_grf250_provision_job *job) {
+    lw_async_request *async_request = &job->requests[0];
+
+    job->report->step = LW_GRF250_PROVISION_SAVE;
+    lw_init_async_request(async_request, &lw_grf250_provision_callback, job);
+    lw_grf250_create_request_read_token(&async_request->request);
+    lw_grf250_provision_submit(job, async_request);
+}
+
+static void lw_grf250_provision_begin_write(lw_grf250_provision_job *job) {
+    job->report->step = LW_GRF250_PROVISION_WRITE;
+
+    // All the packets are created first, so a field that can not be written
+    // fails the step before anything is sent.
+    for (uint32_t i = 0; i < LW_GRF250_CONFIG_FIELD_COUNT; ++i) {
+        if (job->report->changed & (1u << i)) {
+            lw_async_request *async_request = &job->requests[1 + i];
+            lw_init_async_request(async_request, &lw_grf250_provision_callback, job);
+            lw_result create_result = lw_grf250_create_request_write_config(&async_request->request, &job->work, lw_grf250_get_config_command(i));
+
+            if (create_result != LW_RESULT_SUCCESS) {
+                lw_grf250_provision_fail(job, LW_GRF250_PROVISION_WRITE, create_result);
+                return;
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < LW_GRF250_CONFIG_FIELD_COUNT; ++i) {
+        if (job->report->changed & (1u << i)) {
+            lw_grf250_provision_submit(job, &job->requests[1 + i]);
+        }
+    }
+}
+
+// Called once every request of the current step has completed.
+static void lw_grf250_provision_advance(lw_grf250_provision_job *job) {
+    while (!job->done && job->outstanding == 0) {
+        lw_grf250_provision_report *report = job->report;
+
+        if (job->failed_result != LW_RESULT_SUCCESS) {
+            lw_grf250_provision_finish(job, job->failed_step, job->failed_result);
+            return;
+        }
+
+        switch (report->step) {
+            case LW_GRF250_PROVISION_CONNECT:
+            case LW_GRF250_PROVISION_READ: {
+                // Only the profile fields are taken, the rest keep the current values.
+                report->changed = lw_grf250_config_diff(&job->profile->config, &job->current) & job->profile->fields;
+                job->work = job->profile->config;
+
+                if (report->changed) {
+                    lw_grf250_provision_begin_write(job);
+                } else {
+                    lw_grf250_provision_begin_verify(job);
+                }
+
+                break;
+            }
+
+            case LW_GRF250_PROVISION_WRITE: {
+                if (job->profile->save) {
+                    lw_grf250_provision_begin_save(job);
+                } else {
+                    lw_grf250_provision_begin_verify(job);
+                }
+
+                break;
+            }
+
+            case LW_GRF250_PROVISION_SAVE: {
+                report->saved = 1;
+                lw_grf250_provision_begin_verify(job);
+                break;
+            }
+
+            case LW_GRF250_PROVISION_VERIFY: {
+                report->mismatched = lw_grf250_config_diff(&job->current, &job->work) & job->profile->fields;
+                lw_grf250_provision_finish(job, report->mismatched ? LW_GRF250_PROVISION_VERIFY : LW_GRF250_PROVISION_DONE, report->mismatched ? LW_RESULT_ERROR : LW_RESULT_SUCCESS);
+                break;
+            }
+
+            case LW_GRF250_PROVISION_DONE: {
+                return;
+            }
+        }
+    }
+}
+
+static void lw_grf250_provision_callback(lw_callback_device *device, lw_async_request *async_request, lw_result result, lw_response *response) {
+    (void)device;
+    lw_grf250_provision_job *job = (lw_grf250_provision_job *)async_request->user_data;
+    lw_grf250_provision_report *report = job->report;
+    lw_grf250_provision_step step = report->step;
+
+    job->outstanding -= 1;
+    job->completions += 1;
+
+    if (result == LW_RESULT_SUCCESS) {
+        switch (step) {
+            case LW_GRF250_PROVISION_READ: {
+                if (async_request == &job->requests[0]) {
+                    result = lw_grf250_parse_response_serial_number(response, report->serial_number);
+                } else {
+                    result = lw_grf250_parse_response_config(response, &job->current);
+                }
+
+                break;
+            }
+
+            case LW_GRF250_PROVISION_WRITE: {
+                // NOTE: Write responses echo the new value, which is parsed back into the work config.
+                result = lw_grf250_parse_response_config(response, &job->work);
+                break;
+            }
+
+            case LW_GRF250_PROVISION_SAVE: {
+                if (async_request->request.command_id == LW_GRF250_COMMAND_TOKEN) {
+                    uint16_t token = 0;
+                    result = lw_grf250_parse_response_token(response, &token);
+
+                    if (result == LW_RESULT_SUCCESS) {
+                        lw_grf250_create_request_write_save_parameters(&async_request->request, token);
+                        lw_grf250_provision_submit(job, async_request);
+                    }
+                }
+
+                break;
+            }
+
+            case LW_GRF250_PROVISION_VERIFY: {
+                result = lw_grf250_parse_response_config(response, &job->current);
+                break;
+            }
+
+            case LW_GRF250_PROVISION_CONNECT:
+            case LW_GRF250_PROVISION_DONE: {
+                break;
+            }
+        }
+    }
+
+    if (result != LW_RESULT_SUCCESS) {
+        // The serial number is read with the configuration, but failing it
+        // means the device never answered.
+        if (step == LW_GRF250_PROVISION_READ && async_request == &job->requests[0]) {
+            step = LW_GRF250_PROVISION_CONNECT;
+        }
+
+        lw_grf250_provision_fail(job, step, result);
+    }
+
+    lw_grf250_provision_advance(job);
+}
+
+void lw_grf250_start_provision(lw_grf250_provision_job *job, lw_callback_device *device, const lw_grf250_provision_profile *profile, lw_grf250_provision_report *report) {
+    memset(job, 0, sizeof(lw_grf250_provision_job));
+    job->device = device;
+    job->profile = profile;
+    job->report = report;
+    job->start_ms = device->get_time_ms(device);
+    job->failed_result = LW_RESULT_SUCCESS;
+
+    memset(report, 0, sizeof(lw_grf250_provision_report));
+    report->step = LW_GRF250_PROVISION_CONNECT;
+
+    if (profile->fields & ~LW_GRF250_CONFIG_ALL) {
+        lw_grf250_provision_finish(job, LW_GRF250_PROVISION_CONNECT, LW_RESULT_INVALID_PARAMETER);
+        return;
+    }
+
+    // NOTE: A new baud rate only applies after a restart, after which the
+    // verify step could no longer talk to the device.
+    if (profile->fields & LW_GRF250_CONFIG_BAUD_RATE) {
+        lw_grf250_provision_finish(job, LW_GRF250_PROVISION_CONNECT, LW_RESULT_INVALID_PARAMETER);
+        return;
+    }
+
+    lw_result connect_result = lw_grf250_initiate_serial(device);
+
+    if (connect_result != LW_RESULT_SUCCESS) {
+        lw_grf250_provision_finish(job, LW_GRF250_PROVISION_CONNECT, connect_result);
+        return;
+    }
+
+    // The serial number and the full configuration are read in one round trip.
+    report->step = LW_GRF250_PROVISION_READ;
+    lw_init_async_request(&job->requests[0], &lw_grf250_provision_callback, job);
+    lw_grf250_create_request_read_serial_number(&job->requests[0].request);
+    lw_grf250_provision_submit(job, &job->requests[0]);
+    lw_grf250_provision_submit_reads(job, LW_GRF250_CONFIG_ALL);
+    lw_grf250_provision_advance(job);
+}
+
+void lw_grf250_poll_provision(lw_grf250_provision_job *job, uint32_t timeout_ms) {
+    // NOTE: A lost connection fails the outstanding requests, which finishes the job.
+    lw_device_poll(job->device, timeout_ms);
+}
+
+lw_result lw_grf250_provision(lw_callback_device *device, const lw_grf250_provision_profile *profile, lw_grf250_provision_report *report) {
+    lw_grf250_provision_job job;
+    lw_grf250_start_provision(&job, device, profile, report);
+
+    while (!job.done) {
+        lw_grf250_poll_provision(&job, 1000);
+    }
+
+    return report->result;
+}
+
+lw_result lw_grf250_provision_fleet(lw_callback_device **devices, uint32_t device_count, const lw_grf250_provision_profile *profile, lw_grf250_provision_job *jobs, lw_grf250_provision_report *reports) {
+    for (uint32_t i = 0; i < device_count; ++i) {
+        lw_grf250_start_provision(&jobs[i], devices[i], profile, &reports[i]);
+    }
+
+    uint32_t next = 0;
+
+    while (1) {
+        uint32_t active = 0;
+        uint32_t completions = 0;
+
+        for (uint32_t i = 0; i < device_count; ++i) {
+            if (!jobs[i].done) {
+                uint32_t before = jobs[i].completions;
+                lw_grf250_poll_provision(&jobs[i], 0);
+                completions += jobs[i].completions - before;
+                active += jobs[i].done ? 0 : 1;
+            }
+        }
+
+        if (active == 0) {
+            break;
+        }
+
+        // NOTE: When no device made progress, wait briefly on one of them
+        // rather than spinning, taking turns so every device gets to wait.
+        if (completions == 0) {
+            while (jobs[next].done) {
+                next = (next + 1) % device_count;
+            }
+
+            lw_grf250_poll_provision(&jobs[next], 1);
+            next = (next + 1) % device_count;
+        }
+    }
+
+    lw_result fleet_result = LW_RESULT_SUCCESS;
+
+    for (uint32_t i = 0; i < device_count; ++i) {
+        if (reports[i].result != LW_RESULT_SUCCESS) {
+            fleet_result = LW_RESULT_ERROR;
+        }
+    }
+
+    return fleet_result;
+}
+
+const char *lw_grf250_provision_step_name(lw_grf250_provision_step step) {
+    switch (step) {
+        case LW_GRF250_PROVISION_CONNECT: {
+            return "connect";
+        }
+
+        case LW_GRF250_PROVISION_READ: {
+            return "read";
+        }
+
+        case LW_GRF250_PROVISION_WRITE: {
+            return "write";
+        }
+
+        case LW_GRF250_PROVISION_SAVE: {
+            return "save";
+        }
+
+        case LW_GRF250_PROVISION_VERIFY: {
+            return "verify";
+        }
+
+        case LW_GRF250_PROVISION_DONE: {
+            return "done";
+        }
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,195 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Provisioning
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_PROVISION_H
+#define LW_API_GRF250_PROVISION_H
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Provisioning.
+//
+// Brings a device to a configuration profile in a fixed number of round
+// trips, however many fields the profile sets:
+//
+// 1. Read the serial number and the full configuration.
+// 2. Write only the profile fields that differ.
+// 3. Save the parameters if anything was written and the profile asks for it.
+// 4. Read the profile fields back and check them.
+//
+// Each step submits all of its requests to the asynchronous request pipeline
+// at once, so they are sent back to back and share a single round trip.
+//
+// A provisioning job runs from the completion callbacks of its requests, so
+// lw_grf250_provision_fleet provisions many devices from one thread by
+// polling every device in turn, see example_provision.c. The time then scales
+// with the slowest device rather than with commands times devices.
+//
+// The baud rate can not be part of a profile, as it only applies after a
+// restart. Use lw_grf250_negotiate_baud_rate or lw_grf250_switch_baud_rate.
+// ----------------------------------------------------------------------------
+
+// The most requests a job has outstanding, the serial number and every
+// configuration field.
+#define LW_GRF250_PROVISION_MAX_REQUESTS (1 + LW_GRF250_CONFIG_FIELD_COUNT)
+
+typedef struct {
+    // The values of the fields to set, other fields are ignored.
+    lw_grf250_config config;
+
+    // The LW_GRF250_CONFIG_... bits of the fields the profile sets.
+    uint32_t fields;
+
+    // Save the parameters after writing so they persist across restarts.
+    uint8_t save;
+} lw_grf250_provision_profile;
+
+typedef enum {
+    LW_GRF250_PROVISION_CONNECT,
+    LW_GRF250_PROVISION_READ,
+    LW_GRF250_PROVISION_WRITE,
+    LW_GRF250_PROVISION_SAVE,
+    LW_GRF250_PROVISION_VERIFY,
+    LW_GRF250_PROVISION_DONE,
+} lw_grf250_provision_step;
+
+typedef struct {
+    lw_result result;
+
+    // The step that failed, or LW_GRF250_PROVISION_DONE.
+    lw_grf250_provision_step step;
+
+    char serial_number[16];
+
+    // The LW_GRF250_CONFIG_... bits of the fields that were written.
+    uint32_t changed;
+
+    // The LW_GRF250_CONFIG_... bits of the profile fields that did not read
+    // back as written. Only set by the verify step.
+    uint32_t mismatched;
+
+    uint8_t saved;
+    uint32_t elapsed_ms;
+} lw_grf250_provision_report;
+
+// The state of one device being provisioned. Owned by the caller and must
+// stay valid until the job is done, as its requests are linked into the device.
+typedef struct {
+    lw_callback_device *device;
+    const lw_grf250_provision_profile *profile;
+    lw_grf250_provision_report *report;
+
+    uint32_t start_ms;
+    lw_grf250_config current;
+    lw_grf250_config work;
+
+    // The step and result of the first request that failed in this step.
+    lw_grf250_provision_step failed_step;
+    lw_result failed_result;
+
+    uint32_t outstanding;
+    uint32_t completions;
+    uint8_t done;
+
+    lw_async_request requests[LW_GRF250_PROVISION_MAX_REQUESTS];
+} lw_grf250_provision_job;
+
+/*
+ * Initialize a profile that sets no fields and saves.
+ *
+ * @param profile The profile to initialize.
+ */
+void lw_grf250_init_provision_profile(lw_grf250_provision_profile *profile);
+
+/*
+ * Provision a device with a profile, blocking until it is done.
+ *
+ * @param device Connected device, not streaming, with no other asynchronous
+ *        requests outstanding.
+ * @param profile The profile to apply.
+ * @param report The result of every step is written here.
+ * @return LW_RESULT_SUCCESS if every profile field reads back as written,
+ *         LW_RESULT_ERROR if the verify step found mismatched fields,
+ *         LW_RESULT_INVALID_PARAMETER if the profile sets the baud rate,
+ *         otherwise the error of the failed step.
+ */
+lw_result lw_grf250_provision(lw_callback_device *device, const lw_grf250_provision_profile *profile, lw_grf250_provision_report *report);
+
+/*
+ * Provision several devices with the same profile from the calling thread.
+ * Every device runs its own job, and the devices are polled in turn until all
+ * the jobs are done, so a slow or missing device only holds up its own job.
+ *
+ * @param devices The connected devices, not streaming, with no other
+ *        asynchronous requests outstanding.
+ * @param device_count The number of devices.
+ * @param profile The profile to apply.
+ * @param jobs Storage for one job per device.
+ * @param reports One report per device, see lw_grf250_provision.
+ * @return LW_RESULT_SUCCESS if every device was provisioned, otherwise
+ *         LW_RESULT_ERROR, the reports hold the result of each device.
+ */
+lw_result lw_grf250_provision_fleet(lw_callback_device **devices, uint32_t device_count, const lw_grf250_provision_profile *profile, lw_grf250_provision_job *jobs, lw_grf250_provision_report *reports);
+
+/*
+ * Start provisioning a device without blocking. The job advances from
+ * lw_device_poll, or lw_grf250_poll_provision, on the device and is finished
+ * when job->done is set, with the result in the report.
+ *
+ * @param job The job to start.
+ * @param device Connected device, not streaming.
+ * @param profile The profile to apply, must stay valid until the job is done.
+ * @param report The report, must stay valid until the job is done.
+ */
+void lw_grf250_start_provision(lw_grf250_provision_job *job, lw_callback_device *device, const lw_grf250_provision_profile *profile, lw_grf250_provision_report *report);
+
+/*
+ * Poll the device of a provisioning job.
+ *
+ * @param job The job.
+ * @param timeout_ms The time to wait for the next response in milliseconds,
+ *        or 0 for non-blocking, see lw_device_poll.
+ */
+void lw_grf250_poll_provision(lw_grf250_provision_job *job, uint32_t timeout_ms);
+
+/*
+ * Get the name of a provisioning step for reports.
+ *
+ * @param step The step.
+ * @return The name of the step.
+ */
+const char *lw_grf250_provision_step_name(lw_grf250_provision_step step);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_PROVISION_H
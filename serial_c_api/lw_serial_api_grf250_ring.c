@@ -0,0 +1,106 @@
+#include "lw_serial_api_grf250_ring.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Streamed sample ring.
+// ----------------------------------------------------------------------------
+lw_result lw_grf250_sample_ring_init(lw_grf250_sample_ring *ring, lw_grf250_stream_sample *samples, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    lw_atomic_store_release(&ring->head, 0);
+    lw_atomic_store_release(&ring->tail, 0);
+    lw_atomic_store_release(&ring->overruns, 0);
+    ring->cached_tail = 0;
+    ring->cached_head = 0;
+    ring->samples = samples;
+    ring->capacity = capacity;
+    ring->mask = capacity - 1;
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_sample_ring_push(lw_grf250_sample_ring *ring, const lw_grf250_stream_sample *sample) {
+    // NOTE: The indices run freely and wrap at 2^32, only the masked value is
+    // used to address the storage.
+    uint32_t head = lw_atomic_load_acquire(&ring->head);
+
+    if (head - ring->cached_tail >= ring->capacity) {
+        ring->cached_tail = lw_atomic_load_acquire(&ring->tail);
+
+        if (head - ring->cached_tail >= ring->capacity) {
+            lw_atomic_fetch_add(&ring->overruns, 1);
+            return LW_RESULT_AGAIN;
+        }
+    }
+
+    ring->samples[head & ring->mask] = *sample;
+    lw_atomic_store_release(&ring->head, head + 1);
+
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_sample_ring_receive(lw_callback_device *device, lw_grf250_sample_ring *ring, lw_grf_distance_config config, uint32_t timeout_ms) {
+    LW_CHECK_SUCCESS(lw_wait_for_next_response(device, LW_ANY_COMMAND, timeout_ms))
+
+    lw_grf250_stream_sample sample;
+
+    if (device->response.command_id == LW_GRF250_COMMAND_DISTANCE_DATA) {
+        sample.stream = LW_GRF250_STREAM_DISTANCE;
+        memset(&sample.data.distance_data, 0, sizeof(sample.data.distance_data));
+        LW_CHECK_SUCCESS(lw_grf250_parse_response_distance_data(&device->response, config, &sample.data.distance_data))
+    } else if (device->response.command_id == LW_GRF250_COMMAND_MULTI_DATA) {
+        sample.stream = LW_GRF250_STREAM_MULTI;
+        LW_CHECK_SUCCESS(lw_grf250_parse_response_multi_data(&device->response, &sample.data.multi_data))
+    } else {
+        return LW_RESULT_AGAIN;
+    }
+
+    return lw_grf250_sample_ring_push(ring, &sample);
+}
+
+lw_result lw_grf250_sample_ring_pop(lw_grf250_sample_ring *ring, lw_grf250_stream_sample *sample) {
+    return lw_grf250_sample_ring_pop_batch(ring, sample, 1) == 1 ? LW_RESULT_SUCCESS : LW_RESULT_AGAIN;
+}
+
+uint32_t lw_grf250_sample_ring_pop_batch(lw_grf250_sample_ring *ring, lw_grf250_stream_sample *samples, uint32_t max_count) {
+    uint32_t tail = lw_atomic_load_acquire(&ring->tail);
+    uint32_t available = ring->cached_head - tail;
+
+    if (available < max_count) {
+        ring->cached_head = lw_atomic_load_acquire(&ring->head);
+        available = ring->cached_head - tail;
+    }
+
+    uint32_t count = available < max_count ? available : max_count;
+
+    if (count == 0) {
+        return 0;
+    }
+
+    // Copy in at most two runs, up to the end of the storage and then from the start.
+    uint32_t start = tail & ring->mask;
+    uint32_t first_count = ring->capacity - start;
+
+    if (first_count > count) {
+        first_count = count;
+    }
+
+    memcpy(samples, ring->samples + start, first_count * sizeof(lw_grf250_stream_sample));
+    memcpy(samples + first_count, ring->samples, (count - first_count) * sizeof(lw_grf250_stream_sample));
+
+    lw_atomic_store_release(&ring->tail, tail + count);
+
+    return count;
+}
+
+uint32_t lw_grf250_sample_ring_size(lw_grf250_sample_ring *ring) {
+    uint32_t tail = lw_atomic_load_acquire(&ring->tail);
+    uint32_t head = lw_atomic_load_acquire(&ring->head);
+    return head - tail;
+}
+
+uint32_t lw_grf250_sample_ring_overruns(lw_grf250_sample_ring *ring) {
+    return lw_atomic_load_acquire(&ring->overruns);
+}
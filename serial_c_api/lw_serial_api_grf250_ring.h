@@ -0,0 +1,199 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Sample Ring
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_RING_H
+#define LW_API_GRF250_RING_H
+
+#include "lw_serial_api_grf250.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Atomic helpers.
+//
+// The ring is shared between exactly one producer thread and one consumer
+// thread, so only acquire loads and release stores are needed. The compare
+// exchange, the full fence and the read only load are used by the shared
+// memory ring.
+// ----------------------------------------------------------------------------
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+typedef volatile long lw_atomic_uint32;
+#define lw_atomic_load_acquire(atomic) ((uint32_t)_InterlockedOr((volatile long *)(atomic), 0))
+#define lw_atomic_store_release(atomic, value) _InterlockedExchange((volatile long *)(atomic), (long)(value))
+#define lw_atomic_fetch_add(atomic, value) ((uint32_t)_InterlockedExchangeAdd((volatile long *)(atomic), (long)(value)))
+#define lw_atomic_compare_exchange(atomic, expected, desired) (_InterlockedCompareExchange((volatile long *)(atomic), (long)(desired), (long)(expected)) == (long)(expected))
+static __inline void lw_atomic_fence(void) {
+    volatile long fence = 0;
+    _InterlockedExchange(&fence, 0);
+}
+
+// NOTE: _InterlockedOr writes, so memory mapped read only is loaded with a
+// plain volatile read and a fence.
+static __inline uint32_t lw_atomic_load_acquire_read_only(const lw_atomic_uint32 *atomic) {
+    uint32_t value = (uint32_t)*atomic;
+    lw_atomic_fence();
+    return value;
+}
+#else
+#include <stdatomic.h>
+typedef _Atomic uint32_t lw_atomic_uint32;
+#define lw_atomic_load_acquire(atomic) atomic_load_explicit((atomic), memory_order_acquire)
+#define lw_atomic_store_release(atomic, value) atomic_store_explicit((atomic), (value), memory_order_release)
+#define lw_atomic_fetch_add(atomic, value) atomic_fetch_add_explicit((atomic), (value), memory_order_relaxed)
+#define lw_atomic_compare_exchange(atomic, expected, desired) lw_atomic_compare_exchange_uint32((atomic), (expected), (desired))
+#define lw_atomic_fence() atomic_thread_fence(memory_order_seq_cst)
+#define lw_atomic_load_acquire_read_only(atomic) atomic_load_explicit((atomic), memory_order_acquire)
+static inline int lw_atomic_compare_exchange_uint32(lw_atomic_uint32 *atomic, uint32_t expected, uint32_t desired) {
+    return atomic_compare_exchange_strong_explicit(atomic, &expected, desired, memory_order_acq_rel, memory_order_acquire);
+}
+#endif
+
+#ifndef LW_CACHE_LINE_SIZE
+#define LW_CACHE_LINE_SIZE 64
+#endif
+
+// ----------------------------------------------------------------------------
+// Streamed sample ring.
+//
+// A fixed capacity single-producer/single-consumer ring of decoded stream
+// samples. A reader thread fills the ring from the distance or multi data
+// stream while the consumer drains it at its own rate without locks.
+//
+// The producer and consumer indices live on separate cache lines so the two
+// threads do not contend on the same line. Each side also keeps a cached
+// copy of the other side's index and only reloads it when the ring appears
+// full or empty.
+//
+// When the ring is full, new samples are dropped and counted as overruns.
+// ----------------------------------------------------------------------------
+typedef struct {
+    lw_grf250_stream stream;
+
+    union {
+        lw_grf250_distance_data distance_data;
+        lw_grf250_multi_data multi_data;
+    } data;
+} lw_grf250_stream_sample;
+
+typedef struct {
+    // Written by the producer.
+    lw_atomic_uint32 head;
+    uint32_t cached_tail;
+    lw_atomic_uint32 overruns;
+    uint8_t producer_padding[LW_CACHE_LINE_SIZE - 3 * sizeof(uint32_t)];
+
+    // Written by the consumer.
+    lw_atomic_uint32 tail;
+    uint32_t cached_head;
+    uint8_t consumer_padding[LW_CACHE_LINE_SIZE - 2 * sizeof(uint32_t)];
+
+    // Shared, read only after init.
+    lw_grf250_stream_sample *samples;
+    uint32_t capacity;
+    uint32_t mask;
+} lw_grf250_sample_ring;
+
+/*
+ * Initialize an empty ring over caller provided sample storage.
+ *
+ * @param ring The ring to initialize.
+ * @param samples Storage for the samples.
+ * @param capacity The number of samples in the storage, must be a power of 2.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the
+ *         capacity is not a power of 2.
+ */
+lw_result lw_grf250_sample_ring_init(lw_grf250_sample_ring *ring, lw_grf250_stream_sample *samples, uint32_t capacity);
+
+/*
+ * Push a sample. Must only be called from the producer thread.
+ *
+ * @param ring The ring.
+ * @param sample The sample to push.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN if the ring is
+ *         full and the sample was dropped.
+ */
+lw_result lw_grf250_sample_ring_push(lw_grf250_sample_ring *ring, const lw_grf250_stream_sample *sample);
+
+/*
+ * Wait for the next streamed distance or multi data packet from the device,
+ * decode it, and push it into the ring. Must only be called from the producer
+ * thread, usually in a loop on a dedicated reader thread.
+ *
+ * @param device Connected device.
+ * @param ring The ring.
+ * @param config Distance configuration used to decode distance data.
+ * @param timeout_ms The timeout in milliseconds, or 0 for non-blocking.
+ * @return LW_RESULT_SUCCESS if a sample was pushed, LW_RESULT_AGAIN if the
+ *         ring was full, or the result of the wait on failure.
+ */
+lw_result lw_grf250_sample_ring_receive(lw_callback_device *device, lw_grf250_sample_ring *ring, lw_grf_distance_config config, uint32_t timeout_ms);
+
+/*
+ * Pop the oldest sample. Must only be called from the consumer thread.
+ *
+ * @param ring The ring.
+ * @param sample The sample is written here.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN if the ring is empty.
+ */
+lw_result lw_grf250_sample_ring_pop(lw_grf250_sample_ring *ring, lw_grf250_stream_sample *sample);
+
+/*
+ * Pop up to max_count of the oldest samples. Must only be called from the
+ * consumer thread.
+ *
+ * @param ring The ring.
+ * @param samples The samples are written here.
+ * @param max_count The maximum number of samples to pop.
+ * @return The number of samples popped.
+ */
+uint32_t lw_grf250_sample_ring_pop_batch(lw_grf250_sample_ring *ring, lw_grf250_stream_sample *samples, uint32_t max_count);
+
+/*
+ * Get the number of samples waiting in the ring. The value is a snapshot and
+ * can be called from either thread.
+ *
+ * @param ring The ring.
+ * @return The number of samples in the ring.
+ */
+uint32_t lw_grf250_sample_ring_size(lw_grf250_sample_ring *ring);
+
+/*
+ * Get the number of samples dropped because the ring was full.
+ *
+ * @param ring The ring.
+ * @return The number of dropped samples.
+ */
+uint32_t lw_grf250_sample_ring_overruns(lw_grf250_sample_ring *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_RING_H
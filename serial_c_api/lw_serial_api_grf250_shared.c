@@ -0,0 +1,260 @@
+#include "lw_serial_api_grf250_shared.h"
+#include <string.h>
+
+// ----------------------------------------------------------------------------
+// Shared memory sample ring.
+// ----------------------------------------------------------------------------
+static lw_grf250_shared_slot *lw_grf250_shared_ring_slots(lw_grf250_shared_ring *ring) {
+    return (lw_grf250_shared_slot *)((uint8_t *)ring + sizeof(lw_grf250_shared_ring));
+}
+
+static const lw_grf250_shared_slot *lw_grf250_shared_ring_slots_read_only(const lw_grf250_shared_ring *ring) {
+    return (const lw_grf250_shared_slot *)((const uint8_t *)ring + sizeof(lw_grf250_shared_ring));
+}
+
+uint64_t lw_grf250_shared_ring_size(uint32_t capacity) {
+    return (uint64_t)sizeof(lw_grf250_shared_ring) + (uint64_t)capacity * sizeof(lw_grf250_shared_slot);
+}
+
+lw_result lw_grf250_shared_ring_init(lw_grf250_shared_ring *ring, uint32_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    memset(ring, 0, (size_t)lw_grf250_shared_ring_size(capacity));
+    ring->version = LW_GRF250_SHARED_VERSION;
+    ring->capacity = capacity;
+    ring->slot_size = sizeof(lw_grf250_shared_slot);
+
+    // NOTE: The magic is stored last, so a subscriber that maps the ring
+    // during init rejects it rather than seeing a partial header.
+    lw_atomic_fence();
+    ring->magic = LW_GRF250_SHARED_MAGIC;
+
+    return LW_RESULT_SUCCESS;
+}
+
+void lw_grf250_shared_ring_publish(lw_grf250_shared_ring *ring, const lw_grf250_stream_sample *sample) {
+    uint32_t index = lw_atomic_load_acquire(&ring->head);
+    lw_grf250_shared_slot *slot = &lw_grf250_shared_ring_slots(ring)[index & (ring->capacity - 1)];
+
+    // NOTE: The fence keeps the sample stores after the odd sequence, which
+    // a release store alone does not.
+    lw_atomic_store_release(&slot->sequence, 2 * index + 1);
+    lw_atomic_fence();
+
+    memcpy(&slot->sample, sample, sizeof(lw_grf250_stream_sample));
+
+    lw_atomic_store_release(&slot->sequence, 2 * index + 2);
+    lw_atomic_store_release(&ring->head, index + 1);
+}
+
+lw_result lw_grf250_shared_ring_receive(lw_callback_device *device, lw_grf250_shared_ring *ring, lw_grf_distance_config config, uint32_t timeout_ms) {
+    lw_response *response;
+    LW_CHECK_SUCCESS(lw_wait_for_stream_packet(device, LW_ANY_COMMAND, timeout_ms, &response))
+
+    lw_grf250_stream_sample sample;
+
+    if (response->command_id == LW_GRF250_COMMAND_DISTANCE_DATA) {
+        sample.stream = LW_GRF250_STREAM_DISTANCE;
+        memset(&sample.data.distance_data, 0, sizeof(sample.data.distance_data));
+        LW_CHECK_SUCCESS(lw_grf250_parse_response_distance_data(response, config, &sample.data.distance_data))
+    } else if (response->command_id == LW_GRF250_COMMAND_MULTI_DATA) {
+        sample.stream = LW_GRF250_STREAM_MULTI;
+        LW_CHECK_SUCCESS(lw_grf250_parse_response_multi_data(response, &sample.data.multi_data))
+    } else {
+        return LW_RESULT_AGAIN;
+    }
+
+    lw_grf250_shared_ring_publish(ring, &sample);
+    return LW_RESULT_SUCCESS;
+}
+
+lw_result lw_grf250_shared_reader_init(lw_grf250_shared_reader *reader, const lw_grf250_shared_ring *ring, uint64_t size) {
+    memset(reader, 0, sizeof(lw_grf250_shared_reader));
+
+    if (size < sizeof(lw_grf250_shared_ring) || ring->magic != LW_GRF250_SHARED_MAGIC) {
+        return LW_RESULT_ERROR;
+    }
+
+    lw_atomic_fence();
+
+    if (ring->version != LW_GRF250_SHARED_VERSION || ring->slot_size != sizeof(lw_grf250_shared_slot) || ring->capacity == 0 ||
+        (ring->capacity & (ring->capacity - 1)) != 0 || size < lw_grf250_shared_ring_size(ring->capacity)) {
+        return LW_RESULT_ERROR;
+    }
+
+    reader->ring = ring;
+    reader->next = lw_atomic_load_acquire_read_only(&ring->head);
+
+    return LW_RESULT_SUCCESS;
+}
+
+// Copy out the sample with an index, if the slot still holds it.
+static uint8_t lw_grf250_shared_reader_copy(const lw_grf250_shared_ring *ring, uint32_t index, lw_grf250_stream_sample *sample) {
+    const lw_grf250_shared_slot *slot = &lw_grf250_shared_ring_slots_read_only(ring)[index & (ring->capacity - 1)];
+    uint32_t sequence = 2 * index + 2;
+
+    if (lw_atomic_load_acquire_read_only(&slot->sequence) != sequence) {
+        return 0;
+    }
+
+    memcpy(sample, &slot->sample, sizeof(lw_grf250_stream_sample));
+    lw_atomic_fence();
+
+    return lw_atomic_load_acquire_read_only(&slot->sequence) == sequence;
+}
+
+lw_result lw_grf250_shared_reader_next(lw_grf250_shared_reader *reader, lw_grf250_stream_sample *sample) {
+    const lw_grf250_shared_ring *ring = reader->ring;
+
+    while (1) {
+        uint32_t head = lw_atomic_load_acquire_read_only(&ring->head);
+
+        if (head == reader->next) {
+            return LW_RESULT_AGAIN;
+        }
+
+        // Skip to the oldest sample the ring still holds.
+        if (head - reader->next > ring->capacity) {
+            reader->lost += head - reader->next - ring->capacity;
+            reader->next = head - ring->capacity;
+        }
+
+        if (lw_grf250_shared_reader_copy(ring, reader->next, sample)) {
+            reader->next += 1;
+            return LW_RESULT_SUCCESS;
+        }
+
+        // NOTE: The publisher overwrote the slot meanwhile, so the oldest
+        // sample has moved on.
+        reader->lost += 1;
+        reader->next += 1;
+    }
+}
+
+lw_result lw_grf250_shared_reader_latest(lw_grf250_shared_reader *reader, lw_grf250_stream_sample *sample) {
+    const lw_grf250_shared_ring *ring = reader->ring;
+
+    while (1) {
+        uint32_t head = lw_atomic_load_acquire_read_only(&ring->head);
+
+        if (head == reader->next) {
+            return LW_RESULT_AGAIN;
+        }
+
+        if (lw_grf250_shared_reader_copy(ring, head - 1, sample)) {
+            reader->next = head;
+            return LW_RESULT_SUCCESS;
+        }
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Shared memory command channel.
+// ----------------------------------------------------------------------------
+void lw_grf250_shared_commands_init(lw_grf250_shared_commands *commands) {
+    memset(commands, 0, sizeof(lw_grf250_shared_commands));
+    commands->version = LW_GRF250_SHARED_VERSION;
+    commands->slot_count = LW_GRF250_SHARED_COMMAND_SLOTS;
+    commands->slot_size = sizeof(lw_grf250_shared_command);
+
+    lw_atomic_fence();
+    commands->magic = LW_GRF250_SHARED_MAGIC;
+}
+
+lw_result lw_grf250_shared_commands_check(const lw_grf250_shared_commands *commands, uint64_t size) {
+    if (size < sizeof(lw_grf250_shared_commands) || commands->magic != LW_GRF250_SHARED_MAGIC) {
+        return LW_RESULT_ERROR;
+    }
+
+    lw_atomic_fence();
+
+    if (commands->version != LW_GRF250_SHARED_VERSION || commands->slot_count != LW_GRF250_SHARED_COMMAND_SLOTS || commands->slot_size != sizeof(lw_grf250_shared_command)) {
+        return LW_RESULT_ERROR;
+    }
+
+    return LW_RESULT_SUCCESS;
+}
+
+uint32_t lw_grf250_shared_commands_service(lw_callback_device *device, lw_grf250_shared_commands *commands) {
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < LW_GRF250_SHARED_COMMAND_SLOTS; ++i) {
+        lw_grf250_shared_command *command = &commands->slots[i];
+
+        if (lw_atomic_load_acquire(&command->state) != LW_GRF250_SHARED_COMMAND_PENDING) {
+            continue;
+        }
+
+        lw_result request_result = LW_RESULT_INVALID_PARAMETER;
+        command->response_size = 0;
+
+        // NOTE: The subscriber wrote the request, so it is checked before it
+        // is sent.
+        if (command->request_size >= 6 && command->request_size <= LW_PACKET_SEND_SIZE) {
+            memcpy(device->request.data, command->request, command->request_size);
+            device->request.data_size = command->request_size;
+            device->request.command_id = command->request[3];
+
+            request_result = lw_send_request_get_response(device);
+        }
+
+        if (request_result == LW_RESULT_SUCCESS) {
+            memcpy(command->response, device->response.data, device->response.data_size);
+            command->response_size = device->response.data_size;
+        }
+
+        command->result = (int32_t)request_result;
+        lw_atomic_store_release(&command->state, LW_GRF250_SHARED_COMMAND_DONE);
+        ++count;
+    }
+
+    return count;
+}
+
+lw_result lw_grf250_shared_command_submit(lw_grf250_shared_commands *commands, const lw_request *request, uint32_t *slot) {
+    for (uint32_t i = 0; i < LW_GRF250_SHARED_COMMAND_SLOTS; ++i) {
+        lw_grf250_shared_command *command = &commands->slots[i];
+
+        if (!lw_atomic_compare_exchange(&command->state, LW_GRF250_SHARED_COMMAND_FREE, LW_GRF250_SHARED_COMMAND_CLAIMED)) {
+            continue;
+        }
+
+        memcpy(command->request, request->data, request->data_size);
+        command->request_size = request->data_size;
+        lw_atomic_store_release(&command->state, LW_GRF250_SHARED_COMMAND_PENDING);
+
+        *slot = i;
+        return LW_RESULT_SUCCESS;
+    }
+
+    return LW_RESULT_AGAIN;
+}
+
+lw_result lw_grf250_shared_command_poll(lw_grf250_shared_commands *commands, uint32_t slot, lw_response *response) {
+    if (slot >= LW_GRF250_SHARED_COMMAND_SLOTS) {
+        return LW_RESULT_INVALID_PARAMETER;
+    }
+
+    lw_grf250_shared_command *command = &commands->slots[slot];
+
+    if (lw_atomic_load_acquire(&command->state) != LW_GRF250_SHARED_COMMAND_DONE) {
+        return LW_RESULT_AGAIN;
+    }
+
+    lw_result request_result = (lw_result)command->result;
+    lw_init_response(response);
+
+    if (request_result == LW_RESULT_SUCCESS && command->response_size >= 6 && command->response_size <= LW_PACKET_RECV_SIZE) {
+        memcpy(response->data, command->response, command->response_size);
+        response->data_size = command->response_size;
+        response->payload_size = (uint32_t)((response->data[1] | (response->data[2] << 8)) >> 6);
+        response->command_id = response->data[3];
+        response->parse_state = LW_PARSESTATE_DONE;
+    }
+
+    lw_atomic_store_release(&command->state, LW_GRF250_SHARED_COMMAND_FREE);
+
+    return request_result;
+}
@@ -0,0 +1,255 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API GRF250 Shared Memory Publisher
+// Version: 1.0.0
+// https://www.lightwarelidar.com
+// ----------------------------------------------------------------------------
+// License: MIT
+//
+// Copyright (c) 2024 LightWare Optoelectronics (Pty) Ltd.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+// ----------------------------------------------------------------------------
+#ifndef LW_API_GRF250_SHARED_H
+#define LW_API_GRF250_SHARED_H
+
+#include "lw_serial_api_grf250_ring.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// ----------------------------------------------------------------------------
+// Shared memory sample ring.
+//
+// One publisher process owns the serial port and decodes the stream into a
+// ring in shared memory. Any number of subscriber processes map the ring
+// read only and follow it at their own pace, without the publisher knowing
+// about them.
+//
+// Every slot is guarded by a sequence lock. The publisher makes the sequence
+// odd, writes the sample, and then stores 2 * (index + 1), where index counts
+// every sample ever published. A subscriber copies a slot out and keeps the
+// copy only if the sequence was the expected even value before and after.
+// The publisher never waits, so a subscriber that falls more than a ring
+// behind skips to the oldest sample still held and counts the rest as lost.
+//
+// The layout is only shared between builds of this API with the same
+// LW_GRF250_SHARED_VERSION and sample size, which subscribers check.
+// ----------------------------------------------------------------------------
+#define LW_GRF250_SHARED_MAGIC (0x5257474C)
+#define LW_GRF250_SHARED_VERSION (1)
+
+typedef struct {
+    lw_atomic_uint32 sequence;
+    uint32_t reserved;
+    lw_grf250_stream_sample sample;
+} lw_grf250_shared_slot;
+
+typedef struct {
+    // Read only after init.
+    uint32_t magic;
+    uint32_t version;
+    uint32_t capacity;
+    uint32_t slot_size;
+    uint8_t header_padding[LW_CACHE_LINE_SIZE - 4 * sizeof(uint32_t)];
+
+    // Written by the publisher, the number of samples published.
+    lw_atomic_uint32 head;
+    uint8_t publisher_padding[LW_CACHE_LINE_SIZE - sizeof(uint32_t)];
+
+    // NOTE: The slots follow the header.
+} lw_grf250_shared_ring;
+
+typedef struct {
+    const lw_grf250_shared_ring *ring;
+
+    // The index of the next sample to read.
+    uint32_t next;
+
+    // The number of samples that were overwritten before they were read.
+    uint32_t lost;
+} lw_grf250_shared_reader;
+
+/*
+ * Get the size of the shared memory a ring needs.
+ *
+ * @param capacity The number of samples in the ring, must be a power of 2.
+ * @return The size in bytes.
+ */
+uint64_t lw_grf250_shared_ring_size(uint32_t capacity);
+
+/*
+ * Initialize an empty ring in shared memory. Only called by the publisher.
+ *
+ * @param ring The shared memory, at least lw_grf250_shared_ring_size(capacity) bytes.
+ * @param capacity The number of samples in the ring, must be a power of 2.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_INVALID_PARAMETER if the
+ *         capacity is not a power of 2.
+ */
+lw_result lw_grf250_shared_ring_init(lw_grf250_shared_ring *ring, uint32_t capacity);
+
+/*
+ * Publish a sample. Only called by the publisher.
+ *
+ * @param ring The ring.
+ * @param sample The sample to publish.
+ */
+void lw_grf250_shared_ring_publish(lw_grf250_shared_ring *ring, const lw_grf250_stream_sample *sample);
+
+/*
+ * Wait for the next streamed distance or multi data packet from the device,
+ * taking packets held in the stream queue first, decode it and publish it.
+ *
+ * @param device Connected device.
+ * @param ring The ring.
+ * @param config Distance configuration used to decode distance data.
+ * @param timeout_ms The timeout in milliseconds, or 0 for non-blocking.
+ * @return LW_RESULT_SUCCESS if a sample was published, LW_RESULT_AGAIN if the
+ *         packet was not streamed data, or the result of the wait on failure.
+ */
+lw_result lw_grf250_shared_ring_receive(lw_callback_device *device, lw_grf250_shared_ring *ring, lw_grf_distance_config config, uint32_t timeout_ms);
+
+/*
+ * Attach a reader to a mapped ring. The reader starts at the next sample
+ * published.
+ *
+ * @param reader The reader to initialize.
+ * @param ring The mapped ring.
+ * @param size The size of the mapping in bytes.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR if the mapping
+ *         does not hold a ring of this layout.
+ */
+lw_result lw_grf250_shared_reader_init(lw_grf250_shared_reader *reader, const lw_grf250_shared_ring *ring, uint64_t size);
+
+/*
+ * Read the next sample in order.
+ *
+ * @param reader The reader.
+ * @param sample The sample is written here.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN if no new sample
+ *         has been published.
+ */
+lw_result lw_grf250_shared_reader_next(lw_grf250_shared_reader *reader, lw_grf250_stream_sample *sample);
+
+/*
+ * Read the most recent sample, skipping any others. Later calls to
+ * lw_grf250_shared_reader_next continue after it.
+ *
+ * @param reader The reader.
+ * @param sample The sample is written here.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN if no new sample
+ *         has been published.
+ */
+lw_result lw_grf250_shared_reader_latest(lw_grf250_shared_reader *reader, lw_grf250_stream_sample *sample);
+
+// ----------------------------------------------------------------------------
+// Shared memory command channel.
+//
+// Subscribers can not talk to the device themselves, so they place requests
+// in the slots of a second, writable mapping, and the publisher sends them
+// between samples with the managed commands.
+//
+// A slot moves from free to claimed by a subscriber, to pending, to done by
+// the publisher, and back to free once the subscriber takes the response.
+// A subscriber that exits while holding a slot leaves it in use until the
+// publisher initializes the channel again.
+// ----------------------------------------------------------------------------
+#ifndef LW_GRF250_SHARED_COMMAND_SLOTS
+#define LW_GRF250_SHARED_COMMAND_SLOTS 8
+#endif
+
+typedef enum {
+    LW_GRF250_SHARED_COMMAND_FREE,
+    LW_GRF250_SHARED_COMMAND_CLAIMED,
+    LW_GRF250_SHARED_COMMAND_PENDING,
+    LW_GRF250_SHARED_COMMAND_DONE,
+} lw_grf250_shared_command_state;
+
+typedef struct {
+    lw_atomic_uint32 state;
+    int32_t result;
+    uint32_t request_size;
+    uint32_t response_size;
+    uint8_t request[LW_PACKET_SEND_SIZE];
+    uint8_t response[LW_PACKET_RECV_SIZE];
+} lw_grf250_shared_command;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slot_count;
+    uint32_t slot_size;
+    lw_grf250_shared_command slots[LW_GRF250_SHARED_COMMAND_SLOTS];
+} lw_grf250_shared_commands;
+
+/*
+ * Initialize the command channel with every slot free. Only called by the
+ * publisher.
+ *
+ * @param commands The shared memory, at least sizeof(lw_grf250_shared_commands) bytes.
+ */
+void lw_grf250_shared_commands_init(lw_grf250_shared_commands *commands);
+
+/*
+ * Check that a mapping holds a command channel of this layout.
+ *
+ * @param commands The mapped command channel.
+ * @param size The size of the mapping in bytes.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_ERROR otherwise.
+ */
+lw_result lw_grf250_shared_commands_check(const lw_grf250_shared_commands *commands, uint64_t size);
+
+/*
+ * Send every pending request and store the responses. Only called by the
+ * publisher, usually between calls to lw_grf250_shared_ring_receive.
+ *
+ * @param device Connected device.
+ * @param commands The command channel.
+ * @return The number of requests that were sent.
+ */
+uint32_t lw_grf250_shared_commands_service(lw_callback_device *device, lw_grf250_shared_commands *commands);
+
+/*
+ * Submit a request from a subscriber.
+ *
+ * @param commands The command channel.
+ * @param request The request, eg: from lw_grf250_create_request_write_update_rate.
+ * @param slot The slot holding the request is written here.
+ * @return LW_RESULT_SUCCESS on success, or LW_RESULT_AGAIN if every slot is in use.
+ */
+lw_result lw_grf250_shared_command_submit(lw_grf250_shared_commands *commands, const lw_request *request, uint32_t *slot);
+
+/*
+ * Take the response to a submitted request. The slot is freed once the
+ * response is taken.
+ *
+ * @param commands The command channel.
+ * @param slot The slot from lw_grf250_shared_command_submit.
+ * @param response The response is written here, ready for the
+ *        lw_grf250_parse_response_... functions.
+ * @return LW_RESULT_AGAIN while the request is pending, otherwise the result
+ *         of the request in the publisher.
+ */
+lw_result lw_grf250_shared_command_poll(lw_grf250_shared_commands *commands, uint32_t slot, lw_response *response);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // LW_API_GRF250_SHARED_H
@@ -0,0 +1,56 @@
+"""
+example_stream_native.py
+
+This example demonstrates how to stream distance data at a high rate with the native backend,
+which parses responses in C and returns batches of samples as NumPy arrays.
+
+Notes:
+    Requires the pySerial and NumPy modules.
+    Build the native library first with native/build.sh, or native/build_visual_studio.bat on Windows.
+
+2024 LightWare Optoelectronics (Pty) Ltd.
+https://www.lightwarelidar.com
+"""
+
+import grf250_serial
+import grf250_native
+
+# --------------------------------------------------------------------------------------------------
+# Main application.
+# --------------------------------------------------------------------------------------------------
+print("Running GRF-250 native stream sample.")
+
+grf250 = grf250_native.Grf250Native(grf250_serial.SerialServiceHandler("COM70", 921600))
+
+# NOTE: Only needed if running over serial interface and mode is set to 'Wait for interface'.
+grf250.initiate_serial()
+
+# Setup device
+grf250.set_stream(grf250_serial.StreamId.NONE)
+grf250.set_update_rate(50)
+distance_config = (
+    grf250_serial.DistanceConfig.FIRST_RETURN_FILTERED
+    | grf250_serial.DistanceConfig.FIRST_RETURN_STRENGTH
+)
+grf250.set_distance_config(distance_config)
+
+# Stream distance data in batches of up to 50 samples.
+grf250.set_stream(grf250_serial.StreamId.DISTANCE)
+
+for i in range(10):
+    batch = grf250.wait_for_streamed_distance_batch(distance_config, 50, 1)
+
+    if batch.count == 0:
+        print("Stream timeout")
+        continue
+
+    distance_m = batch.first_return_filtered_mm / 1000.0
+    print(
+        f"{batch.count} samples, mean {distance_m.mean():.3f} m, "
+        f"min {distance_m.min():.3f} m, max {distance_m.max():.3f} m"
+    )
+
+crc_errors, header_errors = grf250.get_errors()
+print(f"{crc_errors} CRC errors, {header_errors} header errors")
+
+grf250.set_stream(grf250_serial.StreamId.NONE)
@@ -0,0 +1,332 @@
+"""
+GRF-250 Serial API native backend
+
+An optional drop-in replacement for grf250_serial.Grf250 that parses and
+verifies responses with the C API through ctypes instead of byte by byte in
+Python, and decodes streamed distance data in batches into NumPy arrays.
+
+Build the native library first with native/build.sh, or
+native/build_visual_studio.bat on Windows. Set the LW_NATIVE_LIBRARY
+environment variable to load it from somewhere else.
+
+Notes:
+    Requires the NumPy module.
+
+2024 LightWare Optoelectronics (Pty) Ltd.
+https://www.lightwarelidar.com
+"""
+
+import ctypes
+import os
+import sys
+import time
+import numpy as np
+from grf250_serial import DistanceConfig, Grf250, SerialServiceHandler
+
+
+# -----------------------------------------------------------------------------
+# Native library.
+# -----------------------------------------------------------------------------
+NO_PACKET = -1
+PACKET_RECV_SIZE = 1024
+READ_SIZE = 4096
+
+# How long to sleep between polls of handlers without read_wait, in seconds.
+IDLE_SLEEP = 0.001
+
+# Ordered to match the bits of DistanceConfig.
+DISTANCE_FIELDS = [
+    "first_return_raw_mm",
+    "first_return_filtered_mm",
+    "first_return_strength",
+    "last_return_raw_mm",
+    "last_return_filtered_mm",
+    "last_return_strength",
+    "temperature",
+    "alarm_status",
+]
+
+
+def _library_path() -> str:
+    path = os.environ.get("LW_NATIVE_LIBRARY")
+
+    if path is not None:
+        return path
+
+    if sys.platform == "win32":
+        name = "lw_serial_api_native.dll"
+    else:
+        name = "liblw_serial_api_native.so"
+
+    return os.path.join(os.path.dirname(os.path.abspath(__file__)), "native", name)
+
+
+def _load_library() -> ctypes.CDLL:
+    library = ctypes.CDLL(_library_path())
+    u8_p = ctypes.POINTER(ctypes.c_uint8)
+    u32_p = ctypes.POINTER(ctypes.c_uint32)
+
+    library.lw_native_create_parser.restype = ctypes.c_void_p
+    library.lw_native_create_parser.argtypes = []
+    library.lw_native_destroy_parser.restype = None
+    library.lw_native_destroy_parser.argtypes = [ctypes.c_void_p]
+    library.lw_native_set_distance_config.restype = None
+    library.lw_native_set_distance_config.argtypes = [ctypes.c_void_p, ctypes.c_uint32]
+    library.lw_native_get_errors.restype = None
+    library.lw_native_get_errors.argtypes = [ctypes.c_void_p, u32_p, u32_p]
+    library.lw_native_feed.restype = ctypes.c_int32
+    library.lw_native_feed.argtypes = [ctypes.c_void_p, u8_p, ctypes.c_uint32, u32_p]
+    library.lw_native_get_packet.restype = ctypes.c_uint32
+    library.lw_native_get_packet.argtypes = [ctypes.c_void_p, u8_p, ctypes.c_uint32]
+    library.lw_native_decode_distance_batch.restype = ctypes.c_int32
+    library.lw_native_decode_distance_batch.argtypes = [
+        ctypes.c_void_p,
+        u8_p,
+        ctypes.c_uint32,
+        ctypes.POINTER(ctypes.c_int32),
+        ctypes.c_uint32,
+        u32_p,
+        u32_p,
+    ]
+
+    return library
+
+
+_library = None
+
+
+def _get_library() -> ctypes.CDLL:
+    global _library
+
+    if _library is None:
+        _library = _load_library()
+
+    return _library
+
+
+def is_available() -> bool:
+    """Check if the native library can be loaded."""
+
+    try:
+        _get_library()
+        return True
+    except OSError:
+        return False
+
+
+# -----------------------------------------------------------------------------
+# Distance batch.
+# -----------------------------------------------------------------------------
+class Distance_batch:
+    """
+    Streamed distance data as one NumPy int32 array per field, in the units
+    of Distance_data. Fields missing from the distance configuration are None.
+    """
+
+    def __init__(self, columns: np.ndarray, count: int, config: DistanceConfig):
+        self.count = count
+
+        for i, name in enumerate(DISTANCE_FIELDS):
+            if config & (1 << i):
+                setattr(self, name, columns[i, :count])
+            else:
+                setattr(self, name, None)
+
+
+# -----------------------------------------------------------------------------
+# GRF-250.
+# -----------------------------------------------------------------------------
+class Grf250Native(Grf250):
+    """
+    Handles request/response communication with the GRF-250 sensor, with
+    responses parsed by the native library. The API matches Grf250.
+    """
+
+    def __init__(self, service_handler: SerialServiceHandler):
+        super().__init__(service_handler)
+        self.library = _get_library()
+        self.parser = self.library.lw_native_create_parser()
+
+        if not self.parser:
+            raise MemoryError("Failed to create the native parser.")
+
+        self.distance_config = None
+        self.pending = b""
+        self.packet = (ctypes.c_uint8 * PACKET_RECV_SIZE)()
+
+    def __del__(self):
+        parser = getattr(self, "parser", None)
+
+        if parser:
+            self.library.lw_native_destroy_parser(parser)
+            self.parser = None
+
+    # -----------------------------------------------------------------------------
+    # Communication functions.
+    # -----------------------------------------------------------------------------
+    def read_available(self, timeout: float = 0) -> bytes:
+        """
+        Read received bytes in bulk, falling back to single bytes for handlers without read_available.
+
+        :param timeout: The time to wait for the first byte in seconds, if 0 then non-blocking.
+        """
+
+        if self.pending:
+            data = self.pending
+            self.pending = b""
+            return data
+
+        if timeout > 0:
+            read_wait = getattr(self.service_handler, "read_wait", None)
+
+            if read_wait is not None:
+                return read_wait(READ_SIZE, timeout)
+
+            # Handlers that can't block get polled, but not in a tight loop.
+            time.sleep(min(timeout, IDLE_SLEEP))
+
+        read_available = getattr(self.service_handler, "read_available", None)
+
+        if read_available is not None:
+            return read_available(READ_SIZE)
+
+        byte = self.service_handler.read_byte()
+        return b"" if byte is None else bytes([byte])
+
+    def keep_unconsumed(self, data: bytes, consumed: int):
+        """Keep the bytes following a completed packet for the next parse."""
+
+        if consumed < len(data):
+            self.pending = data[consumed:]
+
+    def load_packet(self):
+        """Copy the completed packet into self.response so it parses as usual."""
+
+        # NOTE: Slicing a ctypes array gives a list, the same as Response.feed builds.
+        size = self.library.lw_native_get_packet(self.parser, self.packet, PACKET_RECV_SIZE)
+        self.response.data = self.packet[:size]
+        self.response.command_id = self.response.data[3]
+
+    def feed(self, data: bytes) -> int:
+        """
+        Parse bytes until a packet completes.
+
+        :return: The command ID of the completed packet, or NO_PACKET.
+        """
+
+        consumed = ctypes.c_uint32(0)
+        buffer = (ctypes.c_uint8 * len(data)).from_buffer_copy(data)
+        command_id = self.library.lw_native_feed(self.parser, buffer, len(data), ctypes.byref(consumed))
+
+        if command_id != NO_PACKET:
+            self.load_packet()
+            self.keep_unconsumed(data, consumed.value)
+
+        return command_id
+
+    def wait_for_next_response(self, command: int, timeout: float = 1) -> bool:
+        """
+        Wait for the next response from the device.
+
+        :param command: The expected command ID.
+        :param timeout: The maximum time to wait for a response, if 0 then non-blocking.
+        :return: True if the response matches the expected command ID. False if the timeout is
+        reached, or no bytes were read if non-blocking.
+        """
+
+        end_time = time.time() + timeout
+        wait = 0
+
+        while True:
+            data = self.read_available(wait)
+
+            # NOTE: An empty feed still completes packets kept by a resync.
+            if self.feed(data) == command:
+                return True
+
+            if self.pending:
+                continue
+
+            time_left = end_time - time.time()
+
+            if not data and time_left <= 0:
+                return False
+
+            # Later passes block on the port for the rest of the timeout.
+            wait = max(time_left, 0)
+
+    def get_errors(self) -> tuple[int, int]:
+        """
+        Get the number of packets that failed parsing.
+
+        :return: The number of CRC errors and header errors.
+        """
+
+        crc_errors = ctypes.c_uint32(0)
+        header_errors = ctypes.c_uint32(0)
+        self.library.lw_native_get_errors(self.parser, ctypes.byref(crc_errors), ctypes.byref(header_errors))
+        return crc_errors.value, header_errors.value
+
+    # -----------------------------------------------------------------------------
+    # Batched streaming.
+    # -----------------------------------------------------------------------------
+    def wait_for_streamed_distance_batch(
+        self, config: DistanceConfig, max_samples: int = 1024, timeout: float = 1
+    ) -> Distance_batch:
+        """
+        Get streamed distance data in bulk. Returns when max_samples have been
+        decoded, or when the timeout is reached with whatever was decoded.
+        Other packets received while streaming are skipped.
+
+        :param config: Distance configuration.
+        :param max_samples: The most samples to return.
+        :param timeout: The timeout in seconds, if 0 then only already received bytes are decoded.
+        :return: The distance batch, which can be empty.
+        """
+
+        if self.distance_config != config:
+            self.library.lw_native_set_distance_config(self.parser, int(config))
+            self.distance_config = config
+
+        columns = np.zeros((len(DISTANCE_FIELDS), max_samples), dtype=np.int32)
+        columns_pointer = columns.ctypes.data_as(ctypes.POINTER(ctypes.c_int32))
+        count = ctypes.c_uint32(0)
+        consumed = ctypes.c_uint32(0)
+        end_time = time.time() + timeout
+        wait = 0
+
+        while count.value < max_samples:
+            data = self.read_available(wait)
+            buffer = (ctypes.c_uint8 * len(data)).from_buffer_copy(data)
+            offset = 0
+
+            while True:
+                view = ctypes.cast(ctypes.byref(buffer, offset), ctypes.POINTER(ctypes.c_uint8))
+                command_id = self.library.lw_native_decode_distance_batch(
+                    self.parser,
+                    view,
+                    len(data) - offset,
+                    columns_pointer,
+                    max_samples,
+                    ctypes.byref(count),
+                    ctypes.byref(consumed),
+                )
+                offset += consumed.value
+
+                # Skip other packets, stop when the bytes are used up or the batch is full.
+                if command_id == NO_PACKET:
+                    break
+
+            self.keep_unconsumed(data, offset)
+
+            if self.pending:
+                continue
+
+            time_left = end_time - time.time()
+
+            if not data and time_left <= 0:
+                break
+
+            wait = max(time_left, 0)
+
+        return Distance_batch(columns, count.value, config)
@@ -40,6 +40,44 @@ class SerialServiceHandler:
         else:
             return ord(self.port.read(1))
 
+    def read_available(self, max_size: int) -> bytes:
+        """
+        Read the bytes already received by the serial port, up to max_size.
+        Returns an empty bytes object if no data is available.
+        """
+
+        # This should be a non-blocking read.
+        size = min(self.port.in_waiting, max_size)
+
+        if size == 0:
+            return b""
+        else:
+            return self.port.read(size)
+
+    def read_wait(self, max_size: int, timeout: float) -> bytes:
+        """
+        Wait up to timeout seconds for bytes to arrive, then read the bytes
+        received, up to max_size. Returns an empty bytes object on timeout.
+        """
+
+        if self.port.in_waiting != 0 or timeout <= 0:
+            return self.read_available(max_size)
+
+        # A blocking read sleeps in the driver until the first byte arrives.
+        # The port timeout belongs to the caller, so it is put back afterwards.
+        previous_timeout = self.port.timeout
+        self.port.timeout = timeout
+
+        try:
+            data = self.port.read(1)
+        finally:
+            self.port.timeout = previous_timeout
+
+        if not data:
+            return b""
+
+        return data + self.read_available(max_size - 1)
+
     def write(self, data):
         """Write data to the serial port."""
 
@@ -0,0 +1,4 @@
+#!/bin/sh
+# Build the native backend for grf250_native.py.
+cd "$(dirname "$0")"
+gcc -shared -fPIC -O3 -fvisibility=hidden -I../../serial_c_api -o liblw_serial_api_native.so lw_serial_api_native.c ../../serial_c_api/lw_serial_api.c ../../serial_c_api/lw_serial_api_grf250.c
@@ -0,0 +1,4 @@
+@REM Build the native backend for grf250_native.py with Visual Studio.
+@REM Run the Developer Command Prompt for Visual Studio, navigate to this directory and execute this batch file.
+
+cl -nologo -LD -O2 -W4 -I..\..\serial_c_api -Fe:lw_serial_api_native.dll lw_serial_api_native.c ..\..\serial_c_api\lw_serial_api.c ..\..\serial_c_api\lw_serial_api_grf250.c
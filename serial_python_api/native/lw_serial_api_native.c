@@ -0,0 +1,169 @@
+// ----------------------------------------------------------------------------
+// LightWare Serial API native backend for Python.
+//
+// A flat C interface over the response parser and distance decoder, loaded
+// with ctypes by grf250_native.py. The parser state lives here so Python
+// only passes byte buffers and output arrays across.
+// ----------------------------------------------------------------------------
+#include "lw_serial_api_grf250.h"
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define LW_NATIVE_EXPORT __declspec(dllexport)
+#else
+#define LW_NATIVE_EXPORT __attribute__((visibility("default")))
+#endif
+
+// The value returned when no packet was completed.
+#define LW_NATIVE_NO_PACKET -1
+
+typedef struct {
+    lw_response response;
+    lw_grf250_distance_decoder decoder;
+    uint32_t crc_errors;
+    uint32_t header_errors;
+} lw_native_parser;
+
+static void lw_native_record_error(lw_native_parser *parser) {
+    switch (parser->response.parse_error) {
+        case LW_PARSE_ERROR_PAYLOAD_SIZE:
+        case LW_PARSE_ERROR_HEADER: {
+            parser->header_errors += 1;
+            break;
+        }
+
+        case LW_PARSE_ERROR_CRC: {
+            parser->crc_errors += 1;
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+}
+
+LW_NATIVE_EXPORT lw_native_parser *lw_native_create_parser(void) {
+    lw_native_parser *parser = (lw_native_parser *)calloc(1, sizeof(lw_native_parser));
+
+    if (parser == NULL) {
+        return NULL;
+    }
+
+    lw_init_response(&parser->response);
+    lw_response_set_header_check(&parser->response, &lw_grf250_check_response_header);
+    parser->decoder = lw_grf250_create_distance_decoder(LW_GRF250_DISTANCE_CONFIG_ALL);
+    return parser;
+}
+
+LW_NATIVE_EXPORT void lw_native_destroy_parser(lw_native_parser *parser) {
+    free(parser);
+}
+
+LW_NATIVE_EXPORT void lw_native_set_distance_config(lw_native_parser *parser, uint32_t config) {
+    parser->decoder = lw_grf250_create_distance_decoder(config);
+}
+
+LW_NATIVE_EXPORT void lw_native_get_errors(lw_native_parser *parser, uint32_t *crc_errors, uint32_t *header_errors) {
+    *crc_errors = parser->crc_errors;
+    *header_errors = parser->header_errors;
+}
+
+/*
+ * Parse bytes until a packet is completed or all bytes are consumed.
+ *
+ * @param parser The parser.
+ * @param data The received bytes.
+ * @param size The number of bytes.
+ * @param consumed The number of bytes consumed is written here.
+ * @return The command ID of the completed packet, or LW_NATIVE_NO_PACKET.
+ */
+LW_NATIVE_EXPORT int32_t lw_native_feed(lw_native_parser *parser, const uint8_t *data, uint32_t size, uint32_t *consumed) {
+    uint32_t offset = 0;
+
+    // NOTE: Bytes kept by a resync can complete packets without new bytes.
+    while (offset < size || parser->response.resync_size != 0) {
+        uint32_t count = 0;
+        lw_result result = lw_feed_response_buffer(&parser->response, data + offset, size - offset, &count);
+        offset += count;
+        lw_native_record_error(parser);
+
+        if (result == LW_RESULT_SUCCESS) {
+            *consumed = offset;
+            return parser->response.command_id;
+        }
+    }
+
+    *consumed = offset;
+    return LW_NATIVE_NO_PACKET;
+}
+
+/*
+ * Copy the last completed packet.
+ *
+ * @param parser The parser.
+ * @param buffer The packet is written here.
+ * @param size The size of the buffer, LW_PACKET_RECV_SIZE always fits.
+ * @return The size of the packet.
+ */
+LW_NATIVE_EXPORT uint32_t lw_native_get_packet(lw_native_parser *parser, uint8_t *buffer, uint32_t size) {
+    uint32_t packet_size = parser->response.data_size;
+
+    if (parser->response.parse_state != LW_PARSESTATE_DONE || packet_size > size) {
+        return 0;
+    }
+
+    memcpy(buffer, parser->response.data, packet_size);
+    return packet_size;
+}
+
+/*
+ * Parse bytes and decode streamed distance data straight into columns.
+ * Parsing stops when the columns are full or a packet other than distance
+ * data is completed, which is left for lw_native_get_packet.
+ *
+ * @param parser The parser.
+ * @param data The received bytes.
+ * @param size The number of bytes.
+ * @param columns LW_GRF250_DISTANCE_FIELD_COUNT rows of capacity samples, one row per field.
+ * @param capacity The number of samples each row holds.
+ * @param count The number of samples already in the columns, updated as samples are added.
+ * @param consumed The number of bytes consumed is written here.
+ * @return The command ID of a completed packet that is not distance data, or LW_NATIVE_NO_PACKET.
+ */
+LW_NATIVE_EXPORT int32_t lw_native_decode_distance_batch(lw_native_parser *parser, const uint8_t *data, uint32_t size,
+                                                         int32_t *columns, uint32_t capacity, uint32_t *count, uint32_t *consumed) {
+    lw_grf250_distance_batch batch;
+    batch.timestamps_ns = NULL;
+    batch.capacity = capacity;
+    batch.count = *count;
+
+    for (uint32_t i = 0; i < LW_GRF250_DISTANCE_FIELD_COUNT; ++i) {
+        batch.columns[i] = columns + (size_t)i * capacity;
+    }
+
+    uint32_t offset = 0;
+    int32_t command_id = LW_NATIVE_NO_PACKET;
+
+    while (batch.count < batch.capacity) {
+        uint32_t fed = 0;
+        command_id = lw_native_feed(parser, data + offset, size - offset, &fed);
+        offset += fed;
+
+        if (command_id == LW_NATIVE_NO_PACKET) {
+            break;
+        }
+
+        if (command_id != LW_GRF250_COMMAND_DISTANCE_DATA) {
+            break;
+        }
+
+        lw_grf250_decode_distance_data_batch(&parser->decoder, &parser->response, &batch);
+        command_id = LW_NATIVE_NO_PACKET;
+    }
+
+    *count = batch.count;
+    *consumed = offset;
+    return command_id;
+}